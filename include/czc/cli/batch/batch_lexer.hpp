@@ -0,0 +1,202 @@
+/**
+ * @file batch_lexer.hpp
+ * @brief 单进程批量词法分析。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   `czc lex` 接受多个输入时，在一个进程内完成全部文件：
+ *   - 输入可以是文件、目录（递归，按文件名通配符过滤）或 `@响应文件`
+ *   - 文件按大小从大到小提交给共享的 TaskScheduler，缩短尾部等待
+ *   - 结果按输入顺序交付，诊断与输出因此与线程数无关
+ *   - 输出为每个文件一个结果文件，或一条聚合的 NDJSON 流
+ *
+ *   每个文件使用独立的 CompilerContext，任务之间不共享可变状态。
+ */
+
+#ifndef CZC_CLI_BATCH_BATCH_LEXER_HPP
+#define CZC_CLI_BATCH_BATCH_LEXER_HPP
+
+#include "czc/cli/context.hpp"
+#include "czc/common/config.hpp"
+#include "czc/common/output_sink.hpp"
+#include "czc/common/result.hpp"
+#include "czc/common/task_scheduler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace czc::cli {
+
+/**
+ * @brief 批量输入中的单个源文件。
+ */
+struct BatchInput {
+  std::filesystem::path path;       ///< 源文件路径
+  std::filesystem::path outputName; ///< 按文件输出时相对输出目录的路径
+  std::uintmax_t size{0};           ///< 文件大小（用于调度）
+};
+
+/**
+ * @brief 输入展开选项。
+ */
+struct BatchInputOptions {
+  /// 展开目录时文件名须匹配其中之一（支持 `*` 与 `?`）
+  std::vector<std::string> include{"*.zero"};
+  /// 文件名或目录名匹配其中之一时跳过（目录连同其子树）
+  std::vector<std::string> exclude;
+};
+
+/**
+ * @brief 检查名称是否匹配任一通配符（`*` 匹配任意串，`?` 匹配单个字符）。
+ *
+ * @param patterns 通配符列表
+ * @param name 文件名或目录名
+ * @return 匹配任一通配符时返回 true
+ */
+[[nodiscard]] bool matchesAnyGlob(std::span<const std::string> patterns,
+                                  std::string_view name) noexcept;
+
+/**
+ * @brief 展开命令行输入为源文件列表。
+ *
+ * @details
+ *   - 普通文件原样加入
+ *   - 目录递归展开，同一目录内按路径排序，结果与遍历顺序无关
+ *   - `@file` 逐行读取输入（忽略空行与 `#` 注释行），可嵌套
+ *   重复出现的文件只保留第一次。
+ *
+ * @param args 命令行输入
+ * @param options 展开选项
+ * @return 源文件列表，输入不存在或响应文件不可读时返回错误
+ */
+[[nodiscard]] Result<std::vector<BatchInput>>
+collectBatchInputs(std::span<const std::string> args,
+                   const BatchInputOptions &options = {});
+
+/**
+ * @brief 单个文件的处理结果。
+ */
+struct BatchFileResult {
+  int exitCode{0};           ///< 退出码（0 成功）
+  std::size_t tokenCount{0}; ///< Token 数
+  std::string output;        ///< 聚合模式下的 Token JSON 对象，失败时为空
+  std::string diagnostics;   ///< 已渲染的诊断文本
+};
+
+/**
+ * @brief 批量处理汇总。
+ */
+struct BatchSummary {
+  std::size_t files{0};    ///< 处理的文件数
+  std::size_t failed{0};   ///< 失败的文件数
+  std::size_t tokens{0};   ///< Token 总数
+  std::uintmax_t bytes{0}; ///< 源码总字节数
+};
+
+/**
+ * @brief 批量执行选项。
+ */
+struct BatchOptions {
+  /// 按文件输出的目录；未设置时输出聚合 NDJSON
+  std::optional<std::filesystem::path> outputDir;
+};
+
+/**
+ * @brief 单进程批量词法分析器。
+ *
+ * @details
+ *   使用示例：
+ *   @code
+ *   BatchLexer batch(driver.context(), {});
+ *   auto summary = batch.run(inputs, driver.scheduler(),
+ *                            [&](const BatchInput &input,
+ *                                BatchFileResult &result) {
+ *                              std::cerr << result.diagnostics;
+ *                              BatchLexer::writeRecord(sink, input, result);
+ *                            });
+ *   @endcode
+ */
+class BatchLexer {
+public:
+  /// 结果消费者，在调用线程上按输入顺序调用
+  using Consumer =
+      std::function<void(const BatchInput &input, BatchFileResult &result)>;
+
+  /**
+   * @brief 构造函数。
+   *
+   * @param ctx 提供全局、输出与词法选项的编译上下文（按值复制）
+   * @param options 批量执行选项
+   */
+  BatchLexer(const CompilerContext &ctx, BatchOptions options);
+
+  /**
+   * @brief 处理全部输入。
+   *
+   * @details
+   *   确定性模式的调度器上按输入顺序逐个处理；否则每个文件作为一个任务
+   *   提交，调用线程在等待下一个待交付结果时协助执行任务。
+   *
+   * @param inputs 源文件列表
+   * @param scheduler 执行文件任务的调度器
+   * @param consume 结果消费者
+   * @return 汇总信息
+   */
+  [[nodiscard]] BatchSummary run(std::span<const BatchInput> inputs,
+                                 TaskScheduler &scheduler,
+                                 const Consumer &consume) const;
+
+  /**
+   * @brief 处理单个文件（线程安全）。
+   *
+   * @param input 源文件
+   * @return 处理结果
+   */
+  [[nodiscard]] BatchFileResult lexFile(const BatchInput &input) const;
+
+  /**
+   * @brief 写出一条 NDJSON 记录。
+   *
+   * @details
+   *   格式：`{"file":..,"exitCode":..,"tokens":..,"result":{..}|null}`
+   *
+   * @param sink 输出汇
+   * @param input 源文件
+   * @param result 处理结果
+   */
+  static void writeRecord(OutputSink &sink, const BatchInput &input,
+                          const BatchFileResult &result);
+
+  /**
+   * @brief 检查按文件输出时是否有两个输入映射到同一输出路径。
+   *
+   * @param inputs 源文件列表
+   * @return 无冲突时成功，否则返回错误
+   */
+  [[nodiscard]] static VoidResult
+  checkOutputNames(std::span<const BatchInput> inputs);
+
+private:
+  /// 将 Token 写到输出目录下的结果文件
+  [[nodiscard]] int writeOutputFile(const BatchInput &input,
+                                    CompilerContext &ctx,
+                                    std::span<const lexer::Token> tokens) const;
+
+  GlobalOptions global_;
+  OutputOptions output_;
+  LexerOptions lexer_;
+  BatchOptions options_;
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_BATCH_BATCH_LEXER_HPP
@@ -22,9 +22,6 @@
 
 namespace czc::cli {
 
-// 前向声明
-class CompilerPhase;
-
 /**
  * @brief 命令接口，定义子命令的通用行为。
  *
@@ -75,22 +72,6 @@ public:
    */
   [[nodiscard]] virtual std::string_view description() const noexcept = 0;
 
-  /**
-   * @brief 获取关联的编译阶段（可选，用于 Pipeline）。
-   *
-   * @return 编译阶段指针，若不支持则返回 nullptr
-   */
-  [[nodiscard]] virtual CompilerPhase *asPhase() noexcept { return nullptr; }
-
-  /**
-   * @brief 获取关联的编译阶段（常量版本）。
-   *
-   * @return 编译阶段常量指针
-   */
-  [[nodiscard]] virtual const CompilerPhase *asPhase() const noexcept {
-    return nullptr;
-  }
-
 protected:
   Command() = default;
 };
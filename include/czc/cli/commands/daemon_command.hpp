@@ -0,0 +1,79 @@
+/**
+ * @file daemon_command.hpp
+ * @brief 常驻编译服务命令定义。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   实现 `czc daemon` 子命令：在 Unix 域套接字上常驻，
+ *   处理 `czc --client` 转发的请求；`--stop` 停止正在运行的服务。
+ */
+
+#ifndef CZC_CLI_COMMANDS_DAEMON_COMMAND_HPP
+#define CZC_CLI_COMMANDS_DAEMON_COMMAND_HPP
+
+#include "czc/common/config.hpp"
+
+#include "czc/cli/commands/command.hpp"
+#include "czc/cli/driver.hpp"
+
+#include <filesystem>
+
+namespace czc::cli {
+
+/**
+ * @brief 常驻编译服务命令。
+ */
+class DaemonCommand : public Command {
+public:
+  /**
+   * @brief 构造函数。
+   *
+   * @param driver 编译驱动器引用（提供 --socket 等全局选项）
+   */
+  explicit DaemonCommand(Driver &driver) : driver_(driver) {}
+
+  ~DaemonCommand() override = default;
+
+  /**
+   * @brief 设置命令行选项。
+   *
+   * @param app CLI11 子命令 App 指针
+   */
+  void setup(CLI::App *app) override;
+
+  /**
+   * @brief 启动服务（阻塞至收到停止请求）或停止已运行的服务。
+   *
+   * @return 退出码，无法监听或连接时返回错误
+   */
+  [[nodiscard]] Result<int> execute() override;
+
+  /**
+   * @brief 获取命令名称。
+   *
+   * @return "daemon"
+   */
+  [[nodiscard]] std::string_view name() const noexcept override {
+    return "daemon";
+  }
+
+  /**
+   * @brief 获取命令描述。
+   *
+   * @return 命令描述
+   */
+  [[nodiscard]] std::string_view description() const noexcept override {
+    return "Run a persistent compiler server for `czc --client`";
+  }
+
+private:
+  Driver &driver_;
+  bool stop_{false}; ///< 停止正在运行的服务
+  std::filesystem::path cacheFile_; ///< 查询缓存文件（--cache）
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_COMMANDS_DAEMON_COMMAND_HPP
@@ -21,7 +21,9 @@
 #include "czc/cli/driver.hpp"
 
 #include <filesystem>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace czc::cli {
 
@@ -33,6 +35,8 @@ namespace czc::cli {
  *   - 基础词法分析
  *   - Trivia 模式（保留空白和注释）
  *   - 多种输出格式（Text/JSON）
+ *   - 批量模式：多个文件、目录与 @响应文件，单进程多线程处理
+ *   - 监视模式（--watch）：文件变化后只重新分析内容变化的文件
  *
  *   命令只负责 CLI 交互，实际词法分析由 Driver + LexerPhase 执行。
  */
@@ -78,14 +82,36 @@ public:
    * @return 命令描述
    */
   [[nodiscard]] std::string_view description() const noexcept override {
-    return "Perform lexical analysis on source file";
+    return "Perform lexical analysis on source files";
   }
 
 private:
+  /**
+   * @brief 是否按批量模式执行。
+   *
+   * @details
+   *   多个输入、目录、响应文件或指定了 --out-dir 时为批量模式；
+   *   单个普通文件保持原有行为（含 --pipeline 与 --client）。
+   */
+  [[nodiscard]] bool isBatch() const;
+
+  /// 以批量模式执行
+  [[nodiscard]] Result<int> executeBatch();
+
+  /// 以监视模式执行（--watch）
+  [[nodiscard]] Result<int> executeWatch();
+
   Driver &driver_;
-  std::filesystem::path inputFile_; ///< 输入文件路径
-  bool trivia_{false};              ///< 是否保留 trivia
-  bool dumpTokens_{false};          ///< 是否输出所有 token
+  std::vector<std::string> inputs_;   ///< 输入：文件、目录或 @响应文件
+  BatchInputOptions inputOptions_;    ///< 目录展开的过滤条件
+  std::filesystem::path outputDir_;   ///< 按文件输出目录（批量模式）
+  bool trivia_{false};                ///< 是否保留 trivia
+  bool dumpTokens_{false};            ///< 是否输出所有 token
+  bool pipelined_{false};             ///< 是否启用流水线模式
+  bool watch_{false};                 ///< 是否监视输入并增量重新分析
+  std::size_t debounceMs_{50};        ///< 监视模式合并事件的窗口（毫秒）
+  /// 单文件的输出渲染线程数；批量与监视模式下为文件级工作线程数
+  std::optional<std::size_t> jobs_;
 };
 
 } // namespace czc::cli
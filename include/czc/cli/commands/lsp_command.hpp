@@ -0,0 +1,65 @@
+/**
+ * @file lsp_command.hpp
+ * @brief 语言服务器命令定义。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   实现 `czc lsp` 子命令：通过标准输入输出运行语言服务器，
+ *   供编辑器获取语义高亮与词法诊断。
+ */
+
+#ifndef CZC_CLI_COMMANDS_LSP_COMMAND_HPP
+#define CZC_CLI_COMMANDS_LSP_COMMAND_HPP
+
+#include "czc/common/config.hpp"
+
+#include "czc/cli/commands/command.hpp"
+
+namespace czc::cli {
+
+/**
+ * @brief 语言服务器命令。
+ */
+class LspCommand : public Command {
+public:
+  LspCommand() = default;
+  ~LspCommand() override = default;
+
+  /**
+   * @brief 设置命令行选项。
+   *
+   * @param app CLI11 子命令 App 指针
+   */
+  void setup(CLI::App *app) override;
+
+  /**
+   * @brief 运行语言服务器直到客户端发送 exit。
+   *
+   * @return 退出码：shutdown 之后退出为 0，否则为 1
+   */
+  [[nodiscard]] Result<int> execute() override;
+
+  /**
+   * @brief 获取命令名称。
+   *
+   * @return "lsp"
+   */
+  [[nodiscard]] std::string_view name() const noexcept override {
+    return "lsp";
+  }
+
+  /**
+   * @brief 获取命令描述。
+   *
+   * @return 命令描述
+   */
+  [[nodiscard]] std::string_view description() const noexcept override {
+    return "Run a language server over stdio";
+  }
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_COMMANDS_LSP_COMMAND_HPP
@@ -17,9 +17,13 @@
 #define CZC_CLI_CONTEXT_HPP
 
 #include "czc/common/config.hpp"
+#include "czc/common/result.hpp"
 #include "czc/diag/diag_context.hpp"
 #include "czc/diag/emitters/text_emitter.hpp"
+#include "czc/lexer/lexer_source_locator.hpp"
+#include "czc/lexer/source_manager.hpp"
 
+#include <cstddef>
 #include <filesystem>
 #include <memory>
 #include <optional>
@@ -31,8 +35,9 @@ namespace czc::cli {
  * @brief 输出格式枚举。
  */
 enum class OutputFormat {
-  Text, ///< 人类可读文本格式
-  Json  ///< JSON 格式
+  Text,  ///< 人类可读文本格式
+  Json,  ///< JSON 格式
+  NdJson ///< NDJSON 格式（每行一个 JSON 对象）
 };
 
 /**
@@ -52,6 +57,11 @@ struct GlobalOptions {
   std::filesystem::path workingDir{std::filesystem::current_path()};
   LogLevel logLevel{LogLevel::Normal};
   bool colorDiagnostics{true};
+  bool asyncDiagnostics{false}; ///< 诊断渲染与写出分离到后台线程
+  std::size_t maxErrorsPerCode{0}; ///< 每个错误码最多输出的诊断数（0=无限）
+  std::optional<std::filesystem::path> diagnosticsJson; ///< 诊断 JSON 副本
+  bool client{false}; ///< 将请求转发给常驻服务（czc daemon）
+  std::optional<std::filesystem::path> daemonSocket; ///< 常驻服务套接字路径
 };
 
 /**
@@ -68,6 +78,10 @@ struct OutputOptions {
 struct LexerOptions {
   bool preserveTrivia{false}; ///< 保留空白和注释信息
   bool dumpTokens{false};     ///< 输出所有 Token
+  bool pipelined{false};      ///< 流水线模式：扫描、格式化、写出并发进行
+  /// 并行度（0 为全部核心）。未指定时单文件输出顺序渲染，
+  /// 批量、监视与流水线模式使用全部核心
+  std::optional<std::size_t> jobs;
 };
 
 /**
@@ -85,6 +99,7 @@ struct ParserOptions {
  *   CompilerContext 替代全局单例模式，提供：
  *   - 选项的集中管理
  *   - 诊断系统的统一入口
+ *   - 全部阶段共享的 SourceManager 与源码定位器
  *   - 通过引用传递确保无全局状态
  *
  *   使用示例：
@@ -151,6 +166,29 @@ public:
   /// 获取语法分析选项（常量）
   [[nodiscard]] const ParserOptions &parser() const noexcept { return parser_; }
 
+  // ========== 源码管理 ==========
+
+  /// 获取项目级源码管理器（可变）
+  [[nodiscard]] lexer::SourceManager &sourceManager() noexcept {
+    return *sourceManager_;
+  }
+
+  /// 获取项目级源码管理器（常量）
+  [[nodiscard]] const lexer::SourceManager &sourceManager() const noexcept {
+    return *sourceManager_;
+  }
+
+  /**
+   * @brief 获取基于 sourceManager() 的源码定位器。
+   *
+   * @details
+   *   与 CompilerContext 同生命周期，并已设为 DiagContext 的默认定位器，
+   *   摘要与延迟刷新时不会悬空。查询只读，可被各阶段与线程共享。
+   */
+  [[nodiscard]] const diag::SourceLocator &sourceLocator() const noexcept {
+    return *sourceLocator_;
+  }
+
   // ========== 诊断系统 ==========
 
   /// 获取诊断上下文（可变）
@@ -163,6 +201,17 @@ public:
     return *diagContext_;
   }
 
+  /**
+   * @brief 按当前全局选项重建诊断发射器。
+   *
+   * @details
+   *   命令行解析完成后调用：应用 --no-color，并在启用
+   *   --async-diagnostics 或 --diagnostics-json 时改用异步多目标发射器。
+   *
+   * @return 成功返回 ok；诊断 JSON 文件无法打开时返回错误
+   */
+  [[nodiscard]] VoidResult configureDiagnostics();
+
   // ========== 便捷方法 ==========
 
   /// 检查是否为详细模式
@@ -196,6 +245,10 @@ private:
   OutputOptions output_;
   LexerOptions lexer_;
   ParserOptions parser_;
+
+  // 堆上分配保证移动后地址不变；须先于 diagContext_ 声明，晚于它析构
+  std::unique_ptr<lexer::SourceManager> sourceManager_;
+  std::unique_ptr<lexer::LexerSourceLocator> sourceLocator_;
   std::unique_ptr<diag::DiagContext> diagContext_;
 
   /// 创建诊断上下文
@@ -0,0 +1,56 @@
+/**
+ * @file daemon_client.hpp
+ * @brief 常驻编译服务客户端。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   `czc --client` 通过 DaemonClient 将请求转发给 `czc daemon`，
+ *   同一连接上可依次发送多个请求。
+ */
+
+#ifndef CZC_CLI_DAEMON_DAEMON_CLIENT_HPP
+#define CZC_CLI_DAEMON_DAEMON_CLIENT_HPP
+
+#include "czc/cli/daemon/protocol.hpp"
+#include "czc/common/config.hpp"
+#include "czc/common/result.hpp"
+
+#include <filesystem>
+
+namespace czc::cli {
+
+/**
+ * @brief 常驻服务客户端连接。
+ *
+ * @note 不可拷贝，可移动
+ */
+class DaemonClient {
+public:
+  /**
+   * @brief 连接常驻服务。
+   *
+   * @param socket 套接字路径
+   * @return 客户端连接，服务未运行或路径无效时返回错误
+   */
+  [[nodiscard]] static Result<DaemonClient>
+  connect(const std::filesystem::path &socket);
+
+  /**
+   * @brief 发送请求并等待响应。
+   *
+   * @param request 请求
+   * @return 响应，连接中断或协议错误时返回错误
+   */
+  [[nodiscard]] Result<DaemonResponse> send(const DaemonRequest &request);
+
+private:
+  explicit DaemonClient(UniqueFd fd) : fd_(std::move(fd)) {}
+
+  UniqueFd fd_;
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_DAEMON_DAEMON_CLIENT_HPP
@@ -0,0 +1,174 @@
+/**
+ * @file daemon_server.hpp
+ * @brief 常驻编译服务。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   `czc daemon` 在 Unix 域套接字上监听请求，进程内常驻：
+ *   - Driver/CompilerContext：翻译器、错误码表、源码定位器只初始化一次
+ *   - 模板与驻留字符串缓存：服务线程上长期有效
+ *   - 文件缓存：路径、修改时间与大小不变时复用 SourceManager 中的缓冲区
+ *
+ *   连接由固定数量的 I/O 线程服务，连接的收发互不阻塞：
+ *   - 套接字读取会阻塞，因此不占用 Driver 中用于计算的工作窃取调度器
+ *   - 空闲或停滞超过 idleTimeout 的连接被关闭，不会长期占用服务线程
+ *   - 请求的执行共用 Driver 与 SourceManager，在 mutex_ 内串行
+ *   缓冲区数超过上限时整体重建 Driver，内存不随请求数增长。
+ */
+
+#ifndef CZC_CLI_DAEMON_DAEMON_SERVER_HPP
+#define CZC_CLI_DAEMON_DAEMON_SERVER_HPP
+
+#include "czc/cli/daemon/protocol.hpp"
+#include "czc/cli/driver.hpp"
+#include "czc/cli/query/query_database.hpp"
+#include "czc/common/config.hpp"
+#include "czc/common/result.hpp"
+#include "czc/lexer/source_manager.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace czc::cli {
+
+/**
+ * @brief 常驻编译服务。
+ *
+ * @details
+ *   使用示例：
+ *   @code
+ *   DaemonServer server(defaultDaemonSocket());
+ *   auto result = server.run(); // 阻塞直到收到 Shutdown 请求
+ *   @endcode
+ */
+class DaemonServer {
+public:
+  /// SourceManager 缓冲区数上限，超出后重建 Driver
+  static constexpr std::size_t kMaxBuffers = 1024;
+
+  /// I/O 线程数，即同时服务的连接数上限，更多的连接排队等待
+  static constexpr std::size_t kMaxConnections = 16;
+
+  /// 默认的连接空闲超时
+  static constexpr std::chrono::milliseconds kIdleTimeout{30'000};
+
+  /**
+   * @brief 构造函数。
+   *
+   * @param socket 监听的套接字路径
+   * @param cacheFile 查询缓存文件（为空时不持久化）
+   */
+  explicit DaemonServer(std::filesystem::path socket,
+                        std::filesystem::path cacheFile = {});
+
+  ~DaemonServer();
+
+  // 不可拷贝，不可移动
+  DaemonServer(const DaemonServer &) = delete;
+  DaemonServer &operator=(const DaemonServer &) = delete;
+  DaemonServer(DaemonServer &&) = delete;
+  DaemonServer &operator=(DaemonServer &&) = delete;
+
+  /**
+   * @brief 绑定套接字并处理请求，直到收到 Shutdown 请求。
+   *
+   * @details
+   *   若路径上残留的套接字已无服务监听则先删除；
+   *   已有服务在运行时返回错误。
+   *   收到 Shutdown 请求后停止接受连接，关闭其余连接的读方向，
+   *   等待正在执行的请求完成后返回。
+   *   设置了缓存文件时，启动前恢复查询缓存，停止后写回。
+   *
+   * @return 正常停止返回 ok，无法监听时返回错误
+   */
+  [[nodiscard]] VoidResult run();
+
+  /**
+   * @brief 设置连接空闲超时（须在 run() 之前调用）。
+   *
+   * @param timeout 连接上两个请求之间允许的最长间隔
+   */
+  void setIdleTimeout(std::chrono::milliseconds timeout) noexcept {
+    idleTimeout_ = timeout;
+  }
+
+  /**
+   * @brief 处理单个请求（不经过套接字，也用于测试；可并发调用）。
+   *
+   * @param request 请求
+   * @return 响应
+   */
+  [[nodiscard]] DaemonResponse handle(const DaemonRequest &request);
+
+  /// 是否已收到 Shutdown 请求
+  [[nodiscard]] bool stopping() const noexcept {
+    return stopping_.load(std::memory_order_acquire);
+  }
+
+  /// 当前常驻的 Driver（用于测试）
+  [[nodiscard]] const Driver &driver() const noexcept { return *driver_; }
+
+  /// 当前的查询数据库（用于测试）
+  [[nodiscard]] const QueryDatabase &queries() const noexcept {
+    return *queries_;
+  }
+
+private:
+  /**
+   * @brief 已加载文件的缓存项。
+   */
+  struct CachedFile {
+    std::filesystem::file_time_type mtime; ///< 加载时的修改时间
+    std::uintmax_t size{0};                ///< 加载时的文件大小
+  };
+
+  /// I/O 线程主循环：依次取出排队的连接并服务，停止后返回
+  void serveQueued();
+
+  /// 处理一条连接上的全部请求
+  void serveConnection(int fd);
+
+  /// 停止时关闭全部连接的读方向
+  void closeConnections();
+
+  /// 执行词法分析请求
+  [[nodiscard]] DaemonResponse lex(const DaemonRequest &request);
+
+  /// 按请求取得 Token 序列：文件内容未变化时复用查询结果
+  [[nodiscard]] Result<std::shared_ptr<const FileTokens>>
+  resolveTokens(const DaemonRequest &request);
+
+  /// 重建 Driver 与查询数据库（丢弃全部缓冲区）
+  void reset();
+
+  std::filesystem::path socket_;
+  std::filesystem::path cacheFile_;
+  std::unique_ptr<Driver> driver_;
+  std::unique_ptr<QueryDatabase> queries_; ///< 引用 driver_ 的 SourceManager
+  std::unordered_map<std::string, CachedFile> files_;
+  std::atomic<bool> stopping_{false};
+  std::chrono::milliseconds idleTimeout_{kIdleTimeout};
+
+  std::mutex mutex_; ///< 保护 driver_、queries_ 与 files_（请求串行执行）
+  std::mutex connectionsMutex_;
+  std::unordered_set<int> connections_; ///< 正在服务的连接
+
+  std::mutex queueMutex_;
+  std::condition_variable queueReady_;
+  std::deque<UniqueFd> pending_; ///< 已接受、等待 I/O 线程的连接
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_DAEMON_DAEMON_SERVER_HPP
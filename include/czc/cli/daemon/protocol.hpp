@@ -0,0 +1,168 @@
+/**
+ * @file protocol.hpp
+ * @brief 常驻编译服务的请求/响应协议。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   `czc daemon` 与 `czc --client` 之间通过 Unix 域套接字交换帧：
+ *   - 帧：4 字节小端长度 + 负载
+ *   - 负载：协议版本、请求类型，随后为定长字段与长度前缀字符串
+ *
+ *   编解码与套接字收发分离，编解码部分不依赖平台，便于单元测试。
+ */
+
+#ifndef CZC_CLI_DAEMON_PROTOCOL_HPP
+#define CZC_CLI_DAEMON_PROTOCOL_HPP
+
+#include "czc/cli/context.hpp"
+#include "czc/common/config.hpp"
+#include "czc/common/result.hpp"
+#include "czc/common/unique_fd.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace czc::cli {
+
+/// 协议版本，不兼容的改动需递增
+inline constexpr std::uint8_t kDaemonProtocolVersion = 1;
+
+/// 单帧负载上限（防止损坏的长度字段触发巨量分配）
+inline constexpr std::uint32_t kMaxDaemonFrame = 1U << 30;
+
+/**
+ * @brief 请求类型。
+ */
+enum class DaemonRequestKind : std::uint8_t {
+  Lex = 1,     ///< 词法分析文件或内存源码
+  Shutdown = 2 ///< 停止服务
+};
+
+/**
+ * @brief 客户端请求。
+ *
+ * @details
+ *   路径相对 cwd 解析；提供 source 时忽略 path，按 name 命名内存缓冲区。
+ */
+struct DaemonRequest {
+  DaemonRequestKind kind{DaemonRequestKind::Lex};
+  std::string cwd;                   ///< 客户端工作目录
+  std::string path;                  ///< 源文件路径
+  std::optional<std::string> source; ///< 内存源码
+  std::string name{"<stdin>"};       ///< 内存源码的虚拟文件名
+  bool preserveTrivia{false};        ///< 保留空白和注释
+  bool dumpTokens{false};            ///< 输出所有 Token
+  bool colorDiagnostics{true};       ///< 诊断着色
+  OutputFormat format{OutputFormat::Text};
+  std::uint32_t maxErrorsPerCode{0}; ///< 每个错误码最多输出数
+};
+
+/**
+ * @brief 服务端响应。
+ */
+struct DaemonResponse {
+  int exitCode{0}; ///< 与本地执行相同的退出码
+  std::string out; ///< 标准输出内容（Token 输出）
+  std::string err; ///< 标准错误内容（已渲染的诊断）
+};
+
+// ========== 编解码 ==========
+
+/// 编码请求负载（不含帧头）
+[[nodiscard]] std::string encodeRequest(const DaemonRequest &request);
+
+/// 解码请求负载
+[[nodiscard]] Result<DaemonRequest> decodeRequest(std::string_view payload);
+
+/// 编码响应负载（不含帧头）
+[[nodiscard]] std::string encodeResponse(const DaemonResponse &response);
+
+/// 解码响应负载
+[[nodiscard]] Result<DaemonResponse> decodeResponse(std::string_view payload);
+
+// ========== 套接字 ==========
+
+/**
+ * @brief 默认套接字路径。
+ *
+ * @return $XDG_RUNTIME_DIR/czc.sock，未设置时为临时目录下的 czc-<uid>.sock
+ */
+[[nodiscard]] std::filesystem::path defaultDaemonSocket();
+
+/**
+ * @brief 连接常驻服务套接字。
+ *
+ * @param socket 套接字路径
+ * @return 已连接的描述符，服务未运行时返回错误
+ */
+[[nodiscard]] Result<UniqueFd>
+connectDaemonSocket(const std::filesystem::path &socket);
+
+/**
+ * @brief 在套接字路径上监听。
+ *
+ * @details
+ *   路径上残留的套接字若已无服务监听则先删除；已有服务在运行时返回错误。
+ *
+ * @param socket 套接字路径
+ * @return 监听描述符
+ */
+[[nodiscard]] Result<UniqueFd>
+listenDaemonSocket(const std::filesystem::path &socket);
+
+/**
+ * @brief 接受一个连接（处理 EINTR）。
+ *
+ * @param listenFd 监听描述符
+ * @return 已连接的描述符
+ */
+[[nodiscard]] Result<UniqueFd> acceptDaemonConnection(int listenFd);
+
+/**
+ * @brief 设置连接的收发超时。
+ *
+ * @details
+ *   超时后 readFrame() 与 writeFrame() 返回错误，
+ *   服务端据此关闭空闲或停滞的连接。
+ *
+ * @param fd 已连接的套接字
+ * @param timeout 超时时长（须大于 0）
+ * @return 设置失败返回错误
+ */
+[[nodiscard]] VoidResult setSocketTimeout(int fd,
+                                          std::chrono::milliseconds timeout);
+
+/**
+ * @brief 关闭连接的读方向，阻塞在 readFrame() 上的线程随即读到连接结束。
+ *
+ * @param fd 已连接的套接字
+ */
+void shutdownSocketReads(int fd) noexcept;
+
+/**
+ * @brief 写出一帧。
+ *
+ * @param fd 已连接的套接字
+ * @param payload 负载
+ * @return 成功返回 ok，写入失败返回错误
+ */
+[[nodiscard]] VoidResult writeFrame(int fd, std::string_view payload);
+
+/**
+ * @brief 读取一帧。
+ *
+ * @param fd 已连接的套接字
+ * @param payload 输出负载
+ * @return 读到完整帧返回 true，对端在帧边界处关闭返回 false
+ */
+[[nodiscard]] Result<bool> readFrame(int fd, std::string &payload);
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_DAEMON_PROTOCOL_HPP
@@ -16,16 +16,23 @@
 #ifndef CZC_CLI_DRIVER_HPP
 #define CZC_CLI_DRIVER_HPP
 
+#include "czc/cli/batch/batch_lexer.hpp"
 #include "czc/cli/context.hpp"
+#include "czc/cli/query/query_database.hpp"
+#include "czc/cli/watch/watch_lexer.hpp"
 #include "czc/common/config.hpp"
+#include "czc/common/output_sink.hpp"
 #include "czc/common/result.hpp"
+#include "czc/common/task_scheduler.hpp"
 #include "czc/diag/diagnostic.hpp"
+#include "czc/lexer/token.hpp"
 
 #include <filesystem>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace czc::cli {
 
@@ -79,6 +86,16 @@ public:
   /// 获取编译上下文（常量）
   [[nodiscard]] const CompilerContext &context() const noexcept { return ctx_; }
 
+  /**
+   * @brief 获取进程共享的任务调度器。
+   *
+   * @details
+   *   首次调用时按 LexerOptions::jobs 创建（1 为确定性单线程，
+   *   0 或未指定为全部核心）。
+   *   各阶段共用这一个实例，并行度不会叠加。
+   */
+  [[nodiscard]] TaskScheduler &scheduler();
+
   /// 获取诊断上下文
   [[nodiscard]] diag::DiagContext &diagContext() noexcept {
     return ctx_.diagContext();
@@ -123,6 +140,79 @@ public:
    */
   [[nodiscard]] int runLexer(const std::filesystem::path &inputFile);
 
+  /**
+   * @brief 对已加载的缓冲区执行词法分析，Token 写入给定输出汇。
+   *
+   * @details
+   *   常驻服务复用 SourceManager 中未变化的缓冲区时使用。
+   *
+   * @param bufferId 源码缓冲区 ID
+   * @param sink 输出汇
+   * @return 退出码（0 成功，非 0 失败）
+   */
+  [[nodiscard]] int runLexer(lexer::BufferID bufferId, OutputSink &sink);
+
+  /**
+   * @brief 输出已有的词法分析结果，Token 写入给定输出汇。
+   *
+   * @details
+   *   常驻服务从 QueryDatabase 取得未失效的 Token 序列时使用；
+   *   结果中的缓冲区须属于本 Driver 的 SourceManager。
+   *
+   * @param lexed 词法分析结果
+   * @param sink 输出汇
+   * @return 退出码（0 成功，非 0 失败）
+   */
+  [[nodiscard]] int runLexer(const FileTokens &lexed, OutputSink &sink);
+
+  /**
+   * @brief 将词法分析请求转发给常驻服务（--client）。
+   *
+   * @details
+   *   服务端渲染的 Token 输出写到本地 -o 目标或标准输出，
+   *   诊断写到错误输出流，退出码与本地执行一致。
+   *
+   * @param inputFile 输入文件路径（相对当前目录）
+   * @return 退出码，无法连接服务时报告诊断并返回 1
+   */
+  [[nodiscard]] int runLexerRemote(const std::filesystem::path &inputFile);
+
+  /**
+   * @brief 在一个进程内对多个文件执行词法分析。
+   *
+   * @details
+   *   诊断按输入顺序写到错误输出流；Token 写到输出目录下的结果文件，
+   *   或作为 NDJSON 记录写到 -o 目标 / 标准输出。非静默模式下最后输出汇总。
+   *
+   * @param inputs 源文件列表（见 collectBatchInputs()）
+   * @param options 批量执行选项
+   * @return 退出码：全部成功为 0，否则为 1
+   */
+  [[nodiscard]] int runLexerBatch(std::span<const BatchInput> inputs,
+                                  const BatchOptions &options);
+
+  /**
+   * @brief 监视模式：全量分析一次，之后只重新分析内容变化的文件。
+   *
+   * @details
+   *   每个文件一行 NDJSON 记录（含诊断），写到 -o 目标 / 标准输出，
+   *   每批变化处理完后立即刷新。非静默模式下每批输出一行汇总。
+   *   watcher 被 interrupt() 唤醒后返回。
+   *
+   * @param args 命令行输入：文件、目录或 @响应文件
+   * @param watcher 文件监视器
+   * @param options 监视选项
+   * @return 退出码：被唤醒后正常停止为 0，输入无效、监视或输出失败为 1
+   */
+  [[nodiscard]] int runLexerWatch(std::span<const std::string> args,
+                                  FileWatcher &watcher,
+                                  const WatchOptions &options);
+
+  /**
+   * @brief 获取常驻服务套接字路径（--socket 或默认路径）。
+   */
+  [[nodiscard]] std::filesystem::path daemonSocket() const;
+
   /**
    * @brief 打印诊断摘要。
    */
@@ -136,7 +226,46 @@ public:
   void setErrorStream(std::ostream &stream) noexcept { errStream_ = &stream; }
 
 private:
+  /**
+   * @brief 以流水线模式执行词法分析（见 LexerOptions::pipelined）。
+   *
+   * @details
+   *   Token 边扫描边写出，输出约定与顺序模式不同：
+   *   - Token 总数写在 Token 之后（JSON 的 "count"、文本的 "Total tokens"）
+   *   - 出现词法错误时已扫描的 Token 仍会写出，随后报告错误并返回 1
+   *
+   * @param inputFile 输入文件路径
+   * @return 退出码
+   */
+  [[nodiscard]] int runLexerPipelined(const std::filesystem::path &inputFile);
+
+  /**
+   * @brief 打开输出目标（-o 指定的文件或标准输出）。
+   *
+   * @return 输出汇，打开失败时报告诊断并返回 nullptr
+   */
+  [[nodiscard]] std::unique_ptr<OutputSink> openOutputSink();
+
+  /**
+   * @brief 刷新输出汇并检查写入错误。
+   *
+   * @param sink 输出汇
+   * @return 退出码
+   */
+  [[nodiscard]] int finishOutput(OutputSink &sink);
+
+  /**
+   * @brief 按输出选项格式化 Token 并写出。
+   *
+   * @param tokens Token 列表
+   * @param sink 输出汇
+   * @return 退出码
+   */
+  [[nodiscard]] int writeTokens(const std::vector<lexer::Token> &tokens,
+                                OutputSink &sink);
+
   CompilerContext ctx_;
+  std::unique_ptr<TaskScheduler> scheduler_; ///< 任务调度器（按需创建）
   std::ostream *errStream_{&std::cerr}; ///< 错误输出流（默认 stderr）
 };
 
@@ -0,0 +1,203 @@
+/**
+ * @file document.hpp
+ * @brief 语言服务器中打开的文档：增量词法分析与语义 Token 编码。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   每次修改都把新文本作为新缓冲区加入 SourceManager，
+ *   只重新分析受影响的区间：
+ *   - 起点：编辑前最后一个与编辑区保持前瞻距离的 Token 的末尾
+ *   - 终点：编辑区之后第一个与旧结果起始位置对齐的 Token，
+ *     此后文本相同、词法分析确定，直接平移复用旧 Token 与错误
+ *
+ *   文档只保存需要着色的 Token（偏移、长度、类型），
+ *   不持有 BufferID 以外的源码引用，缓冲区可整体迁移到新的 SourceManager。
+ */
+
+#ifndef CZC_CLI_LSP_DOCUMENT_HPP
+#define CZC_CLI_LSP_DOCUMENT_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/lexer/lexer_error.hpp"
+#include "czc/lexer/source_manager.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace czc::cli {
+
+/**
+ * @brief 语义 Token 类型（取值即图例下标）。
+ */
+enum class SemanticTokenType : std::uint8_t {
+  Keyword,
+  Variable,
+  Number,
+  String,
+  Operator,
+};
+
+/// 语义 Token 图例（initialize 响应中按此顺序声明）
+inline constexpr std::array<std::string_view, 5> kSemanticTokenLegend = {
+    "keyword", "variable", "number", "string", "operator"};
+
+/**
+ * @brief LSP 位置（0-based 行号，UTF-16 码元列号）。
+ */
+struct LspPosition {
+  std::uint32_t line{0};
+  std::uint32_t character{0};
+
+  [[nodiscard]] bool operator==(const LspPosition &) const noexcept = default;
+};
+
+/**
+ * @brief LSP 区间。
+ */
+struct LspRange {
+  LspPosition start;
+  LspPosition end;
+};
+
+/**
+ * @brief didChange 中的一项内容变更。
+ */
+struct LspContentChange {
+  std::optional<LspRange> range; ///< 为空表示整篇替换
+  std::string text;              ///< 替换文本
+};
+
+/**
+ * @brief 需要着色的 Token。
+ */
+struct LspToken {
+  std::uint32_t offset{0};      ///< 字节偏移
+  std::uint32_t length{0};      ///< 字节长度
+  SemanticTokenType type{};     ///< 语义类型
+};
+
+/**
+ * @brief 文档中的词法错误。
+ */
+struct LspDiagnostic {
+  std::uint32_t offset{0};      ///< 字节偏移
+  std::uint32_t length{0};      ///< 字节长度
+  lexer::LexerErrorCode code{}; ///< 错误码
+  std::string message;          ///< 错误消息
+};
+
+/**
+ * @brief 将 Token 类型映射为语义类型。
+ *
+ * @return 语义类型，分隔符等不着色的 Token 返回 std::nullopt
+ */
+[[nodiscard]] std::optional<SemanticTokenType>
+semanticTypeOf(lexer::TokenType type) noexcept;
+
+/**
+ * @brief 语言服务器中打开的文档。
+ */
+class LspDocument {
+public:
+  /**
+   * @brief 最近一次分析的统计（用于测试与性能观察）。
+   */
+  struct RelexStats {
+    std::uint32_t restartOffset{0}; ///< 重新分析的起点
+    std::size_t lexedTokens{0};     ///< 重新分析产生的 Token 数
+    std::size_t reusedTokens{0};    ///< 直接复用的旧 Token 数
+  };
+
+  /**
+   * @brief 打开文档并完整分析一次。
+   *
+   * @param sm 源码管理器（文档存活期间须有效）
+   * @param uri 文档 URI（也作为缓冲区文件名）
+   * @param text 初始文本
+   * @param version 文档版本
+   */
+  LspDocument(lexer::SourceManager &sm, std::string uri, std::string text,
+              std::int64_t version);
+
+  /**
+   * @brief 依次应用内容变更并增量重新分析。
+   *
+   * @param changes 变更列表（后一项的位置基于前一项应用后的文本）
+   * @param version 新版本
+   */
+  void applyChanges(std::span<const LspContentChange> changes,
+                    std::int64_t version);
+
+  /**
+   * @brief 把当前文本迁移到另一个 SourceManager。
+   *
+   * @details
+   *   Token 与错误只保存偏移，迁移后无需重新分析。
+   *
+   * @param sm 新的源码管理器
+   */
+  void rebind(lexer::SourceManager &sm);
+
+  [[nodiscard]] std::string_view uri() const noexcept { return uri_; }
+  [[nodiscard]] std::int64_t version() const noexcept { return version_; }
+  [[nodiscard]] lexer::BufferID buffer() const noexcept { return buffer_; }
+  [[nodiscard]] std::string_view text() const;
+
+  [[nodiscard]] std::span<const LspToken> tokens() const noexcept {
+    return tokens_;
+  }
+  [[nodiscard]] std::span<const LspDiagnostic> diagnostics() const noexcept {
+    return diagnostics_;
+  }
+  [[nodiscard]] const RelexStats &lastRelex() const noexcept {
+    return stats_;
+  }
+
+  /**
+   * @brief 字节偏移转换为 LSP 位置。
+   */
+  [[nodiscard]] LspPosition positionAt(std::uint32_t offset) const;
+
+  /**
+   * @brief LSP 位置转换为字节偏移。
+   *
+   * @details
+   *   行号越界时返回文本末尾，列号越界时返回行尾（不含换行符）。
+   */
+  [[nodiscard]] std::uint32_t offsetAt(LspPosition position) const;
+
+  /**
+   * @brief 按 LSP 相对编码生成语义 Token 数据。
+   *
+   * @details
+   *   每个 Token 编为 5 个整数：行差、列差（同行时相对上一个 Token）、
+   *   长度（UTF-16）、类型下标、修饰位。跨行 Token 按行拆分。
+   *
+   * @return 编码后的整数序列
+   */
+  [[nodiscard]] std::vector<std::uint32_t> encodeSemanticTokens() const;
+
+private:
+  /// 在 [restart, 文本末尾) 上重新分析，并在对齐处拼接旧结果
+  void relex(std::uint32_t prefix, std::uint32_t suffix,
+             std::int64_t delta);
+
+  lexer::SourceManager *sm_;
+  std::string uri_;
+  std::int64_t version_{0};
+  lexer::BufferID buffer_;
+  std::vector<LspToken> tokens_;
+  std::vector<LspDiagnostic> diagnostics_;
+  RelexStats stats_;
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_LSP_DOCUMENT_HPP
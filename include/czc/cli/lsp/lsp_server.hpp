@@ -0,0 +1,148 @@
+/**
+ * @file lsp_server.hpp
+ * @brief 基于 stdio 的语言服务器。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   `czc lsp` 通过标准输入输出收发 JSON-RPC 消息，支持：
+ *   - 文档同步：didOpen / didChange（增量）/ didClose
+ *   - textDocument/semanticTokens/full 与 /full/delta
+ *   - 每次打开或修改后发布词法诊断（publishDiagnostics）
+ *
+ *   所有文档共享一个 SourceManager，每次修改都会加入整篇文档的新缓冲区。
+ *   旧缓冲区的字节数超过打开文档总字节数的若干倍后，把仍打开的文档
+ *   迁移到新的 SourceManager：保留的源码字节数与打开的文档大小成正比，
+ *   不随编辑次数增长，迁移的拷贝开销均摊到每次编辑为常数倍。
+ */
+
+#ifndef CZC_CLI_LSP_LSP_SERVER_HPP
+#define CZC_CLI_LSP_LSP_SERVER_HPP
+
+#include "czc/cli/lsp/document.hpp"
+#include "czc/common/config.hpp"
+#include "czc/common/json_reader.hpp"
+#include "czc/common/output_sink.hpp"
+#include "czc/lexer/source_manager.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace czc::cli {
+
+/**
+ * @brief 基于 stdio 的语言服务器。
+ *
+ * @details
+ *   使用示例：
+ *   @code
+ *   auto out = FdSink::standardOutput();
+ *   LspServer server(std::cin, *out);
+ *   return server.run();
+ *   @endcode
+ */
+class LspServer {
+public:
+  /// 保留字节数超过打开文档字节数的该倍数后迁移打开的文档
+  static constexpr std::size_t kRetainedFactor = 3;
+
+  /// 保留字节数低于该值时不迁移，避免小文档每次编辑都迁移
+  static constexpr std::size_t kMinRetainedBytes = std::size_t{1} << 20;
+
+  /// 缓冲区数上限：大量极小文档时按数量迁移，限制每个缓冲区的固定开销
+  static constexpr std::size_t kMaxBuffers = 4096;
+
+  /**
+   * @brief 构造函数。
+   *
+   * @param in 消息输入流
+   * @param out 消息输出汇
+   */
+  LspServer(std::istream &in, OutputSink &out);
+
+  // 不可拷贝，不可移动
+  LspServer(const LspServer &) = delete;
+  LspServer &operator=(const LspServer &) = delete;
+  LspServer(LspServer &&) = delete;
+  LspServer &operator=(LspServer &&) = delete;
+
+  ~LspServer() = default;
+
+  /**
+   * @brief 处理消息直到收到 exit 通知或输入结束。
+   *
+   * @return 退出码：shutdown 之后退出为 0，否则为 1
+   */
+  [[nodiscard]] int run();
+
+  /**
+   * @brief 处理单条消息（不经过输入流，也用于测试）。
+   *
+   * @param message 已解析的 JSON-RPC 消息
+   */
+  void handle(const JsonValue &message);
+
+  /// 是否已收到 exit 通知
+  [[nodiscard]] bool exited() const noexcept { return exited_; }
+
+  /// 查找打开的文档
+  [[nodiscard]] const LspDocument *document(std::string_view uri) const;
+
+  /// 共享 SourceManager 中保留的源码字节数（含已被替换的旧版本）
+  [[nodiscard]] std::size_t retainedBytes() const noexcept {
+    return sources_->sourceBytes();
+  }
+
+private:
+  /**
+   * @brief 打开的文档及其最近一次语义 Token 结果。
+   */
+  struct OpenDocument {
+    LspDocument document;
+    std::string resultId;             ///< 最近一次结果的 ID
+    std::vector<std::uint32_t> data;  ///< 最近一次结果的数据
+  };
+
+  void initialize(const JsonValue &id);
+  void didOpen(const JsonValue &params);
+  void didChange(const JsonValue &params);
+  void didClose(const JsonValue &params);
+  void semanticTokensFull(const JsonValue &id, const JsonValue &params);
+  void semanticTokensDelta(const JsonValue &id, const JsonValue &params);
+
+  /// 发布文档当前的词法诊断
+  void publishDiagnostics(const LspDocument &document);
+
+  /// 生成新的语义 Token 结果并记录为最近一次结果
+  void refreshTokens(OpenDocument &open);
+
+  /// 旧缓冲区占用过多时迁移打开的文档
+  void compactSources();
+
+  /// 写出 result 已序列化的响应
+  void reply(const JsonValue &id, std::string_view result);
+
+  /// 写出错误响应
+  void replyError(const JsonValue &id, int code, std::string_view message);
+
+  /// 写出通知
+  void notify(std::string_view method, std::string_view params);
+
+  std::istream &in_;
+  OutputSink &out_;
+  std::unique_ptr<lexer::SourceManager> sources_;
+  std::unordered_map<std::string, OpenDocument> documents_;
+  std::uint64_t nextResultId_{1};
+  bool shutdown_{false};
+  bool exited_{false};
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_LSP_LSP_SERVER_HPP
@@ -0,0 +1,49 @@
+/**
+ * @file transport.hpp
+ * @brief LSP 基础协议的消息分帧（Content-Length 头 + JSON 正文）。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#ifndef CZC_CLI_LSP_TRANSPORT_HPP
+#define CZC_CLI_LSP_TRANSPORT_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/common/output_sink.hpp"
+#include "czc/common/result.hpp"
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace czc::cli {
+
+/// 单条 LSP 消息正文的大小上限
+inline constexpr std::size_t kMaxLspMessage = std::size_t{1} << 28;
+
+/**
+ * @brief 读取一条消息的正文。
+ *
+ * @details
+ *   解析头部直到空行，忽略 Content-Length 之外的头字段。
+ *
+ * @param in 输入流
+ * @param[out] body 消息正文（复用其容量）
+ * @return 读到消息返回 true，头部开始前遇到 EOF 返回 false，
+ *         头部或正文不完整时返回错误（"E006"）
+ */
+[[nodiscard]] Result<bool> readLspMessage(std::istream &in, std::string &body);
+
+/**
+ * @brief 写出一条消息并立即刷新。
+ *
+ * @param out 输出汇
+ * @param body JSON 正文
+ */
+void writeLspMessage(OutputSink &out, std::string_view body);
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_LSP_TRANSPORT_HPP
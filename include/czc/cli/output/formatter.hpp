@@ -6,7 +6,7 @@
  * @date 2025-11-30
  *
  * @details
- *   定义输出格式化的抽象接口，支持 Text 和 JSON 两种格式。
+ *   定义输出格式化的抽象接口，支持 Text、JSON 与 NDJSON 格式。
  */
 
 #ifndef CZC_CLI_OUTPUT_FORMATTER_HPP
@@ -15,11 +15,13 @@
 #include "czc/common/config.hpp"
 
 #include "czc/cli/context.hpp"
+#include "czc/common/output_sink.hpp"
 #include "czc/lexer/lexer_error.hpp"
 #include "czc/lexer/source_manager.hpp"
 #include "czc/lexer/token.hpp"
 
 #include <memory>
+#include <optional>
 #include <span>
 #include <string>
 
@@ -31,7 +33,13 @@ namespace czc::cli {
  * @details
  *   定义格式化输出的抽象接口，具体实现包括：
  *   - TextFormatter: 人类可读的文本格式
- *   - JsonFormatter: JSON 格式（使用 glaze 库）
+ *   - JsonFormatter: JSON / NDJSON 格式（流式写入，无中间 DOM）
+ *
+ *   格式化器只面向输出汇（OutputSink）写入：输出先进入一块可复用的
+ *   大缓冲区，再以大块 write() 交给文件描述符，内存占用与输出规模无关。
+ *   Token 输出拆分为 begin / range / end 三段，流水线或分块并行渲染
+ *   可以逐段调用；writeTokens() 是一次性写出完整列表的组合。
+ *   formatTokens()/formatErrors() 是返回字符串的便捷包装，供测试和小输出使用。
  */
 class OutputFormatter {
 public:
@@ -46,26 +54,82 @@ public:
   OutputFormatter &operator=(OutputFormatter &&) noexcept = default;
 
   /**
-   * @brief 格式化 Token 列表。
+   * @brief 写入 Token 输出的开头部分。
+   *
+   * @param sink 输出汇
+   * @param count Token 总数；流式场景下事先未知时传 std::nullopt，
+   *              此时总数改由 endTokens() 写在结尾
+   */
+  virtual void beginTokens(OutputSink &sink,
+                           std::optional<std::size_t> count) const = 0;
+
+  /**
+   * @brief 写入一段连续的 Token。
+   *
+   * @param tokens Token 片段
+   * @param sm 源码管理器（用于获取 Token 文本）
+   * @param sink 输出汇
+   * @param firstIndex 片段首个 Token 在整个输出中的序号（用于处理分隔符）
+   */
+  virtual void writeTokenRange(std::span<const lexer::Token> tokens,
+                               const lexer::SourceManager &sm,
+                               OutputSink &sink,
+                               std::size_t firstIndex) const = 0;
+
+  /**
+   * @brief 写入 Token 输出的结尾部分。
+   *
+   * @param sink 输出汇
+   * @param count 若 beginTokens() 未写入总数，则在此传入实际总数
+   */
+  virtual void endTokens(OutputSink &sink,
+                         std::optional<std::size_t> count) const = 0;
+
+  /**
+   * @brief 将 Token 列表写入输出汇。
+   *
+   * @param tokens Token 列表
+   * @param sm 源码管理器（用于获取 Token 文本）
+   * @param sink 输出汇
+   */
+  void writeTokens(std::span<const lexer::Token> tokens,
+                   const lexer::SourceManager &sm, OutputSink &sink) const {
+    beginTokens(sink, tokens.size());
+    writeTokenRange(tokens, sm, sink, 0);
+    endTokens(sink, std::nullopt);
+  }
+
+  /**
+   * @brief 将错误列表写入输出汇。
+   *
+   * @param errors 错误列表
+   * @param sm 源码管理器（用于获取位置信息）
+   * @param sink 输出汇
+   */
+  virtual void writeErrors(std::span<const lexer::LexerError> errors,
+                           const lexer::SourceManager &sm,
+                           OutputSink &sink) const = 0;
+
+  /**
+   * @brief 格式化 Token 列表为字符串。
    *
    * @param tokens Token 列表
    * @param sm 源码管理器（用于获取 Token 文本）
    * @return 格式化后的字符串
    */
-  [[nodiscard]] virtual std::string
-  formatTokens(std::span<const lexer::Token> tokens,
-               const lexer::SourceManager &sm) const = 0;
+  [[nodiscard]] std::string formatTokens(std::span<const lexer::Token> tokens,
+                                         const lexer::SourceManager &sm) const;
 
   /**
-   * @brief 格式化错误列表。
+   * @brief 格式化错误列表为字符串。
    *
    * @param errors 错误列表
    * @param sm 源码管理器（用于获取位置信息）
    * @return 格式化后的字符串
    */
-  [[nodiscard]] virtual std::string
+  [[nodiscard]] std::string
   formatErrors(std::span<const lexer::LexerError> errors,
-               const lexer::SourceManager &sm) const = 0;
+               const lexer::SourceManager &sm) const;
 
 protected:
   OutputFormatter() = default;
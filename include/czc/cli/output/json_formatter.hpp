@@ -6,7 +6,8 @@
  * @date 2025-11-30
  *
  * @details
- *   使用 glaze 库实现 JSON 输出格式。
+ *   流式 JSON 输出：Token 逐个就地转义写入输出汇，
+ *   不构建中间结构体，也不做逐 Token 的堆分配。
  */
 
 #ifndef CZC_CLI_OUTPUT_JSON_FORMATTER_HPP
@@ -18,38 +19,62 @@
 
 namespace czc::cli {
 
+/**
+ * @brief JSON 输出布局。
+ */
+enum class JsonLayout {
+  Document, ///< 单个 JSON 文档：{"success":..,"count":..,"tokens":[...]}
+  Lines,    ///< NDJSON：每行一个 Token（或错误）对象，无外层包装
+};
+
 /**
  * @brief JSON 格式化器。
  *
  * @details
- *   使用 glaze 库将 Token 和错误信息格式化为 JSON 格式。
+ *   输出为紧凑 JSON，字段顺序固定：
+ *   - Token: type, value, line, column, offset, length
+ *   - 错误: code, message, file, line, column
+ *   类型名来自 tokenTypeName() 的静态字符串，值直接从 SourceManager 切片转义。
+ *
+ *   总数事先未知（流水线模式）时，"count" 字段写在 "tokens" 数组之后。
  */
 class JsonFormatter : public OutputFormatter {
 public:
-  JsonFormatter() = default;
-  ~JsonFormatter() override = default;
-
   /**
-   * @brief 格式化 Token 列表为 JSON。
+   * @brief 构造 JSON 格式化器。
    *
-   * @param tokens Token 列表
-   * @param sm 源码管理器
-   * @return 格式化后的 JSON 字符串
+   * @param layout 输出布局
    */
-  [[nodiscard]] std::string
-  formatTokens(std::span<const lexer::Token> tokens,
-               const lexer::SourceManager &sm) const override;
+  explicit JsonFormatter(JsonLayout layout = JsonLayout::Document)
+      : layout_(layout) {}
+  ~JsonFormatter() override = default;
+
+  /// 获取输出布局
+  [[nodiscard]] JsonLayout layout() const noexcept { return layout_; }
+
+  void beginTokens(OutputSink &sink,
+                   std::optional<std::size_t> count) const override;
+
+  void writeTokenRange(std::span<const lexer::Token> tokens,
+                       const lexer::SourceManager &sm, OutputSink &sink,
+                       std::size_t firstIndex) const override;
+
+  void endTokens(OutputSink &sink,
+                 std::optional<std::size_t> count) const override;
 
   /**
-   * @brief 格式化错误列表为 JSON。
+   * @brief 将错误列表以 JSON 流式写入输出汇。
    *
    * @param errors 错误列表
    * @param sm 源码管理器
-   * @return 格式化后的 JSON 字符串
+   * @param sink 输出汇
    */
-  [[nodiscard]] std::string
-  formatErrors(std::span<const lexer::LexerError> errors,
-               const lexer::SourceManager &sm) const override;
+  void writeErrors(std::span<const lexer::LexerError> errors,
+                   const lexer::SourceManager &sm,
+                   OutputSink &sink) const override;
+
+private:
+  JsonLayout layout_;
 };
 
 } // namespace czc::cli
@@ -0,0 +1,80 @@
+/**
+ * @file parallel_writer.hpp
+ * @brief 分块并行渲染的 Token 输出器。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   Token 格式化彼此独立，天然可并行：
+ *   - 把 Token 列表切分为固定大小的区间（块）
+ *   - 每个窗口的块经 TaskScheduler::parallelFor() 渲染进独立缓冲区
+ *   - 调用线程按块序号顺序用 writev() 批量写出整个窗口
+ *
+ *   缓冲区按窗口复用，内存占用有上界；渲染使用 Driver 持有的调度器，
+ *   不另建线程。
+ *   JSON 分隔符由 writeTokenRange() 的 firstIndex 决定，块边界无需特殊处理。
+ */
+
+#ifndef CZC_CLI_OUTPUT_PARALLEL_WRITER_HPP
+#define CZC_CLI_OUTPUT_PARALLEL_WRITER_HPP
+
+#include "czc/common/config.hpp"
+
+#include "czc/cli/output/formatter.hpp"
+#include "czc/common/task_scheduler.hpp"
+
+#include <cstddef>
+
+namespace czc::cli {
+
+/**
+ * @brief 并行渲染配置。
+ */
+struct ParallelWriteOptions {
+  std::size_t chunkTokens{16384}; ///< 每块包含的 Token 数
+  std::size_t slotsPerJob{4};     ///< 每个并行度对应的缓冲区数（窗口大小）
+};
+
+/**
+ * @brief 分块并行渲染的 Token 输出器。
+ */
+class ParallelTokenWriter {
+public:
+  /**
+   * @brief 构造输出器。
+   *
+   * @param scheduler 执行渲染的调度器（须比输出器存活更久）
+   * @param options 并行渲染配置
+   */
+  explicit ParallelTokenWriter(TaskScheduler &scheduler,
+                               ParallelWriteOptions options = {}) noexcept
+      : scheduler_(scheduler), options_(options) {}
+
+  /**
+   * @brief 并行渲染并按顺序写出 Token 列表。
+   *
+   * @details
+   *   输出与 OutputFormatter::writeTokens() 逐字节相同。
+   *   Token 数不足两块或调度器为单线程时直接退化为顺序写出。
+   *
+   * @param formatter 格式化器（须可被多线程同时调用的 const 方法）
+   * @param tokens Token 列表
+   * @param sm 源码管理器（只读共享）
+   * @param sink 输出汇（仅由调用线程访问）
+   */
+  void write(const OutputFormatter &formatter,
+             std::span<const lexer::Token> tokens,
+             const lexer::SourceManager &sm, OutputSink &sink) const;
+
+  /// 获取渲染的并行度（调度器的总并行度）
+  [[nodiscard]] std::size_t effectiveJobs() const noexcept;
+
+private:
+  TaskScheduler &scheduler_;
+  ParallelWriteOptions options_;
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_OUTPUT_PARALLEL_WRITER_HPP
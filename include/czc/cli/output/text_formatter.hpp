@@ -23,33 +23,33 @@ namespace czc::cli {
  *
  * @details
  *   将 Token 和错误信息格式化为人类可读的文本格式。
+ *   总数事先未知（流水线模式）时，"Total tokens" 行写在末尾。
  */
 class TextFormatter : public OutputFormatter {
 public:
   TextFormatter() = default;
   ~TextFormatter() override = default;
 
-  /**
-   * @brief 格式化 Token 列表为文本。
-   *
-   * @param tokens Token 列表
-   * @param sm 源码管理器
-   * @return 格式化后的文本
-   */
-  [[nodiscard]] std::string
-  formatTokens(std::span<const lexer::Token> tokens,
-               const lexer::SourceManager &sm) const override;
+  void beginTokens(OutputSink &sink,
+                   std::optional<std::size_t> count) const override;
+
+  void writeTokenRange(std::span<const lexer::Token> tokens,
+                       const lexer::SourceManager &sm, OutputSink &sink,
+                       std::size_t firstIndex) const override;
+
+  void endTokens(OutputSink &sink,
+                 std::optional<std::size_t> count) const override;
 
   /**
-   * @brief 格式化错误列表为文本。
+   * @brief 将错误列表以文本格式写入输出汇。
    *
    * @param errors 错误列表
    * @param sm 源码管理器
-   * @return 格式化后的文本
+   * @param sink 输出汇
    */
-  [[nodiscard]] std::string
-  formatErrors(std::span<const lexer::LexerError> errors,
-               const lexer::SourceManager &sm) const override;
+  void writeErrors(std::span<const lexer::LexerError> errors,
+                   const lexer::SourceManager &sm,
+                   OutputSink &sink) const override;
 };
 
 } // namespace czc::cli
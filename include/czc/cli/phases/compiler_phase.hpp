@@ -0,0 +1,81 @@
+/**
+ * @file compiler_phase.hpp
+ * @brief 编译阶段概念定义。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   编译阶段在编译期声明输入与输出类型，阶段之间按引用或移动传递结果，
+ *   不经过类型擦除。多个阶段通过 PhasePipeline 组合。
+ */
+
+#ifndef CZC_CLI_PHASES_COMPILER_PHASE_HPP
+#define CZC_CLI_PHASES_COMPILER_PHASE_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/common/result.hpp"
+
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+namespace czc::cli {
+
+/**
+ * @brief 编译阶段概念。
+ *
+ * @details
+ *   所有阶段必须满足此概念，提供：
+ *   - Input / Output: 输入与输出类型
+ *   - run(): 消费一个输入（右值，可移动或按 const 引用接收），
+ *     返回输出或错误
+ *
+ *   使用示例：
+ *   @code
+ *   struct TokenCountPhase {
+ *     using Input = LexResult;
+ *     using Output = std::size_t;
+ *     Result<std::size_t> run(const LexResult &lexed) {
+ *       return ok(lexed.tokens.size());
+ *     }
+ *   };
+ *   static_assert(CompilerPhase<TokenCountPhase>);
+ *   @endcode
+ *
+ * @tparam P 阶段类型
+ */
+template <typename P>
+concept CompilerPhase =
+    requires {
+      typename P::Input;
+      typename P::Output;
+    } && requires(P &phase, typename P::Input &&input) {
+      {
+        phase.run(std::move(input))
+      } -> std::same_as<Result<typename P::Output>>;
+    };
+
+/// 阶段的输入类型
+template <CompilerPhase P> using PhaseInput = typename P::Input;
+
+/// 阶段的输出类型
+template <CompilerPhase P> using PhaseOutput = typename P::Output;
+
+/**
+ * @brief 检查相邻阶段的输出与输入类型是否一致。
+ *
+ * @tparam Phases 按执行顺序排列的阶段
+ */
+template <typename... Phases>
+struct PhasesChain : std::true_type {};
+
+template <typename First, typename Second, typename... Rest>
+struct PhasesChain<First, Second, Rest...>
+    : std::bool_constant<std::is_same_v<typename First::Output,
+                                        typename Second::Input> &&
+                         PhasesChain<Second, Rest...>::value> {};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_PHASES_COMPILER_PHASE_HPP
@@ -6,13 +6,15 @@
  * @date 2025-11-30
  *
  * @details
- *   LexerPhase 是词法分析的核心执行单元，实现 CompilerPhase 接口。
+ *   LexerPhase 是词法分析的核心执行单元，满足 CompilerPhase 概念
+ *   （输入为源文件路径，输出为 LexResult），可作为 PhasePipeline 的首个阶段。
  */
 
 #ifndef CZC_CLI_PHASES_LEXER_PHASE_HPP
 #define CZC_CLI_PHASES_LEXER_PHASE_HPP
 
 #include "czc/cli/context.hpp"
+#include "czc/cli/phases/compiler_phase.hpp"
 #include "czc/common/config.hpp"
 #include "czc/common/result.hpp"
 #include "czc/lexer/lexer.hpp"
@@ -31,6 +33,7 @@ namespace czc::cli {
 struct LexResult {
   std::vector<lexer::Token> tokens; ///< Token 列表
   bool hasErrors{false};            ///< 是否有错误
+  lexer::BufferID bufferId;         ///< 源码缓冲区（供后续阶段取文本）
 };
 
 /**
@@ -57,6 +60,9 @@ struct LexResult {
  */
 class LexerPhase {
 public:
+  using Input = std::filesystem::path; ///< 阶段输入：源文件路径
+  using Output = LexResult;            ///< 阶段输出：词法分析结果
+
   /**
    * @brief 构造函数。
    *
@@ -83,6 +89,46 @@ public:
   [[nodiscard]] Result<LexResult>
   runOnFile(const std::filesystem::path &filepath);
 
+  /**
+   * @brief 阶段入口，等同于 runOnFile()。
+   *
+   * @param filepath 源文件路径
+   * @return 词法分析结果，失败时返回错误
+   */
+  [[nodiscard]] Result<LexResult> run(const std::filesystem::path &filepath) {
+    return runOnFile(filepath);
+  }
+
+  /**
+   * @brief 读取源文件内容（检查存在性与大小上限）。
+   *
+   * @param filepath 源文件路径
+   * @return 文件内容，失败时返回错误（"E001"/"E002"/"E003"）
+   */
+  [[nodiscard]] static Result<std::string>
+  readFile(const std::filesystem::path &filepath);
+
+  /**
+   * @brief 读取源文件并加入共享的 SourceManager，不执行词法分析。
+   *
+   * @details
+   *   供流式/流水线模式使用：调用方自行驱动 Lexer，
+   *   结束后通过 reportErrors() 报告错误。
+   *
+   * @param filepath 源文件路径
+   * @return 新缓冲区的 BufferID，失败时返回错误
+   */
+  [[nodiscard]] Result<lexer::BufferID>
+  loadFile(const std::filesystem::path &filepath);
+
+  /**
+   * @brief 将 Lexer 收集的错误发射到诊断系统。
+   *
+   * @param lex 已完成扫描的 Lexer
+   * @param bufferId 源码缓冲区 ID
+   */
+  void reportErrors(const lexer::Lexer &lex, lexer::BufferID bufferId);
+
   /**
    * @brief 对源码字符串执行词法分析。
    *
@@ -94,21 +140,26 @@ public:
   runOnSource(std::string_view source, std::string_view filename = "<stdin>");
 
   /**
-   * @brief 获取输入数据类型标识。
+   * @brief 将源码字符串加入共享的 SourceManager，不执行词法分析。
    *
-   * @return "source"
+   * @param source 源码内容
+   * @param filename 虚拟文件名
+   * @return 新缓冲区的 BufferID，源码过大时返回错误
    */
-  [[nodiscard]] static constexpr std::string_view inputType() noexcept {
-    return "source";
-  }
+  [[nodiscard]] Result<lexer::BufferID>
+  loadSource(std::string_view source, std::string_view filename);
 
   /**
-   * @brief 获取输出数据类型标识。
+   * @brief 对已加入 SourceManager 的缓冲区执行词法分析。
+   *
+   * @details
+   *   常驻进程可复用未变化文件的缓冲区，跳过重新读取。
    *
-   * @return "tokens"
+   * @param bufferId 源码缓冲区 ID
+   * @return 词法分析结果
    */
-  [[nodiscard]] static constexpr std::string_view outputType() noexcept {
-    return "tokens";
+  [[nodiscard]] LexResult runOnBuffer(lexer::BufferID bufferId) {
+    return runLexer(bufferId);
   }
 
   /**
@@ -116,10 +167,10 @@ public:
    *
    * @return SourceManager 引用
    *
-   * @note 用于获取 Token 的文本内容
+   * @note 即 CompilerContext::sourceManager()，用于获取 Token 的文本内容
    */
   [[nodiscard]] lexer::SourceManager &sourceManager() noexcept {
-    return sourceManager_;
+    return ctx_.sourceManager();
   }
 
   /**
@@ -128,12 +179,11 @@ public:
    * @return SourceManager 常量引用
    */
   [[nodiscard]] const lexer::SourceManager &sourceManager() const noexcept {
-    return sourceManager_;
+    return ctx_.sourceManager();
   }
 
 private:
   CompilerContext &ctx_;
-  lexer::SourceManager sourceManager_;
 
   /**
    * @brief 执行词法分析的内部实现。
@@ -144,6 +194,8 @@ private:
   [[nodiscard]] LexResult runLexer(lexer::BufferID bufferId);
 };
 
+static_assert(CompilerPhase<LexerPhase>);
+
 } // namespace czc::cli
 
 #endif // CZC_CLI_PHASES_LEXER_PHASE_HPP
@@ -0,0 +1,229 @@
+/**
+ * @file phase_pipeline.hpp
+ * @brief 编译期组合的静态类型阶段流水线。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   PhasePipeline 把若干满足 CompilerPhase 的阶段串联为一个阶段：
+ *   - 相邻阶段的类型在编译期检查，结果直接移动给下一阶段
+ *   - run() 对单个输入依次执行全部阶段，任一阶段失败即返回错误
+ *   - runEach() 对多个输入按文件流水：每个阶段是调度器上的一个任务，
+ *     第 N 个文件进入下一阶段时第 N+1 个文件已开始上一阶段
+ *
+ *   流水模式下不同阶段并发执行，但每个阶段自身只在一个线程上
+ *   按输入顺序调用。阶段之间共享的可变状态（如同一个 CompilerContext）
+ *   须自行同步，或在各阶段使用独立的上下文。
+ *   阶段抛出的异常在调用线程上重新抛出，与逐个执行时一致。
+ */
+
+#ifndef CZC_CLI_PHASES_PHASE_PIPELINE_HPP
+#define CZC_CLI_PHASES_PHASE_PIPELINE_HPP
+
+#include "czc/cli/phases/compiler_phase.hpp"
+#include "czc/common/config.hpp"
+#include "czc/common/result.hpp"
+#include "czc/common/spsc_queue.hpp"
+#include "czc/common/task_scheduler.hpp"
+
+#include <cstddef>
+#include <latch>
+#include <memory>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace czc::cli {
+
+/**
+ * @brief 流水执行配置。
+ */
+struct PhasePipelineOptions {
+  bool pipelined{true};      ///< 是否按文件跨阶段并发（false 时逐个执行）
+  std::size_t queueDepth{4}; ///< 阶段间队列容量（文件数）
+};
+
+/**
+ * @brief 静态类型阶段流水线。
+ *
+ * @details
+ *   流水线只持有各阶段的引用，本身也满足 CompilerPhase，可以继续组合。
+ *
+ *   使用示例：
+ *   @code
+ *   LexerPhase lex(ctx);
+ *   TokenCountPhase count;
+ *   PhasePipeline pipeline(lex, count);
+ *
+ *   std::vector<std::filesystem::path> files = ...;
+ *   pipeline.runEach(std::span(files), driver.scheduler(),
+ *                    [&](std::size_t i, Result<std::size_t> &&tokens) {
+ *                      // 按输入顺序在调用线程上交付
+ *                    });
+ *   @endcode
+ *
+ * @tparam Phases 按执行顺序排列的阶段
+ */
+template <CompilerPhase... Phases> class PhasePipeline {
+  static_assert(sizeof...(Phases) > 0,
+                "PhasePipeline requires at least one phase");
+  static_assert(PhasesChain<Phases...>::value,
+                "Each phase's Output must match the next phase's Input");
+
+  static constexpr std::size_t kStages = sizeof...(Phases);
+
+  template <std::size_t K>
+  using StagePhase = std::tuple_element_t<K, std::tuple<Phases...>>;
+
+  template <std::size_t K> using StageOutput = PhaseOutput<StagePhase<K>>;
+
+  /// 阶段间传递的元素（optional 使队列槽位可默认构造）
+  template <std::size_t K>
+  using StageSlot = std::optional<Result<StageOutput<K>>>;
+
+public:
+  using Input = PhaseInput<StagePhase<0>>;
+  using Output = StageOutput<kStages - 1>;
+
+  /**
+   * @brief 构造流水线。
+   *
+   * @param phases 各阶段（须比流水线存活更久）
+   */
+  explicit PhasePipeline(Phases &...phases) noexcept : phases_(phases...) {}
+
+  /**
+   * @brief 对单个输入依次执行全部阶段。
+   *
+   * @param input 输入
+   * @return 最后一个阶段的输出，或第一个失败阶段的错误
+   */
+  [[nodiscard]] Result<Output> run(Input input) {
+    return runFrom<0>(std::move(input));
+  }
+
+  /**
+   * @brief 对多个输入执行流水线，结果按输入顺序交付。
+   *
+   * @details
+   *   流水模式下每个阶段作为调度器任务运行，执行期间占用一个工作线程；
+   *   阶段之间通过有界队列传递结果，队列满时上游阻塞（背压）。
+   *   调度器的工作线程少于阶段数时（含确定性模式）逐个执行。
+   *   失败的输入不再进入后续阶段，其错误直接交付给 consume。
+   *
+   * @param inputs 输入（逐个移动给第一个阶段）
+   * @param scheduler 执行各阶段的调度器
+   * @param consume 结果消费者 `void(std::size_t index, Result<Output>&&)`，
+   *                在调用线程上按输入顺序调用
+   * @param options 执行配置
+   * @throws 阶段或 consume 抛出的第一个异常
+   * @note 调用线程阻塞在结果队列上，不参与执行阶段，
+   *       因此应在调度器的工作线程之外调用。
+   */
+  template <typename Consumer>
+  void runEach(std::span<Input> inputs, TaskScheduler &scheduler,
+               Consumer &&consume, PhasePipelineOptions options = {}) {
+    if (!options.pipelined || kStages == 1 || inputs.size() <= 1 ||
+        scheduler.concurrency() - 1 < kStages) {
+      for (std::size_t i = 0; i < inputs.size(); ++i) {
+        consume(i, runFrom<0>(std::move(inputs[i])));
+      }
+      return;
+    }
+    runStaged(inputs, scheduler, consume, options.queueDepth,
+              std::make_index_sequence<kStages>{});
+  }
+
+private:
+  template <std::size_t K, typename T> auto invoke(T &&value) {
+    return std::get<K>(phases_).run(std::forward<T>(value));
+  }
+
+  template <std::size_t K, typename T> Result<Output> runFrom(T &&value) {
+    auto result = invoke<K>(std::forward<T>(value));
+    if constexpr (K + 1 == kStages) {
+      return result;
+    } else {
+      if (!result.has_value()) {
+        return std::unexpected(std::move(result.error()));
+      }
+      return runFrom<K + 1>(std::move(*result));
+    }
+  }
+
+  template <typename Consumer, std::size_t... Ks>
+  void runStaged(std::span<Input> inputs, TaskScheduler &scheduler,
+                 Consumer &consume, std::size_t queueDepth,
+                 std::index_sequence<Ks...>) {
+    // 第 K 个队列承载第 K 个阶段的输出，最后一个队列由调用线程消费
+    std::tuple<std::unique_ptr<SpscQueue<StageSlot<Ks>>>...> queues{
+        std::make_unique<SpscQueue<StageSlot<Ks>>>(queueDepth)...};
+    auto closeAll = [&] { (std::get<Ks>(queues)->close(), ...); };
+
+    // 全部阶段开始运行后才执行阶段代码：阶段内部的 fork-join 在等待时
+    // 可能执行待处理任务，不能在阻塞的阶段之下执行尚未开始的阶段
+    std::latch started(kStages);
+
+    // 组在队列之后构造、之前析构，异常退出时也会等待全部阶段结束
+    TaskGroup stages(scheduler);
+    (stages.spawn([this, &queues, &started, &closeAll, inputs] {
+       started.arrive_and_wait();
+       try {
+         runStage<Ks>(queues, inputs);
+       } catch (...) {
+         // 关闭全部队列让其余阶段退出，异常由 wait() 在调用线程重新抛出
+         closeAll();
+         throw;
+       }
+     }),
+     ...);
+
+    auto &results = *std::get<kStages - 1>(queues);
+    std::size_t index = 0;
+    try {
+      while (auto slot = results.pop()) {
+        consume(index++, std::move(**slot));
+      }
+    } catch (...) {
+      closeAll();
+      throw;
+    }
+    stages.wait();
+  }
+
+  template <std::size_t K, typename Queues>
+  void runStage(Queues &queues, std::span<Input> inputs) {
+    auto &out = *std::get<K>(queues);
+    if constexpr (K == 0) {
+      for (auto &input : inputs) {
+        if (!out.push(StageSlot<0>(invoke<0>(std::move(input))))) {
+          break;
+        }
+      }
+    } else {
+      auto &in = *std::get<K - 1>(queues);
+      while (auto slot = in.pop()) {
+        auto &prev = **slot;
+        StageSlot<K> next;
+        if (prev.has_value()) {
+          next.emplace(invoke<K>(std::move(*prev)));
+        } else {
+          next.emplace(std::unexpected(std::move(prev.error())));
+        }
+        if (!out.push(std::move(next))) {
+          break;
+        }
+      }
+    }
+    out.close();
+  }
+
+  std::tuple<Phases &...> phases_;
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_PHASES_PHASE_PIPELINE_HPP
@@ -0,0 +1,112 @@
+/**
+ * @file token_pipeline.hpp
+ * @brief 词法分析 → 格式化 → 写出 三段式流水线。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   流水线把一次 Token 输出拆成三个并发阶段：
+ *   - 调用线程运行 Lexer，每凑满一个 Token 块就送入有界队列
+ *   - 格式化阶段把 Token 块渲染为固定大小的输出块
+ *   - 写出阶段把输出块直接写入目标输出汇
+ *
+ *   格式化与写出阶段是 Driver 调度器上的任务，各占一个工作线程；
+ *   工作线程不足两个时三个阶段在调用线程上顺序执行，输出不变。
+ *
+ *   阶段之间使用有界 SPSC 队列连接，队列满时上游阻塞（背压），
+ *   Token 块与输出块在阶段间循环复用，因此内存占用与输入规模无关。
+ *   端到端耗时约等于最慢阶段的耗时。
+ *
+ *   由于 Token 总数在扫描结束前未知，输出中的总数写在结尾
+ *   （参见 OutputFormatter::beginTokens/endTokens）。
+ */
+
+#ifndef CZC_CLI_PIPELINE_TOKEN_PIPELINE_HPP
+#define CZC_CLI_PIPELINE_TOKEN_PIPELINE_HPP
+
+#include "czc/common/config.hpp"
+
+#include "czc/cli/output/formatter.hpp"
+#include "czc/common/output_sink.hpp"
+#include "czc/common/task_scheduler.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/lexer/source_manager.hpp"
+
+#include <cstddef>
+
+namespace czc::cli {
+
+/**
+ * @brief 流水线配置。
+ */
+struct PipelineOptions {
+  std::size_t blockSize{4096}; ///< 每个 Token 块包含的 Token 数
+  std::size_t queueDepth{8};   ///< 每个阶段间队列的容量（块数）
+  std::size_t chunkSize{OutputSink::kDefaultCapacity}; ///< 输出块大小（字节）
+};
+
+/**
+ * @brief 流水线运行统计。
+ */
+struct PipelineStats {
+  std::size_t tokenCount{0}; ///< Token 总数（含 EOF）
+  std::size_t blockCount{0}; ///< Token 块数
+  std::size_t chunkCount{0}; ///< 输出块数
+};
+
+/**
+ * @brief Token 输出流水线。
+ */
+class TokenPipeline {
+public:
+  /**
+   * @brief 构造流水线。
+   *
+   * @param options 流水线配置
+   */
+  explicit TokenPipeline(PipelineOptions options = {}) noexcept
+      : options_(options) {}
+
+  /**
+   * @brief 运行流水线直到 Lexer 到达 EOF 且输出全部写出。
+   *
+   * @details
+   *   调用线程充当词法分析阶段。返回前所有阶段均已结束，
+   *   但不会 flush 输出汇，也不会报告 Lexer 错误。
+   *   阶段抛出的异常在调用线程上重新抛出。
+   *
+   * @param lex 待驱动的 Lexer
+   * @param preserveTrivia 是否保留 Trivia
+   * @param formatter 格式化器
+   * @param sm 源码管理器（格式化阶段只读访问）
+   * @param out 最终输出汇（仅由写出阶段访问）
+   * @param scheduler 运行格式化与写出阶段的调度器
+   * @return 运行统计（顺序执行时 chunkCount 为 0）
+   */
+  PipelineStats run(lexer::Lexer &lex, bool preserveTrivia,
+                    const OutputFormatter &formatter,
+                    const lexer::SourceManager &sm, OutputSink &out,
+                    TaskScheduler &scheduler) const;
+
+  /// 获取配置
+  [[nodiscard]] const PipelineOptions &options() const noexcept {
+    return options_;
+  }
+
+private:
+  /// 调用线程之外的阶段数（格式化、写出）
+  static constexpr std::size_t kStages = 2;
+
+  /// 工作线程不足时在调用线程上逐块扫描并直接写入 out
+  PipelineStats runSequential(lexer::Lexer &lex, bool preserveTrivia,
+                              const OutputFormatter &formatter,
+                              const lexer::SourceManager &sm,
+                              OutputSink &out) const;
+
+  PipelineOptions options_;
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_PIPELINE_TOKEN_PIPELINE_HPP
@@ -0,0 +1,325 @@
+/**
+ * @file query_database.hpp
+ * @brief 基于查询的增量计算引擎。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   编译过程被拆成带缓存的查询：
+ *   - 输入：源文件内容，以 SourceManager 内容哈希为指纹
+ *   - 派生查询：tokens(file)、deps(file)（之后的 ast(file) 同理）
+ *
+ *   每个查询记录执行期间读取的其他查询（依赖），以及两个修订号：
+ *   - changedAt：结果最近一次变化的修订
+ *   - verifiedAt：最近一次确认结果仍然有效的修订
+ *
+ *   输入变化时修订号加一。再次请求某个查询时，先逐个确认其依赖，
+ *   依赖都未在 verifiedAt 之后变化则直接复用；否则重新执行，
+ *   若新结果的指纹与旧结果相同则保留 changedAt（提前截止），
+ *   依赖它的查询因此不必重新执行。
+ *
+ *   查询结果的指纹与依赖关系可以保存到磁盘，下次运行时
+ *   内容未变的文件无需重新执行即可得到 deps(file)。
+ */
+
+#ifndef CZC_CLI_QUERY_QUERY_DATABASE_HPP
+#define CZC_CLI_QUERY_QUERY_DATABASE_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/common/result.hpp"
+#include "czc/common/task_scheduler.hpp"
+#include "czc/lexer/lexer_error.hpp"
+#include "czc/lexer/source_manager.hpp"
+#include "czc/lexer/token.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace czc::cli {
+
+/// 修订号，每次输入变化加一
+using Revision = std::uint64_t;
+
+/// 查询结果指纹
+using Fingerprint = std::uint64_t;
+
+/**
+ * @brief 查询种类。
+ */
+enum class QueryKind : std::uint8_t {
+  Source,       ///< 输入：文件内容
+  Tokens,       ///< Token 序列（不含 trivia）
+  TriviaTokens, ///< Token 序列（含 trivia）
+  Deps,         ///< 文件依赖（import 目标）
+};
+
+/// 查询种类数
+inline constexpr std::size_t kQueryKinds = 4;
+
+/**
+ * @brief tokens(file) 的结果。
+ */
+struct FileTokens {
+  lexer::BufferID buffer;                ///< 源码缓冲区
+  std::vector<lexer::Token> tokens;      ///< Token 列表
+  std::vector<lexer::LexerError> errors; ///< 词法错误
+
+  /// 是否有词法错误
+  [[nodiscard]] bool hasErrors() const noexcept { return !errors.empty(); }
+};
+
+/**
+ * @brief deps(file) 的结果。
+ */
+struct FileDeps {
+  /// import 目标，按出现顺序（字符串字面量取其内容，其余取 Token 原文）
+  std::vector<std::string> imports;
+};
+
+/**
+ * @brief 查询执行统计（自上次 resetStats() 起）。
+ */
+struct QueryStats {
+  std::size_t executed{0}; ///< 实际执行的派生查询数
+  std::size_t reused{0};   ///< 依赖未变化、直接复用的派生查询数
+  std::size_t cutoff{0};   ///< 重新执行但指纹不变（提前截止）的查询数
+};
+
+/**
+ * @brief 查询数据库。
+ *
+ * @details
+ *   使用示例：
+ *   @code
+ *   QueryDatabase db(ctx.sourceManager());
+ *   (void)db.load(".czc-cache");
+ *   for (const auto &file : files) {
+ *     (void)db.loadFile(file);    // 内容未变时不产生新修订
+ *   }
+ *   db.prefetch(files, scheduler); // 并行计算
+ *   auto deps = db.deps(files[0]);
+ *   (void)db.save(".czc-cache");
+ *   @endcode
+ *
+ *   线程安全：查询可在多个线程上并发执行（每个查询单独加锁，
+ *   同一查询只会执行一次）；设置输入、load() 与查询须串行。
+ */
+class QueryDatabase {
+public:
+  /// 持久化格式版本
+  static constexpr std::int64_t kFormatVersion = 1;
+
+  /**
+   * @brief 构造函数。
+   *
+   * @param sm 存放输入内容的 SourceManager（须比数据库存活更久）
+   */
+  explicit QueryDatabase(lexer::SourceManager &sm);
+
+  ~QueryDatabase();
+
+  // 不可拷贝，不可移动（查询之间以指针相互引用）
+  QueryDatabase(const QueryDatabase &) = delete;
+  QueryDatabase &operator=(const QueryDatabase &) = delete;
+  QueryDatabase(QueryDatabase &&) = delete;
+  QueryDatabase &operator=(QueryDatabase &&) = delete;
+
+  // ========== 输入 ==========
+
+  /**
+   * @brief 读取文件并设为输入。
+   *
+   * @param path 文件路径
+   * @return 内容与已知内容（含缓存）不同返回 true，读取失败返回错误
+   */
+  [[nodiscard]] Result<bool> loadFile(const std::filesystem::path &path);
+
+  /**
+   * @brief 以给定内容设为输入。
+   *
+   * @details
+   *   内容哈希与当前输入相同时不加入新缓冲区，也不产生新修订。
+   *
+   * @param path 文件路径（作为查询键）
+   * @param content 文件内容
+   * @return 内容与已知内容（含缓存）不同返回 true
+   */
+  bool setFileContents(const std::filesystem::path &path, std::string content);
+
+  /**
+   * @brief 移除输入，之后对该文件的查询返回错误。
+   *
+   * @param path 文件路径
+   */
+  void removeFile(const std::filesystem::path &path);
+
+  /**
+   * @brief 改用新的 SourceManager，旧的随后可以释放。
+   *
+   * @details
+   *   每次内容变化都会加入新缓冲区，长期运行时由调用者定期换用
+   *   新的 SourceManager 以丢弃旧版本的内容。只复制当前输入的内容；
+   *   查询的指纹与修订号保持不变，Token 序列在下次请求时重新计算。
+   *   之前返回的 FileTokens 仍引用旧的 SourceManager。
+   *
+   * @param sm 新的 SourceManager（须比数据库存活更久）
+   */
+  void rebind(lexer::SourceManager &sm);
+
+  // ========== 查询 ==========
+
+  /**
+   * @brief 查询文件的 Token 序列。
+   *
+   * @param path 文件路径
+   * @param preserveTrivia 是否保留 trivia
+   * @return Token 序列，文件未加载时返回错误（"E001"）
+   */
+  [[nodiscard]] Result<std::shared_ptr<const FileTokens>>
+  tokens(const std::filesystem::path &path, bool preserveTrivia = false);
+
+  /**
+   * @brief 查询文件的依赖。
+   *
+   * @param path 文件路径
+   * @return import 目标，文件未加载时返回错误（"E001"）
+   */
+  [[nodiscard]] Result<std::shared_ptr<const FileDeps>>
+  deps(const std::filesystem::path &path);
+
+  /**
+   * @brief 并行计算多个文件的同一种查询（及其依赖的查询）。
+   *
+   * @details
+   *   错误不在此处报告，之后单独查询时返回。
+   *
+   * @param paths 文件路径
+   * @param scheduler 执行查询的调度器
+   * @param kind 查询种类（不能是输入 QueryKind::Source）
+   */
+  void prefetch(std::span<const std::filesystem::path> paths,
+                TaskScheduler &scheduler, QueryKind kind = QueryKind::Deps);
+
+  // ========== 持久化 ==========
+
+  /**
+   * @brief 保存查询指纹、依赖关系与可序列化的结果。
+   *
+   * @details
+   *   先写入临时文件再重命名，中断时不会留下不完整的缓存。
+   *   Token 序列只保存指纹，需要时重新计算。
+   *
+   * @param file 缓存文件路径
+   * @return 写入失败时返回错误（"E003"）
+   */
+  [[nodiscard]] VoidResult save(const std::filesystem::path &file) const;
+
+  /**
+   * @brief 从缓存文件恢复查询。
+   *
+   * @details
+   *   须在设置任何输入之前调用。恢复的输入仍需通过 loadFile() 等重新设置，
+   *   内容哈希与缓存一致时其派生查询可直接复用。
+   *   缓存不存在时什么也不做。
+   *
+   * @param file 缓存文件路径
+   * @return 格式错误或版本不符时返回错误（"E009"）
+   */
+  [[nodiscard]] VoidResult load(const std::filesystem::path &file);
+
+  // ========== 状态 ==========
+
+  /// 当前修订号
+  [[nodiscard]] Revision revision() const noexcept {
+    return revision_.load(std::memory_order_acquire);
+  }
+
+  /// 执行统计
+  [[nodiscard]] QueryStats stats() const noexcept;
+
+  /// 清零执行统计
+  void resetStats() noexcept;
+
+private:
+  /**
+   * @brief 文件输入。
+   */
+  struct SourceInput {
+    lexer::BufferID buffer; ///< 内容所在的缓冲区
+  };
+
+  /// 查询结果（monostate 表示尚无值：未设置的输入或只有指纹的缓存）
+  using SlotValue = std::variant<std::monostate, SourceInput,
+                                 std::shared_ptr<const FileTokens>,
+                                 std::shared_ptr<const FileDeps>>;
+
+  /**
+   * @brief 单个查询的缓存。
+   */
+  struct Slot {
+    QueryKind kind;
+    std::string file;
+
+    std::mutex mutex;           ///< 确认与执行互斥
+    bool memoized{false};       ///< 是否有指纹（结果可能尚未计算）
+    Fingerprint fingerprint{0}; ///< 结果指纹
+    Revision changedAt{0};      ///< 结果最近一次变化的修订
+    Revision verifiedAt{0};     ///< 最近一次确认有效的修订
+    std::vector<Slot *> deps;   ///< 上次执行时读取的查询
+    SlotValue value;            ///< 结果
+  };
+
+  /// 规范化查询键
+  [[nodiscard]] static std::string keyOf(const std::filesystem::path &path);
+
+  /// 查找或创建查询
+  [[nodiscard]] Slot &slot(QueryKind kind, const std::string &file);
+
+  /**
+   * @brief 确保查询在当前修订有效。
+   *
+   * @param slot 查询
+   * @param out 非空时写入结果（须有值，必要时执行查询）
+   * @return 查询的 changedAt，输入缺失或执行失败时返回错误
+   */
+  [[nodiscard]] Result<Revision> refresh(Slot &slot, SlotValue *out);
+
+  /// 在查询锁内执行查询并更新缓存
+  [[nodiscard]] VoidResult execute(Slot &slot, Revision now);
+
+  /// 读取另一个查询的结果，并记录到执行中查询的依赖列表
+  [[nodiscard]] Result<SlotValue> fetch(QueryKind kind, const std::string &file,
+                                        std::vector<Slot *> &deps);
+
+  /// 各查询的计算函数：写入结果、记录依赖并返回指纹
+  [[nodiscard]] Result<Fingerprint>
+  computeTokens(const Slot &slot, SlotValue &value, std::vector<Slot *> &deps);
+  [[nodiscard]] Result<Fingerprint>
+  computeDeps(const Slot &slot, SlotValue &value, std::vector<Slot *> &deps);
+
+  lexer::SourceManager *sm_;
+  mutable std::mutex slotsMutex_; ///< 保护各查询表的结构
+  std::array<std::unordered_map<std::string, std::unique_ptr<Slot>>,
+             kQueryKinds>
+      slots_;
+  std::atomic<Revision> revision_{1};
+
+  std::atomic<std::size_t> executed_{0};
+  std::atomic<std::size_t> reused_{0};
+  std::atomic<std::size_t> cutoff_{0};
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_QUERY_QUERY_DATABASE_HPP
@@ -0,0 +1,134 @@
+/**
+ * @file file_watcher.hpp
+ * @brief 源文件变化监视（inotify）。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   FileWatcher 监视目录中文件内容的变化，并把一阵连续的事件
+ *   （编辑器保存时常见的写临时文件、重命名、再修改属性）合并为一批：
+ *   - 文件写入完成（关闭写句柄）或移入目录视为变化
+ *   - 文件删除或移出目录视为移除
+ *   - 递归监视时，新建的子目录自动加入监视
+ *   - 内核事件队列溢出时，把全部已监视目录中的文件视为变化
+ *
+ *   仅 Linux 可用，其余平台 create() 返回错误。
+ */
+
+#ifndef CZC_CLI_WATCH_FILE_WATCHER_HPP
+#define CZC_CLI_WATCH_FILE_WATCHER_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/common/result.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace czc::cli {
+
+/**
+ * @brief 文件事件种类。
+ */
+enum class FileEventKind : std::uint8_t {
+  Changed, ///< 文件内容可能变化（新建、写入或移入）
+  Removed, ///< 文件或目录被删除或移出
+};
+
+/**
+ * @brief 合并后的文件事件。
+ */
+struct FileEvent {
+  std::filesystem::path path; ///< 文件路径（以监视目录为前缀）
+  FileEventKind kind;         ///< 事件种类
+};
+
+/// 子目录过滤：返回 false 的子目录不加入监视
+using DirectoryFilter = std::function<bool(const std::filesystem::path &)>;
+
+/**
+ * @brief 源文件变化监视器。
+ *
+ * @details
+ *   使用示例：
+ *   @code
+ *   auto watcher = FileWatcher::create();
+ *   (void)(*watcher)->addDirectory("src");
+ *   while (true) {
+ *     auto events = (*watcher)->next(std::chrono::milliseconds(50));
+ *     if (!events.has_value() || (*watcher)->interrupted()) {
+ *       break;
+ *     }
+ *     for (const auto &event : *events) {
+ *       // 按路径排序，同一路径只出现一次
+ *     }
+ *   }
+ *   @endcode
+ *
+ *   线程安全：除 interrupt() 外只能在一个线程上调用。
+ */
+class FileWatcher {
+public:
+  /**
+   * @brief 创建监视器。
+   *
+   * @return 监视器，平台不支持或无法初始化时返回错误（"E010"）
+   */
+  [[nodiscard]] static Result<std::unique_ptr<FileWatcher>> create();
+
+  ~FileWatcher();
+
+  // 不可拷贝，不可移动
+  FileWatcher(const FileWatcher &) = delete;
+  FileWatcher &operator=(const FileWatcher &) = delete;
+  FileWatcher(FileWatcher &&) = delete;
+  FileWatcher &operator=(FileWatcher &&) = delete;
+
+  /**
+   * @brief 监视目录。
+   *
+   * @param dir 目录路径
+   * @param recursive 是否同时监视子目录（含之后新建的）
+   * @param filter 子目录过滤，为空时监视全部子目录
+   * @return 目录不存在或超出系统监视数上限时返回错误（"E010"）
+   */
+  [[nodiscard]] VoidResult addDirectory(const std::filesystem::path &dir,
+                                        bool recursive = true,
+                                        DirectoryFilter filter = {});
+
+  /**
+   * @brief 阻塞等待下一批事件。
+   *
+   * @details
+   *   收到第一个事件后继续读取，直到 debounce 时长内没有新事件；
+   *   同一路径的多个事件合并为最后一个。
+   *
+   * @param debounce 合并窗口
+   * @return 按路径排序的事件；被 interrupt() 唤醒时返回空列表
+   */
+  [[nodiscard]] Result<std::vector<FileEvent>>
+  next(std::chrono::milliseconds debounce);
+
+  /**
+   * @brief 唤醒阻塞中的 next()，之后的 next() 立即返回（可在任意线程调用）。
+   */
+  void interrupt() noexcept;
+
+  /// 是否已被 interrupt() 唤醒
+  [[nodiscard]] bool interrupted() const noexcept;
+
+private:
+  struct Impl;
+
+  explicit FileWatcher(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_WATCH_FILE_WATCHER_HPP
@@ -0,0 +1,172 @@
+/**
+ * @file watch_lexer.hpp
+ * @brief 监视模式的增量词法分析（czc lex --watch）。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   首次全量分析全部输入，之后每批文件事件只重新分析内容真正变化的文件：
+ *   - 文件内容由 QueryDatabase 以内容哈希判断，仅修改时间变化
+ *     （touch、内容相同的保存）不会重新分析，也不输出记录
+ *   - 未变化文件的缓冲区与 Token 序列留在 SourceManager 与查询缓存中
+ *   - 缓冲区数达到 kMaxBuffers 时换用新的 SourceManager，
+ *     只保留各文件的当前内容，常驻内存不随保存次数增长
+ *
+ *   每个重新分析或移除的文件输出一行 NDJSON 记录：
+ *   @code
+ *   {"file":..,"event":"lexed","exitCode":0,"tokens":12,"result":{..},
+ *    "diagnostics":[]}
+ *   {"file":..,"event":"removed"}
+ *   @endcode
+ *   诊断以 JSON 对象数组随记录输出，失败时 result 为 null。
+ */
+
+#ifndef CZC_CLI_WATCH_WATCH_LEXER_HPP
+#define CZC_CLI_WATCH_WATCH_LEXER_HPP
+
+#include "czc/cli/batch/batch_lexer.hpp"
+#include "czc/cli/context.hpp"
+#include "czc/cli/query/query_database.hpp"
+#include "czc/cli/watch/file_watcher.hpp"
+#include "czc/common/config.hpp"
+#include "czc/common/output_sink.hpp"
+#include "czc/common/result.hpp"
+#include "czc/common/task_scheduler.hpp"
+#include "czc/diag/diag_context.hpp"
+#include "czc/lexer/lexer_source_locator.hpp"
+#include "czc/lexer/source_manager.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace czc::cli {
+
+/**
+ * @brief 监视模式选项。
+ */
+struct WatchOptions {
+  BatchInputOptions inputs;               ///< 目录中源文件的过滤条件
+  std::chrono::milliseconds debounce{50}; ///< 合并连续事件的窗口
+};
+
+/**
+ * @brief 一轮处理的汇总。
+ */
+struct WatchSummary {
+  std::size_t lexed{0};     ///< 重新分析的文件数
+  std::size_t unchanged{0}; ///< 有事件但内容哈希未变、已跳过的文件数
+  std::size_t removed{0};   ///< 移除的文件数
+  std::size_t failed{0};    ///< 分析失败的文件数
+};
+
+/**
+ * @brief 监视模式的增量词法分析器。
+ *
+ * @details
+ *   使用示例：
+ *   @code
+ *   WatchLexer watch(ctx, options);
+ *   auto initial = watch.start(args, *watcher, scheduler, sink);
+ *   while (auto events = watcher->next(options.debounce)) {
+ *     auto summary = watch.apply(*events, sink);
+ *   }
+ *   @endcode
+ *
+ *   分析在调用线程上进行，首次全量分析使用调度器并行。
+ */
+class WatchLexer {
+public:
+  /// 换用新 SourceManager 之前允许的缓冲区数
+  static constexpr std::size_t kMaxBuffers = 1024;
+
+  /**
+   * @brief 构造函数。
+   *
+   * @param ctx 编译上下文（提供词法与诊断选项，须比本对象存活更久）
+   * @param options 监视选项
+   */
+  WatchLexer(CompilerContext &ctx, WatchOptions options);
+
+  /**
+   * @brief 展开输入、登记监视目录，并全量分析一次。
+   *
+   * @details
+   *   目录参数递归监视（跳过 exclude 匹配的子目录），
+   *   单个文件监视其所在目录。
+   *
+   * @param args 命令行输入：文件、目录或 @响应文件
+   * @param watcher 文件监视器
+   * @param scheduler 首次分析使用的调度器
+   * @param sink 记录输出汇
+   * @return 汇总信息，输入无效或无法监视时返回错误
+   */
+  [[nodiscard]] Result<WatchSummary> start(std::span<const std::string> args,
+                                           FileWatcher &watcher,
+                                           TaskScheduler &scheduler,
+                                           OutputSink &sink);
+
+  /**
+   * @brief 处理一批文件事件，只重新分析内容变化的文件。
+   *
+   * @param events 文件事件
+   * @param sink 记录输出汇
+   * @return 汇总信息
+   */
+  WatchSummary apply(std::span<const FileEvent> events, OutputSink &sink);
+
+  /// 当前跟踪的源文件数
+  [[nodiscard]] std::size_t fileCount() const noexcept {
+    return tracked_.size();
+  }
+
+  /// 查询数据库（用于测试）
+  [[nodiscard]] const QueryDatabase &queries() const noexcept { return db_; }
+
+  /// 存放源码的 SourceManager（用于测试）
+  [[nodiscard]] const lexer::SourceManager &sources() const noexcept {
+    return *sources_;
+  }
+
+private:
+  /// 缓冲区过多时换用只含当前内容的新 SourceManager
+  void compactSources();
+
+  /// 事件路径是否为监视目标
+  [[nodiscard]] bool accepts(const std::filesystem::path &path,
+                             const std::string &key) const;
+
+  /// 移除 path 本身或其下的全部文件，返回移除数
+  std::size_t untrack(const std::filesystem::path &path, OutputSink &sink);
+
+  /// 分析已加载的文件并写出记录，返回是否成功
+  bool writeLexed(const std::filesystem::path &path, OutputSink &sink);
+
+  /// 写出加载失败的记录
+  void writeFailed(const std::filesystem::path &path, const Error &error,
+                   OutputSink &sink);
+
+  /// 取出本条记录的诊断（JSON 数组）并清空
+  [[nodiscard]] std::string takeDiagnostics();
+
+  CompilerContext &ctx_;
+  WatchOptions options_;
+  std::unique_ptr<lexer::SourceManager> sources_;
+  std::unique_ptr<lexer::LexerSourceLocator> locator_; ///< 基于 sources_
+  QueryDatabase db_;
+  std::vector<std::filesystem::path> roots_; ///< 递归监视的目录（规范化）
+  std::map<std::string, std::filesystem::path> tracked_; ///< 键 -> 输出路径
+  std::ostringstream diagnostics_; ///< 当前记录的诊断（JSON Lines）
+  diag::DiagContext dcx_;          ///< 写入 diagnostics_ 的诊断上下文
+};
+
+} // namespace czc::cli
+
+#endif // CZC_CLI_WATCH_WATCH_LEXER_HPP
@@ -0,0 +1,83 @@
+/**
+ * @file hash.hpp
+ * @brief 64 位非加密哈希。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   用于内容指纹（缓存失效判断），不用于安全用途：
+ *   - hashBytes() 每次处理 8 字节，结果与平台字节序无关
+ *   - hashCombine() 把多个值依次混入同一个指纹
+ */
+
+#ifndef CZC_COMMON_HASH_HPP
+#define CZC_COMMON_HASH_HPP
+
+#include "czc/common/config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace czc {
+
+/// 64 位混合（splitmix64 终结步骤）
+[[nodiscard]] constexpr std::uint64_t mix64(std::uint64_t x) noexcept {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/**
+ * @brief 将 value 混入已有的哈希值。
+ *
+ * @param seed 已有的哈希值
+ * @param value 新值
+ * @return 组合后的哈希值（与参数顺序相关）
+ */
+[[nodiscard]] constexpr std::uint64_t
+hashCombine(std::uint64_t seed, std::uint64_t value) noexcept {
+  return mix64(seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) +
+                       (seed >> 2)));
+}
+
+/**
+ * @brief 计算字节序列的哈希值。
+ *
+ * @param data 字节序列
+ * @param seed 初始值（不同用途可使用不同种子）
+ * @return 64 位哈希值
+ */
+[[nodiscard]] constexpr std::uint64_t
+hashBytes(std::string_view data, std::uint64_t seed = 0) noexcept {
+  constexpr std::uint64_t kMul = 0x9FB21C651E98DF25ULL;
+  std::uint64_t h = mix64(seed ^ (data.size() * kMul));
+
+  std::size_t i = 0;
+  for (; i + 8 <= data.size(); i += 8) {
+    // 按小端组装，结果与平台字节序无关
+    std::uint64_t word = 0;
+    for (std::size_t b = 0; b < 8; ++b) {
+      word |= static_cast<std::uint64_t>(static_cast<unsigned char>(
+                  data[i + b]))
+              << (8 * b);
+    }
+    h = (h ^ mix64(word)) * kMul;
+    h ^= h >> 29;
+  }
+
+  std::uint64_t tail = 0;
+  for (std::size_t b = 0; i + b < data.size(); ++b) {
+    tail |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i + b]))
+            << (8 * b);
+  }
+  return mix64(h ^ mix64(tail));
+}
+
+} // namespace czc
+
+#endif // CZC_COMMON_HASH_HPP
@@ -0,0 +1,134 @@
+/**
+ * @file json_reader.hpp
+ * @brief 轻量 JSON 解析：供 JSON-RPC 等小消息的读取使用。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   与 json_writer.hpp 相对：输出侧直接写入输出汇，
+ *   输入侧将消息解析为小型 DOM（JsonValue）。
+ *   - 数字统一存为 double（JSON-RPC 的 id、行列号均在 2^53 以内）
+ *   - 对象成员保持原始顺序，按键线性查找（消息成员数很少）
+ *   - 字符串中的 \uXXXX（含代理对）解码为 UTF-8
+ *   - 嵌套深度受限，避免恶意输入耗尽栈空间
+ */
+
+#ifndef CZC_COMMON_JSON_READER_HPP
+#define CZC_COMMON_JSON_READER_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/common/output_sink.hpp"
+#include "czc/common/result.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace czc {
+
+/**
+ * @brief JSON 值。
+ *
+ * @details
+ *   访问器对类型不符或缺失的成员返回默认值，
+ *   调用方可以链式读取可选字段：
+ *   @code
+ *   auto line = msg["params"]["position"]["line"].asInt();
+ *   @endcode
+ */
+class JsonValue {
+public:
+  using Array = std::vector<JsonValue>;
+  using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+  /// 值的种类
+  enum class Kind : std::uint8_t { Null, Bool, Number, String, Array, Object };
+
+  JsonValue() = default;
+  explicit JsonValue(bool value) : value_(value) {}
+  explicit JsonValue(double value) : value_(value) {}
+  explicit JsonValue(std::string value) : value_(std::move(value)) {}
+  explicit JsonValue(Array value) : value_(std::move(value)) {}
+  explicit JsonValue(Object value) : value_(std::move(value)) {}
+
+  /// 值的种类
+  [[nodiscard]] Kind kind() const noexcept {
+    return static_cast<Kind>(value_.index());
+  }
+
+  [[nodiscard]] bool isNull() const noexcept { return kind() == Kind::Null; }
+  [[nodiscard]] bool isString() const noexcept {
+    return kind() == Kind::String;
+  }
+  [[nodiscard]] bool isNumber() const noexcept {
+    return kind() == Kind::Number;
+  }
+  [[nodiscard]] bool isObject() const noexcept {
+    return kind() == Kind::Object;
+  }
+  [[nodiscard]] bool isArray() const noexcept { return kind() == Kind::Array; }
+
+  /// 布尔值，非布尔返回 fallback
+  [[nodiscard]] bool asBool(bool fallback = false) const noexcept;
+
+  /// 数值，非数字返回 fallback
+  [[nodiscard]] double asNumber(double fallback = 0) const noexcept;
+
+  /// 整数值（截断），非数字返回 fallback
+  [[nodiscard]] std::int64_t asInt(std::int64_t fallback = 0) const noexcept;
+
+  /// 字符串视图，非字符串返回空
+  [[nodiscard]] std::string_view asString() const noexcept;
+
+  /// 数组元素，非数组返回空
+  [[nodiscard]] const Array &asArray() const noexcept;
+
+  /// 对象成员（保持原始顺序），非对象返回空
+  [[nodiscard]] const Object &members() const noexcept;
+
+  /**
+   * @brief 查找对象成员。
+   *
+   * @param key 成员名
+   * @return 成员指针，非对象或不存在时返回 nullptr
+   */
+  [[nodiscard]] const JsonValue *find(std::string_view key) const noexcept;
+
+  /// 对象成员，不存在时返回 null 值
+  [[nodiscard]] const JsonValue &
+  operator[](std::string_view key) const noexcept;
+
+  /// 取出字符串（移动），非字符串返回空
+  [[nodiscard]] std::string takeString() noexcept;
+
+private:
+  std::variant<std::monostate, bool, double, std::string, Array, Object>
+      value_;
+};
+
+/**
+ * @brief 解析 JSON 文本。
+ *
+ * @param text JSON 文本（允许首尾空白）
+ * @return 解析结果，语法错误时返回错误（"E007"）
+ */
+[[nodiscard]] Result<JsonValue> parseJson(std::string_view text);
+
+/**
+ * @brief 以紧凑形式写出 JSON 值。
+ *
+ * @details
+ *   整数值的数字不带小数部分输出，用于回写 JSON-RPC 的 id。
+ *
+ * @param sink 输出汇
+ * @param value JSON 值
+ */
+void writeJson(OutputSink &sink, const JsonValue &value);
+
+} // namespace czc
+
+#endif // CZC_COMMON_JSON_READER_HPP
@@ -0,0 +1,53 @@
+/**
+ * @file json_writer.hpp
+ * @brief 面向输出汇的 JSON 字符串转义写入。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   不构建任何中间 DOM：结构性字符由调用方直接写入输出汇，
+ *   字符串值通过 writeJsonString() 就地转义。
+ *   转义规则与 glaze 的紧凑输出保持一致：
+ *   - '"' 与 '\\' 使用反斜杠转义
+ *   - \b \f \n \r \t 使用短转义
+ *   - 其余控制字符使用 \u00XX
+ *   - 非 ASCII 字节原样输出（UTF-8 透传）
+ */
+
+#ifndef CZC_COMMON_JSON_WRITER_HPP
+#define CZC_COMMON_JSON_WRITER_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/common/output_sink.hpp"
+
+#include <string_view>
+
+namespace czc {
+
+/**
+ * @brief 写入转义后的 JSON 字符串内容（不含两侧引号）。
+ *
+ * @details
+ *   连续的无需转义字节以单次 write() 批量写出。
+ *
+ * @param sink 输出汇
+ * @param value 原始字符串
+ */
+void writeJsonEscaped(OutputSink &sink, std::string_view value);
+
+/**
+ * @brief 写入带引号的 JSON 字符串。
+ *
+ * @param sink 输出汇
+ * @param value 原始字符串
+ */
+inline void writeJsonString(OutputSink &sink, std::string_view value) {
+  sink.put('"');
+  writeJsonEscaped(sink, value);
+  sink.put('"');
+}
+
+} // namespace czc
+
+#endif // CZC_COMMON_JSON_WRITER_HPP
@@ -0,0 +1,318 @@
+/**
+ * @file output_sink.hpp
+ * @brief 带固定缓冲区的输出汇（Output Sink）定义。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   输出汇是格式化器与最终输出目标之间的薄层：
+ *   - 所有写入先进入一块固定大小、可复用的缓冲区
+ *   - 缓冲区满或显式 flush 时，一次性交给派生类排空
+ *   - 数字使用 std::to_chars 直接写入缓冲区，不经过 locale
+ *
+ *   派生实现包括：
+ *   - FdSink: 以大块 write() 直接写入文件描述符
+ *   - StringSink: 追加到调用方提供的 std::string
+ *   - OstreamSink: 以大块 write() 写入 std::ostream
+ */
+
+#ifndef CZC_COMMON_OUTPUT_SINK_HPP
+#define CZC_COMMON_OUTPUT_SINK_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/common/result.hpp"
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace czc {
+
+/**
+ * @brief 输出汇基类。
+ *
+ * @details
+ *   写入路径全部内联在头文件中：常见情况下只是一次 memcpy。
+ *   只有缓冲区满时才调用虚函数 drain()，因此虚调用开销按块摊销。
+ *
+ * @note 不可拷贝、不可移动；派生类析构时负责调用 flush()。
+ */
+class OutputSink {
+public:
+  /// 默认缓冲区大小（64 KiB）
+  static constexpr std::size_t kDefaultCapacity = 64 * 1024;
+
+  virtual ~OutputSink() = default;
+
+  // 不可拷贝、不可移动
+  OutputSink(const OutputSink &) = delete;
+  OutputSink &operator=(const OutputSink &) = delete;
+  OutputSink(OutputSink &&) = delete;
+  OutputSink &operator=(OutputSink &&) = delete;
+
+  /**
+   * @brief 写入一段字节。
+   *
+   * @details
+   *   超过缓冲区容量的大块数据会绕过缓冲区直接排空，避免二次拷贝。
+   *
+   * @param data 待写入数据
+   */
+  CZC_FORCE_INLINE void write(std::string_view data) {
+    if (data.size() <= capacity_ - size_) [[likely]] {
+      std::memcpy(buffer_.get() + size_, data.data(), data.size());
+      size_ += data.size();
+      return;
+    }
+    writeSlow(data);
+  }
+
+  /**
+   * @brief 先排空缓冲区，再把整块数据直接交给底层设备。
+   *
+   * @details
+   *   用于已在别处渲染好的大块输出（如流水线中的输出块），省去一次拷贝。
+   *
+   * @param data 待写入数据
+   */
+  void writeThrough(std::string_view data);
+
+  /**
+   * @brief 先排空缓冲区，再把多段数据按顺序一次性交给底层设备。
+   *
+   * @details
+   *   FdSink 使用 writev() 实现，多段输出只需一次系统调用。
+   *
+   * @param parts 按顺序排列的数据段
+   */
+  void writeVectored(std::span<const std::string_view> parts);
+
+  /**
+   * @brief 写入单个字符。
+   *
+   * @param c 字符
+   */
+  CZC_FORCE_INLINE void put(char c) {
+    if (size_ == capacity_) [[unlikely]] {
+      drainBuffer();
+    }
+    buffer_[size_++] = c;
+  }
+
+  /**
+   * @brief 以十进制写入整数（std::to_chars，无 locale）。
+   *
+   * @tparam T 整数类型
+   * @param value 整数值
+   */
+  template <std::integral T> CZC_FORCE_INLINE void writeInt(T value) {
+    // 64 位整数的十进制表示最多 20 位数字 + 符号
+    constexpr std::size_t kMaxDigits = 21;
+    if (capacity_ - size_ < kMaxDigits) [[unlikely]] {
+      drainBuffer();
+    }
+    char *begin = buffer_.get() + size_;
+    auto [end, ec] = std::to_chars(begin, begin + kMaxDigits, value);
+    (void)ec; // 缓冲区足够，不会失败
+    size_ += static_cast<std::size_t>(end - begin);
+  }
+
+  /**
+   * @brief 预留至少 n 字节的连续可写空间。
+   *
+   * @details
+   *   供批量写入使用：调用方直接写入返回的指针，然后调用 commit(n)。
+   *   n 不得超过 capacity()。
+   *
+   * @param n 需要的字节数
+   * @return 可写区域的起始指针
+   */
+  [[nodiscard]] CZC_FORCE_INLINE char *reserve(std::size_t n) {
+    if (capacity_ - size_ < n) [[unlikely]] {
+      drainBuffer();
+    }
+    return buffer_.get() + size_;
+  }
+
+  /**
+   * @brief 提交通过 reserve() 写入的字节。
+   *
+   * @param n 实际写入的字节数
+   */
+  CZC_FORCE_INLINE void commit(std::size_t n) noexcept { size_ += n; }
+
+  /**
+   * @brief 排空缓冲区并刷新底层设备。
+   */
+  void flush();
+
+  /**
+   * @brief 检查到目前为止是否没有发生 I/O 错误。
+   */
+  [[nodiscard]] bool ok() const noexcept { return !failed_; }
+
+  /// 获取缓冲区容量
+  [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+  /// 获取累计写入底层设备的字节数（不含尚在缓冲区中的数据）
+  [[nodiscard]] std::size_t bytesDrained() const noexcept { return drained_; }
+
+protected:
+  /**
+   * @brief 构造输出汇。
+   *
+   * @param capacity 缓冲区容量
+   */
+  explicit OutputSink(std::size_t capacity = kDefaultCapacity);
+
+  /**
+   * @brief 将一段数据交给底层设备。
+   *
+   * @param data 待排空数据
+   * @return 成功返回 true
+   */
+  virtual bool drain(std::string_view data) = 0;
+
+  /**
+   * @brief 将多段数据按顺序交给底层设备。
+   *
+   * @details
+   *   默认实现逐段调用 drain()；派生类可使用聚集写覆盖。
+   *
+   * @param parts 数据段
+   * @return 成功返回 true
+   */
+  virtual bool drainVectored(std::span<const std::string_view> parts);
+
+  /**
+   * @brief 刷新底层设备（默认无操作）。
+   */
+  virtual void flushDevice() {}
+
+private:
+  void drainBuffer();
+  void writeSlow(std::string_view data);
+  void drainDirect(std::string_view data);
+
+  std::unique_ptr<char[]> buffer_; ///< 固定缓冲区
+  std::size_t capacity_;           ///< 缓冲区容量
+  std::size_t size_{0};            ///< 已用字节数
+  std::size_t drained_{0};         ///< 已排空字节数
+  bool failed_{false};             ///< 是否发生过 I/O 错误
+};
+
+/**
+ * @brief 写入文件描述符的输出汇。
+ *
+ * @details
+ *   缓冲区满时以单次大块 write() 写出，并处理部分写入与 EINTR。
+ */
+class FdSink final : public OutputSink {
+public:
+  /**
+   * @brief 包装已有的文件描述符。
+   *
+   * @param fd 文件描述符
+   * @param ownsFd 析构时是否关闭 fd
+   * @param capacity 缓冲区容量
+   */
+  explicit FdSink(int fd, bool ownsFd = false,
+                  std::size_t capacity = kDefaultCapacity);
+
+  ~FdSink() override;
+
+  /**
+   * @brief 创建写入标准输出的输出汇。
+   */
+  [[nodiscard]] static std::unique_ptr<FdSink> standardOutput();
+
+  /**
+   * @brief 打开（截断或创建）文件并创建输出汇。
+   *
+   * @param path 文件路径
+   * @return 输出汇，打开失败时返回错误
+   */
+  [[nodiscard]] static Result<std::unique_ptr<FdSink>>
+  open(const std::filesystem::path &path);
+
+  /// 获取底层文件描述符
+  [[nodiscard]] int fd() const noexcept { return fd_; }
+
+protected:
+  bool drain(std::string_view data) override;
+  bool drainVectored(std::span<const std::string_view> parts) override;
+
+private:
+  int fd_;
+  bool ownsFd_;
+};
+
+/**
+ * @brief 追加到 std::string 的输出汇。
+ *
+ * @details
+ *   用于测试以及需要字符串结果的便捷接口。
+ *   调用方需在读取目标字符串前调用 flush()（析构时也会自动 flush）。
+ */
+class StringSink final : public OutputSink {
+public:
+  /// StringSink 的默认缓冲区较小，避免小输出的额外开销
+  static constexpr std::size_t kStringCapacity = 4 * 1024;
+
+  /**
+   * @brief 构造字符串输出汇。
+   *
+   * @param target 目标字符串（生命周期需长于输出汇）
+   * @param capacity 缓冲区容量
+   */
+  explicit StringSink(std::string &target,
+                      std::size_t capacity = kStringCapacity);
+
+  ~StringSink() override;
+
+protected:
+  bool drain(std::string_view data) override;
+
+private:
+  std::string &target_;
+};
+
+/**
+ * @brief 写入 std::ostream 的输出汇。
+ *
+ * @details
+ *   用于只能拿到流对象的场景（如诊断发射器）：小块写入先在缓冲区合并，
+ *   再以单次 ostream::write() 写出；flush() 同时刷新流。
+ */
+class OstreamSink final : public OutputSink {
+public:
+  /**
+   * @brief 构造流输出汇。
+   *
+   * @param out 目标流（生命周期需长于输出汇）
+   * @param capacity 缓冲区容量
+   */
+  explicit OstreamSink(std::ostream &out,
+                       std::size_t capacity = kDefaultCapacity);
+
+  ~OstreamSink() override;
+
+protected:
+  bool drain(std::string_view data) override;
+  void flushDevice() override;
+
+private:
+  std::ostream &out_;
+};
+
+} // namespace czc
+
+#endif // CZC_COMMON_OUTPUT_SINK_HPP
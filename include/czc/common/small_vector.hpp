@@ -0,0 +1,232 @@
+/**
+ * @file small_vector.hpp
+ * @brief 带内联存储的小向量。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   前 N 个元素存放在对象内部，超出后才转移到堆上：
+ *   - 常见的 1~2 个元素不产生堆分配
+ *   - 元素连续存放，迭代器即指针，可直接转换为 std::span
+ *   - 仅提供诊断数据结构用到的 std::vector 接口子集
+ */
+
+#ifndef CZC_COMMON_SMALL_VECTOR_HPP
+#define CZC_COMMON_SMALL_VECTOR_HPP
+
+#include "czc/common/config.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace czc {
+
+/**
+ * @brief 带 N 个内联槽位的向量。
+ *
+ * @tparam T 元素类型（需可移动构造）
+ * @tparam N 内联容量
+ */
+template <typename T, std::size_t N> class SmallVector {
+  static_assert(N > 0, "SmallVector requires a non-zero inline capacity");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  SmallVector() noexcept = default;
+
+  SmallVector(std::initializer_list<T> init) {
+    reserve(init.size());
+    std::uninitialized_copy(init.begin(), init.end(), data_);
+    size_ = init.size();
+  }
+
+  SmallVector(const SmallVector &other) {
+    reserve(other.size_);
+    std::uninitialized_copy(other.begin(), other.end(), data_);
+    size_ = other.size_;
+  }
+
+  SmallVector(SmallVector &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    takeFrom(other);
+  }
+
+  auto operator=(const SmallVector &other) -> SmallVector & {
+    if (this != &other) {
+      clear();
+      reserve(other.size_);
+      std::uninitialized_copy(other.begin(), other.end(), data_);
+      size_ = other.size_;
+    }
+    return *this;
+  }
+
+  auto operator=(SmallVector &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) -> SmallVector & {
+    if (this != &other) {
+      clear();
+      releaseHeap();
+      takeFrom(other);
+    }
+    return *this;
+  }
+
+  ~SmallVector() {
+    clear();
+    releaseHeap();
+  }
+
+  // ========== 访问 ==========
+
+  [[nodiscard]] auto data() noexcept -> T * { return data_; }
+  [[nodiscard]] auto data() const noexcept -> const T * { return data_; }
+
+  [[nodiscard]] auto begin() noexcept -> iterator { return data_; }
+  [[nodiscard]] auto end() noexcept -> iterator { return data_ + size_; }
+  [[nodiscard]] auto begin() const noexcept -> const_iterator { return data_; }
+  [[nodiscard]] auto end() const noexcept -> const_iterator {
+    return data_ + size_;
+  }
+
+  [[nodiscard]] auto operator[](size_type i) noexcept -> T & {
+    return data_[i];
+  }
+  [[nodiscard]] auto operator[](size_type i) const noexcept -> const T & {
+    return data_[i];
+  }
+
+  [[nodiscard]] auto front() noexcept -> T & { return data_[0]; }
+  [[nodiscard]] auto front() const noexcept -> const T & { return data_[0]; }
+  [[nodiscard]] auto back() noexcept -> T & { return data_[size_ - 1]; }
+  [[nodiscard]] auto back() const noexcept -> const T & {
+    return data_[size_ - 1];
+  }
+
+  [[nodiscard]] auto size() const noexcept -> size_type { return size_; }
+  [[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+  [[nodiscard]] auto capacity() const noexcept -> size_type {
+    return capacity_;
+  }
+
+  /// 元素是否仍位于内联存储中
+  [[nodiscard]] auto isInline() const noexcept -> bool {
+    return data_ == inlineData();
+  }
+
+  /// 转换为只读视图
+  operator std::span<const T>() const noexcept { return {data_, size_}; }
+
+  // ========== 修改 ==========
+
+  /**
+   * @brief 在末尾原地构造元素。
+   *
+   * @param args 构造参数（可引用本容器中的元素）
+   * @return 新元素的引用
+   */
+  template <typename... Args> auto emplace_back(Args &&...args) -> T & {
+    if (size_ == capacity_) {
+      // 先在新缓冲区构造新元素，再迁移旧元素，参数引用旧元素时依然安全
+      size_type newCapacity = capacity_ * 2;
+      T *buffer = allocate(newCapacity);
+      try {
+        std::construct_at(buffer + size_, std::forward<Args>(args)...);
+      } catch (...) {
+        std::allocator<T>{}.deallocate(buffer, newCapacity);
+        throw;
+      }
+      relocate(buffer);
+      capacity_ = newCapacity;
+    } else {
+      std::construct_at(data_ + size_, std::forward<Args>(args)...);
+    }
+    return data_[size_++];
+  }
+
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  void pop_back() noexcept { std::destroy_at(data_ + --size_); }
+
+  /// 预留至少 n 个元素的容量
+  void reserve(size_type n) {
+    if (n <= capacity_) {
+      return;
+    }
+    T *buffer = allocate(n);
+    relocate(buffer);
+    capacity_ = n;
+  }
+
+  /// 销毁全部元素（保留容量）
+  void clear() noexcept {
+    std::destroy(data_, data_ + size_);
+    size_ = 0;
+  }
+
+private:
+  [[nodiscard]] auto inlineData() noexcept -> T * {
+    return reinterpret_cast<T *>(inline_);
+  }
+  [[nodiscard]] auto inlineData() const noexcept -> const T * {
+    return reinterpret_cast<const T *>(inline_);
+  }
+
+  static auto allocate(size_type n) -> T * {
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  /// 将现有元素迁移到 buffer 并释放旧的堆存储
+  void relocate(T *buffer) {
+    std::uninitialized_move(data_, data_ + size_, buffer);
+    std::destroy(data_, data_ + size_);
+    releaseHeap();
+    data_ = buffer;
+  }
+
+  void releaseHeap() noexcept {
+    if (!isInline()) {
+      std::allocator<T>{}.deallocate(data_, capacity_);
+      data_ = inlineData();
+      capacity_ = N;
+    }
+  }
+
+  /// 从 other 接管元素；other 变为空的内联状态（要求本对象为空）
+  void takeFrom(SmallVector &other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    if (!other.isInline()) {
+      data_ = other.data_;
+      capacity_ = other.capacity_;
+      size_ = other.size_;
+      other.data_ = other.inlineData();
+      other.capacity_ = N;
+      other.size_ = 0;
+      return;
+    }
+    std::uninitialized_move(other.begin(), other.end(), data_);
+    size_ = other.size_;
+    other.clear();
+  }
+
+  alignas(T) std::byte inline_[N * sizeof(T)];
+  T *data_{inlineData()};
+  size_type size_{0};
+  size_type capacity_{N};
+};
+
+} // namespace czc
+
+#endif // CZC_COMMON_SMALL_VECTOR_HPP
@@ -0,0 +1,184 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief 有界单生产者单消费者（SPSC）队列。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   用于流水线各阶段之间传递数据块：
+ *   - 环形缓冲区，容量固定（向上取整到 2 的幂）
+ *   - 入队/出队在快速路径上只有原子读写，无锁
+ *   - 队列满时生产者阻塞（背压），队列空时消费者阻塞
+ *   - 阻塞基于 C++20 std::atomic::wait/notify
+ *
+ *   关闭状态编码在索引的最高位，使 close() 能唤醒在索引上等待的线程。
+ */
+
+#ifndef CZC_COMMON_SPSC_QUEUE_HPP
+#define CZC_COMMON_SPSC_QUEUE_HPP
+
+#include "czc/common/config.hpp"
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace czc {
+
+/**
+ * @brief 有界 SPSC 阻塞队列。
+ *
+ * @tparam T 元素类型（需可默认构造、可移动）
+ *
+ * @note 只允许一个线程调用 push/tryPush，另一个线程调用 pop/tryPop；
+ *       close() 可由任意一方调用。
+ */
+template <typename T>
+  requires std::default_initializable<T> && std::movable<T>
+class SpscQueue {
+public:
+  /**
+   * @brief 构造队列。
+   *
+   * @param capacity 最小容量（至少为 1）
+   */
+  explicit SpscQueue(std::size_t capacity)
+      : capacity_(std::bit_ceil(capacity == 0 ? std::size_t{1} : capacity)),
+        mask_(capacity_ - 1), slots_(std::make_unique<T[]>(capacity_)) {}
+
+  // 不可拷贝、不可移动（线程间共享）
+  SpscQueue(const SpscQueue &) = delete;
+  SpscQueue &operator=(const SpscQueue &) = delete;
+  SpscQueue(SpscQueue &&) = delete;
+  SpscQueue &operator=(SpscQueue &&) = delete;
+
+  ~SpscQueue() = default;
+
+  /**
+   * @brief 入队，队列满时阻塞。
+   *
+   * @param value 元素
+   * @return 成功返回 true；队列已关闭返回 false
+   */
+  bool push(T value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed) & kIndexMask;
+    while (true) {
+      const std::size_t head = head_.load(std::memory_order_acquire);
+      if (head & kClosedBit) {
+        return false;
+      }
+      if (tail - head < capacity_) {
+        break;
+      }
+      head_.wait(head, std::memory_order_acquire);
+    }
+    publish(tail, std::move(value));
+    return true;
+  }
+
+  /**
+   * @brief 尝试入队，不阻塞。
+   *
+   * @param value 元素（失败时保持不变）
+   * @return 成功返回 true；队列满或已关闭返回 false
+   */
+  bool tryPush(T &value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed) & kIndexMask;
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    if ((head & kClosedBit) || tail - head >= capacity_) {
+      return false;
+    }
+    publish(tail, std::move(value));
+    return true;
+  }
+
+  /**
+   * @brief 出队，队列空时阻塞。
+   *
+   * @return 元素；队列已关闭且已排空时返回 std::nullopt
+   */
+  [[nodiscard]] std::optional<T> pop() {
+    const std::size_t head = head_.load(std::memory_order_relaxed) & kIndexMask;
+    while (true) {
+      const std::size_t tail = tail_.load(std::memory_order_acquire);
+      if ((tail & kIndexMask) != head) {
+        break;
+      }
+      if (tail & kClosedBit) {
+        return std::nullopt;
+      }
+      tail_.wait(tail, std::memory_order_acquire);
+    }
+    return consume(head);
+  }
+
+  /**
+   * @brief 尝试出队，不阻塞。
+   *
+   * @return 元素；队列为空时返回 std::nullopt
+   */
+  [[nodiscard]] std::optional<T> tryPop() {
+    const std::size_t head = head_.load(std::memory_order_relaxed) & kIndexMask;
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    if ((tail & kIndexMask) == head) {
+      return std::nullopt;
+    }
+    return consume(head);
+  }
+
+  /**
+   * @brief 关闭队列，唤醒所有等待者。
+   *
+   * @details
+   *   关闭后 push 失败；pop 继续返回剩余元素，排空后返回 std::nullopt。
+   */
+  void close() noexcept {
+    tail_.fetch_or(kClosedBit, std::memory_order_acq_rel);
+    tail_.notify_all();
+    head_.fetch_or(kClosedBit, std::memory_order_acq_rel);
+    head_.notify_all();
+  }
+
+  /// 检查队列是否已关闭
+  [[nodiscard]] bool isClosed() const noexcept {
+    return (tail_.load(std::memory_order_acquire) & kClosedBit) != 0;
+  }
+
+  /// 获取队列容量
+  [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+  static constexpr std::size_t kClosedBit = std::size_t{1}
+                                            << (sizeof(std::size_t) * 8 - 1);
+  static constexpr std::size_t kIndexMask = ~kClosedBit;
+
+  void publish(std::size_t tail, T &&value) {
+    slots_[tail & mask_] = std::move(value);
+    // 使用 fetch_add 而非 store，保留可能被并发设置的关闭位
+    tail_.fetch_add(1, std::memory_order_release);
+    tail_.notify_one();
+  }
+
+  T consume(std::size_t head) {
+    T value = std::move(slots_[head & mask_]);
+    head_.fetch_add(1, std::memory_order_release);
+    head_.notify_one();
+    return value;
+  }
+
+  const std::size_t capacity_;
+  const std::size_t mask_;
+  std::unique_ptr<T[]> slots_;
+
+  alignas(64) std::atomic<std::size_t> head_{0}; ///< 消费者索引
+  alignas(64) std::atomic<std::size_t> tail_{0}; ///< 生产者索引
+};
+
+} // namespace czc
+
+#endif // CZC_COMMON_SPSC_QUEUE_HPP
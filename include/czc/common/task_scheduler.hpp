@@ -0,0 +1,267 @@
+/**
+ * @file task_scheduler.hpp
+ * @brief 工作窃取任务调度器。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   进程内共享的 fork-join 调度器：
+ *   - 每个工作线程一个 Chase-Lev 队列，空闲时随机窃取其他线程的任务
+ *   - 非工作线程提交的任务进入全局注入队列
+ *   - TaskGroup::wait() 在等待期间执行待处理任务，嵌套 fork-join 不会死锁
+ *   - parallelFor() 对区间二分拆分，直到不超过粒度
+ *   - 单线程（确定性）模式不创建线程，任务在等待者上按提交顺序执行
+ *
+ *   一个进程只应持有一个调度器（由 Driver 持有），
+ *   各阶段共用它，总线程数不会超过配置的并行度。
+ */
+
+#ifndef CZC_COMMON_TASK_SCHEDULER_HPP
+#define CZC_COMMON_TASK_SCHEDULER_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/common/work_deque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace czc {
+
+class TaskScheduler;
+
+/**
+ * @brief 调度器配置。
+ */
+struct SchedulerOptions {
+  /// 总并行度（含参与等待的调用线程），0 表示硬件并发数
+  std::size_t threads{0};
+  /// 确定性模式：不创建工作线程，任务按提交顺序在等待者上执行
+  bool deterministic{false};
+  /// 将工作线程依次绑定到允许的 CPU 上（仅 Linux，不区分 NUMA 节点）
+  bool pinWorkers{false};
+};
+
+/**
+ * @brief 一组可等待的任务（fork-join 作用域）。
+ *
+ * @details
+ *   使用示例：
+ *   @code
+ *   TaskGroup group(scheduler);
+ *   group.spawn([&] { left = solve(lo, mid); });
+ *   group.spawn([&] { right = solve(mid, hi); });
+ *   group.wait();
+ *   @endcode
+ *
+ *   任务抛出的第一个异常在 wait() 中重新抛出。
+ *   析构时等待尚未完成的任务（忽略异常）。
+ */
+class TaskGroup {
+public:
+  /**
+   * @brief 构造任务组。
+   *
+   * @param scheduler 执行任务的调度器
+   */
+  explicit TaskGroup(TaskScheduler &scheduler) noexcept
+      : scheduler_(scheduler) {}
+
+  // 不可拷贝、不可移动（任务持有指向组的指针）
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+  TaskGroup(TaskGroup &&) = delete;
+  TaskGroup &operator=(TaskGroup &&) = delete;
+
+  ~TaskGroup();
+
+  /**
+   * @brief 提交任务。
+   *
+   * @param fn 任务函数（可在任意线程上执行）
+   */
+  void spawn(std::function<void()> fn);
+
+  /**
+   * @brief 等待组内全部任务完成，期间协助执行待处理任务。
+   *
+   * @throws 任务抛出的第一个异常
+   */
+  void wait();
+
+  /// 获取所属调度器
+  [[nodiscard]] TaskScheduler &scheduler() const noexcept {
+    return scheduler_;
+  }
+
+private:
+  friend class TaskScheduler;
+
+  /// 记录任务异常（只保留第一个）
+  void recordError(std::exception_ptr error);
+
+  /// 阻塞直到组内任务完成，不重新抛出异常
+  void join();
+
+  TaskScheduler &scheduler_;
+  std::atomic<std::size_t> pending_{0}; ///< 未完成的任务数
+  std::mutex errorMutex_;
+  std::exception_ptr error_; ///< 第一个任务异常
+};
+
+/**
+ * @brief 工作窃取任务调度器。
+ *
+ * @details
+ *   使用示例：
+ *   @code
+ *   TaskScheduler scheduler({.threads = 8});
+ *   scheduler.parallelFor(0, items.size(), 64,
+ *                         [&](std::size_t lo, std::size_t hi) {
+ *                           for (auto i = lo; i < hi; ++i) process(items[i]);
+ *                         });
+ *   @endcode
+ */
+class TaskScheduler {
+public:
+  /**
+   * @brief 构造调度器并启动工作线程。
+   *
+   * @param options 调度器配置
+   */
+  explicit TaskScheduler(SchedulerOptions options = {});
+
+  // 不可拷贝、不可移动（工作线程持有指针）
+  TaskScheduler(const TaskScheduler &) = delete;
+  TaskScheduler &operator=(const TaskScheduler &) = delete;
+  TaskScheduler(TaskScheduler &&) = delete;
+  TaskScheduler &operator=(TaskScheduler &&) = delete;
+
+  /**
+   * @brief 停止并回收工作线程。
+   *
+   * @note 调用前须等待所有 TaskGroup 完成。
+   */
+  ~TaskScheduler();
+
+  /// 总并行度（后台工作线程数 + 1）
+  [[nodiscard]] std::size_t concurrency() const noexcept {
+    return workers_.size() + 1;
+  }
+
+  /// 是否为确定性单线程模式
+  [[nodiscard]] bool deterministic() const noexcept {
+    return workers_.empty();
+  }
+
+  /**
+   * @brief 在调用线程上执行一个待处理任务。
+   *
+   * @details
+   *   供需要边等待边交付结果的调用方使用（如按顺序收集的生产者）。
+   *
+   * @return 执行了任务返回 true，没有可执行的任务返回 false
+   */
+  bool runPending();
+
+  /**
+   * @brief 对 [begin, end) 并行执行 body，阻塞直到全部完成。
+   *
+   * @details
+   *   区间二分拆分为不超过 grain 的子区间，body(lo, hi) 可能并发调用。
+   *   确定性模式下子区间按固定顺序依次执行。
+   *
+   * @param begin 起始下标
+   * @param end 结束下标（不含）
+   * @param grain 子区间最大长度（至少为 1）
+   * @param body 子区间处理函数
+   * @throws body 抛出的第一个异常
+   */
+  template <typename Body>
+  void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                   const Body &body) {
+    if (begin >= end) {
+      return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    if (end - begin <= grain || deterministic()) {
+      // 无需拆分：确定性模式下也按区间顺序执行
+      for (std::size_t lo = begin; lo < end; lo += grain) {
+        body(lo, std::min(end, lo + grain));
+      }
+      return;
+    }
+    TaskGroup group(*this);
+    splitRange(group, begin, end, grain, body);
+    group.wait();
+  }
+
+private:
+  friend class TaskGroup;
+
+  /**
+   * @brief 调度单元。
+   */
+  struct Task {
+    std::function<void()> fn;
+    TaskGroup *group;
+  };
+
+  /**
+   * @brief 后台工作线程及其任务队列。
+   */
+  struct Worker {
+    WorkStealingDeque<Task> deque;
+    std::jthread thread;
+  };
+
+  /// 递归拆分区间：右半提交为任务，左半在当前线程继续
+  template <typename Body>
+  static void splitRange(TaskGroup &group, std::size_t begin, std::size_t end,
+                         std::size_t grain, const Body &body) {
+    while (end - begin > grain) {
+      const std::size_t mid = begin + (end - begin) / 2;
+      group.spawn([&group, mid, end, grain, &body] {
+        splitRange(group, mid, end, grain, body);
+      });
+      end = mid;
+    }
+    body(begin, end);
+  }
+
+  /// 提交任务：工作线程压入自身队列，其他线程进入注入队列
+  void submit(Task *task);
+
+  /// 查找任务：自身队列 → 注入队列 → 窃取其他线程
+  Task *findTask(Worker *self);
+
+  /// 执行任务并更新所属组
+  void execute(Task *task);
+
+  /// 当前线程对应的工作线程（非本调度器线程返回 nullptr）
+  Worker *currentWorker() const noexcept;
+
+  /// 工作线程主循环
+  void workerLoop(Worker &self, std::size_t index);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::mutex injectMutex_;
+  std::deque<Task *> injected_; ///< 非工作线程提交的任务（FIFO）
+  std::atomic<std::uint64_t> epoch_{0}; ///< 每次提交递增，唤醒空闲线程
+  std::atomic<std::uint64_t> completed_{0}; ///< 每次任务完成递增，唤醒等待者
+  std::atomic<bool> stopping_{false};
+  bool pinWorkers_{false};
+};
+
+} // namespace czc
+
+#endif // CZC_COMMON_TASK_SCHEDULER_HPP
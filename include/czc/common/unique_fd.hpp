@@ -0,0 +1,62 @@
+/**
+ * @file unique_fd.hpp
+ * @brief 独占的文件描述符。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   供持有套接字、inotify、eventfd 等描述符的模块共用，
+ *   析构时关闭描述符（Windows 上不持有 POSIX 描述符，仅记录数值）。
+ */
+
+#ifndef CZC_COMMON_UNIQUE_FD_HPP
+#define CZC_COMMON_UNIQUE_FD_HPP
+
+#include "czc/common/config.hpp"
+
+namespace czc {
+
+/**
+ * @brief 独占的文件描述符（析构时关闭）。
+ */
+class UniqueFd {
+public:
+  UniqueFd() = default;
+  explicit UniqueFd(int fd) noexcept : fd_(fd) {}
+  ~UniqueFd() { reset(); }
+
+  UniqueFd(const UniqueFd &) = delete;
+  UniqueFd &operator=(const UniqueFd &) = delete;
+
+  UniqueFd(UniqueFd &&other) noexcept : fd_(other.release()) {}
+  UniqueFd &operator=(UniqueFd &&other) noexcept {
+    if (this != &other) {
+      reset(other.release());
+    }
+    return *this;
+  }
+
+  /// 获取描述符
+  [[nodiscard]] int get() const noexcept { return fd_; }
+
+  /// 检查是否持有有效描述符
+  [[nodiscard]] bool valid() const noexcept { return fd_ >= 0; }
+
+  /// 放弃所有权
+  [[nodiscard]] int release() noexcept {
+    int fd = fd_;
+    fd_ = -1;
+    return fd;
+  }
+
+  /// 关闭当前描述符并接管新的描述符
+  void reset(int fd = -1) noexcept;
+
+private:
+  int fd_{-1};
+};
+
+} // namespace czc
+
+#endif // CZC_COMMON_UNIQUE_FD_HPP
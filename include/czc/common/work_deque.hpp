@@ -0,0 +1,187 @@
+/**
+ * @file work_deque.hpp
+ * @brief Chase-Lev 工作窃取双端队列。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   TaskScheduler 的每个工作线程持有一个：
+ *   - 所有者在底部 push/pop（LIFO，缓存局部性好），无锁且通常无 CAS
+ *   - 其他线程在顶部 steal（FIFO，偷走最早、通常最大的任务）
+ *   - 容量不足时加倍扩容；旧数组保留到析构，窃取者无需回收协议
+ *
+ *   内存序按 Lê 等人《Correct and Efficient Work-Stealing for Weak
+ *   Memory Models》(PPoPP 2013) 给出的 C11 版本实现。
+ */
+
+#ifndef CZC_COMMON_WORK_DEQUE_HPP
+#define CZC_COMMON_WORK_DEQUE_HPP
+
+#include "czc/common/config.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace czc {
+
+/**
+ * @brief Chase-Lev 工作窃取队列。
+ *
+ * @tparam T 元素类型（以指针存储，队列不拥有元素）
+ *
+ * @note push/pop 只允许所有者线程调用；steal 可由任意线程调用。
+ */
+template <typename T> class WorkStealingDeque {
+public:
+  /**
+   * @brief 构造队列。
+   *
+   * @param capacity 初始容量（向上取整到 2 的幂）
+   */
+  explicit WorkStealingDeque(std::size_t capacity = 256) {
+    auto array = std::make_unique<Array>(
+        std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity));
+    array_.store(array.get(), std::memory_order_relaxed);
+    arrays_.push_back(std::move(array));
+  }
+
+  // 不可拷贝、不可移动（线程间共享）
+  WorkStealingDeque(const WorkStealingDeque &) = delete;
+  WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+  WorkStealingDeque(WorkStealingDeque &&) = delete;
+  WorkStealingDeque &operator=(WorkStealingDeque &&) = delete;
+
+  ~WorkStealingDeque() = default;
+
+  /**
+   * @brief 在底部压入元素（仅所有者）。
+   *
+   * @param item 元素指针
+   */
+  void push(T *item) {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t t = top_.load(std::memory_order_acquire);
+    Array *array = array_.load(std::memory_order_relaxed);
+    if (b - t > static_cast<std::int64_t>(array->capacity) - 1) {
+      array = grow(array, t, b);
+    }
+    array->put(b, item);
+    // 释放存储（而非独立的 release 屏障）：效果相同，且 TSan 能识别
+    bottom_.store(b + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief 从底部弹出元素（仅所有者）。
+   *
+   * @return 元素指针，队列为空时返回 nullptr
+   */
+  [[nodiscard]] T *pop() {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Array *array = array_.load(std::memory_order_relaxed);
+    // 窃取者可能读到 pop 写入的任何 bottom 值，每次写入都须发布此前的元素
+    bottom_.store(b, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      // 已为空
+      bottom_.store(b + 1, std::memory_order_release);
+      return nullptr;
+    }
+
+    T *item = array->get(b);
+    if (t == b) {
+      // 最后一个元素：与窃取者竞争
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      bottom_.store(b + 1, std::memory_order_release);
+    }
+    return item;
+  }
+
+  /**
+   * @brief 从顶部窃取元素（任意线程）。
+   *
+   * @return 元素指针；队列为空或与其他线程竞争失败时返回 nullptr
+   */
+  [[nodiscard]] T *steal() {
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+
+    Array *array = array_.load(std::memory_order_acquire);
+    T *item = array->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+
+  /// 近似元素数（并发修改时仅供参考）
+  [[nodiscard]] std::size_t sizeApprox() const noexcept {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t t = top_.load(std::memory_order_relaxed);
+    return b > t ? static_cast<std::size_t>(b - t) : 0;
+  }
+
+  /// 当前容量
+  [[nodiscard]] std::size_t capacity() const noexcept {
+    return array_.load(std::memory_order_relaxed)->capacity;
+  }
+
+private:
+  /**
+   * @brief 环形数组，索引对容量取模。
+   */
+  struct Array {
+    explicit Array(std::size_t cap)
+        : capacity(cap), mask(cap - 1),
+          slots(std::make_unique<std::atomic<T *>[]>(cap)) {}
+
+    T *get(std::int64_t i) const noexcept {
+      return slots[static_cast<std::size_t>(i) & mask].load(
+          std::memory_order_relaxed);
+    }
+
+    void put(std::int64_t i, T *item) noexcept {
+      slots[static_cast<std::size_t>(i) & mask].store(
+          item, std::memory_order_relaxed);
+    }
+
+    const std::size_t capacity;
+    const std::size_t mask;
+    std::unique_ptr<std::atomic<T *>[]> slots;
+  };
+
+  /// 容量加倍，复制 [top, bottom) 区间
+  Array *grow(Array *old, std::int64_t top, std::int64_t bottom) {
+    auto array = std::make_unique<Array>(old->capacity * 2);
+    for (std::int64_t i = top; i < bottom; ++i) {
+      array->put(i, old->get(i));
+    }
+    Array *raw = array.get();
+    arrays_.push_back(std::move(array));
+    array_.store(raw, std::memory_order_release);
+    return raw;
+  }
+
+  alignas(64) std::atomic<std::int64_t> top_{0};    ///< 窃取端索引
+  alignas(64) std::atomic<std::int64_t> bottom_{0}; ///< 所有者端索引
+  std::atomic<Array *> array_{nullptr};             ///< 当前数组
+  std::vector<std::unique_ptr<Array>> arrays_; ///< 当前及已退役的数组
+};
+
+} // namespace czc
+
+#endif // CZC_COMMON_WORK_DEQUE_HPP
@@ -0,0 +1,101 @@
+/**
+ * @file diag_buffer.hpp
+ * @brief 线程独占的诊断缓冲区。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   并行阶段中每个线程（或每个文件）持有一个 DiagBuffer，
+ *   追加诊断时不加锁；阶段屏障处由 DiagContext::merge 统一合并，
+ *   按 (文件, 偏移) 确定性排序后再去重、计数、发射。
+ *   每个缓冲区携带自己的 SourceLocator，互不覆盖。
+ */
+
+#ifndef CZC_DIAG_DIAG_BUFFER_HPP
+#define CZC_DIAG_DIAG_BUFFER_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/diag/diagnostic.hpp"
+#include "czc/diag/source_locator.hpp"
+
+#include <span>
+#include <vector>
+
+namespace czc::diag {
+
+class DiagContext;
+
+/// 诊断缓冲区 - 单线程独占，无锁追加
+class DiagBuffer {
+public:
+  /// 构造缓冲区
+  /// @param locator 合并发射时使用的源码定位器（可选，生命周期需覆盖 merge）
+  explicit DiagBuffer(const SourceLocator *locator = nullptr) noexcept
+      : locator_(locator) {}
+
+  ~DiagBuffer() = default;
+
+  // 不可拷贝，可移动
+  DiagBuffer(const DiagBuffer &) = delete;
+  auto operator=(const DiagBuffer &) -> DiagBuffer & = delete;
+  DiagBuffer(DiagBuffer &&) noexcept = default;
+  auto operator=(DiagBuffer &&) noexcept -> DiagBuffer & = default;
+
+  /// 追加诊断
+  void emit(Diagnostic diag) {
+    if (diag.isError()) {
+      ++errorCount_;
+    }
+    diagnostics_.push_back(std::move(diag));
+  }
+
+  /// 预留容量
+  void reserve(size_t n) { diagnostics_.reserve(n); }
+
+  /// 获取已缓冲的诊断
+  [[nodiscard]] auto diagnostics() const noexcept
+      -> std::span<const Diagnostic> {
+    return diagnostics_;
+  }
+
+  /// 获取已缓冲的诊断数量
+  [[nodiscard]] auto size() const noexcept -> size_t {
+    return diagnostics_.size();
+  }
+
+  /// 检查是否为空
+  [[nodiscard]] auto empty() const noexcept -> bool {
+    return diagnostics_.empty();
+  }
+
+  /// 获取本缓冲区中的错误数量（合并前，未去重）
+  [[nodiscard]] auto errorCount() const noexcept -> size_t {
+    return errorCount_;
+  }
+
+  /// 获取源码定位器
+  [[nodiscard]] auto locator() const noexcept -> const SourceLocator * {
+    return locator_;
+  }
+
+  /// 设置源码定位器
+  void setLocator(const SourceLocator *locator) noexcept { locator_ = locator; }
+
+  /// 清空缓冲区（保留容量）
+  void clear() noexcept {
+    diagnostics_.clear();
+    errorCount_ = 0;
+  }
+
+private:
+  friend class DiagContext;
+
+  const SourceLocator *locator_;
+  std::vector<Diagnostic> diagnostics_;
+  size_t errorCount_{0};
+};
+
+} // namespace czc::diag
+
+#endif // CZC_DIAG_DIAG_BUFFER_HPP
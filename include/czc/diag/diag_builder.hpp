@@ -47,25 +47,25 @@ public:
   auto span(Span s) -> DiagBuilder &;
 
   /// 设置带标签的 Span
-  auto spanLabel(Span s, std::string_view label) -> DiagBuilder &;
+  auto spanLabel(Span s, DiagString label) -> DiagBuilder &;
 
   /// 添加次要 Span
-  auto secondarySpan(Span s, std::string_view label = "") -> DiagBuilder &;
+  auto secondarySpan(Span s, DiagString label = {}) -> DiagBuilder &;
 
   /// 添加注释
-  auto note(std::string_view message) -> DiagBuilder &;
+  auto note(DiagString message) -> DiagBuilder &;
 
   /// 添加带位置的注释
-  auto note(Span s, std::string_view message) -> DiagBuilder &;
+  auto note(Span s, DiagString message) -> DiagBuilder &;
 
   /// 添加帮助信息
-  auto help(std::string_view message) -> DiagBuilder &;
+  auto help(DiagString message) -> DiagBuilder &;
 
   /// 添加带位置的帮助信息
-  auto help(Span s, std::string_view message) -> DiagBuilder &;
+  auto help(Span s, DiagString message) -> DiagBuilder &;
 
   /// 添加修复建议
-  auto suggestion(Span s, std::string replacement, std::string_view message,
+  auto suggestion(Span s, std::string replacement, DiagString message,
                   Applicability applicability = Applicability::Unspecified)
       -> DiagBuilder &;
 
@@ -13,6 +13,7 @@
 #define CZC_DIAG_DIAG_CONTEXT_HPP
 
 #include "czc/common/config.hpp"
+#include "czc/diag/diag_buffer.hpp"
 #include "czc/diag/diagnostic.hpp"
 #include "czc/diag/emitter.hpp"
 #include "czc/diag/error_guaranteed.hpp"
@@ -22,6 +23,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <span>
 
 namespace czc::diag {
 
@@ -29,8 +31,9 @@ class Emitter;
 
 /// 诊断配置
 struct DiagConfig {
-  bool deduplicate{true};            ///< 去重相同诊断
+  bool deduplicate{true};            ///< 去重同一位置的同类诊断
   size_t maxErrors{0};               ///< 最大错误数（0=无限）
+  size_t maxPerCode{0};              ///< 每个错误码最多输出数（0=无限）
   bool treatWarningsAsErrors{false}; ///< -Werror
   bool colorOutput{true};            ///< 彩色输出
 };
@@ -89,6 +92,16 @@ public:
   /// 发射简单注释
   void note(Message message);
 
+  // ========== 缓冲区合并 ==========
+
+  /// 合并单个线程缓冲区：按 (文件, 偏移) 排序后统一去重、计数、发射
+  /// 合并后缓冲区被清空
+  void merge(DiagBuffer &buffer);
+
+  /// 合并多个线程缓冲区（只加锁一次）
+  /// 排序键为 (文件, 偏移, 缓冲区下标, 缓冲区内序号)，结果与线程调度无关
+  void merge(std::span<DiagBuffer> buffers);
+
   // ========== 统计查询 ==========
 
   /// 获取错误数量
@@ -111,6 +124,9 @@ public:
 
   // ========== 配置 ==========
 
+  /// 替换发射器（先刷新旧发射器）
+  void setEmitter(std::unique_ptr<Emitter> emitter);
+
   /// 设置源码定位器
   void setLocator(const SourceLocator *locator);
 
@@ -132,12 +148,25 @@ public:
   /// 刷新输出
   void flush();
 
+  /// 清空统计、去重与限流状态（常驻进程在两次请求之间调用）
+  void reset();
+
 private:
   struct Impl;
   std::unique_ptr<Impl> impl_;
 
   /// 创建 ErrorGuaranteed
   [[nodiscard]] auto createErrorGuaranteed() -> ErrorGuaranteed;
+
+  /// 处理单条诊断（调用方需持有锁）
+  void processLocked(Diagnostic &diag, const SourceLocator *locator);
+
+  /// 应用 -Werror、去重、统计、按错误码限流与错误上限，
+  /// 返回是否应发射（调用方需持有锁）
+  [[nodiscard]] auto admitLocked(Diagnostic &diag) -> bool;
+
+  /// 汇总统计数据（调用方需持有锁）
+  [[nodiscard]] auto collectStatsLocked() const -> DiagnosticStats;
 };
 
 } // namespace czc::diag
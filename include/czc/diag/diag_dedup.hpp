@@ -0,0 +1,82 @@
+/**
+ * @file diag_dedup.hpp
+ * @brief 固定内存的诊断去重器。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   去重键为 (级别, 错误码, 文件, 起始偏移)，不读取消息文本。
+ *   由两部分组成，内存占用与已处理的诊断数无关：
+ *   - 分块布隆过滤器：每个键只访问一个 64 字节块，
+ *     绝大多数新诊断一次缓存行访问即可确认"未见过"
+ *   - 最近键窗口：固定容量的精确集合（环形缓冲区 + 开放寻址索引），
+ *     布隆过滤器报告"可能见过"时以它做最终判断
+ *
+ *   窗口淘汰的旧键可能被再次放行（重复输出一次），
+ *   但布隆过滤器的误判永远不会吞掉从未出现过的诊断。
+ */
+
+#ifndef CZC_DIAG_DIAG_DEDUP_HPP
+#define CZC_DIAG_DIAG_DEDUP_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/diag/diagnostic.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace czc::diag {
+
+/// 去重键
+struct DedupKey {
+  uint32_t fileId{0};
+  uint32_t offset{0};
+  uint32_t tag{0}; ///< 级别与错误码
+
+  auto operator<=>(const DedupKey &) const = default;
+};
+
+/// 诊断去重器（非线程安全，由 DiagContext 在锁内使用）
+class DiagDeduplicator {
+public:
+  /// 布隆过滤器块数（每块 512 位）
+  static constexpr size_t kBloomBlocks = 1024;
+
+  /// 每个键在块内设置的位数
+  static constexpr size_t kBloomHashes = 4;
+
+  /// 精确窗口容量
+  static constexpr size_t kRecentCapacity = 4096;
+
+  /// 布隆过滤器重建前允许的插入数（约 16 位/键）
+  static constexpr size_t kBloomBudget = kBloomBlocks * 512 / 16;
+
+  DiagDeduplicator();
+  ~DiagDeduplicator();
+
+  DiagDeduplicator(const DiagDeduplicator &) = delete;
+  auto operator=(const DiagDeduplicator &) -> DiagDeduplicator & = delete;
+  DiagDeduplicator(DiagDeduplicator &&) noexcept;
+  auto operator=(DiagDeduplicator &&) noexcept -> DiagDeduplicator &;
+
+  /// 提取诊断的去重键；无主要位置的诊断不参与去重
+  [[nodiscard]] static auto keyOf(const Diagnostic &diag) noexcept
+      -> std::optional<DedupKey>;
+
+  /// 记录键；此前（在窗口内）已出现过时返回 false
+  [[nodiscard]] auto insert(const DedupKey &key) noexcept -> bool;
+
+  /// 清空全部状态
+  void clear() noexcept;
+
+private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+} // namespace czc::diag
+
+#endif // CZC_DIAG_DIAG_DEDUP_HPP
@@ -0,0 +1,125 @@
+/**
+ * @file diag_string.hpp
+ * @brief 诊断文本与进程级字符串驻留。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   诊断中的标签、帮助与注释大多来自字面量或翻译目录，
+ *   内容在进程内反复出现。DiagString 可以：
+ *   - 借用生命周期覆盖整个进程的文本（字面量、内置目录、驻留池），不分配
+ *   - 持有动态文本（如含参数的格式化结果），行为与 std::string 相同
+ *
+ *   StringInterner 把运行时文本复制进只增不减的块存储，
+ *   返回的视图在进程结束前一直有效，适合取值集合有限的文本。
+ */
+
+#ifndef CZC_DIAG_DIAG_STRING_HPP
+#define CZC_DIAG_DIAG_STRING_HPP
+
+#include "czc/common/config.hpp"
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace czc::diag {
+
+/// 诊断文本：借用的静态视图或持有的动态字符串
+class DiagString {
+public:
+  DiagString() = default;
+
+  /// 持有动态文本
+  DiagString(std::string text) : owned_(std::move(text)) {}
+
+  /// 复制并持有文本
+  DiagString(std::string_view text) : owned_(text) {}
+
+  /// 复制并持有 C 字符串
+  DiagString(const char *text) : owned_(text != nullptr ? text : "") {}
+
+  /// 借用文本，调用方保证其生命周期覆盖整个进程
+  [[nodiscard]] static auto borrowed(std::string_view text) noexcept
+      -> DiagString {
+    DiagString result;
+    result.borrowed_ = text.data() != nullptr ? text : std::string_view("");
+    return result;
+  }
+
+  /// 驻留后借用（同一内容只复制一次）
+  [[nodiscard]] static auto interned(std::string_view text) -> DiagString;
+
+  /// 文本视图
+  [[nodiscard]] auto view() const noexcept -> std::string_view {
+    return borrowed_.data() != nullptr ? borrowed_ : std::string_view(owned_);
+  }
+
+  operator std::string_view() const noexcept { return view(); }
+
+  /// 复制为 std::string
+  [[nodiscard]] auto str() const -> std::string { return std::string(view()); }
+
+  [[nodiscard]] auto empty() const noexcept -> bool { return view().empty(); }
+  [[nodiscard]] auto size() const noexcept -> size_t { return view().size(); }
+  [[nodiscard]] auto data() const noexcept -> const char * {
+    return view().data();
+  }
+
+  /// 是否借用外部存储（不持有堆内存）
+  [[nodiscard]] auto isBorrowed() const noexcept -> bool {
+    return borrowed_.data() != nullptr;
+  }
+
+  friend auto operator==(const DiagString &lhs, std::string_view rhs) noexcept
+      -> bool {
+    return lhs.view() == rhs;
+  }
+
+private:
+  std::string owned_;
+  std::string_view borrowed_; ///< data() 非空表示借用
+};
+
+/// 进程级字符串驻留池 - 线程安全，读多写少
+class StringInterner {
+public:
+  /// 单个存储块的大小，更长的文本单独分配
+  static constexpr size_t kBlockSize = 16 * 1024;
+
+  /// 获取进程级实例
+  [[nodiscard]] static auto instance() -> StringInterner &;
+
+  StringInterner() = default;
+  ~StringInterner() = default;
+
+  // 不可拷贝、不可移动（已返回的视图指向内部存储）
+  StringInterner(const StringInterner &) = delete;
+  auto operator=(const StringInterner &) -> StringInterner & = delete;
+  StringInterner(StringInterner &&) = delete;
+  auto operator=(StringInterner &&) -> StringInterner & = delete;
+
+  /// 驻留文本，返回在本对象存活期间有效的视图
+  [[nodiscard]] auto intern(std::string_view text) -> std::string_view;
+
+  /// 已驻留的不同文本数
+  [[nodiscard]] auto size() const -> size_t;
+
+private:
+  /// 复制到块存储（调用方持有写锁）
+  auto store(std::string_view text) -> std::string_view;
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_set<std::string_view> strings_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char *cursor_{nullptr};
+  size_t remaining_{0};
+};
+
+} // namespace czc::diag
+
+#endif // CZC_DIAG_DIAG_STRING_HPP
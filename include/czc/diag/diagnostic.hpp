@@ -14,6 +14,8 @@
 #define CZC_DIAG_DIAGNOSTIC_HPP
 
 #include "czc/common/config.hpp"
+#include "czc/common/small_vector.hpp"
+#include "czc/diag/diag_string.hpp"
 #include "czc/diag/error_code.hpp"
 #include "czc/diag/message.hpp"
 #include "czc/diag/span.hpp"
@@ -49,14 +51,14 @@ enum class Applicability : uint8_t {
 struct Suggestion {
   Span span;               ///< 替换位置
   std::string replacement; ///< 替换文本
-  std::string message;     ///< 建议说明
+  DiagString message;      ///< 建议说明
   Applicability applicability{Applicability::Unspecified};
 
   /// 默认构造
   Suggestion() = default;
 
   /// 完整构造
-  Suggestion(Span s, std::string repl, std::string msg,
+  Suggestion(Span s, std::string repl, DiagString msg,
              Applicability app = Applicability::Unspecified)
       : span(s), replacement(std::move(repl)), message(std::move(msg)),
         applicability(app) {}
@@ -65,27 +67,31 @@ struct Suggestion {
 /// 子诊断（注释、帮助）
 struct SubDiagnostic {
   Level level{Level::Note}; ///< Note 或 Help
-  std::string message;      ///< 消息内容
+  DiagString message;       ///< 消息内容
   std::optional<Span> span; ///< 可选位置
 
   /// 默认构造
   SubDiagnostic() = default;
 
   /// 完整构造
-  SubDiagnostic(Level lvl, std::string msg,
+  SubDiagnostic(Level lvl, DiagString msg,
                 std::optional<Span> s = std::nullopt)
       : level(lvl), message(std::move(msg)), span(s) {}
 };
 
 /// 诊断 - 主要数据结构
 /// 借鉴 rustc DiagInner，但简化为不可变值类型
+/// 标注与子诊断的常见数量内联存放；文本可借用静态或驻留存储
 struct Diagnostic {
-  Level level{Level::Error};           ///< 诊断级别
-  Message message;                     ///< 主要消息
-  std::optional<ErrorCode> code;       ///< 错误码（可选）
-  MultiSpan spans;                     ///< 位置信息
-  std::vector<SubDiagnostic> children; ///< 子诊断
-  std::vector<Suggestion> suggestions; ///< 修复建议
+  /// 内联存放的子诊断数
+  static constexpr size_t kInlineChildren = 2;
+
+  Level level{Level::Error};     ///< 诊断级别
+  Message message;               ///< 主要消息
+  std::optional<ErrorCode> code; ///< 错误码（可选）
+  MultiSpan spans;               ///< 位置信息
+  SmallVector<SubDiagnostic, kInlineChildren> children; ///< 子诊断
+  std::vector<Suggestion> suggestions;                  ///< 修复建议
 
   /// 默认构造
   Diagnostic() = default;
@@ -17,7 +17,9 @@
 #include "czc/diag/diagnostic.hpp"
 #include "czc/diag/source_locator.hpp"
 
+#include <map>
 #include <set>
+#include <span>
 
 namespace czc::diag {
 
@@ -27,6 +29,7 @@ struct DiagnosticStats {
   size_t warningCount{0};               ///< 警告数量
   size_t noteCount{0};                  ///< 注释数量
   std::set<ErrorCode> uniqueErrorCodes; ///< 唯一错误码集合
+  std::map<ErrorCode, size_t> suppressedByCode; ///< 按错误码限流未输出的数量
 
   /// 检查是否有错误
   [[nodiscard]] auto hasErrors() const noexcept -> bool {
@@ -48,6 +51,14 @@ public:
   /// 发射单个诊断
   virtual void emit(const Diagnostic &diag, const SourceLocator *locator) = 0;
 
+  /// 批量发射共享同一定位器的诊断（默认逐个调用 emit）
+  virtual void emitBatch(std::span<const Diagnostic *const> diags,
+                         const SourceLocator *locator) {
+    for (const auto *diag : diags) {
+      emit(*diag, locator);
+    }
+  }
+
   /// 发射诊断总结信息
   /// @param stats 诊断统计数据
   virtual void emitSummary(const DiagnosticStats &stats) = 0;
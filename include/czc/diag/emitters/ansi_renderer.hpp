@@ -16,6 +16,7 @@
 #include "czc/diag/diagnostic.hpp"
 #include "czc/diag/source_locator.hpp"
 
+#include <span>
 #include <string>
 #include <string_view>
 
@@ -65,12 +66,31 @@ struct AnsiStyle {
     style.enabled = false;
     return style;
   }
+
+  /// 获取样式指纹（用于渲染缓存键）
+  [[nodiscard]] constexpr auto cacheKey() const noexcept -> uint64_t {
+    auto bits = [](AnsiColor c, int shift) {
+      return static_cast<uint64_t>(c) << shift;
+    };
+    return static_cast<uint64_t>(enabled) | bits(errorColor, 8) |
+           bits(warningColor, 16) | bits(noteColor, 24) |
+           bits(helpColor, 32) | bits(codeColor, 40) | bits(lineNumColor, 48);
+  }
 };
 
 /// ANSI 渲染器
 /// 将诊断渲染为带 ANSI 转义的字符串
 class AnsiRenderer {
 public:
+  /// 源码行超过该字节数时只渲染标注附近的窗口
+  static constexpr size_t kMaxSnippetLine = kLimits.maxLineLength;
+
+  /// 窗口中标注前后各保留的上下文字节数
+  static constexpr size_t kSnippetContext = 120;
+
+  /// 窗口中标注本身的最大字节数
+  static constexpr size_t kMaxSnippetSpan = 256;
+
   /// 构造渲染器
   explicit AnsiRenderer(AnsiStyle style = AnsiStyle::defaultStyle());
 
@@ -88,6 +108,18 @@ public:
                                       const SourceLocator *locator) const
       -> std::string;
 
+  /// 批量渲染诊断（输出保持输入顺序）
+  /// 主要位置按 (文件, 偏移) 排序后每个文件只做一次前向解析，
+  /// 同一行上的诊断共享已渲染的行号栏与源码行
+  [[nodiscard]] auto renderBatch(std::span<const Diagnostic *const> diags,
+                                 const SourceLocator *locator) const
+      -> std::string;
+
+  /// 批量渲染诊断
+  [[nodiscard]] auto renderBatch(std::span<const Diagnostic> diags,
+                                 const SourceLocator *locator) const
+      -> std::string;
+
   /// 渲染消息（简单 Markdown -> ANSI）
   [[nodiscard]] auto renderMessage(std::string_view msg) const -> std::string;
 
@@ -107,17 +139,32 @@ public:
   }
 
 private:
+  /// 已解析的主要位置
+  struct ResolvedLocation {
+    std::string_view filename;
+    LineColumn position;
+    std::string_view lineContent; ///< 为空时不渲染源码片段
+  };
+
   AnsiStyle style_;
 
-  /// 渲染源码片段
-  [[nodiscard]] auto renderSourceSnippet(const Diagnostic &diag,
-                                         const SourceLocator *locator) const
-      -> std::string;
+  /// 按已解析位置渲染诊断，fragment 为预先渲染的行号栏与源码行
+  void renderDiagnosticTo(std::string &out, const Diagnostic &diag,
+                          const ResolvedLocation *location,
+                          std::string_view fragment) const;
+
+  /// 渲染源码行片段："空白栏 / 行号 | 源码 / 标注栏前缀"
+  void renderLineFragment(std::string &out, uint32_t line,
+                          std::string_view content) const;
+
+  /// 渲染超长源码行：截取标注附近的窗口，两端以 "..." 标记省略
+  void renderWindowedSnippet(std::string &out, const LabeledSpan &span,
+                             const ResolvedLocation &location,
+                             AnsiColor color) const;
 
-  /// 渲染标注指示器
-  [[nodiscard]] auto renderAnnotation(const LabeledSpan &span,
-                                      uint32_t lineStartCol,
-                                      AnsiColor color) const -> std::string;
+  /// 渲染标注指示器（indent 个空格后接 width 个 ^ 与标签）
+  void renderAnnotation(std::string &out, const LabeledSpan &span,
+                        size_t indent, size_t width, AnsiColor color) const;
 };
 
 } // namespace czc::diag
@@ -0,0 +1,88 @@
+/**
+ * @file async_emitter.hpp
+ * @brief 异步多目标发射器。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   编译线程只负责渲染：每个子发射器写入池化的内存缓冲区，
+ *   渲染结果经 SPSC 队列交给后台写线程，由其聚集写入各输出目标。
+ *   慢终端或管道不再阻塞持有 DiagContext 锁的编译线程。
+ *
+ *   - 扇出：同一诊断同时渲染到多个目标（如终端 ANSI + JSON 文件）
+ *   - 共享：一次发射内各格式共用行列/行内容查询结果
+ *   - Fatal/Bug 级别诊断发射后立即同步刷新
+ *   - flush() 与析构保证所有已发射诊断写出
+ */
+
+#ifndef CZC_DIAG_EMITTERS_ASYNC_EMITTER_HPP
+#define CZC_DIAG_EMITTERS_ASYNC_EMITTER_HPP
+
+#include "czc/common/config.hpp"
+#include "czc/common/output_sink.hpp"
+#include "czc/diag/emitter.hpp"
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace czc::diag {
+
+/// 子发射器工厂：以 AsyncEmitter 提供的内存流构造具体格式的发射器
+using EmitterFactory =
+    std::function<std::unique_ptr<Emitter>(std::ostream &out)>;
+
+/// 异步发射目标
+struct AsyncSink {
+  EmitterFactory makeEmitter;              ///< 渲染格式
+  std::unique_ptr<OutputSink> destination; ///< 输出目标（由写线程独占写入）
+};
+
+/// 异步发射器 - 渲染与 I/O 分离
+/// @note emit/emitSummary/flush 需由调用方串行化（DiagContext 已在锁内调用）
+class AsyncEmitter final : public Emitter {
+public:
+  /// 默认队列深度（渲染块数量）
+  static constexpr size_t kDefaultQueueDepth = 256;
+
+  /// 构造异步发射器并启动写线程
+  /// @param sinks 输出目标列表
+  /// @param queueDepth 队列深度，队列满时编译线程阻塞（背压）
+  explicit AsyncEmitter(std::vector<AsyncSink> sinks,
+                        size_t queueDepth = kDefaultQueueDepth);
+
+  /// 析构：写出剩余诊断并停止写线程
+  ~AsyncEmitter() override;
+
+  // 禁止拷贝和移动（写线程持有内部状态）
+  AsyncEmitter(const AsyncEmitter &) = delete;
+  auto operator=(const AsyncEmitter &) -> AsyncEmitter & = delete;
+  AsyncEmitter(AsyncEmitter &&) = delete;
+  auto operator=(AsyncEmitter &&) -> AsyncEmitter & = delete;
+
+  /// 发射诊断（渲染后入队，不等待 I/O）
+  void emit(const Diagnostic &diag, const SourceLocator *locator) override;
+
+  /// 批量渲染到所有目标，再整体入队
+  void emitBatch(std::span<const Diagnostic *const> diags,
+                 const SourceLocator *locator) override;
+
+  /// 发射诊断总结信息
+  void emitSummary(const DiagnosticStats &stats) override;
+
+  /// 刷新：阻塞直到此前的全部输出已写入并刷新各目标
+  void flush() override;
+
+  /// 获取输出目标数量
+  [[nodiscard]] auto sinkCount() const noexcept -> size_t;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace czc::diag
+
+#endif // CZC_DIAG_EMITTERS_ASYNC_EMITTER_HPP
@@ -8,27 +8,39 @@
  * @details
  *   JSON 格式输出的发射器。
  *   借鉴 rustc JsonEmitter。
+ *
+ *   诊断逐条流式写入可复用的固定缓冲区，内存占用与诊断数量无关；
+ *   所有字符串字段（消息、文件名、标签、子诊断、建议）均完整转义。
  */
 
 #ifndef CZC_DIAG_EMITTERS_JSON_EMITTER_HPP
 #define CZC_DIAG_EMITTERS_JSON_EMITTER_HPP
 
 #include "czc/common/config.hpp"
+#include "czc/common/output_sink.hpp"
 #include "czc/diag/emitter.hpp"
 
+#include <memory>
 #include <ostream>
-#include <vector>
 
 namespace czc::diag {
 
+/// JSON 诊断输出格式
+enum class JsonDiagFormat : uint8_t {
+  Document, ///< 单个文档：{"diagnostics":[...],"stats":{...}}
+  Lines,    ///< JSON Lines：每行一个诊断，统计信息单独一行
+  Sarif,    ///< SARIF 2.1.0 日志
+};
+
 /// JSON 发射器 - 机器可读输出
 /// 借鉴 rustc JsonEmitter
 class JsonEmitter final : public Emitter {
 public:
   /// 构造 JSON 发射器
-  explicit JsonEmitter(std::ostream &out, bool pretty = false);
+  explicit JsonEmitter(std::ostream &out,
+                       JsonDiagFormat format = JsonDiagFormat::Document);
 
-  /// 析构函数
+  /// 析构函数（补全未闭合的文档并刷新）
   ~JsonEmitter() override;
 
   // 禁止拷贝，允许移动
@@ -40,29 +52,45 @@ public:
   /// 发射诊断
   void emit(const Diagnostic &diag, const SourceLocator *locator) override;
 
-  /// 发射诊断总结信息
+  /// 发射诊断总结信息（Document/SARIF 模式下闭合文档）
   void emitSummary(const DiagnosticStats &stats) override;
 
-  /// 刷新缓冲区（输出所有缓冲的诊断）
+  /// 刷新缓冲区
   void flush() override;
 
-  /// 设置是否美化输出
-  void setPretty(bool pretty) noexcept { pretty_ = pretty; }
+  /// 获取输出格式
+  [[nodiscard]] auto format() const noexcept -> JsonDiagFormat {
+    return format_;
+  }
 
 private:
-  std::ostream *out_;
-  bool pretty_;
+  std::unique_ptr<OutputSink> sink_;
+  JsonDiagFormat format_;
+  bool opened_{false};   ///< 文档头是否已写出
+  bool closed_{false};   ///< 文档是否已闭合
   bool firstDiag_{true}; ///< 是否是第一个诊断
 
-  /// 将诊断转换为 JSON 字符串
-  [[nodiscard]] auto diagnosticToJson(const Diagnostic &diag,
-                                      const SourceLocator *locator) const
-      -> std::string;
+  /// 写出文档头（Document/SARIF）
+  void openDocument();
+
+  /// 闭合文档（Document/SARIF）；stats 为空时不写统计
+  void closeDocument(const DiagnosticStats *stats);
+
+  /// 写出 czc 原生格式的诊断对象
+  void writeDiagnostic(const Diagnostic &diag, const SourceLocator *locator);
+
+  /// 写出 czc 原生格式的 Span 对象
+  void writeSpan(const Span &span, const SourceLocator *locator);
+
+  /// 写出 SARIF result 对象
+  void writeSarifResult(const Diagnostic &diag, const SourceLocator *locator);
+
+  /// 写出 SARIF location 对象
+  void writeSarifLocation(const Span &span, std::string_view message,
+                          const SourceLocator *locator);
 
-  /// 将 Span 转换为 JSON
-  [[nodiscard]] auto spanToJson(const Span &span,
-                                const SourceLocator *locator) const
-      -> std::string;
+  /// 写出统计对象
+  void writeStats(const DiagnosticStats &stats);
 };
 
 } // namespace czc::diag
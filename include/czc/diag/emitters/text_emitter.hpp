@@ -40,6 +40,10 @@ public:
   /// 发射诊断
   void emit(const Diagnostic &diag, const SourceLocator *locator) override;
 
+  /// 批量发射诊断（同一行上的诊断共享源码片段）
+  void emitBatch(std::span<const Diagnostic *const> diags,
+                 const SourceLocator *locator) override;
+
   /// 发射诊断总结信息
   void emitSummary(const DiagnosticStats &stats) override;
 
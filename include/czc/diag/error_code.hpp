@@ -8,6 +8,10 @@
  * @details
  *   借鉴 rustc 的 ErrCode 和 Registry 设计，实现编译时注册、运行时查询。
  *   错误码格式: [分类字母][4位数字]，如 L1001
+ *
+ *   内置错误码由各模块的 .def 列表（见 error_codes.def）在编译期生成
+ *   按错误码排序的常量表，查询是按分类的数组下标，无锁。
+ *   运行时注册仅供插件扩展使用。
  */
 
 #ifndef CZC_DIAG_ERROR_CODE_HPP
@@ -15,11 +19,13 @@
 
 #include "czc/common/config.hpp"
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -106,7 +112,15 @@ public:
   /// 获取全局单例
   [[nodiscard]] static auto instance() -> ErrorRegistry &;
 
-  /// 注册错误码
+  /// 查找内置错误码（编译期表，无锁），不存在时返回 nullptr
+  [[nodiscard]] static auto builtin(ErrorCode code) noexcept
+      -> const ErrorEntry *;
+
+  /// 获取全部内置错误码条目（按错误码排序）
+  [[nodiscard]] static auto builtinEntries() noexcept
+      -> std::span<const ErrorEntry>;
+
+  /// 运行时注册错误码（供插件使用，不覆盖内置错误码）
   void registerError(ErrorCode code, std::string_view brief,
                      std::string_view explanationKey);
 
@@ -130,6 +144,7 @@ private:
 
   mutable std::shared_mutex mutex_;
   std::unordered_map<ErrorCode, ErrorEntry, ErrorCodeHash> entries_;
+  std::atomic<bool> hasDynamic_{false}; ///< 无插件注册时跳过加锁
 };
 
 } // namespace czc::diag
@@ -145,7 +160,7 @@ private:
     ::czc::diag::ErrorCategory::CAT, CODE                                      \
   }
 
-/// 在源文件中注册错误码详情
+/// 在源文件中注册错误码详情（仅用于插件，内置错误码使用 .def 列表）
 /// 用法: CZC_REGISTER_ERROR(kMissingHexDigits, "brief", "i18n.key")
 #define CZC_REGISTER_ERROR(NAME, BRIEF, EXPLANATION_KEY)                       \
   static const bool kRegistered_##NAME = [] {                                  \
@@ -7,7 +7,8 @@
  *
  * @details
  *   借鉴 rustc Fluent 翻译系统设计，使用 TOML 格式存储翻译。
- *   利用已有的 tomlplusplus 库。
+ *   resources/i18n/ 下的翻译在构建期编译为内置目录（见 i18n_catalog.hpp），
+ *   运行时加载的 TOML（tomlplusplus 解析）仅作为覆盖层。
  */
 
 #ifndef CZC_DIAG_I18N_HPP
@@ -16,12 +17,17 @@
 #include "czc/common/config.hpp"
 #include "czc/diag/error_code.hpp"
 #include "czc/diag/message.hpp"
+#include "czc/diag/message_template.hpp"
 
+#include <array>
+#include <atomic>
+#include <charconv>
 #include <filesystem>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
-#include <unordered_map>
+#include <vector>
 
 namespace czc::diag::i18n {
 
@@ -42,6 +48,11 @@ enum class Locale : uint8_t {
 /// 翻译器
 /// 借鉴 rustc Translator 设计，支持回退机制
 /// 通过依赖注入方式使用，由 DiagContext 持有实例
+///
+/// 查找顺序：运行时覆盖层 -> 当前语言内置目录 -> 英文内置目录。
+/// 查找无锁且不分配；覆盖层每次加载发布一张新的不可变表。
+/// 已返回的视图在其后第二次加载覆盖层之前有效（上一张表总会保留），
+/// 更早的表在没有进行中的查找时释放，反复加载不会累积内存。
 class Translator {
 public:
   /// 默认构造函数
@@ -53,30 +64,56 @@ public:
   /// 获取当前语言
   [[nodiscard]] auto currentLocale() const noexcept -> Locale;
 
-  /// 加载翻译文件
+  /// 获取翻译状态代号
+  /// 语言切换、加载覆盖层或赋值后更新，且在进程内唯一；
+  /// 调用方可据此缓存查找结果，代号不变时已取得的视图仍然有效
+  [[nodiscard]] auto generation() const noexcept -> uint64_t;
+
+  /// 加载翻译文件（作为覆盖层）
   [[nodiscard]] auto loadFromFile(const std::filesystem::path &path) -> bool;
 
-  /// 从内存加载翻译（TOML 格式）
+  /// 从内存加载翻译（TOML 格式，作为覆盖层）
   void loadFromMemory(std::string_view toml);
 
   /// 获取翻译（带回退到英文）
   [[nodiscard]] auto get(std::string_view key) const -> std::string_view;
 
+  /// 获取预编译的消息模板（带回退到英文，不存在时返回空模板）
+  [[nodiscard]] auto getTemplate(std::string_view key) const
+      -> MessageTemplate;
+
+  /// 格式化翻译并追加到 out；键不存在时追加键本身
+  template <typename... Args>
+  void formatTo(std::string &out, std::string_view key, Args &&...args) const {
+    auto tmpl = getTemplate(key);
+    if (tmpl.empty()) {
+      out.append(key);
+      return;
+    }
+    [[maybe_unused]] std::array<ArgBuffer, sizeof...(Args)> buffers{};
+    [[maybe_unused]] size_t slot = 0;
+    // 花括号初始化保证从左到右求值
+    const std::array<std::string_view, sizeof...(Args)> views{
+        toView(std::forward<Args>(args), buffers[slot++])...};
+    tmpl.formatTo(out, views);
+  }
+
   /// 获取翻译并格式化
   template <typename... Args>
   [[nodiscard]] auto get(std::string_view key, Args &&...args) const
       -> std::string {
-    auto tmpl = get(key);
-    if (tmpl.empty()) {
-      return std::string(key);
-    }
-    return formatWithArgs(tmpl, std::forward<Args>(args)...);
+    std::string out;
+    formatTo(out, key, std::forward<Args>(args)...);
+    return out;
   }
 
   /// 获取翻译或使用默认值
   [[nodiscard]] auto getOr(std::string_view key,
                            std::string_view fallback) const -> std::string_view;
 
+  /// 当前保留的覆盖表数（用于测试）
+  [[nodiscard]] auto retainedTables() const -> size_t;
+
   /// 获取错误的简短描述
   [[nodiscard]] auto getErrorBrief(ErrorCode code) const -> std::string_view;
 
@@ -94,40 +131,46 @@ public:
   ~Translator() = default;
 
 private:
-  /// 格式化辅助函数
-  template <typename... Args>
-  auto formatWithArgs(std::string_view tmpl, Args &&...args) const
-      -> std::string {
-    // 简单的占位符替换 {0}, {1}, ...
-    return formatPlaceholders(tmpl, std::initializer_list<std::string>{
-                                        toString(std::forward<Args>(args))...});
-  }
-
-  /// 转换参数为字符串
-  template <typename T> static auto toString(T &&value) -> std::string {
-    if constexpr (std::is_same_v<std::decay_t<T>, std::string>) {
-      return std::forward<T>(value);
-    } else if constexpr (std::is_same_v<std::decay_t<T>, std::string_view>) {
-      return std::string(value);
-    } else if constexpr (std::is_same_v<std::decay_t<T>, const char *>) {
-      return std::string(value);
-    } else if constexpr (std::is_arithmetic_v<std::decay_t<T>>) {
-      return std::to_string(value);
+  /// 数值参数的栈上转换缓冲区
+  using ArgBuffer = std::array<char, 32>;
+
+  /// 将参数转换为字符串视图（数值写入 buffer，不分配）
+  template <typename T>
+  static auto toView(T &&value, ArgBuffer &buffer) -> std::string_view {
+    using D = std::decay_t<T>;
+    if constexpr (std::is_convertible_v<T, std::string_view>) {
+      return std::string_view(value);
+    } else if constexpr (std::is_same_v<D, bool>) {
+      return value ? "1" : "0";
+    } else if constexpr (std::is_arithmetic_v<D>) {
+      // char 按数值输出；浮点数使用最短往返表示
+      using V = std::conditional_t<std::is_integral_v<D>,
+                                   std::common_type_t<D, int>, D>;
+      auto [end, ec] = std::to_chars(buffer.data(),
+                                     buffer.data() + buffer.size(),
+                                     static_cast<V>(value));
+      (void)ec; // 缓冲区足够容纳任意整数与最短浮点表示
+      return {buffer.data(), static_cast<size_t>(end - buffer.data())};
     } else {
       return "<unknown>";
     }
   }
 
-  /// 替换占位符
-  [[nodiscard]] auto
-  formatPlaceholders(std::string_view tmpl,
-                     std::initializer_list<std::string> args) const
-      -> std::string;
+  /// 运行时覆盖表（发布后不可变）
+  struct OverrideTable;
+
+  /// 最多保留的覆盖表数：当前表与上一张表
+  static constexpr size_t kRetainedTables = 2;
+
+  /// 分配新的全局唯一状态代号
+  static auto nextGeneration() noexcept -> uint64_t;
 
-  mutable std::mutex mutex_;
-  Locale locale_{Locale::En};
-  std::unordered_map<std::string, std::string> translations_;
-  std::unordered_map<std::string, std::string> fallback_; ///< 英文回退
+  mutable std::mutex mutex_; ///< 仅串行化覆盖层的写入
+  std::atomic<Locale> locale_{Locale::En};
+  std::atomic<const OverrideTable *> overrides_{nullptr};
+  std::vector<std::shared_ptr<const OverrideTable>> retained_; ///< 已发布的表
+  mutable std::atomic<uint32_t> readers_{0}; ///< 进行中的覆盖层查找数
+  std::atomic<uint64_t> generation_{nextGeneration()};
 };
 
 /// RAII 临时语言切换
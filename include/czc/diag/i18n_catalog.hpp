@@ -0,0 +1,86 @@
+/**
+ * @file i18n_catalog.hpp
+ * @brief 构建期生成的内置翻译目录。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   resources/i18n/ 下的 TOML 翻译文件在构建时由 czc_i18n_gen 编译为
+ *   按键排序的常量表，随二进制一起发布：
+ *   - 启动时无需文件 I/O 与 TOML 解析
+ *   - 表为常量初始化，生命周期覆盖整个进程，查找无锁、无分配
+ *   - 含 `{N}` 占位符的条目同时带有预编译的模板片段
+ */
+
+#ifndef CZC_DIAG_I18N_CATALOG_HPP
+#define CZC_DIAG_I18N_CATALOG_HPP
+
+#include "czc/diag/i18n.hpp"
+#include "czc/diag/message_template.hpp"
+
+#include <algorithm>
+#include <span>
+#include <string_view>
+
+namespace czc::diag::i18n {
+
+/// 目录条目（键为扁平化的点分路径，如 "E0001.message"）
+struct CatalogEntry {
+  std::string_view key;
+  std::string_view value;
+  std::span<const TemplateSegment> segments{}; ///< 无占位符时为空
+
+  /// 以模板视图访问条目值
+  [[nodiscard]] constexpr auto asTemplate() const noexcept -> MessageTemplate {
+    return {value, segments};
+  }
+};
+
+/// 只读翻译目录，条目按键的字节序排列
+class Catalog {
+public:
+  constexpr explicit Catalog(std::span<const CatalogEntry> entries) noexcept
+      : entries_(entries) {}
+
+  /// 二分查找条目，不存在时返回 nullptr
+  [[nodiscard]] constexpr auto findEntry(std::string_view key) const noexcept
+      -> const CatalogEntry * {
+    auto it = std::lower_bound(
+        entries_.begin(), entries_.end(), key,
+        [](const CatalogEntry &e, std::string_view k) { return e.key < k; });
+    if (it != entries_.end() && it->key == key) {
+      return &*it;
+    }
+    return nullptr;
+  }
+
+  /// 二分查找翻译，不存在时返回空视图
+  [[nodiscard]] constexpr auto find(std::string_view key) const noexcept
+      -> std::string_view {
+    const auto *entry = findEntry(key);
+    return entry != nullptr ? entry->value : std::string_view{};
+  }
+
+  /// 获取全部条目
+  [[nodiscard]] constexpr auto entries() const noexcept
+      -> std::span<const CatalogEntry> {
+    return entries_;
+  }
+
+  /// 获取条目数
+  [[nodiscard]] constexpr auto size() const noexcept -> size_t {
+    return entries_.size();
+  }
+
+private:
+  std::span<const CatalogEntry> entries_;
+};
+
+/// 获取指定语言的内置目录，未内置该语言时返回 nullptr
+/// @note 定义位于构建期生成的 i18n_catalogs.cpp
+[[nodiscard]] auto builtinCatalog(Locale locale) noexcept -> const Catalog *;
+
+} // namespace czc::diag::i18n
+
+#endif // CZC_DIAG_I18N_CATALOG_HPP
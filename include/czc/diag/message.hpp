@@ -14,6 +14,7 @@
 #define CZC_DIAG_MESSAGE_HPP
 
 #include "czc/common/config.hpp"
+#include "czc/diag/diag_string.hpp"
 
 #include <format>
 #include <memory>
@@ -58,6 +59,12 @@ public:
   Message(Message &&other) noexcept;
   auto operator=(Message &&other) noexcept -> Message &;
 
+  /// 借用静态文本构造（不复制），调用方保证其生命周期覆盖整个进程
+  [[nodiscard]] static auto fromStatic(std::string_view markdown) -> Message;
+
+  /// 驻留后借用（同一文本在进程内只复制一次）
+  [[nodiscard]] static auto interned(std::string_view markdown) -> Message;
+
   /// 格式化构造（使用 std::format）
   template <typename... Args>
   [[nodiscard]] static auto format(std::format_string<Args...> fmt,
@@ -81,7 +88,7 @@ public:
   [[nodiscard]] auto isEmpty() const noexcept -> bool;
 
 private:
-  std::string markdown_;
+  DiagString markdown_;
   mutable std::optional<std::string> cachedPlain_; ///< 延迟计算缓存
 };
 
@@ -0,0 +1,110 @@
+/**
+ * @file message_template.hpp
+ * @brief 预编译的翻译消息模板。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   翻译文本中的 `{N}` 占位符只在编译期（内置目录）或加载时（覆盖层）
+ *   解析一次，得到"字面量 + 参数槽"的片段序列。
+ *   格式化时按片段顺序追加到调用方缓冲区，不再查找与替换。
+ */
+
+#ifndef CZC_DIAG_MESSAGE_TEMPLATE_HPP
+#define CZC_DIAG_MESSAGE_TEMPLATE_HPP
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace czc::diag::i18n {
+
+/// 片段不带参数槽
+inline constexpr int32_t kNoArg = -1;
+
+/// 模板片段：一段字面量，后跟可选的参数槽
+struct TemplateSegment {
+  uint32_t offset{0};  ///< 字面量在模板文本中的起始偏移
+  uint32_t length{0};  ///< 字面量长度
+  int32_t arg{kNoArg}; ///< 字面量之后的参数序号
+};
+
+/// 按顺序枚举模板片段；不含占位符时不调用回调
+/// @note 仅识别 `{0}`、`{12}` 这类无前导零的十进制序号
+template <typename F>
+constexpr void forEachSegment(std::string_view text, F &&onSegment) {
+  uint32_t literalStart = 0;
+  bool found = false;
+  size_t pos = 0;
+  while ((pos = text.find('{', pos)) != std::string_view::npos) {
+    size_t digits = pos + 1;
+    int32_t index = 0;
+    while (digits < text.size() && text[digits] >= '0' &&
+           text[digits] <= '9' && digits - pos <= 9) {
+      index = index * 10 + (text[digits] - '0');
+      ++digits;
+    }
+    size_t count = digits - pos - 1;
+    bool valid = count > 0 && digits < text.size() && text[digits] == '}' &&
+                 (count == 1 || text[pos + 1] != '0');
+    if (!valid) {
+      ++pos;
+      continue;
+    }
+    onSegment(TemplateSegment{literalStart,
+                              static_cast<uint32_t>(pos - literalStart),
+                              index});
+    found = true;
+    pos = digits + 1;
+    literalStart = static_cast<uint32_t>(pos);
+  }
+  if (found && literalStart < text.size()) {
+    onSegment(TemplateSegment{
+        literalStart, static_cast<uint32_t>(text.size() - literalStart),
+        kNoArg});
+  }
+}
+
+/// 将模板文本编译为片段序列（不含占位符时返回空序列）
+[[nodiscard]] auto compileTemplate(std::string_view text)
+    -> std::vector<TemplateSegment>;
+
+/// 已编译模板的只读视图（文本与片段均由目录持有）
+class MessageTemplate {
+public:
+  constexpr MessageTemplate() = default;
+
+  constexpr MessageTemplate(std::string_view text,
+                            std::span<const TemplateSegment> segments) noexcept
+      : text_(text), segments_(segments) {}
+
+  /// 原始模板文本
+  [[nodiscard]] constexpr auto text() const noexcept -> std::string_view {
+    return text_;
+  }
+
+  /// 是否为空模板（键不存在）
+  [[nodiscard]] constexpr auto empty() const noexcept -> bool {
+    return text_.empty();
+  }
+
+  /// 是否包含参数槽
+  [[nodiscard]] constexpr auto hasPlaceholders() const noexcept -> bool {
+    return !segments_.empty();
+  }
+
+  /// 按片段追加到 out；超出参数个数的槽位原样保留为 `{N}`
+  void formatTo(std::string &out,
+                std::span<const std::string_view> args) const;
+
+private:
+  std::string_view text_;
+  std::span<const TemplateSegment> segments_;
+};
+
+} // namespace czc::diag::i18n
+
+#endif // CZC_DIAG_MESSAGE_TEMPLATE_HPP
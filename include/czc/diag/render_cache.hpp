@@ -0,0 +1,135 @@
+/**
+ * @file render_cache.hpp
+ * @brief 消息渲染快速路径与进程级渲染缓存。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   大部分诊断消息（如 "unterminated string literal"）不含任何 Markdown
+ *   语法，经 cmark 解析后输出与输入相同。needsMarkdown() 以单次字节扫描
+ *   识别这类文本，直接跳过 cmark。
+ *
+ *   需要 cmark 的文本（如 i18n 帮助信息）在进程内按
+ *   (文本, 目标格式, 样式) 缓存渲染结果，相同模板只解析一次。
+ */
+
+#ifndef CZC_DIAG_RENDER_CACHE_HPP
+#define CZC_DIAG_RENDER_CACHE_HPP
+
+#include "czc/common/config.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace czc::diag {
+
+/// 检查文本是否可能包含 Markdown 语法（保守判断）
+/// @return false 表示 cmark 渲染结果必然与原文相同
+[[nodiscard]] auto needsMarkdown(std::string_view text) noexcept -> bool;
+
+/// 渲染目标格式
+enum class RenderTarget : uint8_t {
+  PlainText, ///< 纯文本
+  Html,      ///< HTML
+  Ansi,      ///< ANSI 终端
+};
+
+/// 渲染结果缓存 - 线程安全，读多写少
+class RenderCache {
+public:
+  /// 缓存条目上限，超出时整体清空
+  static constexpr size_t kMaxEntries = 4096;
+
+  /// 可缓存文本的最大长度（更长的文本通常是一次性消息）
+  static constexpr size_t kMaxTextLength = 1024;
+
+  /// 获取进程级实例
+  [[nodiscard]] static auto instance() -> RenderCache &;
+
+  RenderCache() = default;
+  ~RenderCache() = default;
+
+  // 不可拷贝、不可移动
+  RenderCache(const RenderCache &) = delete;
+  auto operator=(const RenderCache &) -> RenderCache & = delete;
+  RenderCache(RenderCache &&) = delete;
+  auto operator=(RenderCache &&) -> RenderCache & = delete;
+
+  /// 查找缓存，未命中时调用 render 计算并插入
+  /// @param text 原始 Markdown 文本
+  /// @param target 目标格式
+  /// @param style 样式键（仅 ANSI 使用，其余为 0）
+  /// @param render 渲染函数
+  [[nodiscard]] auto
+  getOrRender(std::string_view text, RenderTarget target, uint64_t style,
+              const std::function<std::string(std::string_view)> &render)
+      -> std::string;
+
+  /// 获取条目数量
+  [[nodiscard]] auto size() const -> size_t;
+
+  /// 获取命中次数
+  [[nodiscard]] auto hits() const noexcept -> size_t {
+    return hits_.load(std::memory_order_relaxed);
+  }
+
+  /// 获取未命中次数
+  [[nodiscard]] auto misses() const noexcept -> size_t {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+  /// 清空缓存和计数
+  void clear();
+
+private:
+  /// 缓存键：文本哈希与格式、样式组合，文本本身用于消除哈希冲突
+  struct Key {
+    std::string text;
+    RenderTarget target;
+    uint64_t style;
+  };
+
+  /// 查找用键视图（避免查找时分配）
+  struct KeyView {
+    std::string_view text;
+    RenderTarget target;
+    uint64_t style;
+  };
+
+  struct KeyHash {
+    using is_transparent = void;
+    auto operator()(const KeyView &key) const noexcept -> size_t;
+    auto operator()(const Key &key) const noexcept -> size_t {
+      return (*this)(KeyView{key.text, key.target, key.style});
+    }
+  };
+
+  struct KeyEqual {
+    using is_transparent = void;
+    static auto view(const Key &key) noexcept -> KeyView {
+      return {key.text, key.target, key.style};
+    }
+    static auto view(const KeyView &key) noexcept -> KeyView { return key; }
+    template <typename A, typename B>
+    auto operator()(const A &a, const B &b) const noexcept -> bool {
+      auto x = view(a);
+      auto y = view(b);
+      return x.target == y.target && x.style == y.style && x.text == y.text;
+    }
+  };
+
+  std::unordered_map<Key, std::string, KeyHash, KeyEqual> entries_;
+  mutable std::shared_mutex mutex_;
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+};
+
+} // namespace czc::diag
+
+#endif // CZC_DIAG_RENDER_CACHE_HPP
@@ -17,6 +17,7 @@
 #include "czc/diag/span.hpp"
 
 #include <cstdint>
+#include <span>
 #include <string_view>
 
 namespace czc::diag {
@@ -56,6 +57,16 @@ public:
   [[nodiscard]] virtual auto getSourceSlice(Span span) const
       -> std::string_view = 0;
 
+  /// 批量偏移量转行列，offsets 须按升序排列
+  /// 默认逐个调用 getLineColumn；实现可覆盖为单次前向扫描
+  virtual void resolveSorted(uint32_t fileId,
+                             std::span<const uint32_t> offsets,
+                             std::span<LineColumn> out) const {
+    for (size_t i = 0; i < offsets.size(); ++i) {
+      out[i] = getLineColumn(fileId, offsets[i]);
+    }
+  }
+
 protected:
   SourceLocator() = default;
   SourceLocator(const SourceLocator &) = default;
@@ -14,6 +14,8 @@
 #define CZC_DIAG_SPAN_HPP
 
 #include "czc/common/config.hpp"
+#include "czc/common/small_vector.hpp"
+#include "czc/diag/diag_string.hpp"
 
 #include <cstdint>
 #include <optional>
@@ -74,21 +76,25 @@ struct Span {
 /// 带标签的位置 - 用于诊断标注
 struct LabeledSpan {
   Span span;            ///< 位置范围
-  std::string label;    ///< 标注文本
+  DiagString label;     ///< 标注文本
   bool isPrimary{true}; ///< 是否为主要位置
 
   /// 默认构造
   LabeledSpan() = default;
 
   /// 构造带标签的 Span
-  LabeledSpan(Span s, std::string_view lbl, bool primary = true)
-      : span(s), label(lbl), isPrimary(primary) {}
+  LabeledSpan(Span s, DiagString lbl, bool primary = true)
+      : span(s), label(std::move(lbl)), isPrimary(primary) {}
 };
 
 /// 多位置容器 - 支持主要和次要标注
 /// 借鉴 rustc MultiSpan 设计
+/// 前两个标注内联存放，常见诊断无需堆分配
 class MultiSpan {
 public:
+  /// 内联存放的标注数
+  static constexpr size_t kInlineSpans = 2;
+
   MultiSpan() = default;
   ~MultiSpan() = default;
 
@@ -99,16 +105,16 @@ public:
   auto operator=(MultiSpan &&) noexcept -> MultiSpan & = default;
 
   /// 添加主要标注
-  void addPrimary(Span span, std::string_view label = "");
+  void addPrimary(Span span, DiagString label = {});
 
   /// 添加次要标注
-  void addSecondary(Span span, std::string_view label = "");
+  void addSecondary(Span span, DiagString label = {});
 
-  /// 获取主要标注（第一个）
-  [[nodiscard]] auto primary() const -> std::optional<LabeledSpan>;
+  /// 获取主要标注（第一个），不存在时返回 nullptr
+  [[nodiscard]] auto primary() const noexcept -> const LabeledSpan *;
 
   /// 获取所有标注
-  [[nodiscard]] auto spans() const -> std::span<const LabeledSpan> {
+  [[nodiscard]] auto spans() const noexcept -> std::span<const LabeledSpan> {
     return spans_;
   }
 
@@ -122,7 +128,7 @@ public:
   [[nodiscard]] auto size() const noexcept -> size_t { return spans_.size(); }
 
 private:
-  std::vector<LabeledSpan> spans_;
+  SmallVector<LabeledSpan, kInlineSpans> spans_;
 };
 
 } // namespace czc::diag
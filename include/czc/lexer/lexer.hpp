@@ -110,6 +110,18 @@ public:
    */
   [[nodiscard]] std::vector<Token> tokenizeWithTrivia();
 
+  /**
+   * @brief 从缓冲区中间的指定偏移继续词法分析。
+   *
+   * @details
+   *   用于增量重新分析：调用方保证 offset 位于某个 Token 的起始处
+   *   （不在字符串或注释内部），此时从该处开始的结果与整体分析一致。
+   *   行列号按 SourceManager 的行偏移表重新计算。
+   *
+   * @param offset 起始字节偏移
+   */
+  void resumeAt(std::size_t offset);
+
   /**
    * @brief 获取所有错误。
    *
@@ -7,12 +7,14 @@
  *
  * @details
  *   将 SourceManager 适配为 diag::SourceLocator 接口。
+ *   查询全部为只读访问，同一实例可被多个阶段与线程共享。
  *   提供 LexerError 到 Diagnostic 的转换函数。
  */
 
 #ifndef CZC_LEXER_LEXER_SOURCE_LOCATOR_HPP
 #define CZC_LEXER_LEXER_SOURCE_LOCATOR_HPP
 
+#include "czc/diag/diag_buffer.hpp"
 #include "czc/diag/diag_context.hpp"
 #include "czc/diag/diagnostic.hpp"
 #include "czc/diag/i18n.hpp"
@@ -57,6 +59,10 @@ public:
   [[nodiscard]] auto getSourceSlice(diag::Span span) const
       -> std::string_view override;
 
+  /// 沿行偏移表单次前向扫描解析一组升序偏移
+  void resolveSorted(uint32_t fileId, std::span<const uint32_t> offsets,
+                     std::span<diag::LineColumn> out) const override;
+
 private:
   const SourceManager *sm_;
 };
@@ -66,6 +72,7 @@ private:
 // ============================================================================
 
 /// 将 LexerError 转换为 Diagnostic
+/// 标签与帮助文本取自按 translator 状态预先解析的模板
 /// @param err 词法错误
 /// @param sm 源码管理器
 /// @param translator 翻译器（用于 i18n 标签和帮助信息）
@@ -76,7 +83,17 @@ private:
 /// 从 LexerError 提取 Span
 [[nodiscard]] auto toSpan(const LexerError &err) -> diag::Span;
 
-/// 批量发射 Lexer 错误
+/// 将一组 LexerError 转换为诊断并追加到 buffer
+/// 整批只解析一次模板，逐条仅复制消息与标注文本
+void appendDiagnostics(diag::DiagBuffer &buffer,
+                       std::span<const LexerError> errors,
+                       const diag::i18n::Translator &translator);
+
+/// 批量发射 Lexer 错误，使用调用方持有的长期定位器（如 CompilerContext 的）
+void emitLexerErrors(diag::DiagContext &dcx, std::span<const LexerError> errors,
+                     const diag::SourceLocator &locator);
+
+/// 批量发射 Lexer 错误，仅在本次合并期间使用临时定位器
 void emitLexerErrors(diag::DiagContext &dcx, std::span<const LexerError> errors,
                      const SourceManager &sm, BufferID bufferId);
 
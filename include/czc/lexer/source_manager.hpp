@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <functional>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -82,6 +83,18 @@ struct [[maybe_unused]] ExpansionID {
   }
 };
 
+/**
+ * @brief 列号的计量单位。
+ *
+ * @details
+ *   列号均为 0-based：从行首到目标偏移之间的单位数。
+ */
+enum class ColumnUnit : std::uint8_t {
+  Byte,      ///< UTF-8 字节
+  Utf16,     ///< UTF-16 码元（LSP 默认的位置编码）
+  CodePoint, ///< Unicode 码点（等于 SourceLocation::column - 1）
+};
+
 /**
  * @brief 源码生命周期管理器。
  *
@@ -90,6 +103,10 @@ struct [[maybe_unused]] ExpansionID {
  *   Token 仅存储 BufferID + 偏移量，通过 SourceManager 获取实际文本。
  *   只要 SourceManager 存活，Token 就永远有效。
  *
+ *   行偏移表与列号换算索引在加入缓冲区时一次构建，之后所有 const 查询
+ *   都不修改状态，
+ *   可被多个线程并发调用；添加缓冲区须与这些查询串行（happens-before）。
+ *
  * @note 不可拷贝，可移动
  */
 class SourceManager {
@@ -115,6 +132,21 @@ public:
    */
   [[nodiscard]] BufferID addBuffer(std::string source, std::string filename);
 
+  /**
+   * @brief 添加源码缓冲区，使用调用方已计算的内容哈希。
+   *
+   * @details
+   *   调用方为比较内容已计算过 czc::hashBytes(source) 时使用，
+   *   避免对同一内容重复哈希。
+   *
+   * @param source 源码内容（移动）
+   * @param filename 文件名
+   * @param contentHash 内容哈希，须等于 czc::hashBytes(source)
+   * @return 新分配的 BufferID
+   */
+  [[nodiscard]] BufferID addBuffer(std::string source, std::string filename,
+                                   std::uint64_t contentHash);
+
   /**
    * @brief 添加源码缓冲区（拷贝 string_view）。
    *
@@ -148,7 +180,7 @@ public:
    *          只要 SourceManager 实例存活，返回值就有效。
    */
   [[nodiscard]] std::string_view slice(BufferID id, std::uint32_t offset,
-                                       std::uint16_t length) const;
+                                       std::uint32_t length) const;
 
   /**
    * @brief 获取文件名。
@@ -160,6 +192,18 @@ public:
    */
   [[nodiscard]] std::string_view getFilename(BufferID id) const;
 
+  /**
+   * @brief 获取缓冲区内容的哈希值。
+   *
+   * @details
+   *   加入缓冲区时计算（czc::hashBytes），内容相同的缓冲区哈希值相同，
+   *   用作增量计算的内容指纹。
+   *
+   * @param id 缓冲区 ID
+   * @return 64 位内容哈希，若 ID 无效则返回 0
+   */
+  [[nodiscard]] std::uint64_t contentHash(BufferID id) const noexcept;
+
   /**
    * @brief 获取指定行的内容。
    *
@@ -172,6 +216,104 @@ public:
   [[nodiscard]] std::string_view getLineContent(BufferID id,
                                                 std::uint32_t lineNum) const;
 
+  /**
+   * @brief 将字节偏移转换为行号。
+   *
+   * @details
+   *   在惰性构建的行偏移表上二分查找，O(log 行数)。
+   *
+   * @param id 缓冲区 ID
+   * @param offset 字节偏移（允许等于源码长度）
+   * @return 1-based 行号，若参数无效则返回 0
+   */
+  [[nodiscard]] std::uint32_t getLineNumber(BufferID id,
+                                            std::uint32_t offset) const;
+
+  /**
+   * @brief 获取指定行的起始字节偏移。
+   *
+   * @param id 缓冲区 ID
+   * @param lineNum 行号（1-based）
+   * @return 行起始偏移，若参数无效则返回 std::nullopt
+   */
+  [[nodiscard]] std::optional<std::uint32_t>
+  getLineStart(BufferID id, std::uint32_t lineNum) const;
+
+  /**
+   * @brief 获取全部行的起始字节偏移（升序）。
+   *
+   * @details
+   *   供按偏移排序的批量定位使用：调用方沿该表单向推进即可，
+   *   无需逐个二分查找。
+   *
+   * @param id 缓冲区 ID
+   * @return 行起始偏移表，若 ID 无效则返回空
+   */
+  [[nodiscard]] std::span<const std::size_t> getLineStarts(BufferID id) const;
+
+  /**
+   * @brief 查询指定行是否只含 ASCII 字符。
+   *
+   * @details
+   *   ASCII 行上各单位的列号都等于字节列号，换算为 O(1)。
+   *
+   * @param id 缓冲区 ID
+   * @param lineNum 行号（1-based）
+   * @return 只含 ASCII 时返回 true，若参数无效则返回 false
+   */
+  [[nodiscard]] bool isAsciiLine(BufferID id, std::uint32_t lineNum) const;
+
+  /**
+   * @brief 将字节偏移转换为指定单位的列号。
+   *
+   * @details
+   *   先二分查找所在行，再按 getColumnOnLine() 换算。
+   *
+   * @param id 缓冲区 ID
+   * @param offset 字节偏移（允许等于源码长度）
+   * @param unit 列号单位
+   * @return 0-based 列号，若参数无效则返回 0
+   */
+  [[nodiscard]] std::uint32_t getColumn(BufferID id, std::uint32_t offset,
+                                        ColumnUnit unit) const;
+
+  /**
+   * @brief 在已知行内将字节偏移转换为指定单位的列号。
+   *
+   * @details
+   *   ASCII 行与字节单位为 O(1)；其余行在检查点上二分查找，
+   *   再最多扫描一个检查点间隔。偏移落在多字节字符中间时该字符计入，
+   *   与 utf8::utf16Length() 对前缀的计数一致。
+   *   按偏移顺序批量换算的调用方可自行推进行号，省去行查找。
+   *
+   * @param id 缓冲区 ID
+   * @param lineNum offset 所在行号（1-based）
+   * @param offset 字节偏移
+   * @param unit 列号单位
+   * @return 0-based 列号，若参数无效则返回 0
+   */
+  [[nodiscard]] std::uint32_t getColumnOnLine(BufferID id,
+                                              std::uint32_t lineNum,
+                                              std::uint32_t offset,
+                                              ColumnUnit unit) const;
+
+  /**
+   * @brief 将行号与指定单位的列号转换为字节偏移。
+   *
+   * @details
+   *   列号超过行长时截到行尾（不含换行符）；
+   *   UTF-16 列号落在代理对中间时取该字符的起始偏移。
+   *
+   * @param id 缓冲区 ID
+   * @param lineNum 行号（1-based）
+   * @param column 0-based 列号
+   * @param unit 列号单位
+   * @return 字节偏移，若参数无效则返回 std::nullopt
+   */
+  [[nodiscard]] std::optional<std::uint32_t>
+  getOffset(BufferID id, std::uint32_t lineNum, std::uint32_t column,
+            ColumnUnit unit) const;
+
   /**
    * @brief 获取缓冲区数量。
    *
@@ -181,6 +323,15 @@ public:
     return buffers_.size();
   }
 
+  /**
+   * @brief 获取全部缓冲区源码的总字节数。
+   *
+   * @return 已添加缓冲区（含虚拟文件）的源码字节数之和
+   */
+  [[nodiscard]] std::size_t sourceBytes() const noexcept {
+    return sourceBytes_;
+  }
+
   /**
    * @brief 添加虚拟文件缓冲区（宏展开生成的代码）。
    *
@@ -263,23 +414,46 @@ private:
   /**
    * @brief 内部缓冲区结构。
    */
+  /**
+   * @brief 非 ASCII 行内的列号换算检查点。
+   */
+  struct ColumnCheckpoint {
+    std::uint32_t byte;      ///< 行内字节列号（位于字符起始处）
+    std::uint32_t utf16;     ///< 该处的 UTF-16 列号
+    std::uint32_t codePoint; ///< 该处的码点列号
+  };
+
+  /// 非 ASCII 行内相邻检查点的最小字节间隔
+  static constexpr std::uint32_t kCheckpointStride = 64;
+
   struct Buffer {
-    std::string source;                           ///< 源码内容
-    std::string filename;                         ///< 文件名
-    mutable std::vector<std::size_t> lineOffsets; ///< 行偏移缓存（惰性构建）
-    mutable bool lineOffsetsBuilt{false};         ///< 行偏移是否已构建
+    std::string source;                   ///< 源码内容
+    std::string filename;                 ///< 文件名
+    std::uint64_t contentHash{0};         ///< 内容哈希（加入时计算）
+    std::vector<std::size_t> lineOffsets; ///< 各行起始偏移（加入时构建）
+
+    /// 第 i 行的检查点区间为 [lineCheckpoints[i], lineCheckpoints[i + 1])，
+    /// 区间为空即 ASCII 行；整个缓冲区为 ASCII 时表为空
+    std::vector<std::uint32_t> lineCheckpoints;
+    std::vector<ColumnCheckpoint> checkpoints; ///< 所有非 ASCII 行的检查点
 
     // 虚拟文件支持
     bool isSynthetic{false};              ///< true 表示宏展开生成的虚拟文件
     std::optional<BufferID> parentBuffer; ///< 直接父级（用于追溯展开链）
 
     /**
-     * @brief 惰性构建行偏移表。
+     * @brief 构建行偏移表与列号换算索引。
+     */
+    void buildLineOffsets();
+
+    /**
+     * @brief 构建列号换算索引（依赖行偏移表）。
      */
-    void buildLineOffsets() const;
+    void buildColumnIndex();
   };
 
   std::vector<Buffer> buffers_; ///< 稳定存储，BufferID.value 为索引+1
+  std::size_t sourceBytes_{0};  ///< 全部缓冲区的源码字节数
   std::vector<ExpansionInfo>
       expansions_; ///< 宏展开信息，ExpansionID.value 为索引+1
 };
@@ -95,6 +95,20 @@ public:
    */
   void advance(std::size_t count);
 
+  /**
+   * @brief 将读取位置移动到指定偏移。
+   *
+   * @details
+   *   行列号由调用方给出（通常来自 SourceManager 的行偏移表），
+   *   读取器不回扫源码。偏移超出源码长度时截断到末尾。
+   *
+   * @param offset 目标字节偏移
+   * @param line 该偏移所在行号（1-based）
+   * @param column 该偏移所在列号（1-based，UTF-8 字符计数）
+   */
+  void seek(std::size_t offset, std::uint32_t line,
+            std::uint32_t column) noexcept;
+
   /**
    * @brief 获取当前源码位置。
    *
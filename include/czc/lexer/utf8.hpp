@@ -128,6 +128,31 @@ charLength(unsigned char firstByte) noexcept {
 [[nodiscard]] std::optional<std::size_t>
 charCount(std::string_view str) noexcept;
 
+/**
+ * @brief 计算 UTF-8 字符串对应的 UTF-16 码元数。
+ *
+ * @details
+ *   4 字节序列计为 2 个码元（代理对），其余首字节计为 1，续字节不计。
+ *   不校验编码：无效字节按首字节规则计数，与编辑器的逐字节替换一致。
+ *
+ * @param str UTF-8 字符串
+ * @return UTF-16 码元数
+ */
+[[nodiscard]] std::size_t utf16Length(std::string_view str) noexcept;
+
+/**
+ * @brief 将 UTF-16 码元数换算为 UTF-8 字节偏移。
+ *
+ * @details
+ *   落在代理对中间时取该字符的起始偏移；超出字符串时返回 str.size()。
+ *
+ * @param str UTF-8 字符串
+ * @param units 从开头起的 UTF-16 码元数
+ * @return 字节偏移
+ */
+[[nodiscard]] std::size_t utf16ToByteOffset(std::string_view str,
+                                            std::size_t units) noexcept;
+
 /**
  * @brief 从字符串指定位置读取一个完整的 UTF-8 字符。
  *
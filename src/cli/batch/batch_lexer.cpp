@@ -0,0 +1,356 @@
+/**
+ * @file batch_lexer.cpp
+ * @brief 单进程批量词法分析实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/batch/batch_lexer.hpp"
+#include "czc/cli/output/formatter.hpp"
+#include "czc/cli/output/json_formatter.hpp"
+#include "czc/cli/phases/lexer_phase.hpp"
+#include "czc/common/json_writer.hpp"
+#include "czc/diag/diag_builder.hpp"
+#include "czc/diag/emitters/text_emitter.hpp"
+#include "czc/diag/message.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <system_error>
+#include <unordered_set>
+
+namespace czc::cli {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+/// 响应文件的最大嵌套深度
+constexpr std::size_t kMaxResponseDepth = 8;
+
+/// 文件名通配符匹配：`*` 匹配任意串，`?` 匹配单个字符
+bool globMatch(std::string_view pattern, std::string_view name) noexcept {
+  std::size_t p = 0;
+  std::size_t n = 0;
+  std::size_t starP = std::string_view::npos;
+  std::size_t starN = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+      ++p;
+      ++n;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      starP = p++;
+      starN = n;
+    } else if (starP != std::string_view::npos) {
+      p = starP + 1;
+      n = ++starN;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+/// 可留在输出目录内的相对路径原样使用，否则使用 fallback
+fs::path outputNameFor(const fs::path &path, const fs::path &fallback) {
+  auto normal = path.lexically_normal();
+  if (normal.is_relative() && !normal.empty() && *normal.begin() != "..") {
+    return normal;
+  }
+  return fallback;
+}
+
+/**
+ * @brief 输入展开的状态。
+ */
+class InputCollector {
+public:
+  explicit InputCollector(const BatchInputOptions &options)
+      : options_(options) {}
+
+  VoidResult add(const std::string &arg, std::size_t depth) {
+    if (!arg.empty() && arg.front() == '@') {
+      return addResponseFile(arg.substr(1), depth);
+    }
+
+    fs::path path(arg);
+    std::error_code ec;
+    auto status = fs::status(path, ec);
+    if (fs::is_directory(status)) {
+      return addDirectory(path);
+    }
+    if (fs::is_regular_file(status)) {
+      push(path, outputNameFor(path, path.filename()));
+      return ok();
+    }
+    return errVoid("File not found: " + arg, "E001");
+  }
+
+  std::vector<BatchInput> take() { return std::move(inputs_); }
+
+private:
+  VoidResult addResponseFile(const std::string &file, std::size_t depth) {
+    if (depth >= kMaxResponseDepth) {
+      return errVoid("Response files nested too deeply: " + file, "E008");
+    }
+    std::ifstream ifs(file);
+    if (!ifs) {
+      return errVoid("Failed to open response file: " + file, "E003");
+    }
+
+    std::string line;
+    while (std::getline(ifs, line)) {
+      auto first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos || line[first] == '#') {
+        continue;
+      }
+      auto last = line.find_last_not_of(" \t\r");
+      auto added = add(line.substr(first, last - first + 1), depth + 1);
+      if (!added.has_value()) {
+        return added;
+      }
+    }
+    return ok();
+  }
+
+  VoidResult addDirectory(const fs::path &dir) {
+    std::vector<fs::path> files;
+    std::error_code ec;
+    fs::recursive_directory_iterator it(
+        dir, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+      auto name = it->path().filename().string();
+      if (matchesAnyGlob(options_.exclude, name)) {
+        if (it->is_directory(ec)) {
+          it.disable_recursion_pending();
+        }
+        continue;
+      }
+      if (it->is_regular_file(ec) && matchesAnyGlob(options_.include, name)) {
+        files.push_back(it->path());
+      }
+    }
+    if (ec) {
+      return errVoid("Failed to read directory: " + dir.string(), "E003");
+    }
+
+    // 遍历顺序由文件系统决定，排序后结果才可复现
+    std::sort(files.begin(), files.end());
+    for (const auto &file : files) {
+      push(file, outputNameFor(file, file.lexically_relative(dir)));
+    }
+    return ok();
+  }
+
+  void push(const fs::path &path, fs::path outputName) {
+    std::error_code ec;
+    auto key = fs::absolute(path, ec).lexically_normal().string();
+    if (!seen_.insert(std::move(key)).second) {
+      return;
+    }
+    auto size = fs::file_size(path, ec);
+    inputs_.push_back(
+        BatchInput{path, std::move(outputName), ec ? 0 : size});
+  }
+
+  const BatchInputOptions &options_;
+  std::vector<BatchInput> inputs_;
+  std::unordered_set<std::string> seen_;
+};
+
+} // namespace
+
+bool matchesAnyGlob(std::span<const std::string> patterns,
+                    std::string_view name) noexcept {
+  return std::any_of(patterns.begin(), patterns.end(),
+                     [name](const auto &pattern) {
+                       return globMatch(pattern, name);
+                     });
+}
+
+Result<std::vector<BatchInput>>
+collectBatchInputs(std::span<const std::string> args,
+                   const BatchInputOptions &options) {
+  InputCollector collector(options);
+  for (const auto &arg : args) {
+    auto added = collector.add(arg, 0);
+    if (!added.has_value()) {
+      return std::unexpected(std::move(added.error()));
+    }
+  }
+  return ok(collector.take());
+}
+
+// ========== BatchLexer ==========
+
+BatchLexer::BatchLexer(const CompilerContext &ctx, BatchOptions options)
+    : global_(ctx.global()), output_(ctx.output()), lexer_(ctx.lexer()),
+      options_(std::move(options)) {
+  // 并行度来自文件级调度，单个文件内部顺序执行
+  lexer_.pipelined = false;
+  lexer_.jobs = 1;
+}
+
+BatchSummary BatchLexer::run(std::span<const BatchInput> inputs,
+                             TaskScheduler &scheduler,
+                             const Consumer &consume) const {
+  BatchSummary summary;
+  auto account = [&](const BatchInput &input, BatchFileResult &result) {
+    ++summary.files;
+    summary.failed += result.exitCode != 0 ? 1 : 0;
+    summary.tokens += result.tokenCount;
+    summary.bytes += input.size;
+    consume(input, result);
+  };
+
+  if (scheduler.deterministic() || inputs.size() <= 1) {
+    for (const auto &input : inputs) {
+      auto result = lexFile(input);
+      account(input, result);
+    }
+    return summary;
+  }
+
+  // 大文件优先提交，避免最后只剩一个大文件串行执行
+  std::vector<std::size_t> order(inputs.size());
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t a, std::size_t b) {
+                     return inputs[a].size > inputs[b].size;
+                   });
+
+  std::vector<BatchFileResult> results(inputs.size());
+  auto ready = std::make_unique<std::atomic<bool>[]>(inputs.size());
+
+  TaskGroup group(scheduler);
+  for (std::size_t i : order) {
+    group.spawn([&, i] {
+      // 任务必须置位 ready，否则调用线程会一直等待
+      try {
+        results[i] = lexFile(inputs[i]);
+      } catch (const std::exception &e) {
+        results[i] = BatchFileResult{};
+        results[i].exitCode = 1;
+        results[i].diagnostics = std::string("error: ") + e.what() + "\n";
+      }
+      ready[i].store(true, std::memory_order_release);
+      ready[i].notify_one();
+    });
+  }
+
+  // 调用线程按输入顺序交付，等待期间协助执行任务，交付后立即释放结果
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    while (!ready[i].load(std::memory_order_acquire)) {
+      if (!scheduler.runPending()) {
+        // 没有排队的任务：第 i 个文件正在其他线程上处理
+        ready[i].wait(false, std::memory_order_acquire);
+      }
+    }
+    account(inputs[i], results[i]);
+    results[i] = BatchFileResult{};
+  }
+  group.wait();
+  return summary;
+}
+
+BatchFileResult BatchLexer::lexFile(const BatchInput &input) const {
+  CompilerContext ctx(global_, output_);
+  ctx.lexer() = lexer_;
+
+  // 诊断渲染到内存，由调用线程按输入顺序写出
+  std::ostringstream errors;
+  auto &dcx = ctx.diagContext();
+  dcx.config().maxPerCode = global_.maxErrorsPerCode;
+  dcx.setEmitter(std::make_unique<diag::TextEmitter>(
+      errors, global_.colorDiagnostics ? diag::AnsiStyle::defaultStyle()
+                                       : diag::AnsiStyle::noColor()));
+
+  BatchFileResult result;
+  LexerPhase phase(ctx);
+  auto lexed = phase.runOnFile(input.path);
+  if (!lexed.has_value()) {
+    dcx.emit(diag::error(diag::Message(lexed.error().message)).build());
+    result.exitCode = 1;
+  } else if (lexed->hasErrors) {
+    result.exitCode = 1;
+  } else {
+    const auto &tokens = lexed->tokens;
+    result.tokenCount = tokens.size();
+    if (options_.outputDir.has_value()) {
+      result.exitCode = writeOutputFile(input, ctx, tokens);
+    } else {
+      StringSink sink(result.output);
+      JsonFormatter().writeTokens(tokens, ctx.sourceManager(), sink);
+    }
+  }
+
+  dcx.flush();
+  result.diagnostics = std::move(errors).str();
+  return result;
+}
+
+int BatchLexer::writeOutputFile(const BatchInput &input, CompilerContext &ctx,
+                                std::span<const lexer::Token> tokens) const {
+  auto path = *options_.outputDir / input.outputName;
+  path += output_.format == OutputFormat::Json ? ".json" : ".tokens";
+
+  std::error_code ec;
+  fs::create_directories(path.parent_path(), ec);
+  auto opened = FdSink::open(path);
+  if (!opened.has_value()) {
+    ctx.diagContext().emit(
+        diag::error(diag::Message(opened.error().message)).build());
+    return 1;
+  }
+
+  auto &sink = *opened.value();
+  createFormatter(output_.format)->writeTokens(tokens, ctx.sourceManager(),
+                                               sink);
+  sink.flush();
+  if (!sink.ok()) {
+    ctx.diagContext().emit(
+        diag::error(diag::Message("Failed to write lexer output: " +
+                                  path.string()))
+            .build());
+    return 1;
+  }
+  return 0;
+}
+
+void BatchLexer::writeRecord(OutputSink &sink, const BatchInput &input,
+                             const BatchFileResult &result) {
+  sink.write(R"({"file":)");
+  writeJsonString(sink, input.path.string());
+  sink.write(R"(,"exitCode":)");
+  sink.writeInt(result.exitCode);
+  sink.write(R"(,"tokens":)");
+  sink.writeInt(result.tokenCount);
+  sink.write(R"(,"result":)");
+  sink.write(result.output.empty() ? std::string_view("null")
+                                   : std::string_view(result.output));
+  sink.write("}\n");
+}
+
+VoidResult BatchLexer::checkOutputNames(std::span<const BatchInput> inputs) {
+  std::unordered_set<std::string> names;
+  for (const auto &input : inputs) {
+    if (!names.insert(input.outputName.generic_string()).second) {
+      return errVoid("Output path collision: " +
+                         input.outputName.generic_string() + " (from " +
+                         input.path.string() + ")",
+                     "E008");
+    }
+  }
+  return ok();
+}
+
+} // namespace czc::cli
@@ -7,7 +7,9 @@
  */
 
 #include "czc/cli/cli.hpp"
+#include "czc/cli/commands/daemon_command.hpp"
 #include "czc/cli/commands/lex_command.hpp"
+#include "czc/cli/commands/lsp_command.hpp"
 #include "czc/cli/commands/version_command.hpp"
 #include "czc/diag/diag_builder.hpp"
 #include "czc/diag/message.hpp"
@@ -36,6 +38,14 @@ int Cli::run(int argc, char **argv) {
   try {
     app_.parse(argc, argv);
 
+    // 按解析后的选项重建诊断发射器
+    if (auto configured = driver_.context().configureDiagnostics();
+        !configured.has_value()) {
+      driver_.diagContext().emit(
+          diag::error(diag::Message(configured.error().message)).build());
+      return 1;
+    }
+
     // 执行激活的命令
     if (activeCommand_ != nullptr) {
       auto result = activeCommand_->execute();
@@ -57,6 +67,8 @@ int Cli::run(int argc, char **argv) {
 void Cli::registerCommands() {
   registerSimpleCommand<VersionCommand>();
   registerCommandWithDriver<LexCommand>();
+  registerCommandWithDriver<DaemonCommand>();
+  registerSimpleCommand<LspCommand>();
 }
 
 void Cli::setupGlobalOptions() {
@@ -90,10 +102,11 @@ void Cli::setupGlobalOptions() {
 
   // 输出格式
   app_.add_option("-f,--format", ctx.output().format,
-                  "Output format (text, json)")
+                  "Output format (text, json, ndjson)")
       ->transform(CLI::CheckedTransformer(
           std::map<std::string, OutputFormat>{{"text", OutputFormat::Text},
-                                              {"json", OutputFormat::Json}},
+                                              {"json", OutputFormat::Json},
+                                              {"ndjson", OutputFormat::NdJson}},
           CLI::ignore_case))
       ->group("Output Options");
 
@@ -107,6 +120,31 @@ void Cli::setupGlobalOptions() {
           },
           "Disable colored output")
       ->group("Global Options");
+
+  // 异步诊断输出
+  app_.add_flag("--async-diagnostics", ctx.global().asyncDiagnostics,
+                "Render diagnostics on the compiler thread and write them "
+                "from a background thread")
+      ->group("Global Options");
+
+  // 按错误码限流
+  app_.add_option("--max-errors-per-code", ctx.global().maxErrorsPerCode,
+                  "Emit at most N diagnostics per error code (0 = unlimited)")
+      ->group("Global Options");
+
+  // 常驻服务
+  app_.add_flag("--client", ctx.global().client,
+                "Forward the command to a running `czc daemon`")
+      ->group("Global Options");
+  app_.add_option("--socket", ctx.global().daemonSocket,
+                  "Daemon socket path (default: $XDG_RUNTIME_DIR/czc.sock)")
+      ->group("Global Options");
+
+  // 诊断 JSON 副本
+  app_.add_option("--diagnostics-json", ctx.global().diagnosticsJson,
+                  "Also write diagnostics as JSON to this file "
+                  "(.sarif: SARIF 2.1.0, .jsonl/.ndjson: JSON Lines)")
+      ->group("Global Options");
 }
 
 VoidResult Cli::loadConfig() {
@@ -0,0 +1,46 @@
+/**
+ * @file daemon_command.cpp
+ * @brief 常驻编译服务命令实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/commands/daemon_command.hpp"
+#include "czc/cli/daemon/daemon_client.hpp"
+#include "czc/cli/daemon/daemon_server.hpp"
+
+namespace czc::cli {
+
+void DaemonCommand::setup(CLI::App *app) {
+  app->add_flag("--stop", stop_, "Stop the running daemon")
+      ->group("Daemon Options");
+  app->add_option("--cache", cacheFile_,
+                  "Persist query results to this file across restarts")
+      ->group("Daemon Options");
+}
+
+Result<int> DaemonCommand::execute() {
+  auto socket = driver_.daemonSocket();
+
+  if (stop_) {
+    DaemonRequest request;
+    request.kind = DaemonRequestKind::Shutdown;
+    auto client = DaemonClient::connect(socket);
+    if (!client.has_value()) {
+      return std::unexpected(std::move(client.error()));
+    }
+    if (auto response = client->send(request); !response.has_value()) {
+      return std::unexpected(std::move(response.error()));
+    }
+    return Result<int>(0);
+  }
+
+  DaemonServer server(std::move(socket), cacheFile_);
+  if (auto served = server.run(); !served.has_value()) {
+    return std::unexpected(std::move(served.error()));
+  }
+  return Result<int>(0);
+}
+
+} // namespace czc::cli
@@ -11,10 +11,18 @@
 namespace czc::cli {
 
 void LexCommand::setup(CLI::App *app) {
-  // 输入文件（位置参数）
-  app->add_option("input", inputFile_, "Input source file")
+  // 输入（位置参数）：文件、目录或 @响应文件
+  app->add_option("inputs", inputs_,
+                  "Input source files, directories or @response files")
       ->required()
-      ->check(CLI::ExistingFile);
+      ->check(CLI::Validator([](std::string &value) -> std::string {
+        // 响应文件在执行时读取，此处只检查普通路径
+        if ((!value.empty() && value.front() == '@') ||
+            std::filesystem::exists(value)) {
+          return {};
+        }
+        return "Path does not exist: " + value;
+      }));
 
   // trivia 模式
   app->add_flag("--trivia,-t", trivia_, "Preserve whitespace and comments")
@@ -23,6 +31,41 @@ void LexCommand::setup(CLI::App *app) {
   // dump tokens
   app->add_flag("--dump-tokens,-d", dumpTokens_, "Dump all tokens")
       ->group("Lexer Options");
+
+  // 流水线模式
+  app->add_flag("--pipeline", pipelined_,
+                "Overlap lexing, formatting and output. Tokens are streamed "
+                "while scanning: the token count follows the tokens, and on "
+                "lex errors the tokens scanned so far are still written "
+                "before exiting with code 1")
+      ->group("Lexer Options");
+
+  // 并行渲染 / 批量模式下的文件级并行
+  app->add_option("-j,--jobs", jobs_,
+                  "Threads used to lex files in batch and watch mode "
+                  "(default: all cores), or to render a single file's "
+                  "token output (default: 1, sequential); 0 = all cores")
+      ->group("Lexer Options");
+
+  // 批量模式
+  app->add_option("--include", inputOptions_.include,
+                  "File name globs lexed when expanding directories")
+      ->group("Batch Options");
+  app->add_option("--exclude", inputOptions_.exclude,
+                  "File or directory name globs skipped in directories")
+      ->group("Batch Options");
+  app->add_option("--out-dir", outputDir_,
+                  "Write one output file per input instead of NDJSON")
+      ->group("Batch Options");
+
+  // 监视模式
+  app->add_flag("--watch,-w", watch_,
+                "Watch inputs and relex changed files, emitting NDJSON")
+      ->group("Watch Options");
+  app->add_option("--debounce", debounceMs_,
+                  "Milliseconds of quiet before a burst of changes is "
+                  "processed")
+      ->group("Watch Options");
 }
 
 Result<int> LexCommand::execute() {
@@ -30,9 +73,20 @@ Result<int> LexCommand::execute() {
   auto &ctx = driver_.context();
   ctx.lexer().preserveTrivia = trivia_;
   ctx.lexer().dumpTokens = dumpTokens_;
+  ctx.lexer().pipelined = pipelined_;
+  ctx.lexer().jobs = jobs_;
+
+  if (watch_) {
+    return executeWatch();
+  }
+  if (isBatch()) {
+    return executeBatch();
+  }
 
-  // 执行词法分析
-  int exitCode = driver_.runLexer(inputFile_);
+  // 执行词法分析：--client 时转发给常驻服务
+  std::filesystem::path inputFile(inputs_.front());
+  int exitCode = ctx.global().client ? driver_.runLexerRemote(inputFile)
+                                     : driver_.runLexer(inputFile);
 
   // 打印诊断摘要
   if (ctx.isVerbose()) {
@@ -42,4 +96,54 @@ Result<int> LexCommand::execute() {
   return Result<int>(exitCode);
 }
 
+bool LexCommand::isBatch() const {
+  if (inputs_.size() != 1 || !outputDir_.empty()) {
+    return true;
+  }
+  const auto &input = inputs_.front();
+  return (!input.empty() && input.front() == '@') ||
+         std::filesystem::is_directory(input);
+}
+
+Result<int> LexCommand::executeBatch() {
+  auto &ctx = driver_.context();
+  if (ctx.global().client) {
+    return err<int>("--client accepts a single input file", "E008");
+  }
+
+  auto inputs = collectBatchInputs(inputs_, inputOptions_);
+  if (!inputs.has_value()) {
+    return std::unexpected(std::move(inputs.error()));
+  }
+
+  BatchOptions options;
+  if (!outputDir_.empty()) {
+    if (auto names = BatchLexer::checkOutputNames(inputs.value());
+        !names.has_value()) {
+      return std::unexpected(std::move(names.error()));
+    }
+    options.outputDir = outputDir_;
+  }
+
+  return Result<int>(driver_.runLexerBatch(inputs.value(), options));
+}
+
+Result<int> LexCommand::executeWatch() {
+  auto &ctx = driver_.context();
+  if (ctx.global().client || !outputDir_.empty()) {
+    return err<int>("--watch cannot be combined with --client or --out-dir",
+                    "E010");
+  }
+
+  auto watcher = FileWatcher::create();
+  if (!watcher.has_value()) {
+    return std::unexpected(std::move(watcher.error()));
+  }
+
+  WatchOptions options;
+  options.inputs = inputOptions_;
+  options.debounce = std::chrono::milliseconds(debounceMs_);
+  return Result<int>(driver_.runLexerWatch(inputs_, *watcher.value(), options));
+}
+
 } // namespace czc::cli
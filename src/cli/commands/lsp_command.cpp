@@ -0,0 +1,28 @@
+/**
+ * @file lsp_command.cpp
+ * @brief 语言服务器命令实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/commands/lsp_command.hpp"
+#include "czc/cli/lsp/lsp_server.hpp"
+
+#include <iostream>
+
+namespace czc::cli {
+
+void LspCommand::setup([[maybe_unused]] CLI::App *app) {
+  // 客户端通过 initialize 协商能力，不需要额外选项
+}
+
+Result<int> LspCommand::execute() {
+  // 标准输出只承载协议消息
+  std::ios::sync_with_stdio(false);
+  auto out = FdSink::standardOutput();
+  LspServer server(std::cin, *out);
+  return ok(server.run());
+}
+
+} // namespace czc::cli
@@ -7,33 +7,46 @@
  */
 
 #include "czc/cli/context.hpp"
+#include "czc/common/output_sink.hpp"
 #include "czc/diag/emitters/ansi_renderer.hpp"
+#include "czc/diag/emitters/async_emitter.hpp"
+#include "czc/diag/emitters/json_emitter.hpp"
 #include "czc/diag/emitters/text_emitter.hpp"
 #include "czc/diag/i18n.hpp"
 
 #include <filesystem>
 #include <iostream>
 
+#if !CZC_PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
+
 namespace czc::cli {
 
 namespace {
 
-/// 尝试加载 i18n 翻译文件到指定的 Translator
-void loadI18nFiles(diag::i18n::Translator &translator) {
-  // 尝试多个可能的路径
-  std::vector<std::filesystem::path> searchPaths = {
-      "resources/i18n/en.toml",
-      "../resources/i18n/en.toml",
-      "../../resources/i18n/en.toml",
-      std::filesystem::current_path() / "resources/i18n/en.toml",
-  };
-
-  for (const auto &path : searchPaths) {
-    if (std::filesystem::exists(path)) {
-      (void)translator.loadFromFile(path);
-      return;
-    }
+#if CZC_PLATFORM_WINDOWS
+constexpr int kStderrFd = 2;
+#else
+constexpr int kStderrFd = STDERR_FILENO;
+#endif
+
+/// 按诊断 JSON 文件扩展名选择输出格式
+auto jsonFormatFor(const std::filesystem::path &path) -> diag::JsonDiagFormat {
+  auto ext = path.extension();
+  if (ext == ".sarif") {
+    return diag::JsonDiagFormat::Sarif;
   }
+  if (ext == ".jsonl" || ext == ".ndjson") {
+    return diag::JsonDiagFormat::Lines;
+  }
+  return diag::JsonDiagFormat::Document;
+}
+
+/// 按颜色选项创建 ANSI 样式
+auto makeStyle(bool color) -> diag::AnsiStyle {
+  return color ? diag::AnsiStyle::defaultStyle()
+               : diag::AnsiStyle(); // 空样式 = 无颜色
 }
 
 } // namespace
@@ -46,22 +59,62 @@ CompilerContext::CompilerContext(GlobalOptions global, OutputOptions output)
 }
 
 void CompilerContext::initDiagContext() {
-  // 创建 Translator 并加载翻译文件
-  auto translator = std::make_unique<diag::i18n::Translator>();
-  loadI18nFiles(*translator);
+  sourceManager_ = std::make_unique<lexer::SourceManager>();
+  sourceLocator_ =
+      std::make_unique<lexer::LexerSourceLocator>(*sourceManager_);
 
-  // 创建 ANSI 样式
-  auto style = global_.colorDiagnostics ? diag::AnsiStyle::defaultStyle()
-                                        : diag::AnsiStyle(); // 空样式 = 无颜色
+  // 翻译已在构建期编译进二进制，启动时无需查找与解析文件
+  auto translator = std::make_unique<diag::i18n::Translator>();
 
   // 创建默认的 TextEmitter
-  auto emitter = std::make_unique<diag::TextEmitter>(std::cerr, style);
+  auto emitter = std::make_unique<diag::TextEmitter>(
+      std::cerr, makeStyle(global_.colorDiagnostics));
 
   // 创建 DiagContext
   diag::DiagConfig config;
   config.colorOutput = global_.colorDiagnostics;
   diagContext_ = std::make_unique<diag::DiagContext>(
-      std::move(emitter), nullptr, config, std::move(translator));
+      std::move(emitter), sourceLocator_.get(), config, std::move(translator));
+}
+
+VoidResult CompilerContext::configureDiagnostics() {
+  bool color = global_.colorDiagnostics;
+  diagContext_->config().colorOutput = color;
+  diagContext_->config().maxPerCode = global_.maxErrorsPerCode;
+
+  if (!global_.asyncDiagnostics && !global_.diagnosticsJson.has_value()) {
+    diagContext_->setEmitter(
+        std::make_unique<diag::TextEmitter>(std::cerr, makeStyle(color)));
+    return ok();
+  }
+
+  std::vector<diag::AsyncSink> sinks;
+
+  // 终端文本输出：写线程直接写 stderr 文件描述符
+  std::cerr.flush();
+  sinks.push_back(
+      {[color](std::ostream &out) -> std::unique_ptr<diag::Emitter> {
+         return std::make_unique<diag::TextEmitter>(out, makeStyle(color));
+       },
+       std::make_unique<FdSink>(kStderrFd)});
+
+  // JSON 副本：与终端输出共用同一次位置解析
+  if (global_.diagnosticsJson.has_value()) {
+    auto file = FdSink::open(global_.diagnosticsJson.value());
+    if (!file.has_value()) {
+      return std::unexpected(file.error());
+    }
+    auto format = jsonFormatFor(global_.diagnosticsJson.value());
+    sinks.push_back(
+        {[format](std::ostream &out) -> std::unique_ptr<diag::Emitter> {
+           return std::make_unique<diag::JsonEmitter>(out, format);
+         },
+         std::move(file.value())});
+  }
+
+  diagContext_->setEmitter(
+      std::make_unique<diag::AsyncEmitter>(std::move(sinks)));
+  return ok();
 }
 
 } // namespace czc::cli
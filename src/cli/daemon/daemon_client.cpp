@@ -0,0 +1,39 @@
+/**
+ * @file daemon_client.cpp
+ * @brief 常驻编译服务客户端实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/daemon/daemon_client.hpp"
+
+namespace czc::cli {
+
+Result<DaemonClient>
+DaemonClient::connect(const std::filesystem::path &socket) {
+  auto fd = connectDaemonSocket(socket);
+  if (!fd.has_value()) {
+    return std::unexpected(std::move(fd.error()));
+  }
+  return ok(DaemonClient(std::move(fd.value())));
+}
+
+Result<DaemonResponse> DaemonClient::send(const DaemonRequest &request) {
+  if (auto written = writeFrame(fd_.get(), encodeRequest(request));
+      !written.has_value()) {
+    return std::unexpected(std::move(written.error()));
+  }
+
+  std::string payload;
+  auto got = readFrame(fd_.get(), payload);
+  if (!got.has_value()) {
+    return std::unexpected(std::move(got.error()));
+  }
+  if (!got.value()) {
+    return err<DaemonResponse>("czc daemon closed the connection", "E005");
+  }
+  return decodeResponse(payload);
+}
+
+} // namespace czc::cli
@@ -0,0 +1,257 @@
+/**
+ * @file daemon_server.cpp
+ * @brief 常驻编译服务实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/daemon/daemon_server.hpp"
+#include "czc/cli/phases/lexer_phase.hpp"
+#include "czc/diag/diag_builder.hpp"
+#include "czc/diag/emitters/text_emitter.hpp"
+#include "czc/diag/message.hpp"
+
+#include <memory>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace czc::cli {
+
+DaemonServer::DaemonServer(std::filesystem::path socket,
+                           std::filesystem::path cacheFile)
+    : socket_(std::move(socket)), cacheFile_(std::move(cacheFile)) {
+  reset();
+}
+
+DaemonServer::~DaemonServer() = default;
+
+void DaemonServer::reset() {
+  // 查询数据库引用 Driver 的 SourceManager，须先于 Driver 销毁
+  queries_.reset();
+  driver_ = std::make_unique<Driver>();
+  queries_ =
+      std::make_unique<QueryDatabase>(driver_->context().sourceManager());
+  files_.clear();
+}
+
+VoidResult DaemonServer::run() {
+  auto listener = listenDaemonSocket(socket_);
+  if (!listener.has_value()) {
+    return std::unexpected(std::move(listener.error()));
+  }
+
+  // 缓存损坏或版本不符时丢弃，从空数据库开始
+  if (!cacheFile_.empty() && !queries_->load(cacheFile_).has_value()) {
+    reset();
+  }
+
+  VoidResult result = ok();
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(kMaxConnections);
+    for (std::size_t i = 0; i < kMaxConnections; ++i) {
+      threads.emplace_back([this] { serveQueued(); });
+    }
+
+    while (!stopping()) {
+      auto connection = acceptDaemonConnection(listener->get());
+      if (!connection.has_value()) {
+        result = std::unexpected(std::move(connection.error()));
+        break;
+      }
+      if (stopping()) {
+        break; // Shutdown 之后用于唤醒 accept 的连接
+      }
+      // 空闲或停滞的客户端到时被断开，不会一直占用 I/O 线程
+      if (!setSocketTimeout(connection->get(), idleTimeout_).has_value()) {
+        continue;
+      }
+      {
+        std::lock_guard lock(queueMutex_);
+        pending_.push_back(std::move(connection.value()));
+      }
+      queueReady_.notify_one();
+    }
+
+    closeConnections();
+    {
+      // 加锁后再通知：等待中的线程要么已看到 stopping_，要么已在等待
+      std::lock_guard lock(queueMutex_);
+    }
+    queueReady_.notify_all();
+    threads.clear(); // 等待正在执行的请求完成
+    pending_.clear();
+  }
+
+  // 先关闭监听再删除路径，避免新客户端连到即将退出的服务
+  listener->reset();
+  std::error_code ec;
+  std::filesystem::remove(socket_, ec);
+  if (!result.has_value()) {
+    return result;
+  }
+
+  if (!cacheFile_.empty()) {
+    return queries_->save(cacheFile_);
+  }
+  return ok();
+}
+
+void DaemonServer::serveQueued() {
+  while (true) {
+    UniqueFd fd;
+    {
+      std::unique_lock lock(queueMutex_);
+      queueReady_.wait(lock,
+                       [this] { return stopping() || !pending_.empty(); });
+      if (stopping()) {
+        return; // 排队中的连接由 run() 关闭
+      }
+      fd = std::move(pending_.front());
+      pending_.pop_front();
+    }
+    serveConnection(fd.get());
+  }
+}
+
+void DaemonServer::serveConnection(int fd) {
+  {
+    // 先登记再检查，停止时 closeConnections() 不会漏掉本连接
+    std::lock_guard lock(connectionsMutex_);
+    if (stopping()) {
+      return;
+    }
+    connections_.insert(fd);
+  }
+
+  std::string payload;
+  while (!stopping()) {
+    auto got = readFrame(fd, payload);
+    if (!got.has_value() || !got.value()) {
+      break; // 对端关闭、超时或连接出错：丢弃该连接
+    }
+
+    DaemonResponse response;
+    if (auto request = decodeRequest(payload); request.has_value()) {
+      response = handle(request.value());
+    } else {
+      response.exitCode = 1;
+      response.err = request.error().format() + "\n";
+    }
+
+    if (!writeFrame(fd, encodeResponse(response)).has_value()) {
+      break;
+    }
+  }
+
+  {
+    std::lock_guard lock(connectionsMutex_);
+    connections_.erase(fd);
+  }
+  if (stopping()) {
+    // 唤醒阻塞在 accept 上的主循环
+    (void)connectDaemonSocket(socket_);
+  }
+}
+
+void DaemonServer::closeConnections() {
+  stopping_.store(true, std::memory_order_release);
+  std::lock_guard lock(connectionsMutex_);
+  for (int fd : connections_) {
+    shutdownSocketReads(fd);
+  }
+}
+
+DaemonResponse DaemonServer::handle(const DaemonRequest &request) {
+  std::lock_guard lock(mutex_);
+  switch (request.kind) {
+  case DaemonRequestKind::Shutdown:
+    stopping_.store(true, std::memory_order_release);
+    return {};
+  case DaemonRequestKind::Lex:
+    return lex(request);
+  }
+  return {.exitCode = 1, .out = {}, .err = "unknown daemon request\n"};
+}
+
+DaemonResponse DaemonServer::lex(const DaemonRequest &request) {
+  // 缓冲区过多时整体重建，保持常驻内存有界
+  if (driver_->context().sourceManager().bufferCount() >= kMaxBuffers) {
+    reset();
+  }
+
+  auto &ctx = driver_->context();
+  ctx.lexer().preserveTrivia = request.preserveTrivia;
+  ctx.lexer().dumpTokens = request.dumpTokens;
+  ctx.lexer().pipelined = false;
+  ctx.lexer().jobs = 1;
+  ctx.output().format = request.format;
+
+  // 每个请求独立统计诊断，渲染结果随响应返回
+  std::ostringstream errors;
+  auto &dcx = ctx.diagContext();
+  dcx.reset();
+  dcx.config().colorOutput = request.colorDiagnostics;
+  dcx.config().maxPerCode = request.maxErrorsPerCode;
+  dcx.setEmitter(std::make_unique<diag::TextEmitter>(
+      errors, request.colorDiagnostics ? diag::AnsiStyle::defaultStyle()
+                                       : diag::AnsiStyle::noColor()));
+
+  DaemonResponse response;
+  StringSink sink(response.out);
+  if (request.source.has_value()) {
+    // 标准输入没有稳定的身份，不进入查询数据库
+    LexerPhase phase(ctx);
+    auto buffer = phase.loadSource(request.source.value(), request.name);
+    if (buffer.has_value()) {
+      response.exitCode = driver_->runLexer(buffer.value(), sink);
+    } else {
+      dcx.emit(diag::error(diag::Message(buffer.error().message)).build());
+      response.exitCode = 1;
+    }
+  } else if (auto lexed = resolveTokens(request); lexed.has_value()) {
+    response.exitCode = driver_->runLexer(*lexed.value(), sink);
+  } else {
+    dcx.emit(diag::error(diag::Message(lexed.error().message)).build());
+    response.exitCode = 1;
+  }
+  sink.flush();
+
+  dcx.flush();
+  response.err = std::move(errors).str();
+  return response;
+}
+
+Result<std::shared_ptr<const FileTokens>>
+DaemonServer::resolveTokens(const DaemonRequest &request) {
+  std::filesystem::path path(request.path);
+  if (path.is_relative() && !request.cwd.empty()) {
+    path = std::filesystem::path(request.cwd) / path;
+  }
+  path = path.lexically_normal();
+
+  // 路径、修改时间与大小均未变化时无需重新读取文件
+  std::error_code ec;
+  auto mtime = std::filesystem::last_write_time(path, ec);
+  auto size = ec ? 0 : std::filesystem::file_size(path, ec);
+  auto key = path.string();
+  auto it = files_.find(key);
+  const bool unchanged = !ec && it != files_.end() &&
+                         it->second.mtime == mtime && it->second.size == size;
+  if (!unchanged) {
+    // 内容哈希与上次相同（如仅 touch）时查询结果仍可复用
+    auto loaded = queries_->loadFile(path);
+    if (!loaded.has_value()) {
+      return std::unexpected(std::move(loaded.error()));
+    }
+    if (!ec) {
+      files_[key] = CachedFile{mtime, size};
+    }
+  }
+  return queries_->tokens(path, request.preserveTrivia);
+}
+
+} // namespace czc::cli
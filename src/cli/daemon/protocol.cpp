@@ -0,0 +1,466 @@
+/**
+ * @file protocol.cpp
+ * @brief 常驻编译服务协议实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/daemon/protocol.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+
+#if !CZC_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace czc::cli {
+
+namespace {
+
+// 请求标志位
+constexpr std::uint8_t kFlagTrivia = 1U << 0;
+constexpr std::uint8_t kFlagDumpTokens = 1U << 1;
+constexpr std::uint8_t kFlagColor = 1U << 2;
+constexpr std::uint8_t kFlagSource = 1U << 3;
+
+void putU8(std::string &out, std::uint8_t value) {
+  out.push_back(static_cast<char>(value));
+}
+
+void putU32(std::string &out, std::uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out.push_back(static_cast<char>((value >> shift) & 0xFF));
+  }
+}
+
+void putString(std::string &out, std::string_view text) {
+  putU32(out, static_cast<std::uint32_t>(text.size()));
+  out.append(text);
+}
+
+/**
+ * @brief 顺序读取负载字段，越界时置失败标志。
+ */
+class PayloadReader {
+public:
+  explicit PayloadReader(std::string_view data) : data_(data) {}
+
+  std::uint8_t u8() {
+    if (!require(1)) {
+      return 0;
+    }
+    return static_cast<std::uint8_t>(data_[pos_++]);
+  }
+
+  std::uint32_t u32() {
+    if (!require(4)) {
+      return 0;
+    }
+    std::uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+      value |= static_cast<std::uint32_t>(
+                   static_cast<unsigned char>(data_[pos_++]))
+               << shift;
+    }
+    return value;
+  }
+
+  std::string string() {
+    std::uint32_t size = u32();
+    if (!require(size)) {
+      return {};
+    }
+    std::string text(data_.substr(pos_, size));
+    pos_ += size;
+    return text;
+  }
+
+  /// 所有字段读取成功且没有多余字节
+  [[nodiscard]] bool complete() const noexcept {
+    return ok_ && pos_ == data_.size();
+  }
+
+private:
+  bool require(std::size_t size) {
+    if (!ok_ || data_.size() - pos_ < size) {
+      ok_ = false;
+      return false;
+    }
+    return true;
+  }
+
+  std::string_view data_;
+  std::size_t pos_{0};
+  bool ok_{true};
+};
+
+/// 读取并校验协议版本
+bool checkVersion(PayloadReader &reader) {
+  return reader.u8() == kDaemonProtocolVersion;
+}
+
+template <typename T> Result<T> malformed(std::string_view what) {
+  return err<T>("Malformed daemon " + std::string(what), "E006");
+}
+
+} // namespace
+
+// ========== 编解码 ==========
+
+std::string encodeRequest(const DaemonRequest &request) {
+  std::string out;
+  out.reserve(32 + request.cwd.size() + request.path.size() +
+              request.name.size() +
+              (request.source ? request.source->size() : 0));
+
+  putU8(out, kDaemonProtocolVersion);
+  putU8(out, static_cast<std::uint8_t>(request.kind));
+
+  std::uint8_t flags = 0;
+  flags |= request.preserveTrivia ? kFlagTrivia : 0;
+  flags |= request.dumpTokens ? kFlagDumpTokens : 0;
+  flags |= request.colorDiagnostics ? kFlagColor : 0;
+  flags |= request.source.has_value() ? kFlagSource : 0;
+  putU8(out, flags);
+  putU8(out, static_cast<std::uint8_t>(request.format));
+  putU32(out, request.maxErrorsPerCode);
+
+  putString(out, request.cwd);
+  putString(out, request.path);
+  putString(out, request.name);
+  putString(out, request.source.value_or(std::string()));
+  return out;
+}
+
+Result<DaemonRequest> decodeRequest(std::string_view payload) {
+  PayloadReader reader(payload);
+  if (!checkVersion(reader)) {
+    return malformed<DaemonRequest>("request (protocol version mismatch)");
+  }
+
+  DaemonRequest request;
+  auto kind = reader.u8();
+  if (kind != static_cast<std::uint8_t>(DaemonRequestKind::Lex) &&
+      kind != static_cast<std::uint8_t>(DaemonRequestKind::Shutdown)) {
+    return malformed<DaemonRequest>("request (unknown kind)");
+  }
+  request.kind = static_cast<DaemonRequestKind>(kind);
+
+  auto flags = reader.u8();
+  auto format = reader.u8();
+  if (format > static_cast<std::uint8_t>(OutputFormat::NdJson)) {
+    return malformed<DaemonRequest>("request (unknown output format)");
+  }
+  request.preserveTrivia = (flags & kFlagTrivia) != 0;
+  request.dumpTokens = (flags & kFlagDumpTokens) != 0;
+  request.colorDiagnostics = (flags & kFlagColor) != 0;
+  request.format = static_cast<OutputFormat>(format);
+  request.maxErrorsPerCode = reader.u32();
+
+  request.cwd = reader.string();
+  request.path = reader.string();
+  request.name = reader.string();
+  auto source = reader.string();
+  if ((flags & kFlagSource) != 0) {
+    request.source = std::move(source);
+  }
+
+  if (!reader.complete()) {
+    return malformed<DaemonRequest>("request (truncated)");
+  }
+  return ok(std::move(request));
+}
+
+std::string encodeResponse(const DaemonResponse &response) {
+  std::string out;
+  out.reserve(16 + response.out.size() + response.err.size());
+  putU8(out, kDaemonProtocolVersion);
+  putU32(out, static_cast<std::uint32_t>(response.exitCode));
+  putString(out, response.out);
+  putString(out, response.err);
+  return out;
+}
+
+Result<DaemonResponse> decodeResponse(std::string_view payload) {
+  PayloadReader reader(payload);
+  if (!checkVersion(reader)) {
+    return malformed<DaemonResponse>("response (protocol version mismatch)");
+  }
+
+  DaemonResponse response;
+  response.exitCode = static_cast<int>(reader.u32());
+  response.out = reader.string();
+  response.err = reader.string();
+  if (!reader.complete()) {
+    return malformed<DaemonResponse>("response (truncated)");
+  }
+  return ok(std::move(response));
+}
+
+// ========== 套接字 ==========
+
+std::filesystem::path defaultDaemonSocket() {
+  if (const char *runtime = std::getenv("XDG_RUNTIME_DIR");
+      runtime != nullptr && *runtime != '\0') {
+    return std::filesystem::path(runtime) / "czc.sock";
+  }
+  std::error_code ec;
+  auto dir = std::filesystem::temp_directory_path(ec);
+  if (ec) {
+    dir = "/tmp";
+  }
+#if CZC_PLATFORM_WINDOWS
+  return dir / "czc.sock";
+#else
+  return dir / ("czc-" + std::to_string(::getuid()) + ".sock");
+#endif
+}
+
+#if CZC_PLATFORM_WINDOWS
+
+Result<UniqueFd> connectDaemonSocket(const std::filesystem::path &) {
+  return err<UniqueFd>("Daemon mode requires Unix domain sockets", "E005");
+}
+
+Result<UniqueFd> listenDaemonSocket(const std::filesystem::path &) {
+  return err<UniqueFd>("Daemon mode requires Unix domain sockets", "E005");
+}
+
+Result<UniqueFd> acceptDaemonConnection(int) {
+  return err<UniqueFd>("Daemon mode requires Unix domain sockets", "E005");
+}
+
+VoidResult setSocketTimeout(int, std::chrono::milliseconds) {
+  return errVoid("Daemon mode requires Unix domain sockets", "E005");
+}
+
+void shutdownSocketReads(int) noexcept {}
+
+VoidResult writeFrame(int, std::string_view) {
+  return errVoid("Daemon mode requires Unix domain sockets", "E005");
+}
+
+Result<bool> readFrame(int, std::string &) {
+  return err<bool>("Daemon mode requires Unix domain sockets", "E005");
+}
+
+#else
+
+namespace {
+
+/// 完整写出，处理部分写入与 EINTR；MSG_NOSIGNAL 避免对端关闭时触发 SIGPIPE
+bool sendAll(int fd, const char *data, std::size_t size) {
+#ifdef MSG_NOSIGNAL
+  constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+  constexpr int kSendFlags = 0;
+#endif
+  while (size > 0) {
+    ssize_t n = ::send(fd, data, size, kSendFlags);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+/// 完整读取 size 字节，返回实际读到的字节数（小于 size 表示对端关闭）
+Result<std::size_t> recvAll(int fd, char *data, std::size_t size) {
+  std::size_t total = 0;
+  while (total < size) {
+    ssize_t n = ::recv(fd, data + total, size - total, 0);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return err<std::size_t>("Daemon connection timed out", "E005");
+      }
+      return err<std::size_t>("Daemon connection read failed (" +
+                                  std::generic_category().message(errno) + ")",
+                              "E005");
+    }
+    if (n == 0) {
+      break;
+    }
+    total += static_cast<std::size_t>(n);
+  }
+  return ok(std::move(total));
+}
+
+/// 以 errno 构造套接字错误
+template <typename T> Result<T> socketError(std::string_view what) {
+  return err<T>(std::string(what) + " (" +
+                    std::generic_category().message(errno) + ")",
+                "E005");
+}
+
+/// 创建设置了 close-on-exec 的 Unix 流套接字
+Result<UniqueFd> openUnixSocket() {
+  UniqueFd fd(::socket(AF_UNIX, SOCK_STREAM, 0));
+  if (!fd.valid()) {
+    return socketError<UniqueFd>("Failed to create daemon socket");
+  }
+  ::fcntl(fd.get(), F_SETFD, FD_CLOEXEC);
+  return ok(std::move(fd));
+}
+
+/// 填充套接字地址，路径超出 sun_path 时返回错误
+Result<sockaddr_un> socketAddress(const std::filesystem::path &socket) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  const auto &native = socket.native();
+  if (native.empty() || native.size() >= sizeof(addr.sun_path)) {
+    return err<sockaddr_un>("Daemon socket path is empty or too long: " +
+                                socket.string(),
+                            "E005");
+  }
+  std::memcpy(addr.sun_path, native.c_str(), native.size() + 1);
+  return ok(std::move(addr));
+}
+
+} // namespace
+
+Result<UniqueFd> connectDaemonSocket(const std::filesystem::path &socket) {
+  auto addr = socketAddress(socket);
+  if (!addr.has_value()) {
+    return std::unexpected(std::move(addr.error()));
+  }
+  auto fd = openUnixSocket();
+  if (!fd.has_value()) {
+    return fd;
+  }
+
+  int rc;
+  do {
+    rc = ::connect(fd->get(), reinterpret_cast<const sockaddr *>(&*addr),
+                   sizeof(sockaddr_un));
+  } while (rc < 0 && errno == EINTR);
+  if (rc < 0) {
+    return socketError<UniqueFd>("Cannot reach czc daemon at " +
+                                 socket.string());
+  }
+  return fd;
+}
+
+Result<UniqueFd> listenDaemonSocket(const std::filesystem::path &socket) {
+  auto addr = socketAddress(socket);
+  if (!addr.has_value()) {
+    return std::unexpected(std::move(addr.error()));
+  }
+
+  // 残留的套接字文件：仍可连接说明已有服务，否则删除后重新绑定
+  std::error_code ec;
+  if (std::filesystem::exists(std::filesystem::symlink_status(socket, ec))) {
+    if (connectDaemonSocket(socket).has_value()) {
+      return err<UniqueFd>("A czc daemon is already listening on " +
+                               socket.string(),
+                           "E005");
+    }
+    std::filesystem::remove(socket, ec);
+  }
+
+  auto fd = openUnixSocket();
+  if (!fd.has_value()) {
+    return fd;
+  }
+  if (::bind(fd->get(), reinterpret_cast<const sockaddr *>(&*addr),
+             sizeof(sockaddr_un)) < 0) {
+    return socketError<UniqueFd>("Failed to bind daemon socket " +
+                                 socket.string());
+  }
+  if (::listen(fd->get(), SOMAXCONN) < 0) {
+    return socketError<UniqueFd>("Failed to listen on daemon socket");
+  }
+  return fd;
+}
+
+Result<UniqueFd> acceptDaemonConnection(int listenFd) {
+  for (;;) {
+    int fd = ::accept(listenFd, nullptr, nullptr);
+    if (fd >= 0) {
+      ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+      return ok(UniqueFd(fd));
+    }
+    if (errno != EINTR && errno != ECONNABORTED) {
+      return socketError<UniqueFd>("Failed to accept daemon connection");
+    }
+  }
+}
+
+VoidResult setSocketTimeout(int fd, std::chrono::milliseconds timeout) {
+  const auto us =
+      std::chrono::duration_cast<std::chrono::microseconds>(timeout).count();
+  timeval tv{};
+  tv.tv_sec = static_cast<decltype(tv.tv_sec)>(us / 1'000'000);
+  tv.tv_usec = static_cast<decltype(tv.tv_usec)>(us % 1'000'000);
+  if (::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv) < 0 ||
+      ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof tv) < 0) {
+    return socketError<void>("Failed to set daemon connection timeout");
+  }
+  return ok();
+}
+
+void shutdownSocketReads(int fd) noexcept { ::shutdown(fd, SHUT_RD); }
+
+VoidResult writeFrame(int fd, std::string_view payload) {
+  if (payload.size() > kMaxDaemonFrame) {
+    return errVoid("Daemon frame too large", "E006");
+  }
+  std::string header;
+  putU32(header, static_cast<std::uint32_t>(payload.size()));
+  if (!sendAll(fd, header.data(), header.size()) ||
+      !sendAll(fd, payload.data(), payload.size())) {
+    return errVoid("Daemon connection write failed (" +
+                       std::generic_category().message(errno) + ")",
+                   "E005");
+  }
+  return ok();
+}
+
+Result<bool> readFrame(int fd, std::string &payload) {
+  char header[4];
+  auto got = recvAll(fd, header, sizeof(header));
+  if (!got.has_value()) {
+    return std::unexpected(std::move(got.error()));
+  }
+  if (got.value() == 0) {
+    return ok(false);
+  }
+  if (got.value() < sizeof(header)) {
+    return malformed<bool>("frame (truncated header)");
+  }
+
+  PayloadReader reader(std::string_view(header, sizeof(header)));
+  std::uint32_t size = reader.u32();
+  if (size > kMaxDaemonFrame) {
+    return malformed<bool>("frame (length too large)");
+  }
+
+  payload.resize(size);
+  got = recvAll(fd, payload.data(), size);
+  if (!got.has_value()) {
+    return std::unexpected(std::move(got.error()));
+  }
+  if (got.value() < size) {
+    return malformed<bool>("frame (truncated payload)");
+  }
+  return ok(true);
+}
+
+#endif
+
+} // namespace czc::cli
@@ -7,13 +7,17 @@
  */
 
 #include "czc/cli/driver.hpp"
+#include "czc/cli/daemon/daemon_client.hpp"
 #include "czc/cli/output/formatter.hpp"
+#include "czc/cli/output/parallel_writer.hpp"
 #include "czc/cli/phases/lexer_phase.hpp"
+#include "czc/cli/pipeline/token_pipeline.hpp"
 #include "czc/diag/diag_builder.hpp"
 #include "czc/diag/message.hpp"
+#include "czc/lexer/lexer_source_locator.hpp"
 
-#include <fstream>
-#include <iostream>
+#include <format>
+#include <memory>
 
 namespace czc::cli {
 
@@ -21,7 +25,19 @@ Driver::Driver() = default;
 
 Driver::Driver(CompilerContext ctx) : ctx_(std::move(ctx)) {}
 
+TaskScheduler &Driver::scheduler() {
+  if (!scheduler_) {
+    scheduler_ = std::make_unique<TaskScheduler>(
+        SchedulerOptions{.threads = ctx_.lexer().jobs.value_or(0)});
+  }
+  return *scheduler_;
+}
+
 int Driver::runLexer(const std::filesystem::path &inputFile) {
+  if (ctx_.lexer().pipelined) {
+    return runLexerPipelined(inputFile);
+  }
+
   // 创建词法分析阶段
   LexerPhase phase(ctx_);
 
@@ -37,31 +53,237 @@ int Driver::runLexer(const std::filesystem::path &inputFile) {
 
   const auto &lexResult = result.value();
 
-  // 格式化输出
-  auto formatter = createFormatter(ctx_.output().format);
-  std::string output;
-
   if (lexResult.hasErrors) {
     // 错误已通过诊断系统报告，这里只需返回错误码
     return 1;
   }
 
-  // 格式化 Token 输出
-  output = formatter->formatTokens(lexResult.tokens, phase.sourceManager());
+  auto sink = openOutputSink();
+  if (!sink) {
+    return 1;
+  }
+
+  return writeTokens(lexResult.tokens, *sink);
+}
+
+int Driver::runLexer(lexer::BufferID bufferId, OutputSink &sink) {
+  LexerPhase phase(ctx_);
+  auto lexResult = phase.runOnBuffer(bufferId);
+  if (lexResult.hasErrors) {
+    return 1;
+  }
+  return writeTokens(lexResult.tokens, sink);
+}
+
+int Driver::runLexer(const FileTokens &lexed, OutputSink &sink) {
+  if (lexed.hasErrors()) {
+    lexer::emitLexerErrors(ctx_.diagContext(), lexed.errors,
+                           ctx_.sourceLocator());
+    return 1;
+  }
+  return writeTokens(lexed.tokens, sink);
+}
+
+int Driver::runLexerRemote(const std::filesystem::path &inputFile) {
+  std::error_code ec;
+  auto cwd = std::filesystem::current_path(ec);
+
+  DaemonRequest request;
+  request.cwd = cwd.string();
+  request.path = inputFile.string();
+  request.preserveTrivia = ctx_.lexer().preserveTrivia;
+  request.dumpTokens = ctx_.lexer().dumpTokens;
+  request.colorDiagnostics = ctx_.global().colorDiagnostics;
+  request.format = ctx_.output().format;
+  request.maxErrorsPerCode =
+      static_cast<std::uint32_t>(ctx_.global().maxErrorsPerCode);
 
-  // 输出结果
-  if (ctx_.output().file.has_value()) {
-    std::ofstream ofs(ctx_.output().file.value());
-    if (!ofs) {
+  auto client = DaemonClient::connect(daemonSocket());
+  auto response = client.has_value()
+                      ? client->send(request)
+                      : Result<DaemonResponse>(std::unexpected(client.error()));
+  if (!response.has_value()) {
+    diagContext().emit(
+        diag::error(diag::Message(response.error().message)).build());
+    return 1;
+  }
+
+  // 诊断已由服务端渲染，原样写到本地错误流
+  *errStream_ << response->err << std::flush;
+  if (!response->out.empty()) {
+    auto sink = openOutputSink();
+    if (!sink) {
+      return 1;
+    }
+    sink->write(response->out);
+    if (finishOutput(*sink) != 0) {
+      return 1;
+    }
+  }
+  return response->exitCode;
+}
+
+int Driver::runLexerBatch(std::span<const BatchInput> inputs,
+                          const BatchOptions &options) {
+  std::unique_ptr<OutputSink> sink;
+  if (!options.outputDir.has_value()) {
+    sink = openOutputSink();
+    if (!sink) {
+      return 1;
+    }
+  }
+
+  BatchLexer batch(ctx_, options);
+  auto summary = batch.run(
+      inputs, scheduler(),
+      [&](const BatchInput &input, BatchFileResult &result) {
+        *errStream_ << result.diagnostics;
+        if (sink) {
+          BatchLexer::writeRecord(*sink, input, result);
+        }
+      });
+  errStream_->flush();
+
+  int exitCode = summary.failed == 0 ? 0 : 1;
+  if (sink && finishOutput(*sink) != 0) {
+    exitCode = 1;
+  }
+  if (!ctx_.isQuiet()) {
+    *errStream_ << std::format(
+        "lexed {} files ({} bytes, {} tokens), {} failed\n", summary.files,
+        summary.bytes, summary.tokens, summary.failed);
+  }
+  return exitCode;
+}
+
+int Driver::runLexerWatch(std::span<const std::string> args,
+                          FileWatcher &watcher, const WatchOptions &options) {
+  auto sink = openOutputSink();
+  if (!sink) {
+    return 1;
+  }
+
+  WatchLexer watch(ctx_, options);
+  auto initial = watch.start(args, watcher, scheduler(), *sink);
+  if (!initial.has_value()) {
+    diagContext().emit(
+        diag::error(diag::Message(initial.error().message)).build());
+    return 1;
+  }
+  if (finishOutput(*sink) != 0) {
+    return 1;
+  }
+  if (!ctx_.isQuiet()) {
+    *errStream_ << std::format("lexed {} files, {} failed; watching for "
+                               "changes\n",
+                               initial->lexed + initial->failed,
+                               initial->failed)
+                << std::flush;
+  }
+
+  while (true) {
+    auto events = watcher.next(options.debounce);
+    if (!events.has_value()) {
       diagContext().emit(
-          diag::error(diag::Message("Failed to open output file: " +
-                                    ctx_.output().file.value().string()))
-              .build());
+          diag::error(diag::Message(events.error().message)).build());
       return 1;
     }
-    ofs << output;
+    if (watcher.interrupted()) {
+      return 0;
+    }
+
+    auto summary = watch.apply(events.value(), *sink);
+    // 每批立即刷新，消费者无需等待缓冲区填满；输出端关闭时停止监视
+    if (finishOutput(*sink) != 0) {
+      return 1;
+    }
+    const auto touched = summary.lexed + summary.failed + summary.unchanged +
+                         summary.removed;
+    if (!ctx_.isQuiet() && touched != 0) {
+      *errStream_ << std::format(
+                         "relexed {} files ({} unchanged, {} removed), "
+                         "{} failed\n",
+                         summary.lexed + summary.failed, summary.unchanged,
+                         summary.removed, summary.failed)
+                  << std::flush;
+    }
+  }
+}
+
+std::filesystem::path Driver::daemonSocket() const {
+  return ctx_.global().daemonSocket.value_or(defaultDaemonSocket());
+}
+
+int Driver::writeTokens(const std::vector<lexer::Token> &tokens,
+                        OutputSink &sink) {
+  // 格式化器直接流式写入输出汇，不生成完整的中间字符串
+  auto formatter = createFormatter(ctx_.output().format);
+  // 单文件渲染仅在显式指定 -j 时并行
+  if (ctx_.lexer().jobs.value_or(1) == 1) {
+    formatter->writeTokens(tokens, ctx_.sourceManager(), sink);
   } else {
-    std::cout << output;
+    // 在 Driver 持有的调度器上分块渲染，按顺序聚集写出
+    ParallelTokenWriter writer(scheduler());
+    writer.write(*formatter, tokens, ctx_.sourceManager(), sink);
+  }
+
+  return finishOutput(sink);
+}
+
+int Driver::runLexerPipelined(const std::filesystem::path &inputFile) {
+  LexerPhase phase(ctx_);
+
+  auto bufferId = phase.loadFile(inputFile);
+  if (!bufferId.has_value()) {
+    diagContext().emit(
+        diag::error(diag::Message(bufferId.error().message)).build());
+    return 1;
+  }
+
+  auto sink = openOutputSink();
+  if (!sink) {
+    return 1;
+  }
+
+  // 扫描、格式化、写出三阶段在 Driver 的调度器上并发进行
+  lexer::Lexer lex(phase.sourceManager(), bufferId.value());
+  auto formatter = createFormatter(ctx_.output().format);
+  TokenPipeline pipeline;
+  (void)pipeline.run(lex, ctx_.lexer().preserveTrivia, *formatter,
+                     phase.sourceManager(), *sink, scheduler());
+
+  // 流水线模式下 Token 已边扫描边写出，错误在结束后统一报告
+  if (lex.hasErrors()) {
+    sink->flush();
+    phase.reportErrors(lex, bufferId.value());
+    return 1;
+  }
+
+  return finishOutput(*sink);
+}
+
+std::unique_ptr<OutputSink> Driver::openOutputSink() {
+  // 打开输出汇：文件或标准输出
+  if (!ctx_.output().file.has_value()) {
+    return FdSink::standardOutput();
+  }
+
+  auto opened = FdSink::open(ctx_.output().file.value());
+  if (!opened.has_value()) {
+    diagContext().emit(
+        diag::error(diag::Message(opened.error().message)).build());
+    return nullptr;
+  }
+  return std::move(opened.value());
+}
+
+int Driver::finishOutput(OutputSink &sink) {
+  sink.flush();
+
+  if (!sink.ok()) {
+    diagContext().emit(
+        diag::error(diag::Message("Failed to write lexer output")).build());
+    return 1;
   }
 
   return 0;
@@ -0,0 +1,343 @@
+/**
+ * @file document.cpp
+ * @brief 语言服务器文档的增量分析与语义 Token 编码实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/lsp/document.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/lexer/utf8.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace czc::cli {
+
+namespace {
+
+/**
+ * @brief 扫描器越过 Token 末尾最多查看的字节数。
+ *
+ * @details
+ *   peek(2) 与 UTF-8 标识符字符的解码最多看到末尾之后 4 个字节；
+ *   末尾与编辑区的距离不小于该值时，该 Token 不受编辑影响。
+ */
+constexpr std::uint32_t kLookahead = 4;
+
+/// 在纯文本中按 LSP 位置求字节偏移（仅用于同一通知中的多项变更）
+std::size_t offsetInText(std::string_view text, LspPosition position) {
+  std::size_t lineStart = 0;
+  for (std::uint32_t line = 0; line < position.line; ++line) {
+    const void *nl = std::memchr(text.data() + lineStart, '\n',
+                                 text.size() - lineStart);
+    if (nl == nullptr) {
+      return text.size();
+    }
+    lineStart = static_cast<std::size_t>(static_cast<const char *>(nl) -
+                                         text.data()) +
+                1;
+  }
+
+  auto rest = text.substr(lineStart);
+  auto lineEnd = rest.find('\n');
+  auto content = rest.substr(0, lineEnd);
+  if (!content.empty() && content.back() == '\r') {
+    content.remove_suffix(1);
+  }
+  return lineStart +
+         lexer::utf8::utf16ToByteOffset(content, position.character);
+}
+
+} // namespace
+
+std::optional<SemanticTokenType>
+semanticTypeOf(lexer::TokenType type) noexcept {
+  using lexer::TokenType;
+  if (type == TokenType::IDENTIFIER) {
+    return SemanticTokenType::Variable;
+  }
+  if (type >= TokenType::KW_LET && type <= TokenType::KW_AS) {
+    return SemanticTokenType::Keyword;
+  }
+  switch (type) {
+  case TokenType::LIT_INT:
+  case TokenType::LIT_FLOAT:
+  case TokenType::LIT_DECIMAL:
+    return SemanticTokenType::Number;
+  case TokenType::LIT_STRING:
+  case TokenType::LIT_RAW_STRING:
+  case TokenType::LIT_TEX_STRING:
+    return SemanticTokenType::String;
+  case TokenType::LIT_TRUE:
+  case TokenType::LIT_FALSE:
+  case TokenType::LIT_NULL:
+    return SemanticTokenType::Keyword;
+  default:
+    break;
+  }
+  if (type >= TokenType::OP_PLUS && type <= TokenType::OP_COLON_COLON) {
+    return SemanticTokenType::Operator;
+  }
+  return std::nullopt;
+}
+
+// ========== 生命周期 ==========
+
+LspDocument::LspDocument(lexer::SourceManager &sm, std::string uri,
+                         std::string text, std::int64_t version)
+    : sm_(&sm), uri_(std::move(uri)), version_(version) {
+  buffer_ = sm_->addBuffer(std::move(text), uri_);
+  relex(0, 0, 0);
+}
+
+void LspDocument::applyChanges(std::span<const LspContentChange> changes,
+                               std::int64_t version) {
+  version_ = version;
+  if (changes.empty()) {
+    return;
+  }
+
+  auto old = text();
+  std::string working(old);
+
+  // 未变化的前缀/后缀长度（以旧文本计），逐项收紧
+  std::size_t prefix = old.size();
+  std::size_t suffix = old.size();
+  bool fullReplace = false;
+
+  for (std::size_t i = 0; i < changes.size(); ++i) {
+    const auto &change = changes[i];
+    if (!change.range.has_value()) {
+      working = change.text;
+      fullReplace = true;
+      continue;
+    }
+
+    // 单项变更直接使用行偏移表，多项时在工作文本上定位
+    std::size_t start = 0;
+    std::size_t end = 0;
+    if (i == 0) {
+      start = offsetAt(change.range->start);
+      end = offsetAt(change.range->end);
+    } else {
+      start = offsetInText(working, change.range->start);
+      end = offsetInText(working, change.range->end);
+    }
+    end = std::max(start, end);
+
+    prefix = std::min(prefix, start);
+    suffix = std::min(suffix, working.size() - end);
+    working.replace(start, end - start, change.text);
+  }
+
+  if (fullReplace) {
+    // 整篇替换没有位置信息，直接比较新旧文本
+    auto limit = std::min(old.size(), working.size());
+    prefix = static_cast<std::size_t>(
+        std::mismatch(old.begin(), old.begin() + static_cast<long>(limit),
+                      working.begin())
+            .first -
+        old.begin());
+    suffix = 0;
+    while (suffix < limit - prefix &&
+           old[old.size() - 1 - suffix] ==
+               working[working.size() - 1 - suffix]) {
+      ++suffix;
+    }
+  }
+
+  // 前后缀不能重叠
+  auto shorter = std::min(old.size(), working.size());
+  prefix = std::min(prefix, shorter);
+  suffix = std::min(suffix, shorter - prefix);
+
+  auto delta = static_cast<std::int64_t>(working.size()) -
+               static_cast<std::int64_t>(old.size());
+  buffer_ = sm_->addBuffer(std::move(working), uri_);
+  relex(static_cast<std::uint32_t>(prefix),
+        static_cast<std::uint32_t>(suffix), delta);
+}
+
+void LspDocument::rebind(lexer::SourceManager &sm) {
+  auto source = text();
+  buffer_ = sm.addBuffer(source, uri_);
+  sm_ = &sm;
+}
+
+std::string_view LspDocument::text() const { return sm_->getSource(buffer_); }
+
+// ========== 增量分析 ==========
+
+void LspDocument::relex(std::uint32_t prefix, std::uint32_t suffix,
+                        std::int64_t delta) {
+  auto size = static_cast<std::uint32_t>(text().size());
+  // 编辑区在新文本中的末尾
+  std::uint32_t editEnd = size - suffix;
+
+  // 保留末尾距编辑区至少 kLookahead 的 Token，从最后一个的末尾重新开始
+  auto kept = std::partition_point(
+      tokens_.begin(), tokens_.end(), [&](const LspToken &token) {
+        return token.offset + token.length + kLookahead <= prefix;
+      });
+  std::uint32_t restart =
+      kept == tokens_.begin() ? 0 : (kept - 1)->offset + (kept - 1)->length;
+
+  std::vector<LspToken> oldTokens(kept, tokens_.end());
+  tokens_.erase(kept, tokens_.end());
+
+  std::vector<LspDiagnostic> oldDiagnostics;
+  auto keptDiag = std::partition_point(
+      diagnostics_.begin(), diagnostics_.end(),
+      [&](const LspDiagnostic &d) { return d.offset < restart; });
+  std::move(keptDiag, diagnostics_.end(),
+            std::back_inserter(oldDiagnostics));
+  diagnostics_.erase(keptDiag, diagnostics_.end());
+
+  stats_ = RelexStats{restart, 0, 0};
+
+  lexer::Lexer lexer(*sm_, buffer_);
+  lexer.resumeAt(restart);
+
+  std::size_t oldIndex = 0;
+  std::optional<std::uint32_t> converged;
+  while (true) {
+    auto token = lexer.nextToken();
+    if (token.type() == lexer::TokenType::TOKEN_EOF) {
+      break;
+    }
+
+    // 越过编辑区后，起点与旧 Token 对齐即可复用余下结果
+    if (token.offset() >= editEnd) {
+      auto oldOffset = static_cast<std::uint32_t>(token.offset() - delta);
+      while (oldIndex < oldTokens.size() &&
+             oldTokens[oldIndex].offset < oldOffset) {
+        ++oldIndex;
+      }
+      if (oldIndex < oldTokens.size() &&
+          oldTokens[oldIndex].offset == oldOffset) {
+        converged = token.offset();
+        break;
+      }
+    }
+
+    ++stats_.lexedTokens;
+    if (auto type = semanticTypeOf(token.type()); type.has_value()) {
+      tokens_.push_back(LspToken{token.offset(), token.length(), *type});
+    }
+  }
+
+  // 对齐点之前产生的错误属于新结果，之后的由旧结果平移得到
+  auto firstNew = diagnostics_.size();
+  for (const auto &error : lexer.errors()) {
+    if (converged.has_value() && error.location.offset >= *converged) {
+      continue;
+    }
+    diagnostics_.push_back(LspDiagnostic{error.location.offset, error.length,
+                                         error.code,
+                                         error.formattedMessage});
+  }
+  // 字符串未闭合等错误在其内部错误之后报告，按偏移重新排序
+  std::stable_sort(diagnostics_.begin() + static_cast<long>(firstNew),
+                   diagnostics_.end(),
+                   [](const LspDiagnostic &a, const LspDiagnostic &b) {
+                     return a.offset < b.offset;
+                   });
+
+  if (!converged.has_value()) {
+    return;
+  }
+
+  auto oldConverged = static_cast<std::uint32_t>(*converged - delta);
+  stats_.reusedTokens = oldTokens.size() - oldIndex;
+  tokens_.reserve(tokens_.size() + stats_.reusedTokens);
+  for (auto i = oldIndex; i < oldTokens.size(); ++i) {
+    auto token = oldTokens[i];
+    token.offset = static_cast<std::uint32_t>(token.offset + delta);
+    tokens_.push_back(token);
+  }
+  for (auto &diagnostic : oldDiagnostics) {
+    if (diagnostic.offset >= oldConverged) {
+      diagnostic.offset = static_cast<std::uint32_t>(diagnostic.offset + delta);
+      diagnostics_.push_back(std::move(diagnostic));
+    }
+  }
+}
+
+// ========== 位置换算 ==========
+
+LspPosition LspDocument::positionAt(std::uint32_t offset) const {
+  offset = std::min(offset, static_cast<std::uint32_t>(text().size()));
+  auto line = sm_->getLineNumber(buffer_, offset);
+  return LspPosition{line - 1, sm_->getColumnOnLine(buffer_, line, offset,
+                                                    lexer::ColumnUnit::Utf16)};
+}
+
+std::uint32_t LspDocument::offsetAt(LspPosition position) const {
+  return sm_
+      ->getOffset(buffer_, position.line + 1, position.character,
+                  lexer::ColumnUnit::Utf16)
+      .value_or(static_cast<std::uint32_t>(text().size()));
+}
+
+// ========== 语义 Token ==========
+
+std::vector<std::uint32_t> LspDocument::encodeSemanticTokens() const {
+  auto source = text();
+  auto lineStarts = sm_->getLineStarts(buffer_);
+
+  std::vector<std::uint32_t> data;
+  data.reserve(tokens_.size() * 5);
+
+  // Token 按偏移升序：行号单调推进，列号由 SourceManager 的位置索引换算
+  std::size_t line = 0;
+  std::uint32_t prevLine = 0;
+  std::uint32_t prevChar = 0;
+
+  auto lineEndOf = [&](std::size_t l) {
+    return l + 1 < lineStarts.size() ? lineStarts[l + 1] : source.size();
+  };
+  auto utf16Column = [&](std::size_t l, std::size_t offset) {
+    return sm_->getColumnOnLine(buffer_, static_cast<std::uint32_t>(l + 1),
+                                static_cast<std::uint32_t>(offset),
+                                lexer::ColumnUnit::Utf16);
+  };
+
+  for (const auto &token : tokens_) {
+    std::size_t start = token.offset;
+    std::size_t end = std::min<std::size_t>(token.offset + token.length,
+                                            source.size());
+    while (start < end) {
+      while (lineEndOf(line) <= start) {
+        ++line;
+      }
+
+      // 本行内的片段，去掉行尾换行符
+      std::size_t lineEnd = lineEndOf(line);
+      std::size_t segmentEnd = std::min(end, lineEnd);
+      while (segmentEnd > start && (source[segmentEnd - 1] == '\n' ||
+                                    source[segmentEnd - 1] == '\r')) {
+        --segmentEnd;
+      }
+
+      if (segmentEnd > start) {
+        auto lineNo = static_cast<std::uint32_t>(line);
+        auto deltaLine = lineNo - prevLine;
+        auto startChar = utf16Column(line, start);
+        data.push_back(deltaLine);
+        data.push_back(deltaLine == 0 ? startChar - prevChar : startChar);
+        data.push_back(utf16Column(line, segmentEnd) - startChar);
+        data.push_back(static_cast<std::uint32_t>(token.type));
+        data.push_back(0);
+        prevLine = lineNo;
+        prevChar = startChar;
+      }
+      start = lineEnd;
+    }
+  }
+  return data;
+}
+
+} // namespace czc::cli
@@ -0,0 +1,386 @@
+/**
+ * @file lsp_server.cpp
+ * @brief 基于 stdio 的语言服务器实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/lsp/lsp_server.hpp"
+#include "czc/cli/lsp/transport.hpp"
+#include "czc/common/json_writer.hpp"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+
+namespace czc::cli {
+
+namespace {
+
+// JSON-RPC / LSP 错误码
+constexpr int kParseError = -32700;
+constexpr int kInvalidRequest = -32600;
+constexpr int kMethodNotFound = -32601;
+
+/// 读取 LSP 位置
+LspPosition toPosition(const JsonValue &value) {
+  return LspPosition{static_cast<std::uint32_t>(value["line"].asInt()),
+                     static_cast<std::uint32_t>(value["character"].asInt())};
+}
+
+/// 写出 LSP 位置
+void writePosition(OutputSink &sink, LspPosition position) {
+  sink.write(R"({"line":)");
+  sink.writeInt(position.line);
+  sink.write(R"(,"character":)");
+  sink.writeInt(position.character);
+  sink.put('}');
+}
+
+/// 写出整数数组
+void writeIntArray(OutputSink &sink, std::span<const std::uint32_t> values) {
+  sink.put('[');
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    if (i != 0) {
+      sink.put(',');
+    }
+    sink.writeInt(values[i]);
+  }
+  sink.put(']');
+}
+
+} // namespace
+
+LspServer::LspServer(std::istream &in, OutputSink &out)
+    : in_(in), out_(out),
+      sources_(std::make_unique<lexer::SourceManager>()) {}
+
+// ========== 消息循环 ==========
+
+int LspServer::run() {
+  std::string body;
+  while (!exited_) {
+    auto got = readLspMessage(in_, body);
+    if (!got.has_value()) {
+      std::cerr << got.error().format() << "\n";
+      break;
+    }
+    if (!got.value()) {
+      break; // 客户端关闭了输入
+    }
+
+    auto message = parseJson(body);
+    if (!message.has_value()) {
+      replyError(JsonValue(), kParseError, message.error().message);
+      continue;
+    }
+    handle(message.value());
+  }
+  return shutdown_ && exited_ ? 0 : 1;
+}
+
+void LspServer::handle(const JsonValue &message) {
+  const auto *method = message.find("method");
+  if (method == nullptr) {
+    return; // 客户端对服务端请求的响应，当前不发送请求
+  }
+  auto name = method->asString();
+  const auto *id = message.find("id");
+  const auto &params = message["params"];
+
+  if (id == nullptr) {
+    // 通知
+    if (name == "exit") {
+      exited_ = true;
+    } else if (name == "textDocument/didOpen") {
+      didOpen(params);
+    } else if (name == "textDocument/didChange") {
+      didChange(params);
+    } else if (name == "textDocument/didClose") {
+      didClose(params);
+    }
+    return;
+  }
+
+  if (shutdown_) {
+    replyError(*id, kInvalidRequest, "Server is shutting down");
+  } else if (name == "initialize") {
+    initialize(*id);
+  } else if (name == "shutdown") {
+    shutdown_ = true;
+    reply(*id, "null");
+  } else if (name == "textDocument/semanticTokens/full") {
+    semanticTokensFull(*id, params);
+  } else if (name == "textDocument/semanticTokens/full/delta") {
+    semanticTokensDelta(*id, params);
+  } else {
+    replyError(*id, kMethodNotFound, "Unhandled method");
+  }
+}
+
+const LspDocument *LspServer::document(std::string_view uri) const {
+  auto it = documents_.find(std::string(uri));
+  return it != documents_.end() ? &it->second.document : nullptr;
+}
+
+// ========== 请求处理 ==========
+
+void LspServer::initialize(const JsonValue &id) {
+  std::string result;
+  {
+    StringSink sink(result);
+    sink.write(R"({"capabilities":{"positionEncoding":"utf-16",)"
+               R"("textDocumentSync":{"openClose":true,"change":2},)"
+               R"("semanticTokensProvider":{"legend":{"tokenTypes":[)");
+    for (std::size_t i = 0; i < kSemanticTokenLegend.size(); ++i) {
+      if (i != 0) {
+        sink.put(',');
+      }
+      writeJsonString(sink, kSemanticTokenLegend[i]);
+    }
+    sink.write(R"(],"tokenModifiers":[]},"full":{"delta":true}}},)"
+               R"("serverInfo":{"name":"czc","version":)");
+    writeJsonString(sink, kVersion.string);
+    sink.write("}}");
+  }
+  reply(id, result);
+}
+
+void LspServer::didOpen(const JsonValue &params) {
+  const auto &item = params["textDocument"];
+  std::string uri(item["uri"].asString());
+
+  LspDocument document(*sources_, uri, std::string(item["text"].asString()),
+                       item["version"].asInt());
+  auto it = documents_
+                .insert_or_assign(
+                    uri, OpenDocument{std::move(document), {}, {}})
+                .first;
+  compactSources();
+  publishDiagnostics(it->second.document);
+}
+
+void LspServer::didChange(const JsonValue &params) {
+  const auto &item = params["textDocument"];
+  auto it = documents_.find(std::string(item["uri"].asString()));
+  if (it == documents_.end()) {
+    return;
+  }
+
+  std::vector<LspContentChange> changes;
+  for (const auto &change : params["contentChanges"].asArray()) {
+    LspContentChange parsed;
+    if (const auto *range = change.find("range"); range != nullptr) {
+      parsed.range = LspRange{toPosition((*range)["start"]),
+                              toPosition((*range)["end"])};
+    }
+    parsed.text = change["text"].asString();
+    changes.push_back(std::move(parsed));
+  }
+
+  it->second.document.applyChanges(changes, item["version"].asInt());
+  compactSources();
+  publishDiagnostics(it->second.document);
+}
+
+void LspServer::didClose(const JsonValue &params) {
+  std::string uri(params["textDocument"]["uri"].asString());
+  if (documents_.erase(uri) == 0) {
+    return;
+  }
+  compactSources();
+
+  // 关闭后清空编辑器中的诊断
+  std::string notification;
+  {
+    StringSink sink(notification);
+    sink.write(R"({"uri":)");
+    writeJsonString(sink, uri);
+    sink.write(R"(,"diagnostics":[]})");
+  }
+  notify("textDocument/publishDiagnostics", notification);
+}
+
+void LspServer::semanticTokensFull(const JsonValue &id,
+                                   const JsonValue &params) {
+  auto it = documents_.find(
+      std::string(params["textDocument"]["uri"].asString()));
+  if (it == documents_.end()) {
+    reply(id, "null");
+    return;
+  }
+
+  auto &open = it->second;
+  refreshTokens(open);
+
+  std::string result;
+  {
+    StringSink sink(result);
+    sink.write(R"({"resultId":)");
+    writeJsonString(sink, open.resultId);
+    sink.write(R"(,"data":)");
+    writeIntArray(sink, open.data);
+    sink.put('}');
+  }
+  reply(id, result);
+}
+
+void LspServer::semanticTokensDelta(const JsonValue &id,
+                                    const JsonValue &params) {
+  auto it = documents_.find(
+      std::string(params["textDocument"]["uri"].asString()));
+  if (it == documents_.end()) {
+    reply(id, "null");
+    return;
+  }
+
+  auto &open = it->second;
+  if (open.resultId.empty() ||
+      params["previousResultId"].asString() != open.resultId) {
+    // 客户端持有的结果已失效，退回完整结果
+    semanticTokensFull(id, params);
+    return;
+  }
+
+  auto previous = std::move(open.data);
+  refreshTokens(open);
+  const auto &current = open.data;
+
+  // 单个编辑：去掉相同的前缀与后缀，替换中间部分
+  auto limit = std::min(previous.size(), current.size());
+  std::size_t prefix = static_cast<std::size_t>(
+      std::mismatch(previous.begin(),
+                    previous.begin() + static_cast<long>(limit),
+                    current.begin())
+          .first -
+      previous.begin());
+  std::size_t suffix = 0;
+  while (suffix < limit - prefix &&
+         previous[previous.size() - 1 - suffix] ==
+             current[current.size() - 1 - suffix]) {
+    ++suffix;
+  }
+
+  std::string result;
+  {
+    StringSink sink(result);
+    sink.write(R"({"resultId":)");
+    writeJsonString(sink, open.resultId);
+    sink.write(R"(,"edits":[)");
+    if (prefix != previous.size() || prefix != current.size()) {
+      sink.write(R"({"start":)");
+      sink.writeInt(prefix);
+      sink.write(R"(,"deleteCount":)");
+      sink.writeInt(previous.size() - prefix - suffix);
+      sink.write(R"(,"data":)");
+      writeIntArray(sink, std::span<const std::uint32_t>(current).subspan(
+                              prefix, current.size() - prefix - suffix));
+      sink.put('}');
+    }
+    sink.write("]}");
+  }
+  reply(id, result);
+}
+
+// ========== 辅助 ==========
+
+void LspServer::publishDiagnostics(const LspDocument &document) {
+  std::string notification;
+  {
+    StringSink sink(notification);
+    sink.write(R"({"uri":)");
+    writeJsonString(sink, document.uri());
+    sink.write(R"(,"version":)");
+    sink.writeInt(document.version());
+    sink.write(R"(,"diagnostics":[)");
+
+    bool first = true;
+    for (const auto &diagnostic : document.diagnostics()) {
+      if (!first) {
+        sink.put(',');
+      }
+      first = false;
+      sink.write(R"({"range":{"start":)");
+      writePosition(sink, document.positionAt(diagnostic.offset));
+      sink.write(R"(,"end":)");
+      writePosition(sink,
+                    document.positionAt(diagnostic.offset + diagnostic.length));
+      sink.write(R"(},"severity":1,"code":")");
+      sink.write(std::format("L{:04d}", static_cast<int>(diagnostic.code)));
+      sink.write(R"(","source":"czc","message":)");
+      writeJsonString(sink, diagnostic.message);
+      sink.put('}');
+    }
+    sink.write("]}");
+  }
+  notify("textDocument/publishDiagnostics", notification);
+}
+
+void LspServer::refreshTokens(OpenDocument &open) {
+  open.data = open.document.encodeSemanticTokens();
+  open.resultId = std::to_string(nextResultId_++);
+}
+
+void LspServer::compactSources() {
+  std::size_t live = 0;
+  for (const auto &[uri, open] : documents_) {
+    live += open.document.text().size();
+  }
+  const auto limit = std::max(live * kRetainedFactor, kMinRetainedBytes);
+  // 迁移后每个打开的文档仍各占一个缓冲区，数量上限不低于其两倍
+  const auto maxBuffers = std::max(kMaxBuffers, documents_.size() * 2);
+  if (sources_->sourceBytes() <= limit &&
+      sources_->bufferCount() < maxBuffers) {
+    return;
+  }
+  auto fresh = std::make_unique<lexer::SourceManager>();
+  for (auto &[uri, open] : documents_) {
+    open.document.rebind(*fresh);
+  }
+  sources_ = std::move(fresh);
+}
+
+void LspServer::reply(const JsonValue &id, std::string_view result) {
+  std::string body;
+  {
+    StringSink sink(body);
+    sink.write(R"({"jsonrpc":"2.0","id":)");
+    writeJson(sink, id);
+    sink.write(R"(,"result":)");
+    sink.write(result);
+    sink.put('}');
+  }
+  writeLspMessage(out_, body);
+}
+
+void LspServer::replyError(const JsonValue &id, int code,
+                           std::string_view message) {
+  std::string body;
+  {
+    StringSink sink(body);
+    sink.write(R"({"jsonrpc":"2.0","id":)");
+    writeJson(sink, id);
+    sink.write(R"(,"error":{"code":)");
+    sink.writeInt(code);
+    sink.write(R"(,"message":)");
+    writeJsonString(sink, message);
+    sink.write("}}");
+  }
+  writeLspMessage(out_, body);
+}
+
+void LspServer::notify(std::string_view method, std::string_view params) {
+  std::string body;
+  {
+    StringSink sink(body);
+    sink.write(R"({"jsonrpc":"2.0","method":)");
+    writeJsonString(sink, method);
+    sink.write(R"(,"params":)");
+    sink.write(params);
+    sink.put('}');
+  }
+  writeLspMessage(out_, body);
+}
+
+} // namespace czc::cli
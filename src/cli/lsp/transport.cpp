@@ -0,0 +1,74 @@
+/**
+ * @file transport.cpp
+ * @brief LSP 消息分帧实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/lsp/transport.hpp"
+
+#include <charconv>
+#include <optional>
+
+namespace czc::cli {
+
+Result<bool> readLspMessage(std::istream &in, std::string &body) {
+  std::string line;
+  std::optional<std::size_t> length;
+  bool sawHeader = false;
+
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty()) {
+      if (!sawHeader) {
+        continue; // 消息之间多余的空行
+      }
+      break;
+    }
+    sawHeader = true;
+
+    constexpr std::string_view kContentLength = "Content-Length:";
+    if (line.size() > kContentLength.size() &&
+        std::string_view(line).substr(0, kContentLength.size()) ==
+            kContentLength) {
+      auto value = std::string_view(line).substr(kContentLength.size());
+      while (!value.empty() && value.front() == ' ') {
+        value.remove_prefix(1);
+      }
+      std::size_t parsed = 0;
+      auto [end, ec] =
+          std::from_chars(value.data(), value.data() + value.size(), parsed);
+      if (ec != std::errc() || end != value.data() + value.size()) {
+        return err<bool>("Malformed LSP Content-Length header", "E006");
+      }
+      length = parsed;
+    }
+  }
+
+  if (!sawHeader) {
+    return Result<bool>(false);
+  }
+  if (!length.has_value() || *length > kMaxLspMessage) {
+    return err<bool>("Missing or oversized LSP Content-Length", "E006");
+  }
+
+  body.resize(*length);
+  in.read(body.data(), static_cast<std::streamsize>(*length));
+  if (static_cast<std::size_t>(in.gcount()) != *length) {
+    return err<bool>("Truncated LSP message", "E006");
+  }
+  return Result<bool>(true);
+}
+
+void writeLspMessage(OutputSink &out, std::string_view body) {
+  out.write("Content-Length: ");
+  out.writeInt(body.size());
+  out.write("\r\n\r\n");
+  out.write(body);
+  out.flush();
+}
+
+} // namespace czc::cli
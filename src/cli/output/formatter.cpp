@@ -0,0 +1,34 @@
+/**
+ * @file formatter.cpp
+ * @brief 输出格式化器接口的便捷包装实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/output/formatter.hpp"
+
+namespace czc::cli {
+
+std::string OutputFormatter::formatTokens(std::span<const lexer::Token> tokens,
+                                          const lexer::SourceManager &sm) const {
+  std::string out;
+  {
+    StringSink sink(out);
+    writeTokens(tokens, sm, sink);
+  }
+  return out;
+}
+
+std::string
+OutputFormatter::formatErrors(std::span<const lexer::LexerError> errors,
+                              const lexer::SourceManager &sm) const {
+  std::string out;
+  {
+    StringSink sink(out);
+    writeErrors(errors, sm, sink);
+  }
+  return out;
+}
+
+} // namespace czc::cli
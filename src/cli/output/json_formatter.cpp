@@ -8,114 +8,130 @@
 
 #include "czc/cli/output/json_formatter.hpp"
 #include "czc/cli/output/text_formatter.hpp"
+#include "czc/common/json_writer.hpp"
 #include "czc/lexer/token.hpp"
 
-#include <glaze/glaze.hpp>
-
-#include <vector>
-
 namespace czc::cli {
 
-// JSON 数据结构
-namespace json_types {
-
-/// Token 的 JSON 表示结构
-struct TokenJson {
-  std::string type;
-  std::string value;
-  std::uint32_t line;
-  std::uint32_t column;
-  std::uint32_t offset;
-  std::uint16_t length;
-};
-
-/// 错误的 JSON 表示结构
-struct ErrorJson {
-  int code;
-  std::string message;
-  std::string file;
-  std::uint32_t line;
-  std::uint32_t column;
-};
-
-/// Token 列表的 JSON 响应
-struct TokensResponse {
-  bool success{true};
-  std::size_t count{0};
-  std::vector<TokenJson> tokens;
-};
-
-/// 错误列表的 JSON 响应
-struct ErrorsResponse {
-  bool success{false};
-  std::size_t count{0};
-  std::vector<ErrorJson> errors;
-};
-
-} // namespace json_types
-
-using namespace json_types;
-
-std::string JsonFormatter::formatTokens(std::span<const lexer::Token> tokens,
-                                        const lexer::SourceManager &sm) const {
-  TokensResponse response;
-  response.count = tokens.size();
-  response.tokens.reserve(tokens.size());
-
-  for (const auto &token : tokens) {
-    const auto &loc = token.location();
-
-    TokenJson json_token;
-    json_token.type = std::string(lexer::tokenTypeName(token.type()));
-    json_token.value = std::string(token.value(sm));
-    json_token.line = loc.line;
-    json_token.column = loc.column;
-    json_token.offset = loc.offset;
-    json_token.length = token.length();
-
-    response.tokens.push_back(std::move(json_token));
-  }
+namespace {
 
-  // 使用 glaze 序列化为 JSON
-  std::string json;
-  auto result = glz::write_json(response, json);
-  if (result) {
-    // 序列化失败，返回错误 JSON
-    return R"({"success": false, "error": "JSON serialization failed"})";
-  }
+/**
+ * @brief 写入单个 Token 对象。
+ *
+ * @details
+ *   字段顺序与旧版 glaze 结构体一致：type, value, line, column, offset, length。
+ */
+void writeTokenObject(const lexer::Token &token, const lexer::SourceManager &sm,
+                      OutputSink &sink) {
+  const auto &loc = token.location();
+
+  sink.write(R"({"type":")");
+  // 类型名均为 [A-Z_] 组成的静态字符串，无需转义
+  sink.write(lexer::tokenTypeName(token.type()));
+  sink.write(R"(","value":")");
+  writeJsonEscaped(sink, token.value(sm));
+  sink.write(R"(","line":)");
+  sink.writeInt(loc.line);
+  sink.write(R"(,"column":)");
+  sink.writeInt(loc.column);
+  sink.write(R"(,"offset":)");
+  sink.writeInt(loc.offset);
+  sink.write(R"(,"length":)");
+  sink.writeInt(token.length());
+  sink.put('}');
+}
 
-  return json;
+/**
+ * @brief 写入单个错误对象。
+ */
+void writeErrorObject(const lexer::LexerError &error,
+                      const lexer::SourceManager &sm, OutputSink &sink) {
+  const auto &loc = error.location;
+
+  sink.write(R"({"code":)");
+  sink.writeInt(static_cast<int>(error.code));
+  sink.write(R"(,"message":)");
+  writeJsonString(sink, error.formattedMessage);
+  sink.write(R"(,"file":)");
+  writeJsonString(sink, sm.getFilename(loc.buffer));
+  sink.write(R"(,"line":)");
+  sink.writeInt(loc.line);
+  sink.write(R"(,"column":)");
+  sink.writeInt(loc.column);
+  sink.put('}');
 }
 
-std::string
-JsonFormatter::formatErrors(std::span<const lexer::LexerError> errors,
-                            const lexer::SourceManager &sm) const {
-  ErrorsResponse response;
-  response.count = errors.size();
-  response.errors.reserve(errors.size());
+} // namespace
 
-  for (const auto &error : errors) {
-    const auto &loc = error.location;
+void JsonFormatter::beginTokens(OutputSink &sink,
+                                std::optional<std::size_t> count) const {
+  if (layout_ == JsonLayout::Lines) {
+    return;
+  }
+  sink.write(R"({"success":true,)");
+  if (count.has_value()) {
+    sink.write(R"("count":)");
+    sink.writeInt(*count);
+    sink.put(',');
+  }
+  sink.write(R"("tokens":[)");
+}
 
-    ErrorJson json_error;
-    json_error.code = static_cast<int>(error.code);
-    json_error.message = error.formattedMessage;
-    json_error.file = std::string(sm.getFilename(loc.buffer));
-    json_error.line = loc.line;
-    json_error.column = loc.column;
+void JsonFormatter::writeTokenRange(std::span<const lexer::Token> tokens,
+                                    const lexer::SourceManager &sm,
+                                    OutputSink &sink,
+                                    std::size_t firstIndex) const {
+  if (layout_ == JsonLayout::Lines) {
+    for (const auto &token : tokens) {
+      writeTokenObject(token, sm, sink);
+      sink.put('\n');
+    }
+    return;
+  }
 
-    response.errors.push_back(std::move(json_error));
+  // 分隔符写在每个非首个 Token 之前，片段边界因此无需特殊处理
+  for (std::size_t i = 0; i < tokens.size(); ++i) {
+    if (firstIndex + i != 0) {
+      sink.put(',');
+    }
+    writeTokenObject(tokens[i], sm, sink);
   }
+}
 
-  // 使用 glaze 序列化为 JSON
-  std::string json;
-  auto result = glz::write_json(response, json);
-  if (result) {
-    // 序列化失败，返回错误 JSON
-    return R"({"success": false, "error": "JSON serialization failed"})";
+void JsonFormatter::endTokens(OutputSink &sink,
+                              std::optional<std::size_t> count) const {
+  if (layout_ == JsonLayout::Lines) {
+    return;
+  }
+  sink.put(']');
+  if (count.has_value()) {
+    sink.write(R"(,"count":)");
+    sink.writeInt(*count);
+  }
+  sink.put('}');
+}
+
+void JsonFormatter::writeErrors(std::span<const lexer::LexerError> errors,
+                                const lexer::SourceManager &sm,
+                                OutputSink &sink) const {
+  if (layout_ == JsonLayout::Lines) {
+    for (const auto &error : errors) {
+      writeErrorObject(error, sm, sink);
+      sink.put('\n');
+    }
+    return;
   }
 
-  return json;
+  sink.write(R"({"success":false,"count":)");
+  sink.writeInt(errors.size());
+  sink.write(R"(,"errors":[)");
+  for (std::size_t i = 0; i < errors.size(); ++i) {
+    if (i != 0) {
+      sink.put(',');
+    }
+    writeErrorObject(errors[i], sm, sink);
+  }
+  sink.write("]}");
 }
 
 // 工厂函数实现
@@ -123,6 +139,8 @@ std::unique_ptr<OutputFormatter> createFormatter(OutputFormat format) {
   switch (format) {
   case OutputFormat::Json:
     return std::make_unique<JsonFormatter>();
+  case OutputFormat::NdJson:
+    return std::make_unique<JsonFormatter>(JsonLayout::Lines);
   case OutputFormat::Text:
   default:
     return std::make_unique<TextFormatter>();
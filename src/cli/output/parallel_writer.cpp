@@ -0,0 +1,80 @@
+/**
+ * @file parallel_writer.cpp
+ * @brief 分块并行渲染的 Token 输出器实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/output/parallel_writer.hpp"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace czc::cli {
+
+namespace {
+
+/// 单次 writeVectored() 最多合并的块数
+constexpr std::size_t kMaxBatch = 64;
+
+} // namespace
+
+std::size_t ParallelTokenWriter::effectiveJobs() const noexcept {
+  return scheduler_.concurrency();
+}
+
+void ParallelTokenWriter::write(const OutputFormatter &formatter,
+                                std::span<const lexer::Token> tokens,
+                                const lexer::SourceManager &sm,
+                                OutputSink &sink) const {
+  const std::size_t chunkTokens =
+      std::max<std::size_t>(1, options_.chunkTokens);
+  const std::size_t chunkCount =
+      (tokens.size() + chunkTokens - 1) / chunkTokens;
+  const std::size_t jobs = std::min(effectiveJobs(), chunkCount);
+
+  if (jobs <= 1 || chunkCount < 2) {
+    formatter.writeTokens(tokens, sm, sink);
+    return;
+  }
+
+  // 每个窗口的块并行渲染进各自的缓冲区，缓冲区在窗口之间复用
+  const std::size_t window = std::min(
+      chunkCount, jobs * std::max<std::size_t>(1, options_.slotsPerJob));
+  std::vector<std::string> buffers(window);
+  std::vector<std::string_view> batch;
+  batch.reserve(kMaxBatch);
+
+  formatter.beginTokens(sink, tokens.size());
+  for (std::size_t base = 0; base < chunkCount; base += window) {
+    const std::size_t count = std::min(window, chunkCount - base);
+    scheduler_.parallelFor(
+        0, count, 1, [&](std::size_t lo, std::size_t hi) {
+          for (auto i = lo; i < hi; ++i) {
+            const std::size_t first = (base + i) * chunkTokens;
+            auto &data = buffers[i];
+            data.clear();
+            StringSink chunkSink(data);
+            formatter.writeTokenRange(
+                tokens.subspan(first,
+                               std::min(chunkTokens, tokens.size() - first)),
+                sm, chunkSink, first);
+          }
+        });
+
+    // 调用线程按顺序成批写出
+    for (std::size_t i = 0; i < count; ++i) {
+      batch.push_back(buffers[i]);
+      if (batch.size() == kMaxBatch || i + 1 == count) {
+        sink.writeVectored(batch);
+        batch.clear();
+      }
+    }
+  }
+  formatter.endTokens(sink, std::nullopt);
+}
+
+} // namespace czc::cli
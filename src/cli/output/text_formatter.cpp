@@ -9,122 +9,195 @@
 #include "czc/cli/output/text_formatter.hpp"
 #include "czc/lexer/token.hpp"
 
-#include <sstream>
+#include <array>
+#include <charconv>
+#include <cstdint>
 
 namespace czc::cli {
 
-std::string TextFormatter::formatTokens(std::span<const lexer::Token> tokens,
-                                        const lexer::SourceManager &sm) const {
-  std::ostringstream oss;
+namespace {
 
-  oss << "Total tokens: " << tokens.size() << "\n\n";
+/**
+ * @brief 每个字节的文本转义方式：0 表示原样输出，'x' 表示 \xH(H)，
+ *        其他值表示短转义字符。
+ */
+constexpr std::array<char, 256> kEscapeTable = [] {
+  std::array<char, 256> table{};
+  for (std::size_t i = 0; i < 32; ++i) {
+    table[i] = 'x';
+  }
+  table['\n'] = 'n';
+  table['\r'] = 'r';
+  table['\t'] = 't';
+  table['\\'] = '\\';
+  table['"'] = '"';
+  return table;
+}();
+
+constexpr std::string_view kHexDigits = "0123456789abcdef";
+
+/**
+ * @brief 写入转义后的 Token 值，无需转义的连续片段一次性写出。
+ */
+void writeEscaped(OutputSink &sink, std::string_view value) {
+  const char *data = value.data();
+  std::size_t runStart = 0;
+
+  for (std::size_t i = 0; i < value.size(); ++i) {
+    const auto byte = static_cast<std::uint8_t>(data[i]);
+    const char escape = kEscapeTable[byte];
+    if (escape == 0) [[likely]] {
+      continue;
+    }
 
+    if (i > runStart) {
+      sink.write(std::string_view(data + runStart, i - runStart));
+    }
+    runStart = i + 1;
+
+    char *out = sink.reserve(4);
+    out[0] = '\\';
+    if (escape == 'x') {
+      // 与旧版 std::hex 输出一致：小写、不补零
+      out[1] = 'x';
+      if (byte >= 0x10) {
+        out[2] = kHexDigits[byte >> 4];
+        out[3] = kHexDigits[byte & 0x0F];
+        sink.commit(4);
+      } else {
+        out[2] = kHexDigits[byte];
+        sink.commit(3);
+      }
+    } else {
+      out[1] = escape;
+      sink.commit(2);
+    }
+  }
+
+  if (value.size() > runStart) {
+    sink.write(std::string_view(data + runStart, value.size() - runStart));
+  }
+}
+
+/**
+ * @brief 写入左侧补零到指定宽度的十进制数（与 "{:04d}" 等价）。
+ */
+void writeZeroPadded(OutputSink &sink, std::uint32_t value, std::size_t width) {
+  char digits[10];
+  auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+  (void)ec;
+  auto len = static_cast<std::size_t>(end - digits);
+  for (std::size_t i = len; i < width; ++i) {
+    sink.put('0');
+  }
+  sink.write(std::string_view(digits, len));
+}
+
+/**
+ * @brief 获取 Trivia 类型的显示名称。
+ */
+constexpr std::string_view triviaKindName(lexer::Trivia::Kind kind) noexcept {
+  switch (kind) {
+  case lexer::Trivia::Kind::kWhitespace:
+    return "whitespace";
+  case lexer::Trivia::Kind::kNewline:
+    return "newline";
+  case lexer::Trivia::Kind::kComment:
+    return "comment";
+  }
+  return "unknown";
+}
+
+/**
+ * @brief 写入一组 Trivia 行。
+ */
+void writeTrivia(OutputSink &sink, std::span<const lexer::Trivia> trivia,
+                 std::string_view prefix) {
+  for (const auto &item : trivia) {
+    sink.write(prefix);
+    sink.write(triviaKindName(item.kind));
+    sink.write(")\n");
+  }
+}
+
+} // namespace
+
+void TextFormatter::beginTokens(OutputSink &sink,
+                                std::optional<std::size_t> count) const {
+  if (count.has_value()) {
+    sink.write("Total tokens: ");
+    sink.writeInt(*count);
+    sink.write("\n\n");
+  }
+}
+
+void TextFormatter::endTokens(OutputSink &sink,
+                              std::optional<std::size_t> count) const {
+  if (count.has_value()) {
+    sink.write("\nTotal tokens: ");
+    sink.writeInt(*count);
+    sink.put('\n');
+  }
+}
+
+void TextFormatter::writeTokenRange(std::span<const lexer::Token> tokens,
+                                    const lexer::SourceManager &sm,
+                                    OutputSink &sink,
+                                    std::size_t /*firstIndex*/) const {
   for (const auto &token : tokens) {
     const auto &loc = token.location();
-    auto type_name = lexer::tokenTypeName(token.type());
     auto value = token.value(sm);
 
     // 格式: [行:列] 类型 "值"
-    oss << "[" << loc.line << ":" << loc.column << "] ";
-    oss << type_name;
+    sink.put('[');
+    sink.writeInt(loc.line);
+    sink.put(':');
+    sink.writeInt(loc.column);
+    sink.write("] ");
+    sink.write(lexer::tokenTypeName(token.type()));
 
     // 对于非空值，显示实际内容
     if (!value.empty() && token.type() != lexer::TokenType::TOKEN_EOF) {
-      oss << " \"";
-      // 转义特殊字符以便显示
-      for (char c : value) {
-        switch (c) {
-        case '\n':
-          oss << "\\n";
-          break;
-        case '\r':
-          oss << "\\r";
-          break;
-        case '\t':
-          oss << "\\t";
-          break;
-        case '\\':
-          oss << "\\\\";
-          break;
-        case '"':
-          oss << "\\\"";
-          break;
-        default:
-          if (static_cast<unsigned char>(c) < 32) {
-            oss << "\\x" << std::hex << static_cast<int>(c) << std::dec;
-          } else {
-            oss << c;
-          }
-          break;
-        }
-      }
-      oss << "\"";
+      sink.write(" \"");
+      writeEscaped(sink, value);
+      sink.put('"');
     }
 
-    oss << "\n";
+    sink.put('\n');
 
     // 显示 Trivia（如果有）
     if (token.hasTrivia()) {
-      for (const auto &trivia : token.leadingTrivia()) {
-        oss << "  (leading trivia: ";
-        switch (trivia.kind) {
-        case lexer::Trivia::Kind::kWhitespace:
-          oss << "whitespace";
-          break;
-        case lexer::Trivia::Kind::kNewline:
-          oss << "newline";
-          break;
-        case lexer::Trivia::Kind::kComment:
-          oss << "comment";
-          break;
-        }
-        oss << ")\n";
-      }
-      for (const auto &trivia : token.trailingTrivia()) {
-        oss << "  (trailing trivia: ";
-        switch (trivia.kind) {
-        case lexer::Trivia::Kind::kWhitespace:
-          oss << "whitespace";
-          break;
-        case lexer::Trivia::Kind::kNewline:
-          oss << "newline";
-          break;
-        case lexer::Trivia::Kind::kComment:
-          oss << "comment";
-          break;
-        }
-        oss << ")\n";
-      }
+      writeTrivia(sink, token.leadingTrivia(), "  (leading trivia: ");
+      writeTrivia(sink, token.trailingTrivia(), "  (trailing trivia: ");
     }
   }
-
-  return oss.str();
 }
 
-std::string
-TextFormatter::formatErrors(std::span<const lexer::LexerError> errors,
-                            const lexer::SourceManager &sm) const {
-  std::ostringstream oss;
-
-  oss << "=== Lexical Errors ===\n";
-  oss << "Total errors: " << errors.size() << "\n\n";
+void TextFormatter::writeErrors(std::span<const lexer::LexerError> errors,
+                                const lexer::SourceManager &sm,
+                                OutputSink &sink) const {
+  sink.write("=== Lexical Errors ===\n");
+  sink.write("Total errors: ");
+  sink.writeInt(errors.size());
+  sink.write("\n\n");
 
   for (const auto &error : errors) {
     const auto &loc = error.location;
 
-    // 获取文件名
-    auto filename = sm.getFilename(loc.buffer);
+    // 格式: 文件:行:列: error[L####]: 消息
+    sink.write(sm.getFilename(loc.buffer));
+    sink.put(':');
+    sink.writeInt(loc.line);
+    sink.put(':');
+    sink.writeInt(loc.column);
+    sink.write(": error[L");
+    writeZeroPadded(sink, static_cast<std::uint32_t>(error.code), 4);
+    sink.write("]: ");
+    sink.write(error.formattedMessage);
+    sink.put('\n');
 
-    // 格式: 文件:行:列: error[E####]: 消息
-    oss << filename << ":" << loc.line << ":" << loc.column << ": ";
-    oss << "error[" << error.codeString() << "]: ";
-    oss << error.formattedMessage << "\n";
-
-    // 显示源码上下文（如果可用）
     // TODO: 添加源码片段显示
   }
-
-  return oss.str();
 }
 
 } // namespace czc::cli
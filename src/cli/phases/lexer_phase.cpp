@@ -15,60 +15,87 @@
 namespace czc::cli {
 
 Result<LexResult> LexerPhase::runOnFile(const std::filesystem::path &filepath) {
+  auto bufferId = loadFile(filepath);
+  if (!bufferId.has_value()) {
+    return std::unexpected(std::move(bufferId.error()));
+  }
+
+  // 执行词法分析
+  return ok(runLexer(bufferId.value()));
+}
+
+Result<std::string>
+LexerPhase::readFile(const std::filesystem::path &filepath) {
   // 检查文件是否存在
   if (!std::filesystem::exists(filepath)) {
-    return err<LexResult>("File not found: " + filepath.string(), "E001");
+    return err<std::string>("File not found: " + filepath.string(), "E001");
   }
 
   // 检查文件大小
   auto fileSize = std::filesystem::file_size(filepath);
   if (fileSize > kLimits.maxFileSize) {
-    return err<LexResult>("File too large: " + filepath.string() + " (" +
-                              std::to_string(fileSize) + " bytes, max " +
-                              std::to_string(kLimits.maxFileSize) + " bytes)",
-                          "E002");
+    return err<std::string>("File too large: " + filepath.string() + " (" +
+                                std::to_string(fileSize) + " bytes, max " +
+                                std::to_string(kLimits.maxFileSize) +
+                                " bytes)",
+                            "E002");
   }
 
   // 读取文件内容
   std::ifstream ifs(filepath);
   if (!ifs) {
-    return err<LexResult>("Failed to open file: " + filepath.string(), "E003");
+    return err<std::string>("Failed to open file: " + filepath.string(),
+                            "E003");
   }
 
   std::ostringstream oss;
   oss << ifs.rdbuf();
-  std::string content = oss.str();
+  return ok(std::move(oss).str());
+}
 
-  // 添加到 SourceManager
-  auto bufferId =
-      sourceManager_.addBuffer(std::move(content), filepath.string());
+Result<lexer::BufferID>
+LexerPhase::loadFile(const std::filesystem::path &filepath) {
+  auto content = readFile(filepath);
+  if (!content.has_value()) {
+    return std::unexpected(std::move(content.error()));
+  }
 
-  // 执行词法分析
-  return ok(runLexer(bufferId));
+  // 添加到 SourceManager
+  return ok(ctx_.sourceManager().addBuffer(std::move(content.value()),
+                                           filepath.string()));
 }
 
 Result<LexResult> LexerPhase::runOnSource(std::string_view source,
                                           std::string_view filename) {
+  auto bufferId = loadSource(source, filename);
+  if (!bufferId.has_value()) {
+    return std::unexpected(std::move(bufferId.error()));
+  }
+
+  // 执行词法分析
+  return ok(runLexer(bufferId.value()));
+}
+
+Result<lexer::BufferID> LexerPhase::loadSource(std::string_view source,
+                                               std::string_view filename) {
   // 检查源码大小
   if (source.size() > kLimits.maxFileSize) {
-    return err<LexResult>("Source too large: " + std::to_string(source.size()) +
-                              " bytes, max " +
-                              std::to_string(kLimits.maxFileSize) + " bytes",
-                          "E002");
+    return err<lexer::BufferID>(
+        "Source too large: " + std::to_string(source.size()) +
+            " bytes, max " + std::to_string(kLimits.maxFileSize) + " bytes",
+        "E002");
   }
 
   // 添加到 SourceManager
-  auto bufferId = sourceManager_.addBuffer(source, std::string(filename));
-
-  // 执行词法分析
-  return ok(runLexer(bufferId));
+  return ok(ctx_.sourceManager().addBuffer(source, std::string(filename)));
 }
 
 LexResult LexerPhase::runLexer(lexer::BufferID bufferId) {
   LexResult result;
+  result.bufferId = bufferId;
 
   // 创建 Lexer
-  lexer::Lexer lex(sourceManager_, bufferId);
+  lexer::Lexer lex(ctx_.sourceManager(), bufferId);
 
   // 根据选项执行词法分析
   const auto &opts = ctx_.lexer();
@@ -81,12 +108,17 @@ LexResult LexerPhase::runLexer(lexer::BufferID bufferId) {
   // 收集错误到诊断系统
   if (lex.hasErrors()) {
     result.hasErrors = true;
-    // 使用新的诊断系统桥接层发射 lexer 错误
-    lexer::emitLexerErrors(ctx_.diagContext(), lex.errors(), sourceManager_,
-                           bufferId);
+    reportErrors(lex, bufferId);
   }
 
   return result;
 }
 
+void LexerPhase::reportErrors(const lexer::Lexer &lex,
+                              lexer::BufferID /*bufferId*/) {
+  // 使用诊断系统桥接层发射 lexer 错误，定位器由 CompilerContext 持有
+  lexer::emitLexerErrors(ctx_.diagContext(), lex.errors(),
+                         ctx_.sourceLocator());
+}
+
 } // namespace czc::cli
@@ -0,0 +1,188 @@
+/**
+ * @file token_pipeline.cpp
+ * @brief Token 输出流水线实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/pipeline/token_pipeline.hpp"
+#include "czc/common/spsc_queue.hpp"
+
+#include <latch>
+#include <string>
+#include <vector>
+
+namespace czc::cli {
+
+namespace {
+
+using TokenBlock = std::vector<lexer::Token>;
+using OutputChunk = std::string;
+
+/**
+ * @brief 把排空的数据打包为输出块并送入写出队列的输出汇。
+ */
+class ChunkQueueSink final : public OutputSink {
+public:
+  ChunkQueueSink(SpscQueue<OutputChunk> &chunks,
+                 SpscQueue<OutputChunk> &freeChunks, std::size_t capacity)
+      : OutputSink(capacity), chunks_(chunks), freeChunks_(freeChunks) {}
+
+  ~ChunkQueueSink() override { flush(); }
+
+  [[nodiscard]] std::size_t chunkCount() const noexcept { return count_; }
+
+protected:
+  bool drain(std::string_view data) override {
+    // 优先复用写出线程归还的输出块
+    OutputChunk chunk = freeChunks_.tryPop().value_or(OutputChunk{});
+    chunk.assign(data);
+    ++count_;
+    return chunks_.push(std::move(chunk));
+  }
+
+private:
+  SpscQueue<OutputChunk> &chunks_;
+  SpscQueue<OutputChunk> &freeChunks_;
+  std::size_t count_{0};
+};
+
+} // namespace
+
+PipelineStats TokenPipeline::run(lexer::Lexer &lex, bool preserveTrivia,
+                                 const OutputFormatter &formatter,
+                                 const lexer::SourceManager &sm,
+                                 OutputSink &out,
+                                 TaskScheduler &scheduler) const {
+  // 格式化与写出阶段各占一个工作线程，工作线程不足时顺序执行
+  if (scheduler.concurrency() - 1 < kStages) {
+    return runSequential(lex, preserveTrivia, formatter, sm, out);
+  }
+
+  const std::size_t depth = options_.queueDepth;
+  const std::size_t blockSize = options_.blockSize == 0 ? 1 : options_.blockSize;
+
+  // 正向队列承载数据，反向队列归还空块以便复用
+  SpscQueue<TokenBlock> blocks(depth);
+  SpscQueue<TokenBlock> freeBlocks(depth * 2);
+  SpscQueue<OutputChunk> chunks(depth);
+  SpscQueue<OutputChunk> freeChunks(depth * 2);
+  auto closeAll = [&] {
+    blocks.close();
+    chunks.close();
+  };
+
+  PipelineStats stats;
+
+  // 两个阶段都开始运行后才执行阶段代码，与 PhasePipeline 相同
+  std::latch started(kStages);
+
+  // 组在队列之后构造、之前析构，异常退出时也会等待两个阶段结束
+  TaskGroup stages(scheduler);
+
+  // 写出阶段：按顺序把输出块直接交给目标输出汇
+  stages.spawn([&] {
+    started.arrive_and_wait();
+    try {
+      while (auto chunk = chunks.pop()) {
+        out.writeThrough(*chunk);
+        chunk->clear();
+        freeChunks.tryPush(*chunk);
+      }
+    } catch (...) {
+      closeAll();
+      throw;
+    }
+  });
+
+  // 格式化阶段：把 Token 块渲染为输出块
+  stages.spawn([&] {
+    started.arrive_and_wait();
+    try {
+      std::size_t index = 0;
+      {
+        ChunkQueueSink sink(chunks, freeChunks, options_.chunkSize);
+        formatter.beginTokens(sink, std::nullopt);
+        while (auto block = blocks.pop()) {
+          formatter.writeTokenRange(*block, sm, sink, index);
+          index += block->size();
+          block->clear();
+          freeBlocks.tryPush(*block);
+        }
+        formatter.endTokens(sink, index);
+        sink.flush();
+        stats.chunkCount = sink.chunkCount();
+      }
+      chunks.close();
+    } catch (...) {
+      closeAll();
+      throw;
+    }
+  });
+
+  // 词法分析阶段（调用线程）；下游关闭队列时提前结束
+  try {
+    TokenBlock block = freeBlocks.tryPop().value_or(TokenBlock{});
+    block.reserve(blockSize);
+    while (true) {
+      lexer::Token token =
+          preserveTrivia ? lex.nextTokenWithTrivia() : lex.nextToken();
+      const bool isEof = token.type() == lexer::TokenType::TOKEN_EOF;
+      block.push_back(std::move(token));
+      ++stats.tokenCount;
+
+      if (block.size() == blockSize || isEof) {
+        ++stats.blockCount;
+        if (!blocks.push(std::move(block)) || isEof) {
+          break;
+        }
+        block = freeBlocks.tryPop().value_or(TokenBlock{});
+        block.reserve(blockSize);
+      }
+    }
+  } catch (...) {
+    closeAll();
+    throw;
+  }
+  blocks.close();
+
+  // 阶段中的异常在调用线程上重新抛出
+  stages.wait();
+  return stats;
+}
+
+PipelineStats TokenPipeline::runSequential(lexer::Lexer &lex,
+                                           bool preserveTrivia,
+                                           const OutputFormatter &formatter,
+                                           const lexer::SourceManager &sm,
+                                           OutputSink &out) const {
+  const std::size_t blockSize =
+      options_.blockSize == 0 ? 1 : options_.blockSize;
+
+  // 与并发执行的输出逐字节相同：总数同样写在结尾
+  PipelineStats stats;
+  TokenBlock block;
+  block.reserve(blockSize);
+  formatter.beginTokens(out, std::nullopt);
+  while (true) {
+    lexer::Token token =
+        preserveTrivia ? lex.nextTokenWithTrivia() : lex.nextToken();
+    const bool isEof = token.type() == lexer::TokenType::TOKEN_EOF;
+    block.push_back(std::move(token));
+
+    if (block.size() == blockSize || isEof) {
+      ++stats.blockCount;
+      formatter.writeTokenRange(block, sm, out, stats.tokenCount);
+      stats.tokenCount += block.size();
+      block.clear();
+      if (isEof) {
+        break;
+      }
+    }
+  }
+  formatter.endTokens(out, stats.tokenCount);
+  return stats;
+}
+
+} // namespace czc::cli
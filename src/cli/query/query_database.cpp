@@ -0,0 +1,503 @@
+/**
+ * @file query_database.cpp
+ * @brief 基于查询的增量计算引擎实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/query/query_database.hpp"
+#include "czc/cli/phases/lexer_phase.hpp"
+#include "czc/common/hash.hpp"
+#include "czc/common/json_reader.hpp"
+#include "czc/common/json_writer.hpp"
+#include "czc/common/output_sink.hpp"
+#include "czc/lexer/lexer.hpp"
+
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <system_error>
+
+namespace czc::cli {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr std::array<std::string_view, kQueryKinds> kKindNames = {
+    "source", "tokens", "trivia-tokens", "deps"};
+
+std::string_view kindName(QueryKind kind) noexcept {
+  return kKindNames[static_cast<std::size_t>(kind)];
+}
+
+std::optional<QueryKind> kindFromName(std::string_view name) noexcept {
+  for (std::size_t i = 0; i < kKindNames.size(); ++i) {
+    if (kKindNames[i] == name) {
+      return static_cast<QueryKind>(i);
+    }
+  }
+  return std::nullopt;
+}
+
+/// 64 位值以十六进制字符串保存（JSON 数字只有 53 位精度）
+std::string toHex(std::uint64_t value) { return std::format("{:016x}", value); }
+
+std::optional<std::uint64_t> fromHex(std::string_view text) noexcept {
+  std::uint64_t value = 0;
+  auto [end, ec] =
+      std::from_chars(text.data(), text.data() + text.size(), value, 16);
+  if (ec != std::errc() || end != text.data() + text.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+/// 提取 import 目标：`import` 之后直到 `;`、`as` 或下一个 `import` 的 Token
+std::vector<std::string> collectImports(std::span<const lexer::Token> tokens,
+                                        const lexer::SourceManager &sm) {
+  using lexer::TokenType;
+  std::vector<std::string> imports;
+  for (std::size_t i = 0; i < tokens.size(); ++i) {
+    if (tokens[i].type() != TokenType::KW_IMPORT) {
+      continue;
+    }
+    std::string target;
+    for (std::size_t j = i + 1; j < tokens.size(); ++j) {
+      auto type = tokens[j].type();
+      if (type == TokenType::DELIM_SEMICOLON || type == TokenType::KW_AS ||
+          type == TokenType::KW_IMPORT || type == TokenType::TOKEN_EOF) {
+        break;
+      }
+      auto text = tokens[j].value(sm);
+      // 字符串字面量的文本带引号，依赖目标只取其内容
+      if (type == TokenType::LIT_STRING && text.size() >= 2) {
+        text = text.substr(1, text.size() - 2);
+      }
+      target += text;
+    }
+    if (!target.empty()) {
+      imports.push_back(std::move(target));
+    }
+  }
+  return imports;
+}
+
+} // namespace
+
+QueryDatabase::QueryDatabase(lexer::SourceManager &sm) : sm_(&sm) {}
+
+QueryDatabase::~QueryDatabase() = default;
+
+// ========== 输入 ==========
+
+Result<bool> QueryDatabase::loadFile(const fs::path &path) {
+  auto content = LexerPhase::readFile(path);
+  if (!content.has_value()) {
+    return std::unexpected(std::move(content.error()));
+  }
+  return ok(setFileContents(path, std::move(content.value())));
+}
+
+bool QueryDatabase::setFileContents(const fs::path &path,
+                                    std::string content) {
+  auto key = keyOf(path);
+  const Fingerprint hash = hashBytes(content);
+
+  Slot &input = slot(QueryKind::Source, key);
+  std::lock_guard lock(input.mutex);
+  const bool present = std::holds_alternative<SourceInput>(input.value);
+  if (input.memoized && input.fingerprint == hash) {
+    // 内容未变：从缓存恢复的输入只需补上缓冲区，不产生新修订
+    if (!present) {
+      input.value =
+          SourceInput{sm_->addBuffer(std::move(content), key, hash)};
+    }
+    return false;
+  }
+
+  const Revision now = revision_.fetch_add(1, std::memory_order_acq_rel) + 1;
+  input.value = SourceInput{sm_->addBuffer(std::move(content), key, hash)};
+  input.memoized = true;
+  input.fingerprint = hash;
+  input.changedAt = now;
+  input.verifiedAt = now;
+  return true;
+}
+
+void QueryDatabase::removeFile(const fs::path &path) {
+  Slot &input = slot(QueryKind::Source, keyOf(path));
+  std::lock_guard lock(input.mutex);
+  if (!input.memoized) {
+    return;
+  }
+  const Revision now = revision_.fetch_add(1, std::memory_order_acq_rel) + 1;
+  input.value = std::monostate{};
+  input.memoized = false;
+  input.changedAt = now;
+  input.verifiedAt = now;
+}
+
+void QueryDatabase::rebind(lexer::SourceManager &sm) {
+  std::lock_guard lock(slotsMutex_);
+  // 输入的当前内容复制到新的 SourceManager，指纹与修订号不变
+  const auto &inputs = slots_[static_cast<std::size_t>(QueryKind::Source)];
+  for (const auto &[key, input] : inputs) {
+    if (auto *source = std::get_if<SourceInput>(&input->value)) {
+      source->buffer =
+          sm.addBuffer(std::string(sm_->getSource(source->buffer)),
+                       std::string(key), sm_->contentHash(source->buffer));
+    }
+  }
+  // Token 序列引用旧缓冲区：只保留指纹，需要时重新计算
+  for (auto kind : {QueryKind::Tokens, QueryKind::TriviaTokens}) {
+    for (const auto &[key, tokens] : slots_[static_cast<std::size_t>(kind)]) {
+      tokens->value = std::monostate{};
+    }
+  }
+  sm_ = &sm;
+}
+
+// ========== 查询 ==========
+
+Result<std::shared_ptr<const FileTokens>>
+QueryDatabase::tokens(const fs::path &path, bool preserveTrivia) {
+  auto kind = preserveTrivia ? QueryKind::TriviaTokens : QueryKind::Tokens;
+  SlotValue value;
+  auto refreshed = refresh(slot(kind, keyOf(path)), &value);
+  if (!refreshed.has_value()) {
+    return std::unexpected(std::move(refreshed.error()));
+  }
+  return ok(std::get<std::shared_ptr<const FileTokens>>(std::move(value)));
+}
+
+Result<std::shared_ptr<const FileDeps>>
+QueryDatabase::deps(const fs::path &path) {
+  SlotValue value;
+  auto refreshed = refresh(slot(QueryKind::Deps, keyOf(path)), &value);
+  if (!refreshed.has_value()) {
+    return std::unexpected(std::move(refreshed.error()));
+  }
+  return ok(std::get<std::shared_ptr<const FileDeps>>(std::move(value)));
+}
+
+void QueryDatabase::prefetch(std::span<const fs::path> paths,
+                             TaskScheduler &scheduler, QueryKind kind) {
+  scheduler.parallelFor(0, paths.size(), 1,
+                        [&](std::size_t lo, std::size_t hi) {
+                          for (auto i = lo; i < hi; ++i) {
+                            SlotValue value;
+                            (void)refresh(slot(kind, keyOf(paths[i])),
+                                          &value);
+                          }
+                        });
+}
+
+std::string QueryDatabase::keyOf(const fs::path &path) {
+  std::error_code ec;
+  auto absolute = fs::absolute(path, ec);
+  return (ec ? path : absolute).lexically_normal().string();
+}
+
+QueryDatabase::Slot &QueryDatabase::slot(QueryKind kind,
+                                         const std::string &file) {
+  std::lock_guard lock(slotsMutex_);
+  auto &table = slots_[static_cast<std::size_t>(kind)];
+  auto &entry = table[file];
+  if (!entry) {
+    entry = std::make_unique<Slot>();
+    entry->kind = kind;
+    entry->file = file;
+  }
+  return *entry;
+}
+
+Result<Revision> QueryDatabase::refresh(Slot &slot, SlotValue *out) {
+  std::lock_guard lock(slot.mutex);
+  const Revision now = revision();
+
+  if (slot.kind == QueryKind::Source) {
+    if (!std::holds_alternative<SourceInput>(slot.value)) {
+      return err<Revision>("File not loaded: " + slot.file, "E001");
+    }
+    if (out != nullptr) {
+      *out = slot.value;
+    }
+    return ok(Revision(slot.changedAt));
+  }
+
+  // 依赖都未在上次确认之后变化时，无需重新执行即可确认
+  if (slot.memoized && slot.verifiedAt != now) {
+    bool stale = false;
+    for (Slot *dep : slot.deps) {
+      auto changedAt = refresh(*dep, nullptr);
+      if (!changedAt.has_value() || changedAt.value() > slot.verifiedAt) {
+        stale = true;
+        break;
+      }
+    }
+    if (!stale) {
+      slot.verifiedAt = now;
+      reused_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // 只有指纹的缓存在需要结果时才执行
+  const bool valid = slot.memoized && slot.verifiedAt == now;
+  const bool hasValue = !std::holds_alternative<std::monostate>(slot.value);
+  if (!valid || (out != nullptr && !hasValue)) {
+    if (auto executed = execute(slot, now); !executed.has_value()) {
+      return std::unexpected(std::move(executed.error()));
+    }
+  }
+
+  if (out != nullptr) {
+    *out = slot.value;
+  }
+  return ok(Revision(slot.changedAt));
+}
+
+VoidResult QueryDatabase::execute(Slot &slot, Revision now) {
+  std::vector<Slot *> deps;
+  SlotValue value;
+  auto fingerprint = slot.kind == QueryKind::Deps
+                         ? computeDeps(slot, value, deps)
+                         : computeTokens(slot, value, deps);
+  if (!fingerprint.has_value()) {
+    return std::unexpected(std::move(fingerprint.error()));
+  }
+  executed_.fetch_add(1, std::memory_order_relaxed);
+
+  // 结果未变（提前截止）：保留 changedAt，依赖它的查询无需重新执行
+  if (slot.memoized && slot.fingerprint == fingerprint.value()) {
+    cutoff_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    slot.changedAt = now;
+  }
+  slot.memoized = true;
+  slot.fingerprint = fingerprint.value();
+  slot.verifiedAt = now;
+  slot.deps = std::move(deps);
+  slot.value = std::move(value);
+  return ok();
+}
+
+Result<QueryDatabase::SlotValue>
+QueryDatabase::fetch(QueryKind kind, const std::string &file,
+                     std::vector<Slot *> &deps) {
+  Slot &dep = slot(kind, file);
+  SlotValue value;
+  auto refreshed = refresh(dep, &value);
+  if (!refreshed.has_value()) {
+    return std::unexpected(std::move(refreshed.error()));
+  }
+  deps.push_back(&dep);
+  return ok(std::move(value));
+}
+
+Result<Fingerprint> QueryDatabase::computeTokens(const Slot &slot,
+                                                 SlotValue &value,
+                                                 std::vector<Slot *> &deps) {
+  auto source = fetch(QueryKind::Source, slot.file, deps);
+  if (!source.has_value()) {
+    return std::unexpected(std::move(source.error()));
+  }
+  const auto buffer = std::get<SourceInput>(source.value()).buffer;
+
+  auto result = std::make_shared<FileTokens>();
+  result->buffer = buffer;
+  lexer::Lexer lex(*sm_, buffer);
+  result->tokens = slot.kind == QueryKind::TriviaTokens
+                       ? lex.tokenizeWithTrivia()
+                       : lex.tokenize();
+  result->errors.assign(lex.errors().begin(), lex.errors().end());
+  value = std::shared_ptr<const FileTokens>(std::move(result));
+
+  // Token 序列完全由内容决定，内容指纹即结果指纹
+  return ok(hashCombine(sm_->contentHash(buffer),
+                        static_cast<std::uint64_t>(slot.kind)));
+}
+
+Result<Fingerprint> QueryDatabase::computeDeps(const Slot &slot,
+                                               SlotValue &value,
+                                               std::vector<Slot *> &deps) {
+  auto lexed = fetch(QueryKind::Tokens, slot.file, deps);
+  if (!lexed.has_value()) {
+    return std::unexpected(std::move(lexed.error()));
+  }
+  const auto &tokens = std::get<std::shared_ptr<const FileTokens>>(
+      lexed.value());
+
+  auto result = std::make_shared<FileDeps>();
+  result->imports = collectImports(tokens->tokens, *sm_);
+
+  Fingerprint fingerprint = hashBytes("deps");
+  for (const auto &target : result->imports) {
+    fingerprint = hashCombine(fingerprint, hashBytes(target));
+  }
+  value = std::shared_ptr<const FileDeps>(std::move(result));
+  return ok(std::move(fingerprint));
+}
+
+// ========== 持久化 ==========
+
+VoidResult QueryDatabase::save(const fs::path &file) const {
+  std::string json;
+  {
+    StringSink sink(json);
+    sink.write(R"({"version":)");
+    sink.writeInt(kFormatVersion);
+    sink.write(R"(,"revision":)");
+    writeJsonString(sink, toHex(revision()));
+    sink.write(R"(,"queries":[)");
+
+    std::lock_guard lock(slotsMutex_);
+    bool first = true;
+    for (const auto &table : slots_) {
+      for (const auto &[key, slot] : table) {
+        if (!slot->memoized) {
+          continue;
+        }
+        sink.write(first ? "{" : ",{");
+        first = false;
+        sink.write(R"("kind":)");
+        writeJsonString(sink, kindName(slot->kind));
+        sink.write(R"(,"file":)");
+        writeJsonString(sink, key);
+        sink.write(R"(,"fingerprint":)");
+        writeJsonString(sink, toHex(slot->fingerprint));
+        sink.write(R"(,"changedAt":)");
+        writeJsonString(sink, toHex(slot->changedAt));
+        sink.write(R"(,"verifiedAt":)");
+        writeJsonString(sink, toHex(slot->verifiedAt));
+
+        sink.write(R"(,"deps":[)");
+        for (std::size_t i = 0; i < slot->deps.size(); ++i) {
+          sink.write(i == 0 ? R"({"kind":)" : R"(,{"kind":)");
+          writeJsonString(sink, kindName(slot->deps[i]->kind));
+          sink.write(R"(,"file":)");
+          writeJsonString(sink, slot->deps[i]->file);
+          sink.write("}");
+        }
+        sink.write("]");
+
+        // 可序列化的结果随指纹保存
+        if (const auto *deps =
+                std::get_if<std::shared_ptr<const FileDeps>>(&slot->value)) {
+          sink.write(R"(,"imports":[)");
+          for (std::size_t i = 0; i < (*deps)->imports.size(); ++i) {
+            if (i != 0) {
+              sink.write(",");
+            }
+            writeJsonString(sink, (*deps)->imports[i]);
+          }
+          sink.write("]");
+        }
+        sink.write("}");
+      }
+    }
+    sink.write("]}\n");
+  }
+
+  // 先写临时文件再重命名，读者不会看到写了一半的缓存
+  auto temp = file;
+  temp += ".tmp";
+  {
+    std::ofstream ofs(temp, std::ios::binary | std::ios::trunc);
+    ofs << json;
+    if (!ofs.flush()) {
+      return errVoid("Failed to write query cache: " + temp.string(), "E003");
+    }
+  }
+  std::error_code ec;
+  fs::rename(temp, file, ec);
+  if (ec) {
+    fs::remove(temp, ec);
+    return errVoid("Failed to write query cache: " + file.string(), "E003");
+  }
+  return ok();
+}
+
+VoidResult QueryDatabase::load(const fs::path &file) {
+  std::ifstream ifs(file, std::ios::binary);
+  if (!ifs) {
+    return ok(); // 首次运行没有缓存
+  }
+  std::ostringstream oss;
+  oss << ifs.rdbuf();
+
+  auto invalid = [&](std::string_view what) {
+    return errVoid("Invalid query cache " + file.string() + ": " +
+                       std::string(what),
+                   "E009");
+  };
+
+  auto parsed = parseJson(oss.str());
+  if (!parsed.has_value()) {
+    return invalid(parsed.error().message);
+  }
+  const auto &root = parsed.value();
+  if (root["version"].asInt(-1) != kFormatVersion) {
+    return invalid("unsupported version");
+  }
+  auto revision = fromHex(root["revision"].asString());
+  if (!revision.has_value()) {
+    return invalid("missing revision");
+  }
+
+  for (const auto &record : root["queries"].asArray()) {
+    auto kind = kindFromName(record["kind"].asString());
+    auto fingerprint = fromHex(record["fingerprint"].asString());
+    auto changedAt = fromHex(record["changedAt"].asString());
+    auto verifiedAt = fromHex(record["verifiedAt"].asString());
+    if (!kind || !fingerprint || !changedAt || !verifiedAt) {
+      return invalid("malformed query record");
+    }
+
+    Slot &restored = slot(*kind, std::string(record["file"].asString()));
+    restored.memoized = true;
+    restored.fingerprint = *fingerprint;
+    restored.changedAt = *changedAt;
+    restored.verifiedAt = *verifiedAt;
+    restored.deps.clear();
+    for (const auto &dep : record["deps"].asArray()) {
+      auto depKind = kindFromName(dep["kind"].asString());
+      if (!depKind) {
+        return invalid("malformed dependency");
+      }
+      restored.deps.push_back(
+          &slot(*depKind, std::string(dep["file"].asString())));
+    }
+
+    if (*kind == QueryKind::Deps) {
+      auto deps = std::make_shared<FileDeps>();
+      for (const auto &target : record["imports"].asArray()) {
+        deps->imports.emplace_back(target.asString());
+      }
+      restored.value = std::shared_ptr<const FileDeps>(std::move(deps));
+    }
+  }
+
+  // 新的输入变化必须晚于缓存中的所有修订
+  revision_.store(*revision + 1, std::memory_order_release);
+  return ok();
+}
+
+// ========== 状态 ==========
+
+QueryStats QueryDatabase::stats() const noexcept {
+  return QueryStats{executed_.load(std::memory_order_relaxed),
+                    reused_.load(std::memory_order_relaxed),
+                    cutoff_.load(std::memory_order_relaxed)};
+}
+
+void QueryDatabase::resetStats() noexcept {
+  executed_.store(0, std::memory_order_relaxed);
+  reused_.store(0, std::memory_order_relaxed);
+  cutoff_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace czc::cli
@@ -0,0 +1,328 @@
+/**
+ * @file file_watcher.cpp
+ * @brief 源文件变化监视实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/watch/file_watcher.hpp"
+#include "czc/common/unique_fd.hpp"
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+
+#if CZC_PLATFORM_LINUX
+#include <array>
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace czc::cli {
+
+namespace fs = std::filesystem;
+
+#if CZC_PLATFORM_LINUX
+
+namespace {
+
+/// 待交付的事件：按路径合并，std::map 使结果有序
+using PendingEvents = std::map<fs::path, FileEventKind>;
+
+/// 持续有事件时，最多合并这么多个 debounce 窗口，避免一直不交付
+constexpr int kMaxDebounceWindows = 10;
+
+/// 只在写入完成时报告变化，避免读到写了一半的文件
+constexpr std::uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO |
+                                     IN_MOVED_FROM | IN_CREATE | IN_DELETE |
+                                     IN_ONLYDIR;
+
+/// 以 errno 构造监视错误
+template <typename T> Result<T> watchError(std::string_view what) {
+  return err<T>(std::string(what) + " (" +
+                    std::generic_category().message(errno) + ")",
+                "E010");
+}
+
+/// path 是否为 dir 本身或位于其下
+bool isWithin(const fs::path &path, const fs::path &dir) {
+  auto relative = path.lexically_relative(dir);
+  return !relative.empty() && *relative.begin() != "..";
+}
+
+} // namespace
+
+struct FileWatcher::Impl {
+  /**
+   * @brief 单个被监视的目录。
+   */
+  struct Watch {
+    fs::path dir;
+    bool recursive{false};
+    std::shared_ptr<const DirectoryFilter> filter;
+  };
+
+  UniqueFd inotify;
+  UniqueFd wake; ///< interrupt() 写入的 eventfd
+  std::unordered_map<int, Watch> watches;
+  std::atomic<bool> interrupted{false};
+
+  /// 监视目录；report 非空时把其中已有的文件记为变化
+  VoidResult add(const fs::path &dir, bool recursive,
+                 const std::shared_ptr<const DirectoryFilter> &filter,
+                 PendingEvents *report) {
+    int wd = ::inotify_add_watch(inotify.get(), dir.c_str(), kWatchMask);
+    if (wd < 0) {
+      return watchError<void>("Failed to watch directory " + dir.string());
+    }
+    watches[wd] = Watch{dir, recursive, filter};
+
+    std::error_code ec;
+    fs::directory_iterator it(
+        dir, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::directory_iterator(); it.increment(ec)) {
+      std::error_code statusEc;
+      const auto &path = it->path();
+      if (it->is_symlink(statusEc)) {
+        continue; // 与目录展开一致，不跟随符号链接
+      }
+      if (it->is_directory(statusEc)) {
+        if (recursive && (!*filter || (*filter)(path))) {
+          if (auto added = add(path, true, filter, report);
+              !added.has_value()) {
+            return added;
+          }
+        }
+      } else if (report != nullptr && it->is_regular_file(statusEc)) {
+        (*report)[path] = FileEventKind::Changed;
+      }
+    }
+    return ok();
+  }
+
+  /// 停止监视 dir 及其子目录
+  void forget(const fs::path &dir) {
+    for (auto it = watches.begin(); it != watches.end();) {
+      if (isWithin(it->second.dir, dir)) {
+        ::inotify_rm_watch(inotify.get(), it->first);
+        it = watches.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  /// 事件队列溢出后无法得知丢失了哪些事件，把全部文件视为变化
+  void rescan(PendingEvents &pending) {
+    for (const auto &[wd, watch] : watches) {
+      std::error_code ec;
+      fs::directory_iterator it(watch.dir, ec);
+      for (; !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        std::error_code statusEc;
+        if (it->is_regular_file(statusEc)) {
+          pending[it->path()] = FileEventKind::Changed;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief 等待事件或唤醒。
+   *
+   * @param timeoutMs 超时毫秒数，-1 表示一直等待
+   * @return 有事件可读返回 true，超时或被唤醒返回 false
+   */
+  Result<bool> wait(int timeoutMs) {
+    std::array<pollfd, 2> fds{{{inotify.get(), POLLIN, 0},
+                               {wake.get(), POLLIN, 0}}};
+    while (!interrupted.load(std::memory_order_acquire)) {
+      int n = ::poll(fds.data(), fds.size(), timeoutMs);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return watchError<bool>("Failed to wait for file events");
+      }
+      if (fds[1].revents != 0) {
+        break;
+      }
+      return ok(n > 0);
+    }
+    return ok(false);
+  }
+
+  /// 读出全部可读的事件
+  void drain(PendingEvents &pending) {
+    alignas(inotify_event) std::array<char, 16 * 1024> buffer;
+    while (true) {
+      auto n = ::read(inotify.get(), buffer.data(), buffer.size());
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        return; // EAGAIN：已读完
+      }
+      for (auto offset = 0; offset < n;) {
+        const auto *event =
+            reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+        handle(*event, pending);
+        offset += static_cast<int>(sizeof(inotify_event) + event->len);
+      }
+    }
+  }
+
+  void handle(const inotify_event &event, PendingEvents &pending) {
+    if ((event.mask & IN_Q_OVERFLOW) != 0) {
+      rescan(pending);
+      return;
+    }
+    auto it = watches.find(event.wd);
+    if (it == watches.end()) {
+      return;
+    }
+    if ((event.mask & IN_IGNORED) != 0) {
+      watches.erase(it);
+      return;
+    }
+    if (event.len == 0) {
+      return;
+    }
+    auto path = it->second.dir / event.name;
+
+    if ((event.mask & IN_ISDIR) != 0) {
+      if ((event.mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+        // add() 会修改 watches，先复制
+        const auto watch = it->second;
+        if (watch.recursive && (!*watch.filter || (*watch.filter)(path))) {
+          // 监视建立之前写入的文件不会再产生事件，直接记为变化；
+          // 目录已被删除时忽略
+          (void)add(path, true, watch.filter, &pending);
+        }
+      } else if ((event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0) {
+        forget(path);
+        for (auto p = pending.lower_bound(path);
+             p != pending.end() && isWithin(p->first, path);) {
+          p = pending.erase(p);
+        }
+        pending[path] = FileEventKind::Removed;
+      }
+      return;
+    }
+
+    if ((event.mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) != 0) {
+      pending[path] = FileEventKind::Changed;
+    } else if ((event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0) {
+      pending[path] = FileEventKind::Removed;
+    }
+  }
+};
+
+Result<std::unique_ptr<FileWatcher>> FileWatcher::create() {
+  auto impl = std::make_unique<Impl>();
+  impl->inotify.reset(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC));
+  if (!impl->inotify.valid()) {
+    return watchError<std::unique_ptr<FileWatcher>>(
+        "Failed to initialize inotify");
+  }
+  impl->wake.reset(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+  if (!impl->wake.valid()) {
+    return watchError<std::unique_ptr<FileWatcher>>(
+        "Failed to initialize file watcher");
+  }
+  return ok(std::unique_ptr<FileWatcher>(new FileWatcher(std::move(impl))));
+}
+
+VoidResult FileWatcher::addDirectory(const fs::path &dir, bool recursive,
+                                     DirectoryFilter filter) {
+  return impl_->add(dir, recursive,
+                    std::make_shared<const DirectoryFilter>(std::move(filter)),
+                    nullptr);
+}
+
+Result<std::vector<FileEvent>>
+FileWatcher::next(std::chrono::milliseconds debounce) {
+  PendingEvents pending;
+  while (pending.empty()) {
+    auto ready = impl_->wait(-1);
+    if (!ready.has_value()) {
+      return std::unexpected(std::move(ready.error()));
+    }
+    if (!ready.value()) {
+      return ok(std::vector<FileEvent>{}); // 被唤醒
+    }
+    impl_->drain(pending);
+  }
+
+  // 编辑器保存往往产生一串事件：安静 debounce 之后才交付
+  const auto window = static_cast<int>(debounce.count());
+  for (int i = 0; i < kMaxDebounceWindows; ++i) {
+    auto ready = impl_->wait(window);
+    if (!ready.has_value()) {
+      return std::unexpected(std::move(ready.error()));
+    }
+    if (!ready.value()) {
+      break;
+    }
+    impl_->drain(pending);
+  }
+  if (interrupted()) {
+    return ok(std::vector<FileEvent>{});
+  }
+
+  std::vector<FileEvent> events;
+  events.reserve(pending.size());
+  for (auto &[path, kind] : pending) {
+    events.push_back(FileEvent{path, kind});
+  }
+  return ok(std::move(events));
+}
+
+void FileWatcher::interrupt() noexcept {
+  impl_->interrupted.store(true, std::memory_order_release);
+  const std::uint64_t one = 1;
+  [[maybe_unused]] auto written = ::write(impl_->wake.get(), &one, sizeof one);
+}
+
+#else
+
+struct FileWatcher::Impl {
+  std::atomic<bool> interrupted{false};
+};
+
+Result<std::unique_ptr<FileWatcher>> FileWatcher::create() {
+  return err<std::unique_ptr<FileWatcher>>("Watch mode requires inotify",
+                                           "E010");
+}
+
+VoidResult FileWatcher::addDirectory(const fs::path & /*dir*/,
+                                     bool /*recursive*/,
+                                     DirectoryFilter /*filter*/) {
+  return errVoid("Watch mode requires inotify", "E010");
+}
+
+Result<std::vector<FileEvent>>
+FileWatcher::next(std::chrono::milliseconds /*debounce*/) {
+  return err<std::vector<FileEvent>>("Watch mode requires inotify", "E010");
+}
+
+void FileWatcher::interrupt() noexcept {
+  impl_->interrupted.store(true, std::memory_order_release);
+}
+
+#endif
+
+FileWatcher::FileWatcher(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+FileWatcher::~FileWatcher() = default;
+
+bool FileWatcher::interrupted() const noexcept {
+  return impl_->interrupted.load(std::memory_order_acquire);
+}
+
+} // namespace czc::cli
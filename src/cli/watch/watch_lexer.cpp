@@ -0,0 +1,297 @@
+/**
+ * @file watch_lexer.cpp
+ * @brief 监视模式的增量词法分析实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/watch/watch_lexer.hpp"
+#include "czc/cli/output/json_formatter.hpp"
+#include "czc/common/json_writer.hpp"
+#include "czc/diag/diag_builder.hpp"
+#include "czc/diag/emitters/json_emitter.hpp"
+#include "czc/diag/message.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <system_error>
+#include <unordered_set>
+
+namespace czc::cli {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+/// 规范化路径键（与 QueryDatabase 的查询键一致）
+std::string keyOf(const fs::path &path) {
+  std::error_code ec;
+  auto absolute = fs::absolute(path, ec);
+  return (ec ? path : absolute).lexically_normal().string();
+}
+
+/// relative 不为空且不指向 dir 之外
+bool isInside(const fs::path &relative) {
+  return !relative.empty() && *relative.begin() != "..";
+}
+
+} // namespace
+
+WatchLexer::WatchLexer(CompilerContext &ctx, WatchOptions options)
+    : ctx_(ctx), options_(std::move(options)),
+      sources_(std::make_unique<lexer::SourceManager>()),
+      locator_(std::make_unique<lexer::LexerSourceLocator>(*sources_)),
+      db_(*sources_),
+      dcx_(std::make_unique<diag::JsonEmitter>(diagnostics_,
+                                               diag::JsonDiagFormat::Lines),
+           locator_.get()) {
+  dcx_.config().maxPerCode = ctx.global().maxErrorsPerCode;
+}
+
+Result<WatchSummary> WatchLexer::start(std::span<const std::string> args,
+                                       FileWatcher &watcher,
+                                       TaskScheduler &scheduler,
+                                       OutputSink &sink) {
+  auto inputs = collectBatchInputs(args, options_.inputs);
+  if (!inputs.has_value()) {
+    return std::unexpected(std::move(inputs.error()));
+  }
+
+  // 目录参数递归监视，新建的子目录同样按 exclude 过滤
+  auto filter = [exclude = options_.inputs.exclude](const fs::path &dir) {
+    return !matchesAnyGlob(exclude, dir.filename().string());
+  };
+  for (const auto &arg : args) {
+    std::error_code ec;
+    if (arg.empty() || arg.front() == '@' || !fs::is_directory(arg, ec)) {
+      continue;
+    }
+    if (auto added = watcher.addDirectory(arg, true, filter);
+        !added.has_value()) {
+      return std::unexpected(std::move(added.error()));
+    }
+    roots_.emplace_back(keyOf(arg));
+  }
+
+  // 其余文件监视所在目录；已在递归监视范围内的目录不重复登记，
+  // 同一目录的第二次登记会覆盖第一次的递归设置
+  std::unordered_set<std::string> parents;
+  for (const auto &input : *inputs) {
+    tracked_.try_emplace(keyOf(input.path), input.path);
+
+    auto parent = input.path.parent_path();
+    if (parent.empty()) {
+      parent = ".";
+    }
+    auto key = keyOf(parent);
+    const bool covered =
+        std::any_of(roots_.begin(), roots_.end(), [&](const fs::path &root) {
+          return isInside(fs::path(key).lexically_relative(root));
+        });
+    if (covered || !parents.insert(key).second) {
+      continue;
+    }
+    if (auto added = watcher.addDirectory(parent, false); !added.has_value()) {
+      return std::unexpected(std::move(added.error()));
+    }
+  }
+
+  // 先串行设置输入，再并行分析，最后按输入顺序输出
+  WatchSummary summary;
+  std::vector<fs::path> loaded;
+  std::vector<bool> ready(inputs->size(), false);
+  for (std::size_t i = 0; i < inputs->size(); ++i) {
+    const auto &path = (*inputs)[i].path;
+    if (auto set = db_.loadFile(path); set.has_value()) {
+      loaded.push_back(path);
+      ready[i] = true;
+    } else {
+      writeFailed(path, set.error(), sink);
+      ++summary.failed;
+    }
+  }
+  db_.prefetch(loaded, scheduler,
+               ctx_.lexer().preserveTrivia ? QueryKind::TriviaTokens
+                                           : QueryKind::Tokens);
+  for (std::size_t i = 0; i < inputs->size(); ++i) {
+    if (!ready[i]) {
+      continue;
+    }
+    if (writeLexed((*inputs)[i].path, sink)) {
+      ++summary.lexed;
+    } else {
+      ++summary.failed;
+    }
+  }
+  return ok(std::move(summary));
+}
+
+WatchSummary WatchLexer::apply(std::span<const FileEvent> events,
+                               OutputSink &sink) {
+  compactSources();
+
+  WatchSummary summary;
+  for (const auto &event : events) {
+    if (event.kind == FileEventKind::Removed) {
+      summary.removed += untrack(event.path, sink);
+      continue;
+    }
+
+    auto key = keyOf(event.path);
+    if (!accepts(event.path, key)) {
+      continue;
+    }
+
+    auto loaded = db_.loadFile(event.path);
+    if (!loaded.has_value()) {
+      // 事件之后文件又被删除：按移除处理
+      std::error_code ec;
+      if (!fs::exists(event.path, ec)) {
+        summary.removed += untrack(event.path, sink);
+        continue;
+      }
+      tracked_.try_emplace(key, event.path);
+      writeFailed(event.path, loaded.error(), sink);
+      ++summary.failed;
+      continue;
+    }
+
+    // 内容哈希未变（touch、内容相同的保存）：沿用已有的 Token
+    auto [it, added] = tracked_.try_emplace(key, event.path);
+    if (!added && !loaded.value()) {
+      ++summary.unchanged;
+      continue;
+    }
+    if (writeLexed(it->second, sink)) {
+      ++summary.lexed;
+    } else {
+      ++summary.failed;
+    }
+  }
+  return summary;
+}
+
+void WatchLexer::compactSources() {
+  if (sources_->bufferCount() < kMaxBuffers) {
+    return;
+  }
+  auto fresh = std::make_unique<lexer::SourceManager>();
+  db_.rebind(*fresh);
+  auto locator = std::make_unique<lexer::LexerSourceLocator>(*fresh);
+  dcx_.setLocator(locator.get());
+  locator_ = std::move(locator);
+  sources_ = std::move(fresh);
+}
+
+bool WatchLexer::accepts(const fs::path &path, const std::string &key) const {
+  if (tracked_.contains(key)) {
+    return true;
+  }
+  const auto &filters = options_.inputs;
+  if (!matchesAnyGlob(filters.include, path.filename().string())) {
+    return false;
+  }
+  return std::any_of(roots_.begin(), roots_.end(), [&](const fs::path &root) {
+    auto relative = fs::path(key).lexically_relative(root);
+    if (!isInside(relative)) {
+      return false;
+    }
+    // 与目录展开一致：路径中任一部分匹配 exclude 即跳过
+    return std::none_of(relative.begin(), relative.end(),
+                        [&](const fs::path &part) {
+                          return matchesAnyGlob(filters.exclude,
+                                                part.string());
+                        });
+  });
+}
+
+std::size_t WatchLexer::untrack(const fs::path &path, OutputSink &sink) {
+  // 文件本身，或目录下的全部文件；键以目录键加分隔符开头
+  const auto key = keyOf(path);
+  std::size_t removed = 0;
+  for (auto it = tracked_.lower_bound(key);
+       it != tracked_.end() && it->first.starts_with(key);) {
+    if (it->first.size() != key.size() &&
+        it->first[key.size()] != fs::path::preferred_separator) {
+      ++it;
+      continue;
+    }
+    db_.removeFile(it->second);
+    sink.write(R"({"file":)");
+    writeJsonString(sink, it->second.string());
+    sink.write(R"(,"event":"removed"})");
+    sink.put('\n');
+    it = tracked_.erase(it);
+    ++removed;
+  }
+  return removed;
+}
+
+bool WatchLexer::writeLexed(const fs::path &path, OutputSink &sink) {
+  auto lexed = db_.tokens(path, ctx_.lexer().preserveTrivia);
+  if (!lexed.has_value()) {
+    writeFailed(path, lexed.error(), sink);
+    return false;
+  }
+
+  const auto &result = *lexed.value();
+  if (result.hasErrors()) {
+    lexer::emitLexerErrors(dcx_, result.errors, *locator_);
+  }
+  const bool success = !result.hasErrors();
+
+  sink.write(R"({"file":)");
+  writeJsonString(sink, path.string());
+  sink.write(R"(,"event":"lexed","exitCode":)");
+  sink.writeInt(success ? 0 : 1);
+  sink.write(R"(,"tokens":)");
+  sink.writeInt(success ? result.tokens.size() : 0);
+  sink.write(R"(,"result":)");
+  if (success) {
+    JsonFormatter().writeTokens(result.tokens, *sources_, sink);
+  } else {
+    sink.write("null");
+  }
+  sink.write(R"(,"diagnostics":)");
+  sink.write(takeDiagnostics());
+  sink.write("}\n");
+  return success;
+}
+
+void WatchLexer::writeFailed(const fs::path &path, const Error &error,
+                             OutputSink &sink) {
+  dcx_.emit(diag::error(diag::Message(error.message)).build());
+  sink.write(R"({"file":)");
+  writeJsonString(sink, path.string());
+  sink.write(R"(,"event":"lexed","exitCode":1,"tokens":0,"result":null)");
+  sink.write(R"(,"diagnostics":)");
+  sink.write(takeDiagnostics());
+  sink.write("}\n");
+}
+
+std::string WatchLexer::takeDiagnostics() {
+  dcx_.flush();
+  auto lines = diagnostics_.str();
+  diagnostics_.str({});
+  // 去重与每代码上限按记录计算
+  dcx_.reset();
+
+  // JSON Lines -> JSON 数组（字符串中的换行已转义，裸换行只作分隔）
+  std::string json = "[";
+  std::size_t begin = 0;
+  while (begin < lines.size()) {
+    auto end = std::min(lines.find('\n', begin), lines.size());
+    if (end > begin) {
+      if (json.size() > 1) {
+        json += ',';
+      }
+      json.append(lines, begin, end - begin);
+    }
+    begin = end + 1;
+  }
+  json += ']';
+  return json;
+}
+
+} // namespace czc::cli
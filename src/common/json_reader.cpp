@@ -0,0 +1,472 @@
+/**
+ * @file json_reader.cpp
+ * @brief 轻量 JSON 解析的实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/json_reader.hpp"
+#include "czc/common/json_writer.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <format>
+
+namespace czc {
+
+// ========== JsonValue ==========
+
+bool JsonValue::asBool(bool fallback) const noexcept {
+  const auto *value = std::get_if<bool>(&value_);
+  return value != nullptr ? *value : fallback;
+}
+
+double JsonValue::asNumber(double fallback) const noexcept {
+  const auto *value = std::get_if<double>(&value_);
+  return value != nullptr ? *value : fallback;
+}
+
+std::int64_t JsonValue::asInt(std::int64_t fallback) const noexcept {
+  const auto *value = std::get_if<double>(&value_);
+  return value != nullptr ? static_cast<std::int64_t>(*value) : fallback;
+}
+
+std::string_view JsonValue::asString() const noexcept {
+  const auto *value = std::get_if<std::string>(&value_);
+  return value != nullptr ? std::string_view(*value) : std::string_view();
+}
+
+const JsonValue::Array &JsonValue::asArray() const noexcept {
+  static const Array kEmpty;
+  const auto *value = std::get_if<Array>(&value_);
+  return value != nullptr ? *value : kEmpty;
+}
+
+const JsonValue::Object &JsonValue::members() const noexcept {
+  static const Object kEmpty;
+  const auto *value = std::get_if<Object>(&value_);
+  return value != nullptr ? *value : kEmpty;
+}
+
+const JsonValue *JsonValue::find(std::string_view key) const noexcept {
+  const auto *object = std::get_if<Object>(&value_);
+  if (object == nullptr) {
+    return nullptr;
+  }
+  for (const auto &[name, member] : *object) {
+    if (name == key) {
+      return &member;
+    }
+  }
+  return nullptr;
+}
+
+const JsonValue &JsonValue::operator[](std::string_view key) const noexcept {
+  static const JsonValue kNull;
+  const auto *member = find(key);
+  return member != nullptr ? *member : kNull;
+}
+
+std::string JsonValue::takeString() noexcept {
+  auto *value = std::get_if<std::string>(&value_);
+  return value != nullptr ? std::move(*value) : std::string();
+}
+
+// ========== 解析 ==========
+
+namespace {
+
+/// 最大嵌套深度
+constexpr int kMaxDepth = 256;
+
+/**
+ * @brief 递归下降解析器。
+ */
+class JsonParser {
+public:
+  explicit JsonParser(std::string_view text) : text_(text) {}
+
+  Result<JsonValue> parseDocument() {
+    JsonValue value;
+    if (!parseValue(value, 0)) {
+      return fail();
+    }
+    skipWhitespace();
+    if (pos_ != text_.size()) {
+      error_ = "trailing characters";
+      return fail();
+    }
+    return ok(std::move(value));
+  }
+
+private:
+  Result<JsonValue> fail() const {
+    return err<JsonValue>(
+        std::format("Malformed JSON at offset {}: {}", pos_, error_), "E007");
+  }
+
+  void skipWhitespace() noexcept {
+    while (pos_ < text_.size()) {
+      char ch = text_[pos_];
+      if (ch != ' ' && ch != '\t' && ch != '\n' && ch != '\r') {
+        return;
+      }
+      ++pos_;
+    }
+  }
+
+  bool consume(std::string_view literal) noexcept {
+    if (text_.substr(pos_, literal.size()) != literal) {
+      error_ = "invalid literal";
+      return false;
+    }
+    pos_ += literal.size();
+    return true;
+  }
+
+  bool parseValue(JsonValue &out, int depth) {
+    if (depth > kMaxDepth) {
+      error_ = "nesting too deep";
+      return false;
+    }
+    skipWhitespace();
+    if (pos_ >= text_.size()) {
+      error_ = "unexpected end of input";
+      return false;
+    }
+
+    switch (text_[pos_]) {
+    case '{':
+      return parseObject(out, depth);
+    case '[':
+      return parseArray(out, depth);
+    case '"': {
+      std::string value;
+      if (!parseString(value)) {
+        return false;
+      }
+      out = JsonValue(std::move(value));
+      return true;
+    }
+    case 't':
+      out = JsonValue(true);
+      return consume("true");
+    case 'f':
+      out = JsonValue(false);
+      return consume("false");
+    case 'n':
+      out = JsonValue();
+      return consume("null");
+    default:
+      return parseNumber(out);
+    }
+  }
+
+  bool parseObject(JsonValue &out, int depth) {
+    ++pos_; // '{'
+    JsonValue::Object members;
+    skipWhitespace();
+    if (pos_ < text_.size() && text_[pos_] == '}') {
+      ++pos_;
+      out = JsonValue(std::move(members));
+      return true;
+    }
+
+    while (true) {
+      skipWhitespace();
+      if (pos_ >= text_.size() || text_[pos_] != '"') {
+        error_ = "expected member name";
+        return false;
+      }
+      std::string name;
+      if (!parseString(name)) {
+        return false;
+      }
+      skipWhitespace();
+      if (pos_ >= text_.size() || text_[pos_] != ':') {
+        error_ = "expected ':'";
+        return false;
+      }
+      ++pos_;
+
+      JsonValue member;
+      if (!parseValue(member, depth + 1)) {
+        return false;
+      }
+      members.emplace_back(std::move(name), std::move(member));
+
+      skipWhitespace();
+      if (pos_ < text_.size() && text_[pos_] == ',') {
+        ++pos_;
+        continue;
+      }
+      if (pos_ < text_.size() && text_[pos_] == '}') {
+        ++pos_;
+        out = JsonValue(std::move(members));
+        return true;
+      }
+      error_ = "expected ',' or '}'";
+      return false;
+    }
+  }
+
+  bool parseArray(JsonValue &out, int depth) {
+    ++pos_; // '['
+    JsonValue::Array elements;
+    skipWhitespace();
+    if (pos_ < text_.size() && text_[pos_] == ']') {
+      ++pos_;
+      out = JsonValue(std::move(elements));
+      return true;
+    }
+
+    while (true) {
+      JsonValue element;
+      if (!parseValue(element, depth + 1)) {
+        return false;
+      }
+      elements.push_back(std::move(element));
+
+      skipWhitespace();
+      if (pos_ < text_.size() && text_[pos_] == ',') {
+        ++pos_;
+        continue;
+      }
+      if (pos_ < text_.size() && text_[pos_] == ']') {
+        ++pos_;
+        out = JsonValue(std::move(elements));
+        return true;
+      }
+      error_ = "expected ',' or ']'";
+      return false;
+    }
+  }
+
+  bool parseNumber(JsonValue &out) {
+    // JSON 数字语法的子集校验交给 from_chars，再拒绝其允许的前导 '+'
+    std::size_t start = pos_;
+    while (pos_ < text_.size()) {
+      char ch = text_[pos_];
+      bool numeric = (ch >= '0' && ch <= '9') || ch == '-' || ch == '+' ||
+                     ch == '.' || ch == 'e' || ch == 'E';
+      if (!numeric) {
+        break;
+      }
+      ++pos_;
+    }
+    if (start == pos_ || text_[start] == '+') {
+      error_ = "unexpected character";
+      return false;
+    }
+
+    double value = 0;
+    const char *first = text_.data() + start;
+    const char *last = text_.data() + pos_;
+    auto [end, ec] = std::from_chars(first, last, value);
+    if (ec != std::errc() || end != last) {
+      error_ = "invalid number";
+      return false;
+    }
+    out = JsonValue(value);
+    return true;
+  }
+
+  bool parseHex4(std::uint32_t &out) noexcept {
+    if (pos_ + 4 > text_.size()) {
+      error_ = "truncated \\u escape";
+      return false;
+    }
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+      char ch = text_[pos_++];
+      out <<= 4;
+      if (ch >= '0' && ch <= '9') {
+        out |= static_cast<std::uint32_t>(ch - '0');
+      } else if (ch >= 'a' && ch <= 'f') {
+        out |= static_cast<std::uint32_t>(ch - 'a' + 10);
+      } else if (ch >= 'A' && ch <= 'F') {
+        out |= static_cast<std::uint32_t>(ch - 'A' + 10);
+      } else {
+        error_ = "invalid \\u escape";
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void appendUtf8(std::string &out, std::uint32_t cp) {
+    if (cp < 0x80) {
+      out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+      out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+      out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+      out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+  }
+
+  bool parseString(std::string &out) {
+    ++pos_; // '"'
+    while (true) {
+      // 批量拷贝无需转义的片段
+      std::size_t runStart = pos_;
+      while (pos_ < text_.size() && text_[pos_] != '"' &&
+             text_[pos_] != '\\' &&
+             static_cast<unsigned char>(text_[pos_]) >= 0x20) {
+        ++pos_;
+      }
+      out.append(text_.substr(runStart, pos_ - runStart));
+
+      if (pos_ >= text_.size()) {
+        error_ = "unterminated string";
+        return false;
+      }
+      char ch = text_[pos_++];
+      if (ch == '"') {
+        return true;
+      }
+      if (ch != '\\') {
+        error_ = "control character in string";
+        return false;
+      }
+      if (pos_ >= text_.size()) {
+        error_ = "unterminated string";
+        return false;
+      }
+
+      switch (text_[pos_++]) {
+      case '"':
+        out.push_back('"');
+        break;
+      case '\\':
+        out.push_back('\\');
+        break;
+      case '/':
+        out.push_back('/');
+        break;
+      case 'b':
+        out.push_back('\b');
+        break;
+      case 'f':
+        out.push_back('\f');
+        break;
+      case 'n':
+        out.push_back('\n');
+        break;
+      case 'r':
+        out.push_back('\r');
+        break;
+      case 't':
+        out.push_back('\t');
+        break;
+      case 'u': {
+        std::uint32_t cp = 0;
+        if (!parseHex4(cp)) {
+          return false;
+        }
+        // 高代理后紧跟低代理时合并为一个码点，孤立代理替换为 U+FFFD
+        if (cp >= 0xD800 && cp <= 0xDBFF &&
+            text_.substr(pos_, 2) == "\\u") {
+          std::size_t save = pos_;
+          pos_ += 2;
+          std::uint32_t low = 0;
+          if (!parseHex4(low)) {
+            return false;
+          }
+          if (low >= 0xDC00 && low <= 0xDFFF) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+          } else {
+            pos_ = save;
+            cp = 0xFFFD;
+          }
+        } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+          cp = 0xFFFD;
+        }
+        appendUtf8(out, cp);
+        break;
+      }
+      default:
+        error_ = "invalid escape";
+        return false;
+      }
+    }
+  }
+
+  std::string_view text_;
+  std::size_t pos_{0};
+  std::string_view error_;
+};
+
+} // namespace
+
+Result<JsonValue> parseJson(std::string_view text) {
+  return JsonParser(text).parseDocument();
+}
+
+// ========== 写出 ==========
+
+void writeJson(OutputSink &sink, const JsonValue &value) {
+  switch (value.kind()) {
+  case JsonValue::Kind::Null:
+    sink.write("null");
+    return;
+  case JsonValue::Kind::Bool:
+    sink.write(value.asBool() ? "true" : "false");
+    return;
+  case JsonValue::Kind::Number: {
+    double number = value.asNumber();
+    if (std::trunc(number) == number && std::abs(number) < 9.0e15) {
+      sink.writeInt(static_cast<std::int64_t>(number));
+    } else if (std::isfinite(number)) {
+      char digits[32];
+      auto result = std::to_chars(digits, digits + sizeof(digits), number);
+      sink.write(std::string_view(
+          digits, static_cast<std::size_t>(result.ptr - digits)));
+    } else {
+      sink.write("null");
+    }
+    return;
+  }
+  case JsonValue::Kind::String:
+    writeJsonString(sink, value.asString());
+    return;
+  case JsonValue::Kind::Array: {
+    sink.put('[');
+    bool first = true;
+    for (const auto &element : value.asArray()) {
+      if (!first) {
+        sink.put(',');
+      }
+      first = false;
+      writeJson(sink, element);
+    }
+    sink.put(']');
+    return;
+  }
+  case JsonValue::Kind::Object:
+    break;
+  }
+
+  sink.put('{');
+  bool first = true;
+  for (const auto &[name, member] : value.members()) {
+    if (!first) {
+      sink.put(',');
+    }
+    first = false;
+    writeJsonString(sink, name);
+    sink.put(':');
+    writeJson(sink, member);
+  }
+  sink.put('}');
+}
+
+} // namespace czc
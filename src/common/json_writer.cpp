@@ -0,0 +1,81 @@
+/**
+ * @file json_writer.cpp
+ * @brief JSON 字符串转义写入的实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/json_writer.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace czc {
+
+namespace {
+
+/**
+ * @brief 每个字节的转义方式：0 表示原样输出，'u' 表示 \u00XX，
+ *        其他值表示短转义字符。
+ */
+constexpr std::array<char, 256> kEscapeTable = [] {
+  std::array<char, 256> table{};
+  for (std::size_t i = 0; i < 0x20; ++i) {
+    table[i] = 'u';
+  }
+  table['"'] = '"';
+  table['\\'] = '\\';
+  table['\b'] = 'b';
+  table['\f'] = 'f';
+  table['\n'] = 'n';
+  table['\r'] = 'r';
+  table['\t'] = 't';
+  return table;
+}();
+
+constexpr std::string_view kHexDigits = "0123456789abcdef";
+
+} // namespace
+
+void writeJsonEscaped(OutputSink &sink, std::string_view value) {
+  const char *data = value.data();
+  const std::size_t size = value.size();
+  std::size_t runStart = 0;
+
+  for (std::size_t i = 0; i < size; ++i) {
+    const char escape = kEscapeTable[static_cast<std::uint8_t>(data[i])];
+    if (escape == 0) [[likely]] {
+      continue;
+    }
+
+    // 先批量写出之前的安全片段
+    if (i > runStart) {
+      sink.write(std::string_view(data + runStart, i - runStart));
+    }
+    runStart = i + 1;
+
+    if (escape == 'u') {
+      const auto byte = static_cast<std::uint8_t>(data[i]);
+      char *out = sink.reserve(6);
+      out[0] = '\\';
+      out[1] = 'u';
+      out[2] = '0';
+      out[3] = '0';
+      out[4] = kHexDigits[byte >> 4];
+      out[5] = kHexDigits[byte & 0x0F];
+      sink.commit(6);
+    } else {
+      char *out = sink.reserve(2);
+      out[0] = '\\';
+      out[1] = escape;
+      sink.commit(2);
+    }
+  }
+
+  if (size > runStart) {
+    sink.write(std::string_view(data + runStart, size - runStart));
+  }
+}
+
+} // namespace czc
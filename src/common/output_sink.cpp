@@ -0,0 +1,265 @@
+/**
+ * @file output_sink.cpp
+ * @brief 输出汇的实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/output_sink.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <system_error>
+
+#if CZC_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace czc {
+
+namespace {
+
+#if CZC_PLATFORM_WINDOWS
+constexpr int kStdoutFd = 1;
+#else
+constexpr int kStdoutFd = STDOUT_FILENO;
+#endif
+
+#if !CZC_PLATFORM_WINDOWS
+/// 单次 writev() 的段数上限（POSIX 保证 IOV_MAX >= 16，Linux/macOS 为 1024）
+constexpr std::size_t kMaxIovecs = 64;
+#endif
+
+/// 单次系统调用写入的上限（Windows _write 使用 unsigned int 长度）
+constexpr std::size_t kMaxWriteChunk = std::size_t{1} << 30;
+
+/**
+ * @brief 将全部数据写入 fd，处理部分写入和 EINTR。
+ */
+bool writeAll(int fd, const char *data, std::size_t size) {
+  while (size > 0) {
+    std::size_t chunk = size < kMaxWriteChunk ? size : kMaxWriteChunk;
+#if CZC_PLATFORM_WINDOWS
+    int n = ::_write(fd, data, static_cast<unsigned int>(chunk));
+#else
+    ssize_t n = ::write(fd, data, chunk);
+#endif
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+} // namespace
+
+// ============================================================================
+// OutputSink
+// ============================================================================
+
+OutputSink::OutputSink(std::size_t capacity)
+    : buffer_(std::make_unique_for_overwrite<char[]>(capacity)),
+      capacity_(capacity) {}
+
+void OutputSink::flush() {
+  drainBuffer();
+  flushDevice();
+}
+
+void OutputSink::drainBuffer() {
+  if (size_ == 0) {
+    return;
+  }
+  if (!failed_) {
+    if (drain(std::string_view(buffer_.get(), size_))) {
+      drained_ += size_;
+    } else {
+      failed_ = true;
+    }
+  }
+  size_ = 0;
+}
+
+void OutputSink::writeSlow(std::string_view data) {
+  drainBuffer();
+  if (data.size() <= capacity_) {
+    std::memcpy(buffer_.get(), data.data(), data.size());
+    size_ = data.size();
+    return;
+  }
+  // 大块数据直接排空，不经过缓冲区
+  drainDirect(data);
+}
+
+void OutputSink::writeThrough(std::string_view data) {
+  drainBuffer();
+  drainDirect(data);
+}
+
+void OutputSink::writeVectored(std::span<const std::string_view> parts) {
+  drainBuffer();
+  if (parts.empty() || failed_) {
+    return;
+  }
+  if (drainVectored(parts)) {
+    for (auto part : parts) {
+      drained_ += part.size();
+    }
+  } else {
+    failed_ = true;
+  }
+}
+
+bool OutputSink::drainVectored(std::span<const std::string_view> parts) {
+  for (auto part : parts) {
+    if (!part.empty() && !drain(part)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void OutputSink::drainDirect(std::string_view data) {
+  if (data.empty() || failed_) {
+    return;
+  }
+  if (drain(data)) {
+    drained_ += data.size();
+  } else {
+    failed_ = true;
+  }
+}
+
+// ============================================================================
+// FdSink
+// ============================================================================
+
+FdSink::FdSink(int fd, bool ownsFd, std::size_t capacity)
+    : OutputSink(capacity), fd_(fd), ownsFd_(ownsFd) {}
+
+FdSink::~FdSink() {
+  flush();
+  if (ownsFd_ && fd_ >= 0) {
+#if CZC_PLATFORM_WINDOWS
+    ::_close(fd_);
+#else
+    ::close(fd_);
+#endif
+  }
+}
+
+std::unique_ptr<FdSink> FdSink::standardOutput() {
+  // 与 iostream/stdio 混用时，先把它们已缓冲的内容写出，保证顺序
+  std::fflush(stdout);
+  return std::make_unique<FdSink>(kStdoutFd, false);
+}
+
+Result<std::unique_ptr<FdSink>>
+FdSink::open(const std::filesystem::path &path) {
+#if CZC_PLATFORM_WINDOWS
+  int fd = ::_wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+                    _S_IREAD | _S_IWRITE);
+#else
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+  if (fd < 0) {
+    auto reason = std::generic_category().message(errno);
+    return err<std::unique_ptr<FdSink>>(
+        "Failed to open output file: " + path.string() + " (" + reason + ")",
+        "E004");
+  }
+  return czc::ok(std::make_unique<FdSink>(fd, true));
+}
+
+bool FdSink::drain(std::string_view data) {
+  return writeAll(fd_, data.data(), data.size());
+}
+
+bool FdSink::drainVectored(std::span<const std::string_view> parts) {
+#if CZC_PLATFORM_WINDOWS
+  return OutputSink::drainVectored(parts);
+#else
+  std::array<iovec, kMaxIovecs> iov;
+
+  std::size_t next = 0;
+  while (next < parts.size()) {
+    // 每批最多 kMaxIovecs 段
+    std::size_t count = 0;
+    while (next + count < parts.size() && count < kMaxIovecs) {
+      auto part = parts[next + count];
+      iov[count].iov_base = const_cast<char *>(part.data());
+      iov[count].iov_len = part.size();
+      ++count;
+    }
+    next += count;
+
+    // 处理部分写入：跳过已写完的段，调整当前段的起点
+    iovec *cur = iov.data();
+    std::size_t remaining = count;
+    while (remaining > 0) {
+      ssize_t n = ::writev(fd_, cur, static_cast<int>(remaining));
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      auto written = static_cast<std::size_t>(n);
+      while (remaining > 0 && written >= cur->iov_len) {
+        written -= cur->iov_len;
+        ++cur;
+        --remaining;
+      }
+      if (remaining > 0) {
+        cur->iov_base = static_cast<char *>(cur->iov_base) + written;
+        cur->iov_len -= written;
+      }
+    }
+  }
+  return true;
+#endif
+}
+
+// ============================================================================
+// StringSink
+// ============================================================================
+
+StringSink::StringSink(std::string &target, std::size_t capacity)
+    : OutputSink(capacity), target_(target) {}
+
+StringSink::~StringSink() { flush(); }
+
+bool StringSink::drain(std::string_view data) {
+  target_.append(data);
+  return true;
+}
+
+// ============================================================================
+// OstreamSink
+// ============================================================================
+
+OstreamSink::OstreamSink(std::ostream &out, std::size_t capacity)
+    : OutputSink(capacity), out_(out) {}
+
+OstreamSink::~OstreamSink() { flush(); }
+
+bool OstreamSink::drain(std::string_view data) {
+  out_.write(data.data(), static_cast<std::streamsize>(data.size()));
+  return static_cast<bool>(out_);
+}
+
+void OstreamSink::flushDevice() { out_.flush(); }
+
+} // namespace czc
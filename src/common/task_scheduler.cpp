@@ -0,0 +1,257 @@
+/**
+ * @file task_scheduler.cpp
+ * @brief 工作窃取任务调度器实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/task_scheduler.hpp"
+
+#include <utility>
+
+#if CZC_PLATFORM_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace czc {
+
+namespace {
+
+/// 当前线程所属的调度器与工作线程（非工作线程为空）
+thread_local const TaskScheduler *tlsScheduler = nullptr;
+thread_local void *tlsWorker = nullptr;
+
+/// 选择窃取起点的线程局部随机数（xorshift）
+std::size_t nextRandom() noexcept {
+  thread_local std::uint64_t state =
+      0x9E3779B97F4A7C15ULL ^
+      reinterpret_cast<std::uintptr_t>(&state);
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return static_cast<std::size_t>(state);
+}
+
+/// 将当前线程绑定到第 index 个允许的 CPU（失败时保持不变）
+void pinCurrentThread(std::size_t index) noexcept {
+#if CZC_PLATFORM_LINUX
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return;
+  }
+  const int count = CPU_COUNT(&allowed);
+  if (count <= 0) {
+    return;
+  }
+
+  int target = static_cast<int>(index % static_cast<std::size_t>(count));
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed) && target-- == 0) {
+      cpu_set_t one;
+      CPU_ZERO(&one);
+      CPU_SET(cpu, &one);
+      (void)pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+      return;
+    }
+  }
+#else
+  (void)index;
+#endif
+}
+
+} // namespace
+
+// ========== TaskGroup ==========
+
+TaskGroup::~TaskGroup() { join(); }
+
+void TaskGroup::spawn(std::function<void()> fn) {
+  pending_.fetch_add(1, std::memory_order_relaxed);
+  scheduler_.submit(new TaskScheduler::Task{std::move(fn), this});
+}
+
+void TaskGroup::wait() {
+  join();
+
+  std::exception_ptr error;
+  {
+    std::lock_guard lock(errorMutex_);
+    error = std::exchange(error_, nullptr);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void TaskGroup::join() {
+  while (true) {
+    // 先读取完成计数再检查本组，之后完成的任务都会改变计数
+    const std::uint64_t seen =
+        scheduler_.completed_.load(std::memory_order_acquire);
+    if (pending_.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+    if (scheduler_.runPending()) {
+      continue;
+    }
+    // 没有可协助的任务：剩余任务正在其他线程上执行
+    scheduler_.completed_.wait(seen, std::memory_order_acquire);
+  }
+}
+
+void TaskGroup::recordError(std::exception_ptr error) {
+  std::lock_guard lock(errorMutex_);
+  if (!error_) {
+    error_ = std::move(error);
+  }
+}
+
+// ========== TaskScheduler ==========
+
+TaskScheduler::TaskScheduler(SchedulerOptions options)
+    : pinWorkers_(options.pinWorkers) {
+  std::size_t threads = options.threads;
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (options.deterministic) {
+    threads = 1;
+  }
+
+  // 先创建全部队列再启动线程，窃取时遍历的数组之后不再变化
+  for (std::size_t i = 1; i < threads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (std::size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->thread =
+        std::jthread([this, i] { workerLoop(*workers_[i], i); });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  stopping_.store(true, std::memory_order_release);
+  epoch_.fetch_add(1, std::memory_order_release);
+  epoch_.notify_all();
+  for (auto &worker : workers_) {
+    worker->thread.join();
+  }
+
+  // 未被等待的任务直接丢弃
+  for (auto &worker : workers_) {
+    while (Task *task = worker->deque.pop()) {
+      delete task;
+    }
+  }
+  for (Task *task : injected_) {
+    delete task;
+  }
+}
+
+bool TaskScheduler::runPending() {
+  Task *task = findTask(currentWorker());
+  if (task == nullptr) {
+    return false;
+  }
+  execute(task);
+  return true;
+}
+
+void TaskScheduler::submit(Task *task) {
+  if (Worker *self = currentWorker(); self != nullptr) {
+    self->deque.push(task);
+  } else {
+    std::lock_guard lock(injectMutex_);
+    injected_.push_back(task);
+  }
+  epoch_.fetch_add(1, std::memory_order_release);
+  epoch_.notify_one();
+}
+
+TaskScheduler::Task *TaskScheduler::findTask(Worker *self) {
+  if (self != nullptr) {
+    if (Task *task = self->deque.pop()) {
+      return task;
+    }
+  }
+
+  {
+    std::lock_guard lock(injectMutex_);
+    if (!injected_.empty()) {
+      Task *task = injected_.front();
+      injected_.pop_front();
+      return task;
+    }
+  }
+
+  // 从随机位置开始轮询其他线程，避免所有窃取者争抢同一个队列
+  const std::size_t count = workers_.size();
+  if (count == 0) {
+    return nullptr;
+  }
+  const std::size_t start = nextRandom() % count;
+  for (std::size_t i = 0; i < count; ++i) {
+    Worker &victim = *workers_[(start + i) % count];
+    if (&victim == self) {
+      continue;
+    }
+    if (Task *task = victim.deque.steal()) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+void TaskScheduler::execute(Task *task) {
+  std::unique_ptr<Task> owned(task);
+  TaskGroup *group = owned->group;
+  try {
+    owned->fn();
+  } catch (...) {
+    group->recordError(std::current_exception());
+  }
+  owned.reset();
+
+  // 计数归零后等待者可能立即析构 group，唤醒经由调度器自身的计数
+  group->pending_.fetch_sub(1, std::memory_order_acq_rel);
+  completed_.fetch_add(1, std::memory_order_release);
+  completed_.notify_all();
+}
+
+TaskScheduler::Worker *TaskScheduler::currentWorker() const noexcept {
+  return tlsScheduler == this ? static_cast<Worker *>(tlsWorker) : nullptr;
+}
+
+void TaskScheduler::workerLoop(Worker &self, std::size_t index) {
+  tlsScheduler = this;
+  tlsWorker = &self;
+  if (pinWorkers_) {
+    // 调用线程占用第 0 个位置，工作线程从第 1 个开始
+    pinCurrentThread(index + 1);
+  }
+
+  while (!stopping_.load(std::memory_order_acquire)) {
+    if (Task *task = findTask(&self)) {
+      execute(task);
+      continue;
+    }
+
+    // 先读取提交计数再复查，之后的提交都会改变计数，不会丢失唤醒
+    const std::uint64_t seen = epoch_.load(std::memory_order_acquire);
+    if (Task *task = findTask(&self)) {
+      execute(task);
+      continue;
+    }
+    if (stopping_.load(std::memory_order_acquire)) {
+      break;
+    }
+    epoch_.wait(seen, std::memory_order_acquire);
+  }
+
+  tlsScheduler = nullptr;
+  tlsWorker = nullptr;
+}
+
+} // namespace czc
@@ -0,0 +1,26 @@
+/**
+ * @file unique_fd.cpp
+ * @brief 独占文件描述符的实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/unique_fd.hpp"
+
+#if !CZC_PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
+
+namespace czc {
+
+void UniqueFd::reset(int fd) noexcept {
+#if !CZC_PLATFORM_WINDOWS
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+#endif
+  fd_ = fd;
+}
+
+} // namespace czc
@@ -23,46 +23,45 @@ auto DiagBuilder::code(ErrorCode c) -> DiagBuilder & {
 }
 
 auto DiagBuilder::span(Span s) -> DiagBuilder & {
-  diag_.spans.addPrimary(s, "");
+  diag_.spans.addPrimary(s);
   return *this;
 }
 
-auto DiagBuilder::spanLabel(Span s, std::string_view label) -> DiagBuilder & {
-  diag_.spans.addPrimary(s, label);
+auto DiagBuilder::spanLabel(Span s, DiagString label) -> DiagBuilder & {
+  diag_.spans.addPrimary(s, std::move(label));
   return *this;
 }
 
-auto DiagBuilder::secondarySpan(Span s, std::string_view label)
-    -> DiagBuilder & {
-  diag_.spans.addSecondary(s, label);
+auto DiagBuilder::secondarySpan(Span s, DiagString label) -> DiagBuilder & {
+  diag_.spans.addSecondary(s, std::move(label));
   return *this;
 }
 
-auto DiagBuilder::note(std::string_view message) -> DiagBuilder & {
-  diag_.children.emplace_back(Level::Note, std::string(message));
+auto DiagBuilder::note(DiagString message) -> DiagBuilder & {
+  diag_.children.emplace_back(Level::Note, std::move(message));
   return *this;
 }
 
-auto DiagBuilder::note(Span s, std::string_view message) -> DiagBuilder & {
-  diag_.children.emplace_back(Level::Note, std::string(message), s);
+auto DiagBuilder::note(Span s, DiagString message) -> DiagBuilder & {
+  diag_.children.emplace_back(Level::Note, std::move(message), s);
   return *this;
 }
 
-auto DiagBuilder::help(std::string_view message) -> DiagBuilder & {
-  diag_.children.emplace_back(Level::Help, std::string(message));
+auto DiagBuilder::help(DiagString message) -> DiagBuilder & {
+  diag_.children.emplace_back(Level::Help, std::move(message));
   return *this;
 }
 
-auto DiagBuilder::help(Span s, std::string_view message) -> DiagBuilder & {
-  diag_.children.emplace_back(Level::Help, std::string(message), s);
+auto DiagBuilder::help(Span s, DiagString message) -> DiagBuilder & {
+  diag_.children.emplace_back(Level::Help, std::move(message), s);
   return *this;
 }
 
 auto DiagBuilder::suggestion(Span s, std::string replacement,
-                             std::string_view message,
+                             DiagString message,
                              Applicability applicability) -> DiagBuilder & {
   diag_.suggestions.emplace_back(s, std::move(replacement),
-                                 std::string(message), applicability);
+                                 std::move(message), applicability);
   return *this;
 }
 
@@ -7,43 +7,31 @@
  */
 
 #include "czc/diag/diag_context.hpp"
+#include "czc/diag/diag_dedup.hpp"
 #include "czc/diag/emitter.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <set>
-#include <unordered_set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace czc::diag {
 
 namespace {
 
-/// 计算诊断的哈希值，用于去重
-[[nodiscard]] auto computeDiagnosticHash(const Diagnostic &diag) -> size_t {
-  size_t hash = 0;
-
-  // 组合哈希值的辅助函数
-  auto combineHash = [&hash](size_t value) {
-    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-  };
-
-  // 哈希消息内容
-  combineHash(std::hash<std::string_view>{}(diag.message.markdown()));
-
-  // 哈希错误码
-  if (diag.code) {
-    combineHash(diag.code->hash());
-  }
-
-  // 哈希主要位置
-  auto primarySpan = diag.primarySpan();
-  if (primarySpan) {
-    combineHash(std::hash<uint32_t>{}(primarySpan->fileId));
-    combineHash(std::hash<uint32_t>{}(primarySpan->startOffset));
-  }
-
-  return hash;
-}
+/// 合并排序条目：指向缓冲区内的诊断及其确定性排序键
+struct MergeEntry {
+  uint32_t fileId;
+  uint32_t offset;
+  uint32_t bufferIndex;
+  uint32_t sequence;
+  Diagnostic *diag;
+  const SourceLocator *locator;
+};
 
 } // namespace
 
@@ -54,15 +42,18 @@ struct DiagContext::Impl {
   DiagConfig config;
   std::unique_ptr<i18n::Translator> translator;
 
-  // 统计数据
-  size_t errorCount{0};
-  size_t warningCount{0};
-  size_t noteCount{0};
-  bool hadFatal{false};
+  // 统计数据（原子计数，查询无需加锁；写入仍在 mutex 内进行）
+  std::atomic<size_t> errorCount{0};
+  std::atomic<size_t> warningCount{0};
+  std::atomic<size_t> noteCount{0};
+  std::atomic<bool> hadFatal{false};
   std::set<ErrorCode> uniqueErrorCodes; ///< 唯一错误码集合
 
-  // 去重（使用哈希值）
-  std::unordered_set<size_t> seenDiagnosticHashes;
+  // 去重（固定内存，按级别、错误码与位置）
+  DiagDeduplicator dedup;
+
+  // 按错误码限流：每个错误码已接收的诊断数
+  std::unordered_map<ErrorCode, size_t, ErrorCodeHash> perCodeCount;
 
   // 线程安全
   mutable std::mutex mutex;
@@ -86,57 +77,147 @@ auto DiagContext::operator=(DiagContext &&) noexcept -> DiagContext & = default;
 
 void DiagContext::emit(Diagnostic diag) {
   std::lock_guard lock(impl_->mutex);
+  processLocked(diag, impl_->locator);
+}
+
+void DiagContext::processLocked(Diagnostic &diag,
+                                const SourceLocator *locator) {
+  if (admitLocked(diag) && impl_->emitter) {
+    impl_->emitter->emit(diag, locator ? locator : impl_->locator);
+  }
+}
 
+auto DiagContext::admitLocked(Diagnostic &diag) -> bool {
   // 处理 -Werror
   if (impl_->config.treatWarningsAsErrors && diag.level == Level::Warning) {
     diag.level = Level::Error;
   }
 
-  // 去重检查（使用哈希值）
+  // 去重检查；无位置的诊断不参与去重
   if (impl_->config.deduplicate) {
-    size_t hash = computeDiagnosticHash(diag);
-    if (impl_->seenDiagnosticHashes.contains(hash)) {
-      return;
+    if (auto key = DiagDeduplicator::keyOf(diag);
+        key && !impl_->dedup.insert(*key)) {
+      return false;
     }
-    impl_->seenDiagnosticHashes.insert(hash);
   }
 
-  // 更新统计
+  // 更新统计（写入均在锁内，relaxed 足够）
+  size_t errors = impl_->errorCount.load(std::memory_order_relaxed);
   switch (diag.level) {
   case Level::Error:
   case Level::Bug:
-    ++impl_->errorCount;
+    impl_->errorCount.store(++errors, std::memory_order_relaxed);
     if (diag.code) {
       impl_->uniqueErrorCodes.insert(*diag.code);
     }
     break;
   case Level::Fatal:
-    ++impl_->errorCount;
-    impl_->hadFatal = true;
+    impl_->errorCount.store(++errors, std::memory_order_relaxed);
+    impl_->hadFatal.store(true, std::memory_order_relaxed);
     if (diag.code) {
       impl_->uniqueErrorCodes.insert(*diag.code);
     }
     break;
   case Level::Warning:
-    ++impl_->warningCount;
+    impl_->warningCount.fetch_add(1, std::memory_order_relaxed);
     break;
   case Level::Note:
   case Level::Help:
-    ++impl_->noteCount;
+    impl_->noteCount.fetch_add(1, std::memory_order_relaxed);
     break;
   default:
     break;
   }
 
+  // 按错误码限流：超出部分计入统计但不输出
+  if (impl_->config.maxPerCode > 0 && diag.code) {
+    if (++impl_->perCodeCount[*diag.code] > impl_->config.maxPerCode) {
+      return false;
+    }
+  }
+
   // 检查最大错误数
-  if (impl_->config.maxErrors > 0 &&
-      impl_->errorCount > impl_->config.maxErrors) {
+  return impl_->config.maxErrors == 0 || errors <= impl_->config.maxErrors;
+}
+
+auto DiagContext::collectStatsLocked() const -> DiagnosticStats {
+  DiagnosticStats result;
+  result.errorCount = impl_->errorCount.load(std::memory_order_relaxed);
+  result.warningCount = impl_->warningCount.load(std::memory_order_relaxed);
+  result.noteCount = impl_->noteCount.load(std::memory_order_relaxed);
+  result.uniqueErrorCodes = impl_->uniqueErrorCodes;
+  size_t limit = impl_->config.maxPerCode;
+  for (const auto &[code, count] : impl_->perCodeCount) {
+    if (limit > 0 && count > limit) {
+      result.suppressedByCode.emplace(code, count - limit);
+    }
+  }
+  return result;
+}
+
+void DiagContext::merge(DiagBuffer &buffer) {
+  merge(std::span<DiagBuffer>(&buffer, 1));
+}
+
+void DiagContext::merge(std::span<DiagBuffer> buffers) {
+  // 锁外收集并排序：缓冲区此时已不再被工作线程写入
+  size_t total = 0;
+  for (const auto &buffer : buffers) {
+    total += buffer.size();
+  }
+  if (total == 0) {
     return;
   }
 
-  // 发射
-  if (impl_->emitter) {
-    impl_->emitter->emit(diag, impl_->locator);
+  std::vector<MergeEntry> entries;
+  entries.reserve(total);
+  for (size_t b = 0; b < buffers.size(); ++b) {
+    auto &items = buffers[b].diagnostics_;
+    for (size_t i = 0; i < items.size(); ++i) {
+      // 无位置的诊断排在最前（fileId 0）
+      auto span = items[i].primarySpan().value_or(Span::invalid());
+      entries.push_back({span.fileId, span.startOffset,
+                         static_cast<uint32_t>(b), static_cast<uint32_t>(i),
+                         &items[i], buffers[b].locator_});
+    }
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const MergeEntry &a, const MergeEntry &b) {
+              return std::tie(a.fileId, a.offset, a.bufferIndex, a.sequence) <
+                     std::tie(b.fileId, b.offset, b.bufferIndex, b.sequence);
+            });
+
+  {
+    std::lock_guard lock(impl_->mutex);
+
+    // 连续使用同一定位器的诊断合并为一批交给发射器
+    std::vector<const Diagnostic *> batch;
+    batch.reserve(entries.size());
+    const SourceLocator *batchLocator = nullptr;
+    auto flushBatch = [&] {
+      if (!batch.empty() && impl_->emitter) {
+        impl_->emitter->emitBatch(batch, batchLocator);
+      }
+      batch.clear();
+    };
+
+    for (auto &entry : entries) {
+      if (!admitLocked(*entry.diag)) {
+        continue;
+      }
+      const auto *locator = entry.locator ? entry.locator : impl_->locator;
+      if (locator != batchLocator) {
+        flushBatch();
+        batchLocator = locator;
+      }
+      batch.push_back(entry.diag);
+    }
+    flushBatch();
+  }
+
+  for (auto &buffer : buffers) {
+    buffer.clear();
   }
 }
 
@@ -178,54 +259,46 @@ void DiagContext::note(Message message) {
 }
 
 auto DiagContext::errorCount() const noexcept -> size_t {
-  std::lock_guard lock(impl_->mutex);
-  return impl_->errorCount;
+  return impl_->errorCount.load(std::memory_order_relaxed);
 }
 
 auto DiagContext::warningCount() const noexcept -> size_t {
-  std::lock_guard lock(impl_->mutex);
-  return impl_->warningCount;
+  return impl_->warningCount.load(std::memory_order_relaxed);
 }
 
 auto DiagContext::hasErrors() const noexcept -> bool {
-  std::lock_guard lock(impl_->mutex);
-  return impl_->errorCount > 0;
+  return impl_->errorCount.load(std::memory_order_relaxed) > 0;
 }
 
 auto DiagContext::shouldAbort() const noexcept -> bool {
-  std::lock_guard lock(impl_->mutex);
-  if (impl_->hadFatal) {
+  if (impl_->hadFatal.load(std::memory_order_relaxed)) {
     return true;
   }
-  if (impl_->config.maxErrors > 0 &&
-      impl_->errorCount >= impl_->config.maxErrors) {
-    return true;
-  }
-  return false;
+  size_t maxErrors = impl_->config.maxErrors;
+  return maxErrors > 0 &&
+         impl_->errorCount.load(std::memory_order_relaxed) >= maxErrors;
 }
 
 auto DiagContext::stats() const noexcept -> DiagnosticStats {
   std::lock_guard lock(impl_->mutex);
-  DiagnosticStats result;
-  result.errorCount = impl_->errorCount;
-  result.warningCount = impl_->warningCount;
-  result.noteCount = impl_->noteCount;
-  result.uniqueErrorCodes = impl_->uniqueErrorCodes;
-  return result;
+  return collectStatsLocked();
 }
 
 void DiagContext::emitSummary() {
   std::lock_guard lock(impl_->mutex);
   if (impl_->emitter) {
-    DiagnosticStats s;
-    s.errorCount = impl_->errorCount;
-    s.warningCount = impl_->warningCount;
-    s.noteCount = impl_->noteCount;
-    s.uniqueErrorCodes = impl_->uniqueErrorCodes;
-    impl_->emitter->emitSummary(s);
+    impl_->emitter->emitSummary(collectStatsLocked());
   }
 }
 
+void DiagContext::setEmitter(std::unique_ptr<Emitter> emitter) {
+  std::lock_guard lock(impl_->mutex);
+  if (impl_->emitter) {
+    impl_->emitter->flush();
+  }
+  impl_->emitter = std::move(emitter);
+}
+
 void DiagContext::setLocator(const SourceLocator *locator) {
   std::lock_guard lock(impl_->mutex);
   impl_->locator = locator;
@@ -256,6 +329,17 @@ void DiagContext::flush() {
   }
 }
 
+void DiagContext::reset() {
+  std::lock_guard lock(impl_->mutex);
+  impl_->errorCount.store(0, std::memory_order_relaxed);
+  impl_->warningCount.store(0, std::memory_order_relaxed);
+  impl_->noteCount.store(0, std::memory_order_relaxed);
+  impl_->hadFatal.store(false, std::memory_order_relaxed);
+  impl_->uniqueErrorCodes.clear();
+  impl_->dedup.clear();
+  impl_->perCodeCount.clear();
+}
+
 auto DiagContext::createErrorGuaranteed() -> ErrorGuaranteed {
   return ErrorGuaranteed();
 }
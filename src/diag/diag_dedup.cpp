@@ -0,0 +1,196 @@
+/**
+ * @file diag_dedup.cpp
+ * @brief 固定内存的诊断去重器实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/diag_dedup.hpp"
+
+#include <algorithm>
+
+namespace czc::diag {
+
+namespace {
+
+/// 索引表槽位数（窗口容量的两倍，负载因子不超过 0.5）
+constexpr size_t kIndexSlots = DiagDeduplicator::kRecentCapacity * 2;
+constexpr size_t kIndexMask = kIndexSlots - 1;
+static_assert((kIndexSlots & kIndexMask) == 0);
+
+/// 空槽位
+constexpr uint16_t kEmptySlot = UINT16_MAX;
+static_assert(DiagDeduplicator::kRecentCapacity < kEmptySlot);
+
+/// 64 位混合（splitmix64 终结步骤）
+constexpr auto mix(uint64_t x) noexcept -> uint64_t {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+constexpr auto hashKey(const DedupKey &key) noexcept -> uint64_t {
+  return mix((static_cast<uint64_t>(key.fileId) << 32 | key.offset) ^
+             mix(key.tag));
+}
+
+} // namespace
+
+/// 去重器状态（约 112 KiB，构造时一次分配）
+struct DiagDeduplicator::State {
+  using Block = std::array<uint64_t, 8>;
+
+  std::array<Block, kBloomBlocks> bloom{};
+  size_t bloomInserts{0};
+
+  std::array<DedupKey, kRecentCapacity> ring{};
+  size_t ringSize{0};
+  size_t ringHead{0}; ///< 下一个写入（满时即最旧）的位置
+
+  std::array<uint16_t, kIndexSlots> index{}; ///< 存放 ring 下标
+
+  State() { index.fill(kEmptySlot); }
+
+  // ========== 布隆过滤器 ==========
+
+  /// 块内各位取自哈希值高位的 9 位片段，块号取自低位
+  static auto blockOf(uint64_t hash) noexcept -> size_t {
+    return static_cast<size_t>(hash % kBloomBlocks);
+  }
+
+  static auto bitOf(uint64_t hash, size_t i) noexcept -> uint32_t {
+    return static_cast<uint32_t>((hash >> (28 + 9 * i)) & 511);
+  }
+
+  [[nodiscard]] auto bloomMayContain(uint64_t hash) const noexcept -> bool {
+    const auto &block = bloom[blockOf(hash)];
+    for (size_t i = 0; i < kBloomHashes; ++i) {
+      auto bit = bitOf(hash, i);
+      if ((block[bit >> 6] & (uint64_t{1} << (bit & 63))) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void bloomAdd(uint64_t hash) noexcept {
+    auto &block = bloom[blockOf(hash)];
+    for (size_t i = 0; i < kBloomHashes; ++i) {
+      auto bit = bitOf(hash, i);
+      block[bit >> 6] |= uint64_t{1} << (bit & 63);
+    }
+  }
+
+  /// 位图接近饱和时按窗口内容重建，保证窗口中的键仍可命中
+  void rebuildBloom() noexcept {
+    for (auto &block : bloom) {
+      block.fill(0);
+    }
+    for (size_t i = 0; i < ringSize; ++i) {
+      bloomAdd(hashKey(ring[i]));
+    }
+    bloomInserts = ringSize;
+  }
+
+  // ========== 最近键窗口 ==========
+
+  [[nodiscard]] auto findSlot(const DedupKey &key, uint64_t hash) const noexcept
+      -> size_t {
+    for (size_t slot = hash & kIndexMask;; slot = (slot + 1) & kIndexMask) {
+      if (index[slot] == kEmptySlot || ring[index[slot]] == key) {
+        return slot;
+      }
+    }
+  }
+
+  /// 已知键不在窗口中时，只需找到探测链上的第一个空槽位
+  [[nodiscard]] auto freeSlot(uint64_t hash) const noexcept -> size_t {
+    size_t slot = hash & kIndexMask;
+    while (index[slot] != kEmptySlot) {
+      slot = (slot + 1) & kIndexMask;
+    }
+    return slot;
+  }
+
+  /// 线性探测的回移删除，保持探测链连续
+  void eraseSlot(size_t hole) noexcept {
+    for (size_t next = (hole + 1) & kIndexMask; index[next] != kEmptySlot;
+         next = (next + 1) & kIndexMask) {
+      size_t home = hashKey(ring[index[next]]) & kIndexMask;
+      // next 的理想位置不在 (hole, next] 区间内时才能移入 hole
+      bool movable = hole <= next ? (home <= hole || home > next)
+                                  : (home <= hole && home > next);
+      if (movable) {
+        index[hole] = index[next];
+        hole = next;
+      }
+    }
+    index[hole] = kEmptySlot;
+  }
+
+  /// 加入不在窗口中的键；淘汰会移动槽位，因此在淘汰之后定位插入点
+  void recentAdd(const DedupKey &key, uint64_t hash) noexcept {
+    if (ringSize == kRecentCapacity) {
+      const auto &oldest = ring[ringHead];
+      eraseSlot(findSlot(oldest, hashKey(oldest)));
+    } else {
+      ++ringSize;
+    }
+    ring[ringHead] = key;
+    index[freeSlot(hash)] = static_cast<uint16_t>(ringHead);
+    ringHead = (ringHead + 1) % kRecentCapacity;
+  }
+};
+
+DiagDeduplicator::DiagDeduplicator() : state_(std::make_unique<State>()) {}
+
+DiagDeduplicator::~DiagDeduplicator() = default;
+
+DiagDeduplicator::DiagDeduplicator(DiagDeduplicator &&) noexcept = default;
+auto DiagDeduplicator::operator=(DiagDeduplicator &&) noexcept
+    -> DiagDeduplicator & = default;
+
+auto DiagDeduplicator::keyOf(const Diagnostic &diag) noexcept
+    -> std::optional<DedupKey> {
+  const auto *primary = diag.spans.primary();
+  if (primary == nullptr) {
+    return std::nullopt;
+  }
+
+  // tag: [level:8][hasCode:1][category:7][code:16]
+  uint32_t tag = static_cast<uint32_t>(diag.level) << 24;
+  if (diag.code) {
+    tag |= 1U << 23;
+    tag |= static_cast<uint32_t>(diag.code->category) << 16;
+    tag |= diag.code->code;
+  }
+  return DedupKey{primary->span.fileId, primary->span.startOffset, tag};
+}
+
+auto DiagDeduplicator::insert(const DedupKey &key) noexcept -> bool {
+  auto &s = *state_;
+  uint64_t hash = hashKey(key);
+
+  // 常见情况：布隆过滤器确认未见过，无需在窗口中比较键
+  // （窗口中的键总在过滤器中，重建时也会重新加入）
+  if (s.bloomMayContain(hash) &&
+      s.index[s.findSlot(key, hash)] != kEmptySlot) {
+    return false;
+  }
+
+  if (s.bloomInserts >= kBloomBudget) {
+    s.rebuildBloom();
+  }
+  s.bloomAdd(hash);
+  ++s.bloomInserts;
+  s.recentAdd(key, hash);
+  return true;
+}
+
+void DiagDeduplicator::clear() noexcept { *state_ = State(); }
+
+} // namespace czc::diag
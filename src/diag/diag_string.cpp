@@ -0,0 +1,72 @@
+/**
+ * @file diag_string.cpp
+ * @brief 诊断文本与进程级字符串驻留实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/diag_string.hpp"
+
+#include <cstring>
+#include <mutex>
+
+namespace czc::diag {
+
+auto DiagString::interned(std::string_view text) -> DiagString {
+  return borrowed(StringInterner::instance().intern(text));
+}
+
+auto StringInterner::instance() -> StringInterner & {
+  // 有意泄漏：静态析构期间仍可能有诊断引用驻留文本
+  static auto *interner = new StringInterner();
+  return *interner;
+}
+
+auto StringInterner::intern(std::string_view text) -> std::string_view {
+  if (text.empty()) {
+    return "";
+  }
+
+  {
+    std::shared_lock lock(mutex_);
+    if (auto it = strings_.find(text); it != strings_.end()) {
+      return *it;
+    }
+  }
+
+  std::unique_lock lock(mutex_);
+  // 双重检查：等待写锁期间其他线程可能已插入
+  if (auto it = strings_.find(text); it != strings_.end()) {
+    return *it;
+  }
+  auto stored = store(text);
+  strings_.insert(stored);
+  return stored;
+}
+
+auto StringInterner::size() const -> size_t {
+  std::shared_lock lock(mutex_);
+  return strings_.size();
+}
+
+auto StringInterner::store(std::string_view text) -> std::string_view {
+  if (text.size() > kBlockSize / 4) {
+    // 长文本独占一块，不浪费当前块的剩余空间
+    auto &block = blocks_.emplace_back(std::make_unique<char[]>(text.size()));
+    std::memcpy(block.get(), text.data(), text.size());
+    return {block.get(), text.size()};
+  }
+
+  if (remaining_ < text.size()) {
+    cursor_ = blocks_.emplace_back(std::make_unique<char[]>(kBlockSize)).get();
+    remaining_ = kBlockSize;
+  }
+  std::memcpy(cursor_, text.data(), text.size());
+  std::string_view stored(cursor_, text.size());
+  cursor_ += text.size();
+  remaining_ -= text.size();
+  return stored;
+}
+
+} // namespace czc::diag
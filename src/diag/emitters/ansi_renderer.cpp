@@ -7,10 +7,15 @@
  */
 
 #include "czc/diag/emitters/ansi_renderer.hpp"
+#include "czc/diag/render_cache.hpp"
 
 #include <cmark.h>
+
+#include <algorithm>
 #include <format>
-#include <sstream>
+#include <iterator>
+#include <tuple>
+#include <vector>
 
 namespace czc::diag {
 
@@ -208,70 +213,255 @@ void renderNodeToAnsi(cmark_node *node, std::string &out,
   }
 }
 
+/// 源码行中的渲染窗口（字节区间）
+struct LineWindow {
+  size_t begin{0};
+  size_t end{0};
+  size_t spanBegin{0};
+  size_t spanEnd{0};
+};
+
+/// 是否为 UTF-8 后续字节
+constexpr auto isContinuation(char c) noexcept -> bool {
+  return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+/// 统计 UTF-8 码点数（即显示列数的近似）
+auto countCodePoints(std::string_view text) noexcept -> size_t {
+  return static_cast<size_t>(
+      std::count_if(text.begin(), text.end(),
+                    [](char c) { return !isContinuation(c); }));
+}
+
+/// 计算以标注为中心的窗口，边界对齐到 UTF-8 字符起始处
+/// 只检查边界附近至多 3 个字节，代价与行长无关
+auto computeLineWindow(std::string_view line, size_t start, size_t length,
+                       size_t context, size_t maxSpan) noexcept
+    -> LineWindow {
+  auto floorBoundary = [&](size_t pos) {
+    while (pos > 0 && pos < line.size() && isContinuation(line[pos])) {
+      --pos;
+    }
+    return pos;
+  };
+  auto ceilBoundary = [&](size_t pos) {
+    while (pos < line.size() && isContinuation(line[pos])) {
+      ++pos;
+    }
+    return pos;
+  };
+
+  LineWindow window;
+  window.spanBegin = floorBoundary(std::min(start, line.size()));
+  window.spanEnd = ceilBoundary(
+      std::min(window.spanBegin + std::min(length, maxSpan), line.size()));
+  window.begin = floorBoundary(
+      window.spanBegin > context ? window.spanBegin - context : 0);
+  window.end = ceilBoundary(std::min(window.spanEnd + context, line.size()));
+  return window;
+}
+
 } // namespace
 
 auto AnsiRenderer::renderMessage(std::string_view msg) const -> std::string {
-  if (msg.empty()) {
-    return "";
+  // 快速路径：不含 Markdown 语法的文本渲染结果与原文相同
+  if (!needsMarkdown(msg)) {
+    return std::string(msg);
   }
 
-  // 使用 cmark 解析 Markdown
-  cmark_node *doc =
-      cmark_parse_document(msg.data(), msg.size(), CMARK_OPT_DEFAULT);
+  return RenderCache::instance().getOrRender(
+      msg, RenderTarget::Ansi, style_.cacheKey(),
+      [this](std::string_view text) -> std::string {
+        // 使用 cmark 解析 Markdown
+        cmark_node *doc =
+            cmark_parse_document(text.data(), text.size(), CMARK_OPT_DEFAULT);
 
-  if (doc == nullptr) {
-    // 解析失败，返回原始内容
-    return std::string(msg);
-  }
+        if (doc == nullptr) {
+          // 解析失败，返回原始内容
+          return std::string(text);
+        }
 
-  std::string result;
-  result.reserve(msg.size() * 2);
+        std::string result;
+        result.reserve(text.size() * 2);
 
-  renderNodeToAnsi(doc, result, style_);
-  cmark_node_free(doc);
+        renderNodeToAnsi(doc, result, style_);
+        cmark_node_free(doc);
 
-  // 移除末尾多余换行（诊断消息通常不需要尾部换行）
-  while (!result.empty() && result.back() == '\n') {
-    result.pop_back();
-  }
+        // 移除末尾多余换行（诊断消息通常不需要尾部换行）
+        while (!result.empty() && result.back() == '\n') {
+          result.pop_back();
+        }
 
-  return result;
+        return result;
+      });
 }
 
 auto AnsiRenderer::renderDiagnostic(const Diagnostic &diag,
                                     const SourceLocator *locator) const
     -> std::string {
-  std::ostringstream out;
+  std::string out;
+
+  auto primarySpan = diag.spans.primary();
+  if (!primarySpan || locator == nullptr) {
+    renderDiagnosticTo(out, diag, nullptr, {});
+    return out;
+  }
+
+  const auto &span = primarySpan->span;
+  ResolvedLocation location{
+      locator->getFilename(span),
+      locator->getLineColumn(span.fileId, span.startOffset), {}};
+  location.lineContent =
+      locator->getLineContent(span.fileId, location.position.line);
+
+  std::string fragment;
+  if (!location.lineContent.empty() &&
+      location.lineContent.size() <= kMaxSnippetLine) {
+    renderLineFragment(fragment, location.position.line,
+                       location.lineContent);
+  }
+  renderDiagnosticTo(out, diag, &location, fragment);
+  return out;
+}
+
+auto AnsiRenderer::renderBatch(std::span<const Diagnostic> diags,
+                               const SourceLocator *locator) const
+    -> std::string {
+  std::vector<const Diagnostic *> pointers;
+  pointers.reserve(diags.size());
+  for (const auto &diag : diags) {
+    pointers.push_back(&diag);
+  }
+  return renderBatch(pointers, locator);
+}
+
+auto AnsiRenderer::renderBatch(std::span<const Diagnostic *const> diags,
+                               const SourceLocator *locator) const
+    -> std::string {
+  constexpr uint32_t kNoFragment = UINT32_MAX;
+
+  std::string out;
+  if (locator == nullptr) {
+    for (const auto *diag : diags) {
+      renderDiagnosticTo(out, *diag, nullptr, {});
+    }
+    return out;
+  }
+
+  // 收集主要位置并按 (文件, 偏移) 排序
+  struct Site {
+    uint32_t fileId;
+    uint32_t offset;
+    uint32_t index;
+  };
+  std::vector<Site> sites;
+  sites.reserve(diags.size());
+  for (uint32_t i = 0; i < diags.size(); ++i) {
+    if (auto primary = diags[i]->spans.primary()) {
+      sites.push_back({primary->span.fileId, primary->span.startOffset, i});
+    }
+  }
+  std::sort(sites.begin(), sites.end(), [](const Site &a, const Site &b) {
+    return std::tie(a.fileId, a.offset, a.index) <
+           std::tie(b.fileId, b.offset, b.index);
+  });
+
+  std::vector<ResolvedLocation> resolved(diags.size());
+  std::vector<uint32_t> fragmentOf(diags.size(), kNoFragment);
+  std::vector<std::string> fragments;
+  std::vector<uint32_t> offsets;
+  std::vector<LineColumn> positions;
+
+  // 每个文件一次前向解析；相邻位置同行时复用行片段
+  for (size_t begin = 0; begin < sites.size();) {
+    uint32_t fileId = sites[begin].fileId;
+    size_t end = begin;
+    offsets.clear();
+    while (end < sites.size() && sites[end].fileId == fileId) {
+      offsets.push_back(sites[end].offset);
+      ++end;
+    }
+    positions.assign(offsets.size(), LineColumn{});
+    locator->resolveSorted(fileId, offsets, positions);
+
+    auto filename = locator->getFilename(
+        diags[sites[begin].index]->spans.primary()->span);
+    uint32_t lastLine = 0;
+    std::string_view lastContent;
+    uint32_t lastFragment = kNoFragment;
+    for (size_t k = 0; k < offsets.size(); ++k) {
+      auto position = positions[k];
+      if (k == 0 || position.line != lastLine) {
+        lastLine = position.line;
+        lastContent = locator->getLineContent(fileId, position.line);
+        lastFragment = kNoFragment;
+        // 超长行按各自标注开窗，不共享整行片段
+        if (!lastContent.empty() && lastContent.size() <= kMaxSnippetLine) {
+          lastFragment = static_cast<uint32_t>(fragments.size());
+          renderLineFragment(fragments.emplace_back(), position.line,
+                             lastContent);
+        }
+      }
+      auto index = sites[begin + k].index;
+      resolved[index] = {filename, position, lastContent};
+      fragmentOf[index] = lastFragment;
+    }
+    begin = end;
+  }
 
+  // 按输入顺序输出
+  for (uint32_t i = 0; i < diags.size(); ++i) {
+    const auto *location =
+        diags[i]->spans.primary() ? &resolved[i] : nullptr;
+    std::string_view fragment;
+    if (fragmentOf[i] != kNoFragment) {
+      fragment = fragments[fragmentOf[i]];
+    }
+    renderDiagnosticTo(out, *diags[i], location, fragment);
+  }
+  return out;
+}
+
+void AnsiRenderer::renderDiagnosticTo(std::string &out, const Diagnostic &diag,
+                                      const ResolvedLocation *location,
+                                      std::string_view fragment) const {
   auto levelColor = getLevelColor(diag.level);
   auto levelStr = levelToString(diag.level);
 
   // 第一行：error[L1001]: message
-  out << wrapBold(wrapColor(levelStr, levelColor));
+  out += wrapBold(wrapColor(levelStr, levelColor));
 
   if (diag.hasCode()) {
-    out << wrapBold(
+    out += wrapBold(
         wrapColor(std::format("[{}]", diag.code->toString()), levelColor));
   }
 
-  out << wrapBold(": ");
-  out << renderMessage(diag.message.renderPlainText());
-  out << "\n";
+  out += wrapBold(": ");
+  out += renderMessage(diag.message.renderPlainText());
+  out += '\n';
 
   // 位置信息
-  auto primarySpan = diag.spans.primary();
-  if (primarySpan && locator != nullptr) {
-    auto filename = locator->getFilename(primarySpan->span);
-    auto lc = locator->getLineColumn(primarySpan->span.fileId,
-                                     primarySpan->span.startOffset);
-
-    out << "  ";
-    out << wrapColor("-->", style_.lineNumColor);
-    out << " " << filename << ":" << lc.line << ":" << lc.column;
-    out << "\n";
+  if (location != nullptr) {
+    out += "  ";
+    out += wrapColor("-->", style_.lineNumColor);
+    out += ' ';
+    out += location->filename;
+    std::format_to(std::back_inserter(out), ":{}:{}\n",
+                   location->position.line, location->position.column);
 
     // 源码片段
-    out << renderSourceSnippet(diag, locator);
+    const auto &primary = *diag.spans.primary();
+    if (location->lineContent.size() > kMaxSnippetLine) {
+      renderWindowedSnippet(out, primary, *location, levelColor);
+    } else if (!fragment.empty()) {
+      out += fragment;
+      // 计算列偏移（1-based 转 0-based）
+      auto column = location->position.column;
+      size_t indent = column > 0 ? column - 1 : 0;
+      renderAnnotation(out, primary, indent,
+                       std::max<size_t>(primary.span.length(), 1),
+                       levelColor);
+    }
   }
 
   // 子诊断
@@ -279,98 +469,110 @@ auto AnsiRenderer::renderDiagnostic(const Diagnostic &diag,
     auto childColor = getLevelColor(child.level);
     auto childLevelStr = levelToString(child.level);
 
-    out << "  = ";
-    out << wrapBold(wrapColor(childLevelStr, childColor));
-    out << ": ";
-    out << renderMessage(child.message);
-    out << "\n";
+    out += "  = ";
+    out += wrapBold(wrapColor(childLevelStr, childColor));
+    out += ": ";
+    out += renderMessage(child.message);
+    out += '\n';
   }
 
   // 建议
   for (const auto &suggestion : diag.suggestions) {
-    out << "  = ";
-    out << wrapBold(wrapColor("help", style_.helpColor));
-    out << ": ";
-    out << renderMessage(suggestion.message);
+    out += "  = ";
+    out += wrapBold(wrapColor("help", style_.helpColor));
+    out += ": ";
+    out += renderMessage(suggestion.message);
     if (!suggestion.replacement.empty()) {
-      out << ": ";
-      out << wrapColor("`" + suggestion.replacement + "`", style_.codeColor);
+      out += ": ";
+      out += wrapColor("`" + suggestion.replacement + "`", style_.codeColor);
     }
-    out << "\n";
+    out += '\n';
   }
-
-  return out.str();
 }
 
-auto AnsiRenderer::renderSourceSnippet(const Diagnostic &diag,
-                                       const SourceLocator *locator) const
-    -> std::string {
-  if (locator == nullptr) {
-    return "";
-  }
-
-  auto primarySpan = diag.spans.primary();
-  if (!primarySpan) {
-    return "";
-  }
-
-  std::ostringstream out;
-
-  auto lc = locator->getLineColumn(primarySpan->span.fileId,
-                                   primarySpan->span.startOffset);
-  auto lineContent = locator->getLineContent(primarySpan->span.fileId, lc.line);
-
-  if (lineContent.empty()) {
-    return "";
-  }
-
+void AnsiRenderer::renderLineFragment(std::string &out, uint32_t line,
+                                      std::string_view content) const {
   // 行号宽度 - 计算行号字符串的显示宽度
-  std::string lineNumStr = std::to_string(lc.line);
-  size_t lineNumWidth = lineNumStr.size();
+  std::string lineNumStr = std::to_string(line);
 
   // 创建与行号等宽的空白边距
-  std::string margin(lineNumWidth, ' ');
+  std::string margin(lineNumStr.size(), ' ');
+  auto bar = wrapColor("|", style_.lineNumColor);
 
   // 打印空白行 "{margin} |"
   // rustc 格式: "   |" 其中空格数等于行号宽度
-  out << " " << margin << " " << wrapColor("|", style_.lineNumColor) << "\n";
+  out += ' ';
+  out += margin;
+  out += ' ';
+  out += bar;
+  out += '\n';
 
   // 打印 "{line_num} | {content}"
-  // 右对齐行号，宽度为 lineNumWidth
-  out << " " << wrapColor(lineNumStr, style_.lineNumColor);
-  out << " " << wrapColor("|", style_.lineNumColor);
-  out << " " << lineContent << "\n";
+  out += ' ';
+  out += wrapColor(lineNumStr, style_.lineNumColor);
+  out += ' ';
+  out += bar;
+  out += ' ';
+  out += content;
+  out += '\n';
+
+  // 标注行前缀 "{margin} | "
+  out += ' ';
+  out += margin;
+  out += ' ';
+  out += bar;
+  out += ' ';
+}
 
-  // 打印标注行 "{margin} | {spaces}{carets}"
-  out << " " << margin << " " << wrapColor("|", style_.lineNumColor) << " ";
+void AnsiRenderer::renderWindowedSnippet(std::string &out,
+                                         const LabeledSpan &span,
+                                         const ResolvedLocation &location,
+                                         AnsiColor color) const {
+  constexpr std::string_view kEllipsis = "...";
+
+  // 列号为行内字节偏移 + 1，只在窗口内部逐字节处理
+  auto line = location.lineContent;
+  auto column = location.position.column;
+  auto window =
+      computeLineWindow(line, column > 0 ? column - 1 : 0, span.span.length(),
+                        kSnippetContext, kMaxSnippetSpan);
+
+  bool elidedBefore = window.begin > 0;
+  bool elidedAfter = window.end < line.size();
+  std::string content;
+  content.reserve(window.end - window.begin + 2 * kEllipsis.size());
+  if (elidedBefore) {
+    content += kEllipsis;
+  }
+  content += line.substr(window.begin, window.end - window.begin);
+  if (elidedAfter) {
+    content += kEllipsis;
+  }
+  renderLineFragment(out, location.position.line, content);
+
+  // 窗口内按码点对齐标注
+  size_t indent = (elidedBefore ? kEllipsis.size() : 0) +
+                  countCodePoints(line.substr(
+                      window.begin, window.spanBegin - window.begin));
+  size_t width = countCodePoints(
+      line.substr(window.spanBegin, window.spanEnd - window.spanBegin));
+  renderAnnotation(out, span, indent, std::max<size_t>(width, 1), color);
+}
 
-  // 计算列偏移（1-based 转 0-based）
-  size_t col = lc.column > 0 ? lc.column - 1 : 0;
-  out << std::string(col, ' ');
+void AnsiRenderer::renderAnnotation(std::string &out, const LabeledSpan &span,
+                                    size_t indent, size_t width,
+                                    AnsiColor color) const {
+  out.append(indent, ' ');
 
   // 打印标注符号
-  size_t spanLen = primarySpan->span.length();
-  if (spanLen == 0) {
-    spanLen = 1;
-  }
-
-  auto levelColor = getLevelColor(diag.level);
-  out << wrapColor(std::string(spanLen, '^'), levelColor);
+  out += wrapColor(std::string(width, '^'), color);
 
   // 打印标签
-  if (!primarySpan->label.empty()) {
-    out << " " << wrapColor(primarySpan->label, levelColor);
+  if (!span.label.empty()) {
+    out += ' ';
+    out += wrapColor(span.label, color);
   }
-  out << "\n";
-
-  return out.str();
-}
-
-auto AnsiRenderer::renderAnnotation(const LabeledSpan & /*span*/,
-                                    uint32_t /*lineStartCol*/,
-                                    AnsiColor /*color*/) const -> std::string {
-  // 简化实现
-  return "";
+  out += '\n';
 }
 
 } // namespace czc::diag
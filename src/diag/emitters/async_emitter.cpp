@@ -0,0 +1,301 @@
+/**
+ * @file async_emitter.cpp
+ * @brief 异步多目标发射器实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/emitters/async_emitter.hpp"
+#include "czc/common/spsc_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace czc::diag {
+
+namespace {
+
+/// 单次写线程批处理的最大块数
+constexpr size_t kMaxBatch = 64;
+
+/// 新建渲染缓冲区的初始容量
+constexpr size_t kInitialBufferCapacity = 1024;
+
+/// 追加到外部 std::string 的流缓冲区（未设置目标时丢弃）
+class StringAppendBuf final : public std::streambuf {
+public:
+  void setTarget(std::string *target) noexcept { target_ = target; }
+
+protected:
+  auto overflow(int_type ch) -> int_type override {
+    if (target_ != nullptr &&
+        !traits_type::eq_int_type(ch, traits_type::eof())) {
+      target_->push_back(traits_type::to_char_type(ch));
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  auto xsputn(const char *s, std::streamsize n) -> std::streamsize override {
+    if (target_ == nullptr) {
+      return n;
+    }
+    target_->append(s, static_cast<size_t>(n));
+    return n;
+  }
+
+private:
+  std::string *target_{nullptr};
+};
+
+/// 单次发射内缓存位置查询，让多个格式共享行列计算
+class SharedLocator final : public SourceLocator {
+public:
+  explicit SharedLocator(const SourceLocator &inner) : inner_(&inner) {}
+
+  auto getFilename(Span span) const -> std::string_view override {
+    return inner_->getFilename(span);
+  }
+
+  auto getLineColumn(uint32_t fileId, uint32_t offset) const
+      -> LineColumn override {
+    for (const auto &entry : lineColumns_) {
+      if (entry.fileId == fileId && entry.offset == offset) {
+        return entry.value;
+      }
+    }
+    auto value = inner_->getLineColumn(fileId, offset);
+    lineColumns_.push_back({fileId, offset, value});
+    return value;
+  }
+
+  auto getLineContent(uint32_t fileId, uint32_t line) const
+      -> std::string_view override {
+    for (const auto &entry : lines_) {
+      if (entry.fileId == fileId && entry.line == line) {
+        return entry.value;
+      }
+    }
+    auto value = inner_->getLineContent(fileId, line);
+    lines_.push_back({fileId, line, value});
+    return value;
+  }
+
+  auto getSourceSlice(Span span) const -> std::string_view override {
+    return inner_->getSourceSlice(span);
+  }
+
+private:
+  struct LineColumnEntry {
+    uint32_t fileId;
+    uint32_t offset;
+    LineColumn value;
+  };
+  struct LineEntry {
+    uint32_t fileId;
+    uint32_t line;
+    std::string_view value;
+  };
+
+  const SourceLocator *inner_;
+  // 一个诊断只涉及少量位置，线性查找即可
+  mutable std::vector<LineColumnEntry> lineColumns_;
+  mutable std::vector<LineEntry> lines_;
+};
+
+/// 队列中的数据块；ticket 非 0 表示刷新屏障
+struct Packet {
+  uint32_t sink{0};
+  std::string data;
+  uint64_t ticket{0};
+};
+
+/// 单个输出目标的渲染状态（仅编译线程访问 emitter/stream）
+struct SinkState {
+  StringAppendBuf buffer;
+  std::ostream stream{&buffer};
+  std::unique_ptr<Emitter> emitter;
+  std::unique_ptr<OutputSink> destination; ///< 仅写线程访问
+};
+
+} // namespace
+
+/// AsyncEmitter 内部实现
+struct AsyncEmitter::Impl {
+  std::vector<std::unique_ptr<SinkState>> sinks;
+  SpscQueue<Packet> queue;         ///< 编译线程 -> 写线程
+  SpscQueue<std::string> recycled; ///< 写线程 -> 编译线程（缓冲区池）
+
+  std::string spare;      ///< 渲染为空时留存的缓冲区（仅编译线程访问）
+  uint64_t nextTicket{0}; ///< 仅编译线程访问
+  std::atomic<uint64_t> completedTicket{0}; ///< 写线程已完成的屏障
+  std::jthread writer;
+
+  Impl(std::vector<AsyncSink> specs, size_t queueDepth)
+      : queue(queueDepth), recycled(queueDepth) {
+    sinks.reserve(specs.size());
+    for (auto &spec : specs) {
+      auto state = std::make_unique<SinkState>();
+      state->emitter = spec.makeEmitter(state->stream);
+      state->destination = std::move(spec.destination);
+      sinks.push_back(std::move(state));
+    }
+    writer = std::jthread([this] { writerLoop(); });
+  }
+
+  /// 从池中取出一块渲染缓冲区
+  auto acquireBuffer() -> std::string {
+    if (spare.capacity() != 0) {
+      return std::move(spare);
+    }
+    if (auto buffer = recycled.tryPop()) {
+      return std::move(*buffer);
+    }
+    std::string buffer;
+    buffer.reserve(kInitialBufferCapacity);
+    return buffer;
+  }
+
+  /// 对每个目标执行一次渲染，并把非空结果入队
+  template <typename Render> void renderAll(Render &&render) {
+    for (uint32_t i = 0; i < sinks.size(); ++i) {
+      auto &state = *sinks[i];
+      std::string data = acquireBuffer();
+      state.buffer.setTarget(&data);
+      render(state.emitter);
+      state.buffer.setTarget(nullptr);
+      if (data.empty()) {
+        spare = std::move(data);
+        continue;
+      }
+      queue.push(Packet{i, std::move(data), 0});
+    }
+  }
+
+  /// 插入刷新屏障并等待写线程完成
+  void flushAndWait() {
+    uint64_t ticket = ++nextTicket;
+    if (!queue.push(Packet{0, {}, ticket})) {
+      return;
+    }
+    uint64_t done = completedTicket.load(std::memory_order_acquire);
+    while (done < ticket) {
+      completedTicket.wait(done, std::memory_order_acquire);
+      done = completedTicket.load(std::memory_order_acquire);
+    }
+  }
+
+  /// 写线程：批量取出数据块，按目标聚集写出
+  void writerLoop() {
+    std::vector<Packet> batch;
+    batch.reserve(kMaxBatch);
+    std::vector<std::vector<std::string_view>> parts(sinks.size());
+
+    while (auto first = queue.pop()) {
+      batch.push_back(std::move(*first));
+      while (batch.size() < kMaxBatch) {
+        auto more = queue.tryPop();
+        if (!more) {
+          break;
+        }
+        batch.push_back(std::move(*more));
+      }
+
+      uint64_t ticket = 0;
+      for (const auto &packet : batch) {
+        if (packet.ticket != 0) {
+          ticket = packet.ticket;
+        } else {
+          parts[packet.sink].push_back(packet.data);
+        }
+      }
+
+      for (size_t i = 0; i < sinks.size(); ++i) {
+        if (!parts[i].empty()) {
+          sinks[i]->destination->writeVectored(parts[i]);
+          parts[i].clear();
+        }
+      }
+
+      // 屏障之前的数据都已在本批写出，刷新后通知等待方
+      if (ticket != 0) {
+        for (auto &state : sinks) {
+          state->destination->flush();
+        }
+        completedTicket.store(ticket, std::memory_order_release);
+        completedTicket.notify_all();
+      }
+
+      for (auto &packet : batch) {
+        if (packet.ticket == 0) {
+          packet.data.clear();
+          recycled.tryPush(packet.data);
+        }
+      }
+      batch.clear();
+    }
+
+    for (auto &state : sinks) {
+      state->destination->flush();
+    }
+  }
+};
+
+AsyncEmitter::AsyncEmitter(std::vector<AsyncSink> sinks, size_t queueDepth)
+    : impl_(std::make_unique<Impl>(std::move(sinks), queueDepth)) {}
+
+AsyncEmitter::~AsyncEmitter() {
+  // 子发射器析构时可能补写内容（如闭合 JSON 文档），同样经队列写出
+  impl_->renderAll([](auto &e) { e.reset(); });
+
+  // 关闭队列后写线程排空剩余数据块并退出
+  impl_->queue.close();
+  impl_->writer.join();
+}
+
+void AsyncEmitter::emit(const Diagnostic &diag, const SourceLocator *locator) {
+  if (locator != nullptr) {
+    SharedLocator shared(*locator);
+    impl_->renderAll([&](auto &e) { e->emit(diag, &shared); });
+  } else {
+    impl_->renderAll([&](auto &e) { e->emit(diag, locator); });
+  }
+
+  // 致命错误之后进程可能立即退出，先保证已写出
+  if (diag.level >= Level::Fatal) {
+    flush();
+  }
+}
+
+void AsyncEmitter::emitBatch(std::span<const Diagnostic *const> diags,
+                             const SourceLocator *locator) {
+  // 批量渲染自行按文件排序解析位置，无需逐条缓存的共享定位器
+  impl_->renderAll([&](auto &e) { e->emitBatch(diags, locator); });
+
+  bool fatal = std::any_of(diags.begin(), diags.end(), [](const auto *diag) {
+    return diag->level >= Level::Fatal;
+  });
+  if (fatal) {
+    flush();
+  }
+}
+
+void AsyncEmitter::emitSummary(const DiagnosticStats &stats) {
+  impl_->renderAll([&](auto &e) { e->emitSummary(stats); });
+}
+
+void AsyncEmitter::flush() {
+  // 子发射器可能在 flush 时补写内容
+  impl_->renderAll([](auto &e) { e->flush(); });
+  impl_->flushAndWait();
+}
+
+auto AsyncEmitter::sinkCount() const noexcept -> size_t {
+  return impl_->sinks.size();
+}
+
+} // namespace czc::diag
@@ -7,160 +7,532 @@
  */
 
 #include "czc/diag/emitters/json_emitter.hpp"
+#include "czc/common/json_writer.hpp"
 
-#include <glaze/glaze.hpp>
-
-#include <sstream>
+#include <algorithm>
+#include <string>
 
 namespace czc::diag {
 
-JsonEmitter::JsonEmitter(std::ostream &out, bool pretty)
-    : out_(&out), pretty_(pretty) {}
+namespace {
+
+/// 将诊断级别映射为 SARIF 级别
+[[nodiscard]] auto sarifLevel(Level level) -> std::string_view {
+  switch (level) {
+  case Level::Error:
+  case Level::Fatal:
+  case Level::Bug:
+    return "error";
+  case Level::Warning:
+    return "warning";
+  default:
+    return "note";
+  }
+}
+
+/// 是否为 RFC 3986 的非保留字符
+[[nodiscard]] constexpr auto isUnreserved(char c) noexcept -> bool {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_' ||
+         c == '~';
+}
+
+/// 按字节百分号编码路径，保留非保留字符与 `/`
+void writePercentEncoded(OutputSink &sink, std::string_view path) {
+  static constexpr std::string_view kHex = "0123456789ABCDEF";
+  for (char c : path) {
+    if (isUnreserved(c) || c == '/') {
+      sink.put(c);
+      continue;
+    }
+    auto byte = static_cast<unsigned char>(c);
+    sink.put('%');
+    sink.put(kHex[byte >> 4]);
+    sink.put(kHex[byte & 0x0F]);
+  }
+}
+
+/**
+ * @brief 写入 artifactLocation 的内容（不含花括号）。
+ *
+ * @details
+ *   绝对路径写为 `file://` URI；Windows 盘符路径的 `\` 换为 `/`。
+ *   相对路径写为相对 URI 引用，并以 `%SRCROOT%` 作为 uriBaseId。
+ */
+void writeArtifactUri(OutputSink &sink, std::string_view filename) {
+  sink.write(R"("uri":")");
+  const bool hasDrive = filename.size() >= 3 && filename[1] == ':' &&
+                        (filename[2] == '/' || filename[2] == '\\') &&
+                        ((filename[0] >= 'a' && filename[0] <= 'z') ||
+                         (filename[0] >= 'A' && filename[0] <= 'Z'));
+  if (hasDrive) {
+    sink.write("file:///");
+    sink.put(filename[0]);
+    sink.put(':');
+    std::string path(filename.substr(2));
+    std::replace(path.begin(), path.end(), '\\', '/');
+    writePercentEncoded(sink, path);
+    sink.put('"');
+    return;
+  }
+  if (filename.starts_with('/')) {
+    sink.write("file://");
+    writePercentEncoded(sink, filename);
+    sink.put('"');
+    return;
+  }
+  writePercentEncoded(sink, filename);
+  sink.write(R"(","uriBaseId":"%SRCROOT%")");
+}
+
+/**
+ * @brief 将字节列号换算为 Unicode 码点列号（均从 1 开始）。
+ *
+ * @details
+ *   行内容按 UTF-8 计数非续字节；超出行内容的部分（如行尾换行符）
+ *   按每字节一列计。
+ */
+[[nodiscard]] auto codePointColumn(std::string_view line, uint32_t byteColumn)
+    -> uint32_t {
+  if (byteColumn == 0) {
+    return 0;
+  }
+  const auto bytes = static_cast<std::size_t>(byteColumn - 1);
+  const auto prefix = line.substr(0, bytes);
+  auto column = static_cast<uint32_t>(bytes - prefix.size()) + 1;
+  for (char c : prefix) {
+    if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+      ++column;
+    }
+  }
+  return column;
+}
 
-JsonEmitter::~JsonEmitter() = default;
+/// 写入 `"key":` 前缀
+void writeKey(OutputSink &sink, std::string_view key) {
+  sink.put('"');
+  sink.write(key);
+  sink.write("\":");
+}
+
+} // namespace
+
+JsonEmitter::JsonEmitter(std::ostream &out, JsonDiagFormat format)
+    : sink_(std::make_unique<OstreamSink>(out)), format_(format) {}
+
+JsonEmitter::~JsonEmitter() {
+  if (sink_) {
+    // 未调用 emitSummary 时也保证输出为合法 JSON
+    if (opened_ && !closed_) {
+      closeDocument(nullptr);
+    }
+    sink_->flush();
+  }
+}
 
 void JsonEmitter::emit(const Diagnostic &diag, const SourceLocator *locator) {
-  if (firstDiag_) {
-    *out_ << "{\"diagnostics\": [\n";
-    firstDiag_ = false;
-  } else {
-    *out_ << ",\n";
+  if (format_ == JsonDiagFormat::Lines) {
+    writeDiagnostic(diag, locator);
+    sink_->put('\n');
+    return;
+  }
+
+  if (!opened_) {
+    openDocument();
+  }
+  if (!firstDiag_) {
+    sink_->put(',');
   }
+  firstDiag_ = false;
 
-  *out_ << diagnosticToJson(diag, locator);
+  if (format_ == JsonDiagFormat::Sarif) {
+    writeSarifResult(diag, locator);
+  } else {
+    writeDiagnostic(diag, locator);
+  }
 }
 
 void JsonEmitter::emitSummary(const DiagnosticStats &stats) {
-  // 在 flush 之前添加统计信息
-  if (!firstDiag_) {
-    *out_ << "\n], \"stats\": {\n";
-    *out_ << "  \"error_count\": " << stats.errorCount << ",\n";
-    *out_ << "  \"warning_count\": " << stats.warningCount << ",\n";
-    *out_ << "  \"note_count\": " << stats.noteCount << ",\n";
-    *out_ << "  \"unique_error_codes\": [";
+  if (format_ == JsonDiagFormat::Lines) {
+    sink_->put('{');
+    writeKey(*sink_, "stats");
+    writeStats(stats);
+    sink_->write("}\n");
+    return;
+  }
 
-    bool first = true;
-    for (const auto &code : stats.uniqueErrorCodes) {
-      if (!first) {
-        *out_ << ", ";
-      }
-      first = false;
-      *out_ << "\"" << code.toString() << "\"";
+  if (closed_) {
+    return;
+  }
+  if (!opened_) {
+    openDocument();
+  }
+  closeDocument(&stats);
+}
+
+void JsonEmitter::flush() { sink_->flush(); }
+
+// ========== 文档结构 ==========
+
+void JsonEmitter::openDocument() {
+  opened_ = true;
+  if (format_ == JsonDiagFormat::Sarif) {
+    sink_->write(
+        R"({"version":"2.1.0",)"
+        R"("$schema":"https://json.schemastore.org/sarif-2.1.0.json",)"
+        R"("runs":[{"tool":{"driver":{"name":"czc","version":")");
+    sink_->write(kVersion.string);
+    // 列号按 Unicode 码点计，与 SARIF 默认的 UTF-16 代码单元区分
+    sink_->write(R"("}},"columnKind":"unicodeCodePoints","results":[)");
+  } else {
+    sink_->write(R"({"diagnostics":[)");
+  }
+}
+
+void JsonEmitter::closeDocument(const DiagnosticStats *stats) {
+  closed_ = true;
+  sink_->put(']');
+  if (format_ == JsonDiagFormat::Sarif) {
+    if (stats != nullptr) {
+      sink_->write(R"(,"invocations":[{"executionSuccessful":)");
+      sink_->write(stats->hasErrors() ? "false" : "true");
+      sink_->write("}]");
     }
-    *out_ << "]\n";
-    *out_ << "}}";
+    sink_->write("}]}\n");
+    return;
+  }
+  if (stats != nullptr) {
+    sink_->put(',');
+    writeKey(*sink_, "stats");
+    writeStats(*stats);
   }
+  sink_->write("}\n");
 }
 
-void JsonEmitter::flush() {
-  // 如果没有调用 emitSummary，则关闭数组
-  if (!firstDiag_) {
-    // 检查是否已经输出了 summary（通过检查是否以 '}' 结尾）
-    // 这里简化处理，假设 emitSummary 已经处理了关闭
+void JsonEmitter::writeStats(const DiagnosticStats &stats) {
+  auto &out = *sink_;
+  out.put('{');
+  writeKey(out, "error_count");
+  out.writeInt(stats.errorCount);
+  out.put(',');
+  writeKey(out, "warning_count");
+  out.writeInt(stats.warningCount);
+  out.put(',');
+  writeKey(out, "note_count");
+  out.writeInt(stats.noteCount);
+  out.put(',');
+  writeKey(out, "unique_error_codes");
+  out.put('[');
+  bool first = true;
+  for (const auto &code : stats.uniqueErrorCodes) {
+    if (!first) {
+      out.put(',');
+    }
+    first = false;
+    writeJsonString(out, code.toString());
+  }
+  out.put(']');
+  if (!stats.suppressedByCode.empty()) {
+    out.put(',');
+    writeKey(out, "suppressed");
+    out.put('{');
+    first = true;
+    for (const auto &[code, count] : stats.suppressedByCode) {
+      if (!first) {
+        out.put(',');
+      }
+      first = false;
+      writeKey(out, code.toString());
+      out.writeInt(count);
+    }
+    out.put('}');
   }
-  out_->flush();
+  out.put('}');
 }
 
-auto JsonEmitter::diagnosticToJson(const Diagnostic &diag,
-                                   const SourceLocator *locator) const
-    -> std::string {
-  std::ostringstream out;
+// ========== czc 原生格式 ==========
 
-  out << "  {\n";
-  out << "    \"level\": \"" << levelToString(diag.level) << "\",\n";
+void JsonEmitter::writeDiagnostic(const Diagnostic &diag,
+                                  const SourceLocator *locator) {
+  auto &out = *sink_;
+  out.put('{');
+  writeKey(out, "level");
+  writeJsonString(out, levelToString(diag.level));
 
   if (diag.hasCode()) {
-    out << "    \"code\": \"" << diag.code->toString() << "\",\n";
-  }
-
-  // 转义消息中的特殊字符
-  auto message = diag.message.renderPlainText();
-  std::string escapedMessage;
-  for (char c : message) {
-    switch (c) {
-    case '"':
-      escapedMessage += "\\\"";
-      break;
-    case '\\':
-      escapedMessage += "\\\\";
-      break;
-    case '\n':
-      escapedMessage += "\\n";
-      break;
-    case '\r':
-      escapedMessage += "\\r";
-      break;
-    case '\t':
-      escapedMessage += "\\t";
-      break;
-    default:
-      escapedMessage += c;
-      break;
-    }
-  }
-  out << "    \"message\": \"" << escapedMessage << "\",\n";
+    out.put(',');
+    writeKey(out, "code");
+    writeJsonString(out, diag.code->toString());
+  }
+
+  out.put(',');
+  writeKey(out, "message");
+  writeJsonString(out, diag.message.renderPlainText());
 
   // Spans
-  out << "    \"spans\": [";
+  out.put(',');
+  writeKey(out, "spans");
+  out.put('[');
   bool first = true;
   for (const auto &ls : diag.spans.spans()) {
-    if (!first)
-      out << ", ";
+    if (!first) {
+      out.put(',');
+    }
     first = false;
-    out << spanToJson(ls.span, locator);
+    writeSpan(ls.span, locator);
+    // 在 Span 对象末尾追加标注信息
+    out.write(R"(,"primary":)");
+    out.write(ls.isPrimary ? "true" : "false");
+    if (!ls.label.empty()) {
+      out.put(',');
+      writeKey(out, "label");
+      writeJsonString(out, ls.label);
+    }
+    out.put('}');
   }
-  out << "],\n";
+  out.put(']');
 
   // Children
-  out << "    \"children\": [";
+  out.put(',');
+  writeKey(out, "children");
+  out.put('[');
   first = true;
   for (const auto &child : diag.children) {
-    if (!first)
-      out << ", ";
+    if (!first) {
+      out.put(',');
+    }
     first = false;
-    out << "{\"level\": \"" << levelToString(child.level) << "\", ";
-    out << "\"message\": \"" << child.message << "\"}";
+    out.put('{');
+    writeKey(out, "level");
+    writeJsonString(out, levelToString(child.level));
+    out.put(',');
+    writeKey(out, "message");
+    writeJsonString(out, child.message);
+    if (child.span) {
+      out.put(',');
+      writeKey(out, "span");
+      writeSpan(*child.span, locator);
+      out.put('}');
+    }
+    out.put('}');
   }
-  out << "],\n";
+  out.put(']');
 
   // Suggestions
-  out << "    \"suggestions\": [";
+  out.put(',');
+  writeKey(out, "suggestions");
+  out.put('[');
   first = true;
   for (const auto &suggestion : diag.suggestions) {
-    if (!first)
-      out << ", ";
+    if (!first) {
+      out.put(',');
+    }
     first = false;
-    out << "{\"message\": \"" << suggestion.message << "\", ";
-    out << "\"replacement\": \"" << suggestion.replacement << "\"}";
+    out.put('{');
+    writeKey(out, "message");
+    writeJsonString(out, suggestion.message);
+    out.put(',');
+    writeKey(out, "replacement");
+    writeJsonString(out, suggestion.replacement);
+    out.put(',');
+    writeKey(out, "span");
+    writeSpan(suggestion.span, locator);
+    out.write("}}");
   }
-  out << "]\n";
+  out.write("]}");
+}
 
-  out << "  }";
+void JsonEmitter::writeSpan(const Span &span, const SourceLocator *locator) {
+  // 不写闭合括号，调用方可追加字段
+  auto &out = *sink_;
+  out.put('{');
+  writeKey(out, "file_id");
+  out.writeInt(span.fileId);
+  out.put(',');
+  writeKey(out, "start");
+  out.writeInt(span.startOffset);
+  out.put(',');
+  writeKey(out, "end");
+  out.writeInt(span.endOffset);
 
-  return out.str();
+  if (locator != nullptr && span.isValid()) {
+    auto lc = locator->getLineColumn(span.fileId, span.startOffset);
+    out.put(',');
+    writeKey(out, "file");
+    writeJsonString(out, locator->getFilename(span));
+    out.put(',');
+    writeKey(out, "line");
+    out.writeInt(lc.line);
+    out.put(',');
+    writeKey(out, "column");
+    out.writeInt(lc.column);
+  }
 }
 
-auto JsonEmitter::spanToJson(const Span &span,
-                             const SourceLocator *locator) const
-    -> std::string {
-  std::ostringstream out;
+// ========== SARIF 2.1.0 ==========
 
-  out << "{";
-  out << "\"file_id\": " << span.fileId << ", ";
-  out << "\"start\": " << span.startOffset << ", ";
-  out << "\"end\": " << span.endOffset;
+void JsonEmitter::writeSarifResult(const Diagnostic &diag,
+                                   const SourceLocator *locator) {
+  auto &out = *sink_;
+  out.put('{');
+  if (diag.hasCode()) {
+    writeKey(out, "ruleId");
+    writeJsonString(out, diag.code->toString());
+    out.put(',');
+  }
+  writeKey(out, "level");
+  writeJsonString(out, sarifLevel(diag.level));
+  out.write(R"(,"message":{"text":)");
+  writeJsonString(out, diag.message.renderPlainText());
+  out.put('}');
 
-  if (locator != nullptr && span.isValid()) {
-    auto filename = locator->getFilename(span);
-    auto lc = locator->getLineColumn(span.fileId, span.startOffset);
-    out << ", \"file\": \"" << filename << "\"";
-    out << ", \"line\": " << lc.line;
-    out << ", \"column\": " << lc.column;
+  // 主要位置 -> locations，次要位置与子诊断 -> relatedLocations
+  bool hasPrimary = false;
+  bool hasRelated = false;
+  for (const auto &ls : diag.spans.spans()) {
+    (ls.isPrimary ? hasPrimary : hasRelated) = true;
+  }
+  for (const auto &child : diag.children) {
+    hasRelated = hasRelated || child.span.has_value();
   }
 
-  out << "}";
+  if (hasPrimary) {
+    out.write(R"(,"locations":[)");
+    bool first = true;
+    for (const auto &ls : diag.spans.spans()) {
+      if (!ls.isPrimary) {
+        continue;
+      }
+      if (!first) {
+        out.put(',');
+      }
+      first = false;
+      writeSarifLocation(ls.span, ls.label, locator);
+    }
+    out.put(']');
+  }
 
-  return out.str();
+  if (hasRelated) {
+    out.write(R"(,"relatedLocations":[)");
+    bool first = true;
+    for (const auto &ls : diag.spans.spans()) {
+      if (ls.isPrimary) {
+        continue;
+      }
+      if (!first) {
+        out.put(',');
+      }
+      first = false;
+      writeSarifLocation(ls.span, ls.label, locator);
+    }
+    for (const auto &child : diag.children) {
+      if (!child.span) {
+        continue;
+      }
+      if (!first) {
+        out.put(',');
+      }
+      first = false;
+      writeSarifLocation(*child.span, child.message, locator);
+    }
+    out.put(']');
+  }
+
+  // 不带位置的子诊断与修复建议放入 properties，避免信息丢失
+  bool hasNotes = false;
+  for (const auto &child : diag.children) {
+    hasNotes = hasNotes || !child.span.has_value();
+  }
+  if (hasNotes || !diag.suggestions.empty()) {
+    out.write(R"(,"properties":{)");
+    bool needComma = false;
+    if (hasNotes) {
+      writeKey(out, "notes");
+      out.put('[');
+      bool first = true;
+      for (const auto &child : diag.children) {
+        if (child.span) {
+          continue;
+        }
+        if (!first) {
+          out.put(',');
+        }
+        first = false;
+        writeJsonString(out, child.message);
+      }
+      out.put(']');
+      needComma = true;
+    }
+    if (!diag.suggestions.empty()) {
+      if (needComma) {
+        out.put(',');
+      }
+      writeKey(out, "suggestions");
+      out.put('[');
+      bool first = true;
+      for (const auto &suggestion : diag.suggestions) {
+        if (!first) {
+          out.put(',');
+        }
+        first = false;
+        out.put('{');
+        writeKey(out, "message");
+        writeJsonString(out, suggestion.message);
+        out.put(',');
+        writeKey(out, "replacement");
+        writeJsonString(out, suggestion.replacement);
+        out.put('}');
+      }
+      out.put(']');
+    }
+    out.put('}');
+  }
+
+  out.put('}');
+}
+
+void JsonEmitter::writeSarifLocation(const Span &span, std::string_view message,
+                                     const SourceLocator *locator) {
+  auto &out = *sink_;
+  out.write(R"({"physicalLocation":{)");
+  if (locator != nullptr && span.isValid()) {
+    out.write(R"("artifactLocation":{)");
+    writeArtifactUri(out, locator->getFilename(span));
+    out.write("},");
+  }
+  out.write(R"("region":{)");
+  if (locator != nullptr && span.isValid()) {
+    auto start = locator->getLineColumn(span.fileId, span.startOffset);
+    auto end = locator->getLineColumn(span.fileId, span.endOffset);
+    writeKey(out, "startLine");
+    out.writeInt(start.line);
+    out.put(',');
+    writeKey(out, "startColumn");
+    out.writeInt(codePointColumn(
+        locator->getLineContent(span.fileId, start.line), start.column));
+    if (end.isValid()) {
+      out.put(',');
+      writeKey(out, "endLine");
+      out.writeInt(end.line);
+      out.put(',');
+      writeKey(out, "endColumn");
+      out.writeInt(codePointColumn(
+          locator->getLineContent(span.fileId, end.line), end.column));
+    }
+    out.put(',');
+  }
+  writeKey(out, "byteOffset");
+  out.writeInt(span.startOffset);
+  out.put(',');
+  writeKey(out, "byteLength");
+  out.writeInt(span.length());
+  out.write("}}");
+  if (!message.empty()) {
+    out.write(R"(,"message":{"text":)");
+    writeJsonString(out, message);
+    out.put('}');
+  }
+  out.put('}');
 }
 
 } // namespace czc::diag
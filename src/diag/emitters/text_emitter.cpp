@@ -19,6 +19,11 @@ void TextEmitter::emit(const Diagnostic &diag, const SourceLocator *locator) {
   *out_ << renderer_.renderDiagnostic(diag, locator);
 }
 
+void TextEmitter::emitBatch(std::span<const Diagnostic *const> diags,
+                            const SourceLocator *locator) {
+  *out_ << renderer_.renderBatch(diags, locator);
+}
+
 void TextEmitter::emitSummary(const DiagnosticStats &stats) {
   if (stats.errorCount == 0 && stats.warningCount == 0) {
     return;
@@ -26,6 +31,13 @@ void TextEmitter::emitSummary(const DiagnosticStats &stats) {
 
   *out_ << "\n";
 
+  // 按错误码限流的提示
+  for (const auto &[code, count] : stats.suppressedByCode) {
+    *out_ << renderer_.wrapColor("note", AnsiColor::BrightCyan) << ": "
+          << count << " more " << code.toString() << " diagnostic"
+          << (count > 1 ? "s" : "") << " suppressed\n";
+  }
+
   // 输出错误统计
   if (stats.errorCount > 0) {
     std::string errorMsg;
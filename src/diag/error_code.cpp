@@ -8,6 +8,8 @@
 
 #include "czc/diag/error_code.hpp"
 
+#include <algorithm>
+#include <array>
 #include <format>
 
 namespace czc::diag {
@@ -21,13 +23,123 @@ auto ErrorRegistry::instance() -> ErrorRegistry & {
   return registry;
 }
 
+// ============================================================================
+// 编译期内置错误表
+// ============================================================================
+
+namespace {
+
+/// 分类下标上限（ErrorCategory 取值从 1 开始）
+constexpr size_t kCategoryCount = 6;
+
+/// 各模块 .def 列表按声明顺序展开
+constexpr ErrorEntry kDeclaredErrors[] = {
+#define CZC_ERROR(NAME, CAT, CODE, BRIEF, KEY)                                 \
+  ErrorEntry{ErrorCode(ErrorCategory::CAT, CODE), BRIEF, KEY},
+#include "czc/diag/error_codes.def"
+#undef CZC_ERROR
+};
+
+/// 按错误码排序的内置错误表
+constexpr auto kBuiltinErrors = [] {
+  std::array<ErrorEntry, std::size(kDeclaredErrors)> sorted{};
+  std::ranges::copy(kDeclaredErrors, sorted.begin());
+  std::ranges::sort(sorted, {}, &ErrorEntry::code);
+  return sorted;
+}();
+
+static_assert(std::ranges::adjacent_find(kBuiltinErrors, {},
+                                         &ErrorEntry::code) ==
+                  kBuiltinErrors.end(),
+              "duplicate error code in .def lists");
+
+/// 单个分类在槽位表中的区间
+struct CategoryRange {
+  uint16_t base{0};   ///< 该分类的最小错误编号
+  uint16_t size{0};   ///< 编号跨度（最大 - 最小 + 1）
+  uint16_t offset{0}; ///< 在槽位表中的起始下标
+};
+
+constexpr auto kCategoryRanges = [] {
+  std::array<CategoryRange, kCategoryCount> ranges{};
+  uint16_t offset = 0;
+  for (size_t cat = 0; cat < kCategoryCount; ++cat) {
+    uint16_t lo = UINT16_MAX;
+    uint16_t hi = 0;
+    for (const auto &entry : kBuiltinErrors) {
+      if (static_cast<size_t>(entry.code.category) == cat) {
+        lo = std::min(lo, entry.code.code);
+        hi = std::max(hi, entry.code.code);
+      }
+    }
+    if (lo <= hi) {
+      auto size = static_cast<uint16_t>(hi - lo + 1);
+      ranges[cat] = {lo, size, offset};
+      offset = static_cast<uint16_t>(offset + size);
+    }
+  }
+  return ranges;
+}();
+
+constexpr size_t kSlotCount = [] {
+  size_t total = 0;
+  for (const auto &range : kCategoryRanges) {
+    total += range.size;
+  }
+  return total;
+}();
+
+/// 槽位表：编号 -> kBuiltinErrors 下标，-1 表示空位
+constexpr auto kSlots = [] {
+  std::array<int16_t, kSlotCount> slots{};
+  slots.fill(-1);
+  for (size_t i = 0; i < kBuiltinErrors.size(); ++i) {
+    const auto &code = kBuiltinErrors[i].code;
+    const auto &range = kCategoryRanges[static_cast<size_t>(code.category)];
+    slots[range.offset + (code.code - range.base)] = static_cast<int16_t>(i);
+  }
+  return slots;
+}();
+
+} // namespace
+
+auto ErrorRegistry::builtin(ErrorCode code) noexcept -> const ErrorEntry * {
+  auto cat = static_cast<size_t>(code.category);
+  if (cat >= kCategoryCount) {
+    return nullptr;
+  }
+  const auto &range = kCategoryRanges[cat];
+  // 无符号回绕使小于 base 的编号同样落在区间之外
+  auto index = static_cast<uint32_t>(code.code - range.base);
+  if (index >= range.size) {
+    return nullptr;
+  }
+  auto slot = kSlots[range.offset + index];
+  return slot < 0 ? nullptr : &kBuiltinErrors[static_cast<size_t>(slot)];
+}
+
+auto ErrorRegistry::builtinEntries() noexcept -> std::span<const ErrorEntry> {
+  return kBuiltinErrors;
+}
+
+// ============================================================================
+// 运行时注册（插件）
+// ============================================================================
+
 void ErrorRegistry::registerError(ErrorCode code, std::string_view brief,
                                   std::string_view explanationKey) {
   std::unique_lock lock(mutex_);
   entries_[code] = ErrorEntry{code, brief, explanationKey};
+  hasDynamic_.store(true, std::memory_order_release);
 }
 
 auto ErrorRegistry::lookup(ErrorCode code) const -> std::optional<ErrorEntry> {
+  if (const auto *entry = builtin(code)) {
+    return *entry;
+  }
+  if (!hasDynamic_.load(std::memory_order_acquire)) {
+    return std::nullopt;
+  }
   std::shared_lock lock(mutex_);
   auto it = entries_.find(code);
   if (it != entries_.end()) {
@@ -37,18 +149,25 @@ auto ErrorRegistry::lookup(ErrorCode code) const -> std::optional<ErrorEntry> {
 }
 
 auto ErrorRegistry::allCodes() const -> std::vector<ErrorCode> {
-  std::shared_lock lock(mutex_);
   std::vector<ErrorCode> codes;
-  codes.reserve(entries_.size());
-  for (const auto &[code, _] : entries_) {
-    codes.push_back(code);
+  codes.reserve(kBuiltinErrors.size());
+  for (const auto &entry : kBuiltinErrors) {
+    codes.push_back(entry.code);
+  }
+  if (hasDynamic_.load(std::memory_order_acquire)) {
+    std::shared_lock lock(mutex_);
+    for (const auto &[code, _] : entries_) {
+      if (builtin(code) == nullptr) {
+        codes.push_back(code);
+      }
+    }
+    std::ranges::sort(codes);
   }
   return codes;
 }
 
 auto ErrorRegistry::isRegistered(ErrorCode code) const -> bool {
-  std::shared_lock lock(mutex_);
-  return entries_.contains(code);
+  return lookup(code).has_value();
 }
 
 } // namespace czc::diag
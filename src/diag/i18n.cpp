@@ -7,10 +7,14 @@
  */
 
 #include "czc/diag/i18n.hpp"
+#include "czc/diag/i18n_catalog.hpp"
 
 #include <toml++/toml.hpp>
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
+#include <map>
 #include <sstream>
 
 namespace czc::diag::i18n {
@@ -48,23 +52,53 @@ auto parseLocale(std::string_view str) -> Locale {
   return Locale::En;
 }
 
+/// 运行时覆盖表：按键排序的扁平条目，加载时即编译模板
+struct Translator::OverrideTable {
+  struct Entry {
+    std::string key;
+    std::string value;
+    std::vector<TemplateSegment> segments;
+  };
+  std::vector<Entry> entries;
+
+  [[nodiscard]] auto find(std::string_view key) const noexcept
+      -> MessageTemplate {
+    auto it = std::lower_bound(
+        entries.begin(), entries.end(), key,
+        [](const Entry &entry, std::string_view k) { return entry.key < k; });
+    if (it != entries.end() && it->key == key) {
+      return {it->value, it->segments};
+    }
+    return {};
+  }
+};
+
+auto Translator::nextGeneration() noexcept -> uint64_t {
+  // 从 1 开始，0 可供缓存方表示"尚未填充"
+  static std::atomic<uint64_t> counter{0};
+  return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 Translator::Translator() = default;
 
-// 拷贝构造函数
+// 拷贝构造函数（共享已发布的不可变覆盖表）
 Translator::Translator(const Translator &other) {
   std::lock_guard lock(other.mutex_);
-  locale_ = other.locale_;
-  translations_ = other.translations_;
-  fallback_ = other.fallback_;
+  locale_.store(other.currentLocale(), std::memory_order_relaxed);
+  retained_ = other.retained_;
+  overrides_.store(other.overrides_.load(std::memory_order_acquire),
+                   std::memory_order_release);
 }
 
 // 拷贝赋值运算符
 auto Translator::operator=(const Translator &other) -> Translator & {
   if (this != &other) {
     std::scoped_lock lock(mutex_, other.mutex_);
-    locale_ = other.locale_;
-    translations_ = other.translations_;
-    fallback_ = other.fallback_;
+    locale_.store(other.currentLocale(), std::memory_order_relaxed);
+    retained_ = other.retained_;
+    overrides_.store(other.overrides_.load(std::memory_order_acquire),
+                     std::memory_order_release);
+    generation_.store(nextGeneration(), std::memory_order_release);
   }
   return *this;
 }
@@ -72,28 +106,38 @@ auto Translator::operator=(const Translator &other) -> Translator & {
 // 移动构造函数
 Translator::Translator(Translator &&other) noexcept {
   std::lock_guard lock(other.mutex_);
-  locale_ = other.locale_;
-  translations_ = std::move(other.translations_);
-  fallback_ = std::move(other.fallback_);
+  locale_.store(other.currentLocale(), std::memory_order_relaxed);
+  retained_ = std::move(other.retained_);
+  overrides_.store(other.overrides_.exchange(nullptr),
+                   std::memory_order_release);
 }
 
 // 移动赋值运算符
 auto Translator::operator=(Translator &&other) noexcept -> Translator & {
   if (this != &other) {
     std::scoped_lock lock(mutex_, other.mutex_);
-    locale_ = other.locale_;
-    translations_ = std::move(other.translations_);
-    fallback_ = std::move(other.fallback_);
+    locale_.store(other.currentLocale(), std::memory_order_relaxed);
+    retained_ = std::move(other.retained_);
+    overrides_.store(other.overrides_.exchange(nullptr),
+                     std::memory_order_release);
+    generation_.store(nextGeneration(), std::memory_order_release);
+    other.generation_.store(nextGeneration(), std::memory_order_release);
   }
   return *this;
 }
 
 void Translator::setLocale(Locale locale) {
-  std::lock_guard lock(mutex_);
-  locale_ = locale;
+  locale_.store(locale, std::memory_order_relaxed);
+  generation_.store(nextGeneration(), std::memory_order_release);
+}
+
+auto Translator::currentLocale() const noexcept -> Locale {
+  return locale_.load(std::memory_order_relaxed);
 }
 
-auto Translator::currentLocale() const noexcept -> Locale { return locale_; }
+auto Translator::generation() const noexcept -> uint64_t {
+  return generation_.load(std::memory_order_acquire);
+}
 
 auto Translator::loadFromFile(const std::filesystem::path &path) -> bool {
   std::ifstream file(path);
@@ -108,7 +152,7 @@ auto Translator::loadFromFile(const std::filesystem::path &path) -> bool {
 }
 
 void Translator::loadFromMemory(std::string_view toml) {
-  std::lock_guard lock(mutex_);
+  std::map<std::string, std::string, std::less<>> merged;
 
   try {
     auto result = toml::parse(toml);
@@ -122,7 +166,7 @@ void Translator::loadFromMemory(std::string_view toml) {
                                   : prefix + "." + std::string(key.str());
 
         if (value.is_string()) {
-          translations_[fullKey] = std::string(value.as_string()->get());
+          merged[fullKey] = std::string(value.as_string()->get());
         } else if (value.is_table()) {
           parseTable(*value.as_table(), fullKey);
         }
@@ -132,22 +176,73 @@ void Translator::loadFromMemory(std::string_view toml) {
     parseTable(result, "");
   } catch (const toml::parse_error &) {
     // 解析失败，忽略
+    return;
+  }
+
+  std::lock_guard lock(mutex_);
+
+  // 与当前覆盖层合并（新加载的键优先），发布为一张新表
+  if (const auto *current = overrides_.load(std::memory_order_relaxed)) {
+    for (const auto &entry : current->entries) {
+      merged.try_emplace(entry.key, entry.value);
+    }
+  }
+  auto table = std::make_shared<OverrideTable>();
+  table->entries.reserve(merged.size());
+  for (auto &node : merged) {
+    auto segments = compileTemplate(node.second);
+    table->entries.push_back(
+        {node.first, std::move(node.second), std::move(segments)});
+  }
+
+  retained_.push_back(table);
+  overrides_.store(table.get(), std::memory_order_seq_cst);
+  generation_.store(nextGeneration(), std::memory_order_release);
+
+  // 没有进行中的查找时，之后的查找只会看到新表：释放上一张之前的表。
+  // 与 getTemplate() 中的计数均为 seq_cst，读到 0 即保证这一点
+  if (retained_.size() > kRetainedTables &&
+      readers_.load(std::memory_order_seq_cst) == 0) {
+    retained_.erase(retained_.begin(), retained_.end() - kRetainedTables);
   }
 }
 
-auto Translator::get(std::string_view key) const -> std::string_view {
+auto Translator::retainedTables() const -> size_t {
   std::lock_guard lock(mutex_);
+  return retained_.size();
+}
+
+auto Translator::get(std::string_view key) const -> std::string_view {
+  return getTemplate(key).text();
+}
+
+auto Translator::getTemplate(std::string_view key) const -> MessageTemplate {
+  // 运行时覆盖层优先；计数期间加载覆盖层不会释放正在查找的表
+  readers_.fetch_add(1, std::memory_order_seq_cst);
+  MessageTemplate overridden;
+  if (const auto *table = overrides_.load(std::memory_order_seq_cst)) {
+    overridden = table->find(key);
+  }
+  readers_.fetch_sub(1, std::memory_order_release);
+  if (!overridden.empty()) {
+    return overridden;
+  }
 
-  // 先查找当前语言
-  auto it = translations_.find(std::string(key));
-  if (it != translations_.end()) {
-    return it->second;
+  // 当前语言的内置目录
+  auto locale = currentLocale();
+  if (const auto *catalog = builtinCatalog(locale)) {
+    if (const auto *entry = catalog->findEntry(key)) {
+      return entry->asTemplate();
+    }
   }
 
   // 回退到英文
-  it = fallback_.find(std::string(key));
-  if (it != fallback_.end()) {
-    return it->second;
+  if (locale != Locale::En) {
+    if (const auto *catalog = builtinCatalog(Locale::En)) {
+      if (const auto *entry = catalog->findEntry(key)) {
+        return entry->asTemplate();
+      }
+    }
   }
 
   return {};
@@ -178,25 +273,6 @@ auto Translator::getErrorExplanation(ErrorCode code) const -> Message {
   return Message("");
 }
 
-auto Translator::formatPlaceholders(
-    std::string_view tmpl, std::initializer_list<std::string> args) const
-    -> std::string {
-  std::string result(tmpl);
-  size_t index = 0;
-
-  for (const auto &arg : args) {
-    std::string placeholder = "{" + std::to_string(index) + "}";
-    size_t pos = 0;
-    while ((pos = result.find(placeholder, pos)) != std::string::npos) {
-      result.replace(pos, placeholder.length(), arg);
-      pos += arg.length();
-    }
-    ++index;
-  }
-
-  return result;
-}
-
 // ============================================================================
 // TranslationScope 实现
 // ============================================================================
@@ -12,6 +12,7 @@
 #include "czc/diag/message.hpp"
 #include "czc/diag/emitters/ansi_renderer.hpp"
 #include "czc/diag/i18n.hpp"
+#include "czc/diag/render_cache.hpp"
 
 #include <cmark.h>
 
@@ -48,6 +49,18 @@ auto Message::operator=(Message &&other) noexcept -> Message & {
   return *this;
 }
 
+auto Message::fromStatic(std::string_view markdown) -> Message {
+  Message message;
+  message.markdown_ = DiagString::borrowed(markdown);
+  return message;
+}
+
+auto Message::interned(std::string_view markdown) -> Message {
+  Message message;
+  message.markdown_ = DiagString::interned(markdown);
+  return message;
+}
+
 auto Message::markdown() const noexcept -> std::string_view {
   return markdown_;
 }
@@ -87,20 +100,13 @@ void extractPlainText(cmark_node *node, std::string &out) {
     out += '\n';
   }
 }
-} // namespace
-
-auto Message::renderPlainText() const -> std::string {
-  if (cachedPlain_) {
-    return *cachedPlain_;
-  }
-
-  // 使用 cmark 解析
-  cmark_node *doc = cmark_parse_document(markdown_.data(), markdown_.size(),
-                                         CMARK_OPT_DEFAULT);
+/// 使用 cmark 渲染纯文本
+auto renderPlainWithCmark(std::string_view markdown) -> std::string {
+  cmark_node *doc =
+      cmark_parse_document(markdown.data(), markdown.size(), CMARK_OPT_DEFAULT);
 
   if (doc == nullptr) {
-    cachedPlain_ = markdown_;
-    return *cachedPlain_;
+    return std::string(markdown);
   }
 
   std::string result;
@@ -111,17 +117,16 @@ auto Message::renderPlainText() const -> std::string {
   while (!result.empty() && result.back() == '\n') {
     result.pop_back();
   }
-
-  cachedPlain_ = std::move(result);
-  return *cachedPlain_;
+  return result;
 }
 
-auto Message::renderHtml() const -> std::string {
-  cmark_node *doc = cmark_parse_document(markdown_.data(), markdown_.size(),
-                                         CMARK_OPT_DEFAULT);
+/// 使用 cmark 渲染 HTML
+auto renderHtmlWithCmark(std::string_view markdown) -> std::string {
+  cmark_node *doc =
+      cmark_parse_document(markdown.data(), markdown.size(), CMARK_OPT_DEFAULT);
 
   if (doc == nullptr) {
-    return markdown_;
+    return std::string(markdown);
   }
 
   char *rendered = cmark_render_html(doc, CMARK_OPT_DEFAULT);
@@ -133,7 +138,59 @@ auto Message::renderHtml() const -> std::string {
     return result;
   }
 
-  return markdown_;
+  return std::string(markdown);
+}
+
+/// 无 Markdown 语法文本的 HTML：单个段落，转义与 cmark 一致
+auto renderHtmlParagraph(std::string_view text) -> std::string {
+  if (text.empty()) {
+    return "";
+  }
+
+  std::string result;
+  result.reserve(text.size() + 8);
+  result += "<p>";
+  for (char c : text) {
+    switch (c) {
+    case '"':
+      result += "&quot;";
+      break;
+    case '>':
+      result += "&gt;";
+      break;
+    default:
+      // '<' 与 '&' 已由 needsMarkdown 排除
+      result += c;
+      break;
+    }
+  }
+  result += "</p>\n";
+  return result;
+}
+
+} // namespace
+
+auto Message::renderPlainText() const -> std::string {
+  if (cachedPlain_) {
+    return *cachedPlain_;
+  }
+
+  // 快速路径：不含 Markdown 语法时纯文本即原文
+  if (!needsMarkdown(markdown_)) {
+    return markdown_.str();
+  }
+
+  cachedPlain_ = RenderCache::instance().getOrRender(
+      markdown_, RenderTarget::PlainText, 0, renderPlainWithCmark);
+  return *cachedPlain_;
+}
+
+auto Message::renderHtml() const -> std::string {
+  if (!needsMarkdown(markdown_)) {
+    return renderHtmlParagraph(markdown_);
+  }
+  return RenderCache::instance().getOrRender(markdown_, RenderTarget::Html, 0,
+                                             renderHtmlWithCmark);
 }
 
 auto Message::renderAnsi(const AnsiStyle &style) const -> std::string {
@@ -0,0 +1,55 @@
+/**
+ * @file message_template.cpp
+ * @brief 预编译消息模板实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/message_template.hpp"
+
+#include <charconv>
+
+namespace czc::diag::i18n {
+
+auto compileTemplate(std::string_view text) -> std::vector<TemplateSegment> {
+  std::vector<TemplateSegment> segments;
+  forEachSegment(text,
+                 [&](TemplateSegment segment) { segments.push_back(segment); });
+  return segments;
+}
+
+void MessageTemplate::formatTo(std::string &out,
+                               std::span<const std::string_view> args) const {
+  if (segments_.empty()) {
+    out.append(text_);
+    return;
+  }
+
+  size_t estimate = text_.size();
+  for (auto arg : args) {
+    estimate += arg.size();
+  }
+  out.reserve(out.size() + estimate);
+
+  for (const auto &segment : segments_) {
+    out.append(text_.substr(segment.offset, segment.length));
+    if (segment.arg == kNoArg) {
+      continue;
+    }
+    auto index = static_cast<size_t>(segment.arg);
+    if (index < args.size()) {
+      out.append(args[index]);
+    } else {
+      // 缺少对应参数时保留占位符
+      char buf[16];
+      auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), segment.arg);
+      (void)ec;
+      out.push_back('{');
+      out.append(buf, end);
+      out.push_back('}');
+    }
+  }
+}
+
+} // namespace czc::diag::i18n
@@ -0,0 +1,149 @@
+/**
+ * @file render_cache.cpp
+ * @brief 消息渲染快速路径与进程级渲染缓存实现。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/render_cache.hpp"
+
+#include <array>
+#include <mutex>
+
+namespace czc::diag {
+
+namespace {
+
+/// 会触发 cmark 行内语法或改变输出的字节
+constexpr auto kMarkdownBytes = [] {
+  std::array<bool, 256> table{};
+  // 控制字符（换行会产生段落/软换行，NUL 会被替换）
+  for (int c = 0; c < 0x20; ++c) {
+    table[c] = true;
+  }
+  // 非 ASCII：cmark 会替换非法 UTF-8 序列，保守起见走完整路径
+  for (int c = 0x80; c < 0x100; ++c) {
+    table[c] = true;
+  }
+  // 行内语法：代码、强调、链接/图片、转义、自动链接/HTML、实体
+  for (unsigned char c : std::string_view("`*_[\\<&")) {
+    table[c] = true;
+  }
+  return table;
+}();
+
+[[nodiscard]] constexpr auto isBlank(char c) noexcept -> bool {
+  return c == ' ' || c == '\t';
+}
+
+[[nodiscard]] constexpr auto isDigit(char c) noexcept -> bool {
+  return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+auto needsMarkdown(std::string_view text) noexcept -> bool {
+  if (text.empty()) {
+    return false;
+  }
+
+  // cmark 会裁剪段落首尾空白
+  if (isBlank(text.front()) || isBlank(text.back())) {
+    return true;
+  }
+
+  // 行首块结构：列表、Setext/ATX 标题、引用、分隔线、围栏代码块
+  switch (text.front()) {
+  case '~':
+  case '-':
+  case '+':
+  case '=':
+  case '#':
+  case '>':
+    return true;
+  default:
+    break;
+  }
+
+  // 有序列表：最多 9 位数字后跟 '.' 或 ')'
+  if (isDigit(text.front())) {
+    size_t i = 0;
+    while (i < text.size() && i < 10 && isDigit(text[i])) {
+      ++i;
+    }
+    if (i < text.size() && (text[i] == '.' || text[i] == ')')) {
+      return true;
+    }
+  }
+
+  for (char c : text) {
+    if (kMarkdownBytes[static_cast<unsigned char>(c)]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ============================================================================
+// RenderCache
+// ============================================================================
+
+auto RenderCache::instance() -> RenderCache & {
+  static RenderCache cache;
+  return cache;
+}
+
+auto RenderCache::KeyHash::operator()(const KeyView &key) const noexcept
+    -> size_t {
+  size_t hash = std::hash<std::string_view>{}(key.text);
+  hash ^= (static_cast<size_t>(key.target) + 0x9e3779b9 + (hash << 6) +
+           (hash >> 2));
+  hash ^= (std::hash<uint64_t>{}(key.style) + 0x9e3779b9 + (hash << 6) +
+           (hash >> 2));
+  return hash;
+}
+
+auto RenderCache::getOrRender(
+    std::string_view text, RenderTarget target, uint64_t style,
+    const std::function<std::string(std::string_view)> &render)
+    -> std::string {
+  if (text.size() > kMaxTextLength) {
+    return render(text);
+  }
+
+  KeyView key{text, target, style};
+  {
+    std::shared_lock lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return it->second;
+    }
+  }
+
+  // 锁外渲染：cmark 解析可能较慢，并发未命中时重复渲染无害
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  std::string rendered = render(text);
+
+  std::unique_lock lock(mutex_);
+  if (entries_.size() >= kMaxEntries) {
+    entries_.clear();
+  }
+  entries_.try_emplace(Key{std::string(text), target, style}, rendered);
+  return rendered;
+}
+
+auto RenderCache::size() const -> size_t {
+  std::shared_lock lock(mutex_);
+  return entries_.size();
+}
+
+void RenderCache::clear() {
+  std::unique_lock lock(mutex_);
+  entries_.clear();
+  hits_.store(0, std::memory_order_relaxed);
+  misses_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace czc::diag
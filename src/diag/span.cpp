@@ -10,21 +10,21 @@
 
 namespace czc::diag {
 
-void MultiSpan::addPrimary(Span span, std::string_view label) {
-  spans_.emplace_back(span, label, true);
+void MultiSpan::addPrimary(Span span, DiagString label) {
+  spans_.emplace_back(span, std::move(label), true);
 }
 
-void MultiSpan::addSecondary(Span span, std::string_view label) {
-  spans_.emplace_back(span, label, false);
+void MultiSpan::addSecondary(Span span, DiagString label) {
+  spans_.emplace_back(span, std::move(label), false);
 }
 
-auto MultiSpan::primary() const -> std::optional<LabeledSpan> {
+auto MultiSpan::primary() const noexcept -> const LabeledSpan * {
   for (const auto &ls : spans_) {
     if (ls.isPrimary) {
-      return ls;
+      return &ls;
     }
   }
-  return std::nullopt;
+  return nullptr;
 }
 
 auto MultiSpan::secondaries() const -> std::vector<LabeledSpan> {
@@ -13,6 +13,8 @@
 
 #include "czc/lexer/lexer.hpp"
 
+#include <algorithm>
+
 namespace czc::lexer {
 
 Lexer::Lexer(SourceManager &sm, BufferID buffer)
@@ -90,6 +92,21 @@ std::vector<Token> Lexer::tokenizeWithTrivia() {
   return tokens;
 }
 
+void Lexer::resumeAt(std::size_t offset) {
+  auto source = reader_.source();
+  offset = std::min(offset, source.size());
+
+  auto offset32 = static_cast<std::uint32_t>(offset);
+  auto line = sm_.getLineNumber(reader_.buffer(), offset32);
+
+  // 列号为行首到 offset 之间的码点数（1-based）
+  std::uint32_t column =
+      sm_.getColumnOnLine(reader_.buffer(), line, offset32,
+                          ColumnUnit::CodePoint) +
+      1;
+  reader_.seek(offset, line, column);
+}
+
 std::span<const LexerError> Lexer::errors() const noexcept {
   return errors_.errors();
 }
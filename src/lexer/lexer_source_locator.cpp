@@ -7,9 +7,14 @@
  */
 
 #include "czc/lexer/lexer_source_locator.hpp"
+#include "czc/diag/diag_buffer.hpp"
 #include "czc/diag/i18n.hpp"
 #include "czc/lexer/lexer_error_codes.hpp"
 
+#include <algorithm>
+#include <array>
+#include <iterator>
+
 namespace czc::lexer {
 
 LexerSourceLocator::LexerSourceLocator(const SourceManager &sm) : sm_(&sm) {}
@@ -23,25 +28,17 @@ auto LexerSourceLocator::getFilename(diag::Span span) const
 auto LexerSourceLocator::getLineColumn(uint32_t fileId, uint32_t offset) const
     -> diag::LineColumn {
   BufferID bid{fileId};
-  auto source = sm_->getSource(bid);
-
-  if (source.empty() || offset > source.size()) {
+  if (sm_->getSource(bid).empty()) {
     return {0, 0};
   }
 
-  uint32_t line = 1;
-  uint32_t column = 1;
-
-  for (uint32_t i = 0; i < offset && i < source.size(); ++i) {
-    if (source[i] == '\n') {
-      ++line;
-      column = 1;
-    } else {
-      ++column;
-    }
+  // 行偏移表二分查找，列号为行内字节偏移 + 1
+  uint32_t line = sm_->getLineNumber(bid, offset);
+  if (line == 0) {
+    return {0, 0};
   }
-
-  return {line, column};
+  auto lineStart = sm_->getLineStart(bid, line);
+  return {line, offset - lineStart.value_or(0) + 1};
 }
 
 auto LexerSourceLocator::getLineContent(uint32_t fileId, uint32_t line) const
@@ -50,12 +47,34 @@ auto LexerSourceLocator::getLineContent(uint32_t fileId, uint32_t line) const
   return sm_->getLineContent(bid, line);
 }
 
+void LexerSourceLocator::resolveSorted(uint32_t fileId,
+                                       std::span<const uint32_t> offsets,
+                                       std::span<diag::LineColumn> out) const {
+  BufferID bid{fileId};
+  auto sourceSize = sm_->getSource(bid).size();
+  auto starts = sm_->getLineStarts(bid);
+
+  // 行下标只前进不后退：总代价为 O(行数 + 偏移数)
+  size_t line = 0;
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    uint32_t offset = offsets[i];
+    if (sourceSize == 0 || offset > sourceSize) {
+      out[i] = {0, 0};
+      continue;
+    }
+    while (line + 1 < starts.size() && starts[line + 1] <= offset) {
+      ++line;
+    }
+    out[i] = {static_cast<uint32_t>(line + 1),
+              static_cast<uint32_t>(offset - starts[line] + 1)};
+  }
+}
+
 auto LexerSourceLocator::getSourceSlice(diag::Span span) const
     -> std::string_view {
+  // 直接返回 SourceManager 存储内的视图，长度不截断
   BufferID bid{span.fileId};
-  uint16_t length = static_cast<uint16_t>(
-      std::min(static_cast<uint32_t>(UINT16_MAX), span.length()));
-  return sm_->slice(bid, span.startOffset, length);
+  return sm_->slice(bid, span.startOffset, span.length());
 }
 
 // ============================================================================
@@ -71,97 +90,123 @@ auto toSpan(const LexerError &err) -> diag::Span {
 
 namespace {
 
-/// 根据错误码获取 i18n 键前缀
-auto getI18nKeyPrefix(LexerErrorCode code) -> std::string {
-  switch (code) {
-  case LexerErrorCode::MissingHexDigits:
-    return "lexer.missing_hex_digits";
-  case LexerErrorCode::MissingBinaryDigits:
-    return "lexer.missing_binary_digits";
-  case LexerErrorCode::MissingOctalDigits:
-    return "lexer.missing_octal_digits";
-  case LexerErrorCode::MissingExponentDigits:
-    return "lexer.missing_exponent_digits";
-  case LexerErrorCode::InvalidTrailingChar:
-    return "lexer.invalid_trailing_char";
-  case LexerErrorCode::InvalidNumberSuffix:
-    return "lexer.invalid_number_suffix";
-  case LexerErrorCode::InvalidEscapeSequence:
-    return "lexer.invalid_escape_sequence";
-  case LexerErrorCode::UnterminatedString:
-    return "lexer.unterminated_string";
-  case LexerErrorCode::InvalidHexEscape:
-    return "lexer.invalid_hex_escape";
-  case LexerErrorCode::InvalidUnicodeEscape:
-    return "lexer.invalid_unicode_escape";
-  case LexerErrorCode::UnterminatedRawString:
-    return "lexer.unterminated_raw_string";
-  case LexerErrorCode::InvalidCharacter:
-    return "lexer.invalid_character";
-  case LexerErrorCode::InvalidUtf8Sequence:
-    return "lexer.invalid_utf8_sequence";
-  case LexerErrorCode::UnterminatedBlockComment:
-    return "lexer.unterminated_block_comment";
-  case LexerErrorCode::TokenTooLong:
-    return "lexer.token_too_long";
-  default:
-    return "";
+/// 单个错误码在编译期确定的部分
+struct LexerErrorKeys {
+  uint16_t code;
+  std::string_view labelKey;
+  std::string_view helpKey;
+};
+
+/// 由 lexer_errors.def 展开，i18n 键在编译期拼接
+constexpr LexerErrorKeys kLexerErrorKeys[] = {
+#define CZC_ERROR(NAME, CAT, CODE, BRIEF, KEY)                                 \
+  {CODE, KEY ".label", KEY ".help"},
+#include "czc/lexer/lexer_errors.def"
+#undef CZC_ERROR
+};
+
+static_assert(std::is_sorted(std::begin(kLexerErrorKeys),
+                             std::end(kLexerErrorKeys),
+                             [](const auto &a, const auto &b) {
+                               return a.code < b.code;
+                             }),
+              "lexer_errors.def must list codes in ascending order");
+
+constexpr size_t kNoTemplate = SIZE_MAX;
+
+/// 错误码在 kLexerErrorKeys 中的下标，未知错误码返回 kNoTemplate
+constexpr auto templateIndex(LexerErrorCode code) noexcept -> size_t {
+  auto value = static_cast<uint16_t>(code);
+  const auto *it = std::lower_bound(
+      std::begin(kLexerErrorKeys), std::end(kLexerErrorKeys), value,
+      [](const LexerErrorKeys &keys, uint16_t c) { return keys.code < c; });
+  if (it == std::end(kLexerErrorKeys) || it->code != value) {
+    return kNoTemplate;
   }
+  return static_cast<size_t>(it - std::begin(kLexerErrorKeys));
 }
 
-} // namespace
+/// 按 Translator 状态解析好的标签与帮助文本（驻留存储，进程内有效）
+struct PreparedTemplates {
+  uint64_t generation{0}; ///< 0 表示尚未填充
+  std::array<std::string_view, std::size(kLexerErrorKeys)> labels{};
+  std::array<std::string_view, std::size(kLexerErrorKeys)> helps{};
+};
+
+/// 获取 translator 当前状态的模板（每线程缓存，状态代号变化时重建）
+auto preparedTemplates(const diag::i18n::Translator &translator)
+    -> const PreparedTemplates & {
+  thread_local PreparedTemplates cache;
+  auto generation = translator.generation();
+  if (cache.generation != generation) {
+    for (size_t i = 0; i < std::size(kLexerErrorKeys); ++i) {
+      // 驻留后诊断可借用文本，不依赖 Translator 的生命周期
+      auto &interner = diag::StringInterner::instance();
+      cache.labels[i] = interner.intern(
+          translator.get(kLexerErrorKeys[i].labelKey));
+      cache.helps[i] =
+          interner.intern(translator.get(kLexerErrorKeys[i].helpKey));
+    }
+    cache.generation = generation;
+  }
+  return cache;
+}
 
-auto toDiagnostic(const LexerError &err, const SourceManager & /*sm*/,
-                  const diag::i18n::Translator &translator)
+/// 按预备模板构造诊断
+auto makeDiagnostic(const LexerError &err, const PreparedTemplates &prepared)
     -> diag::Diagnostic {
-  // 从 LexerErrorCode 映射到 diag::ErrorCode
-  auto diagCode = diag::ErrorCode(diag::ErrorCategory::Lexer,
-                                  static_cast<uint16_t>(err.code));
-
   diag::Diagnostic diag(diag::Level::Error, diag::Message(err.formattedMessage),
-                        diagCode);
-
-  // 获取 i18n 键前缀
-  auto keyPrefix = getI18nKeyPrefix(err.code);
-
-  // 获取标签
-  std::string label;
-  if (!keyPrefix.empty()) {
-    auto labelKey = keyPrefix + ".label";
-    auto labelView = translator.get(labelKey);
-    if (!labelView.empty()) {
-      label = std::string(labelView);
-    }
+                        diag::ErrorCode(diag::ErrorCategory::Lexer,
+                                        static_cast<uint16_t>(err.code)));
+
+  auto index = templateIndex(err.code);
+  std::string_view label;
+  std::string_view help;
+  if (index != kNoTemplate) {
+    label = prepared.labels[index];
+    help = prepared.helps[index];
   }
 
-  // 添加位置信息（带标签）
-  diag.spans.addPrimary(toSpan(err), label);
-
-  // 获取帮助信息（如果有）
-  if (!keyPrefix.empty()) {
-    auto helpKey = keyPrefix + ".help";
-    auto helpView = translator.get(helpKey);
-    if (!helpView.empty()) {
-      diag.children.emplace_back(diag::Level::Help, std::string(helpView));
-    }
+  diag.spans.addPrimary(toSpan(err), diag::DiagString::borrowed(label));
+  if (!help.empty()) {
+    diag.children.emplace_back(diag::Level::Help,
+                               diag::DiagString::borrowed(help));
   }
-
   return diag;
 }
 
-void emitLexerErrors(diag::DiagContext &dcx, std::span<const LexerError> errors,
-                     const SourceManager &sm, BufferID /*bufferId*/) {
-  // 创建 SourceLocator 适配器
-  LexerSourceLocator locator(sm);
-  dcx.setLocator(&locator);
+} // namespace
 
-  // 获取 DiagContext 中的 Translator
-  const auto &translator = dcx.translator();
+auto toDiagnostic(const LexerError &err, const SourceManager & /*sm*/,
+                  const diag::i18n::Translator &translator)
+    -> diag::Diagnostic {
+  return makeDiagnostic(err, preparedTemplates(translator));
+}
 
-  // 发射所有错误
+void appendDiagnostics(diag::DiagBuffer &buffer,
+                       std::span<const LexerError> errors,
+                       const diag::i18n::Translator &translator) {
+  // 整批共享一次模板解析
+  const auto &prepared = preparedTemplates(translator);
+  buffer.reserve(buffer.size() + errors.size());
   for (const auto &err : errors) {
-    dcx.emit(toDiagnostic(err, sm, translator));
+    buffer.emit(makeDiagnostic(err, prepared));
   }
 }
 
+void emitLexerErrors(diag::DiagContext &dcx, std::span<const LexerError> errors,
+                     const diag::SourceLocator &locator) {
+  // 先在本地缓冲，再一次性合并发射
+  diag::DiagBuffer buffer(&locator);
+  appendDiagnostics(buffer, errors, dcx.translator());
+  dcx.merge(buffer);
+}
+
+void emitLexerErrors(diag::DiagContext &dcx, std::span<const LexerError> errors,
+                     const SourceManager &sm, BufferID /*bufferId*/) {
+  // 定位器只在本次合并期间使用，不写入 DiagContext（避免悬空指针）
+  LexerSourceLocator locator(sm);
+  emitLexerErrors(dcx, errors, locator);
+}
+
 } // namespace czc::lexer
@@ -7,36 +7,116 @@
  */
 
 #include "czc/lexer/source_manager.hpp"
+#include "czc/common/hash.hpp"
 #include "czc/lexer/token.hpp"
+#include "czc/lexer/utf8.hpp"
 
 #include <algorithm>
+#include <cstring>
 
 namespace czc::lexer {
 
-void SourceManager::Buffer::buildLineOffsets() const {
-  if (lineOffsetsBuilt) {
-    return;
+namespace {
+
+/// 按 8 字节一组检查区间是否只含 ASCII
+bool isAsciiRange(const char *p, std::size_t n) noexcept {
+  constexpr std::uint64_t kHighBits = 0x8080808080808080ULL;
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, p + i, sizeof(word));
+    if ((word & kHighBits) != 0) {
+      return false;
+    }
+  }
+  for (; i < n; ++i) {
+    if (static_cast<unsigned char>(p[i]) >= 0x80) {
+      return false;
+    }
   }
+  return true;
+}
+
+/// 字符（以首字节表示）占用的 UTF-16 码元数，与 utf8::utf16Length 一致
+constexpr std::uint32_t utf16Width(unsigned char lead) noexcept {
+  return lead >= 0xF0 ? 2 : 1;
+}
 
+} // namespace
+
+void SourceManager::Buffer::buildLineOffsets() {
   lineOffsets.clear();
   lineOffsets.push_back(0); // 第一行从偏移 0 开始
 
-  for (std::size_t i = 0; i < source.size(); ++i) {
-    if (source[i] == '\n') {
-      lineOffsets.push_back(i + 1); // 下一行从换行符后开始
-    }
+  // memchr 逐个跳到换行符，下一行从换行符后开始
+  const char *begin = source.data();
+  const char *end = begin + source.size();
+  const char *p = begin;
+  while (const void *nl =
+             std::memchr(p, '\n', static_cast<std::size_t>(end - p))) {
+    p = static_cast<const char *>(nl) + 1;
+    lineOffsets.push_back(static_cast<std::size_t>(p - begin));
+  }
+
+  buildColumnIndex();
+}
+
+void SourceManager::Buffer::buildColumnIndex() {
+  lineCheckpoints.clear();
+  checkpoints.clear();
+  if (isAsciiRange(source.data(), source.size())) {
+    return; // 全 ASCII：所有单位的列号都等于字节列号
   }
 
-  lineOffsetsBuilt = true;
+  lineCheckpoints.reserve(lineOffsets.size() + 1);
+  for (std::size_t line = 0; line < lineOffsets.size(); ++line) {
+    lineCheckpoints.push_back(static_cast<std::uint32_t>(checkpoints.size()));
+
+    std::size_t lineStart = lineOffsets[line];
+    std::size_t lineEnd = line + 1 < lineOffsets.size() ? lineOffsets[line + 1]
+                                                        : source.size();
+    if (isAsciiRange(source.data() + lineStart, lineEnd - lineStart)) {
+      continue;
+    }
+
+    // 行首总有检查点，之后每隔至少 kCheckpointStride 字节在字符起始处记录
+    checkpoints.push_back(ColumnCheckpoint{0, 0, 0});
+    std::uint32_t nextCheckpoint = kCheckpointStride;
+    std::uint32_t utf16 = 0;
+    std::uint32_t codePoint = 0;
+    for (std::size_t pos = lineStart; pos < lineEnd; ++pos) {
+      auto byte = static_cast<unsigned char>(source[pos]);
+      if (utf8::isContinuationByte(byte)) {
+        continue;
+      }
+      auto column = static_cast<std::uint32_t>(pos - lineStart);
+      if (column >= nextCheckpoint) {
+        checkpoints.push_back(ColumnCheckpoint{column, utf16, codePoint});
+        nextCheckpoint = column + kCheckpointStride;
+      }
+      utf16 += utf16Width(byte);
+      ++codePoint;
+    }
+  }
+  lineCheckpoints.push_back(static_cast<std::uint32_t>(checkpoints.size()));
 }
 
 BufferID SourceManager::addBuffer(std::string source, std::string filename) {
+  const auto hash = hashBytes(source);
+  return addBuffer(std::move(source), std::move(filename), hash);
+}
+
+BufferID SourceManager::addBuffer(std::string source, std::string filename,
+                                  std::uint64_t contentHash) {
   Buffer buffer;
   buffer.source = std::move(source);
   buffer.filename = std::move(filename);
+  buffer.contentHash = contentHash;
   buffer.isSynthetic = false;
   buffer.parentBuffer = std::nullopt;
+  buffer.buildLineOffsets();
 
+  sourceBytes_ += buffer.source.size();
   buffers_.push_back(std::move(buffer));
 
   // BufferID.value 从 1 开始，0 表示无效
@@ -56,7 +136,7 @@ std::string_view SourceManager::getSource(BufferID id) const {
 }
 
 std::string_view SourceManager::slice(BufferID id, std::uint32_t offset,
-                                      std::uint16_t length) const {
+                                      std::uint32_t length) const {
   if (!id.isValid() || id.value > buffers_.size()) {
     return {};
   }
@@ -81,6 +161,13 @@ std::string_view SourceManager::getFilename(BufferID id) const {
   return buffers_[id.value - 1].filename;
 }
 
+std::uint64_t SourceManager::contentHash(BufferID id) const noexcept {
+  if (!id.isValid() || id.value > buffers_.size()) {
+    return 0;
+  }
+  return buffers_[id.value - 1].contentHash;
+}
+
 std::string_view SourceManager::getLineContent(BufferID id,
                                                std::uint32_t lineNum) const {
   if (!id.isValid() || id.value > buffers_.size() || lineNum == 0) {
@@ -88,7 +175,6 @@ std::string_view SourceManager::getLineContent(BufferID id,
   }
 
   const auto &buffer = buffers_[id.value - 1];
-  buffer.buildLineOffsets();
 
   // lineNum 是 1-based
   std::size_t lineIndex = lineNum - 1;
@@ -119,15 +205,171 @@ std::string_view SourceManager::getLineContent(BufferID id,
                           lineEnd - lineStart);
 }
 
+std::uint32_t SourceManager::getLineNumber(BufferID id,
+                                          std::uint32_t offset) const {
+  if (!id.isValid() || id.value > buffers_.size()) {
+    return 0;
+  }
+
+  const auto &buffer = buffers_[id.value - 1];
+  if (offset > buffer.source.size()) {
+    return 0;
+  }
+
+  // 第一个起始偏移大于 offset 的行之前即为所在行
+  auto it = std::upper_bound(buffer.lineOffsets.begin(),
+                             buffer.lineOffsets.end(), offset);
+  return static_cast<std::uint32_t>(it - buffer.lineOffsets.begin());
+}
+
+std::optional<std::uint32_t>
+SourceManager::getLineStart(BufferID id, std::uint32_t lineNum) const {
+  if (!id.isValid() || id.value > buffers_.size() || lineNum == 0) {
+    return std::nullopt;
+  }
+
+  const auto &buffer = buffers_[id.value - 1];
+
+  if (lineNum > buffer.lineOffsets.size()) {
+    return std::nullopt;
+  }
+  return static_cast<std::uint32_t>(buffer.lineOffsets[lineNum - 1]);
+}
+
+std::span<const std::size_t> SourceManager::getLineStarts(BufferID id) const {
+  if (!id.isValid() || id.value > buffers_.size()) {
+    return {};
+  }
+
+  const auto &buffer = buffers_[id.value - 1];
+  return buffer.lineOffsets;
+}
+
+bool SourceManager::isAsciiLine(BufferID id, std::uint32_t lineNum) const {
+  if (!id.isValid() || id.value > buffers_.size() || lineNum == 0) {
+    return false;
+  }
+
+  const auto &buffer = buffers_[id.value - 1];
+  if (lineNum > buffer.lineOffsets.size()) {
+    return false;
+  }
+  return buffer.lineCheckpoints.empty() ||
+         buffer.lineCheckpoints[lineNum - 1] == buffer.lineCheckpoints[lineNum];
+}
+
+std::uint32_t SourceManager::getColumn(BufferID id, std::uint32_t offset,
+                                       ColumnUnit unit) const {
+  std::uint32_t lineNum = getLineNumber(id, offset);
+  if (lineNum == 0) {
+    return 0;
+  }
+  return getColumnOnLine(id, lineNum, offset, unit);
+}
+
+std::uint32_t SourceManager::getColumnOnLine(BufferID id,
+                                             std::uint32_t lineNum,
+                                             std::uint32_t offset,
+                                             ColumnUnit unit) const {
+  if (!id.isValid() || id.value > buffers_.size() || lineNum == 0) {
+    return 0;
+  }
+
+  const auto &buffer = buffers_[id.value - 1];
+  if (lineNum > buffer.lineOffsets.size() || offset > buffer.source.size()) {
+    return 0;
+  }
+  auto lineStart = static_cast<std::uint32_t>(buffer.lineOffsets[lineNum - 1]);
+  if (offset < lineStart) {
+    return 0;
+  }
+  std::uint32_t byteColumn = offset - lineStart;
+  if (unit == ColumnUnit::Byte || isAsciiLine(id, lineNum)) {
+    return byteColumn;
+  }
+
+  // 最后一个不超过目标的检查点，再向后扫描至多一个间隔
+  auto first = buffer.checkpoints.begin() + buffer.lineCheckpoints[lineNum - 1];
+  auto last = buffer.checkpoints.begin() + buffer.lineCheckpoints[lineNum];
+  auto it = std::upper_bound(first, last, byteColumn,
+                             [](std::uint32_t column, const auto &checkpoint) {
+                               return column < checkpoint.byte;
+                             }) -
+            1;
+
+  std::uint32_t utf16 = it->utf16;
+  std::uint32_t codePoint = it->codePoint;
+  for (std::uint32_t pos = lineStart + it->byte; pos < offset; ++pos) {
+    auto byte = static_cast<unsigned char>(buffer.source[pos]);
+    if (!utf8::isContinuationByte(byte)) {
+      utf16 += utf16Width(byte);
+      ++codePoint;
+    }
+  }
+  return unit == ColumnUnit::Utf16 ? utf16 : codePoint;
+}
+
+std::optional<std::uint32_t> SourceManager::getOffset(BufferID id,
+                                                      std::uint32_t lineNum,
+                                                      std::uint32_t column,
+                                                      ColumnUnit unit) const {
+  auto lineStart = getLineStart(id, lineNum);
+  if (!lineStart.has_value()) {
+    return std::nullopt;
+  }
+  auto content = getLineContent(id, lineNum);
+  auto length = static_cast<std::uint32_t>(content.size());
+  if (unit == ColumnUnit::Byte || isAsciiLine(id, lineNum)) {
+    return *lineStart + std::min(column, length);
+  }
+
+  const auto &buffer = buffers_[id.value - 1];
+  auto first = buffer.checkpoints.begin() + buffer.lineCheckpoints[lineNum - 1];
+  auto last = buffer.checkpoints.begin() + buffer.lineCheckpoints[lineNum];
+  auto unitsAt = [unit](const ColumnCheckpoint &checkpoint) {
+    return unit == ColumnUnit::Utf16 ? checkpoint.utf16 : checkpoint.codePoint;
+  };
+  auto it = std::upper_bound(first, last, column,
+                             [&](std::uint32_t target, const auto &checkpoint) {
+                               return target < unitsAt(checkpoint);
+                             }) -
+            1;
+
+  // 检查点可能落在行尾换行符上，此时目标必然越过行尾
+  std::uint32_t pos = std::min(it->byte, length);
+  std::uint32_t units = unitsAt(*it);
+  while (pos < length) {
+    auto byte = static_cast<unsigned char>(content[pos]);
+    if (!utf8::isContinuationByte(byte)) {
+      std::uint32_t width =
+          unit == ColumnUnit::Utf16 ? utf16Width(byte) : 1;
+      if (units + width > column) {
+        break;
+      }
+      units += width;
+    }
+    // 越过整个字符（含其后续字节）
+    ++pos;
+    while (pos < length && utf8::isContinuationByte(
+                               static_cast<unsigned char>(content[pos]))) {
+      ++pos;
+    }
+  }
+  return *lineStart + pos;
+}
+
 BufferID SourceManager::addSyntheticBuffer(std::string source,
                                            std::string syntheticName,
                                            BufferID parentBuffer) {
   Buffer buffer;
   buffer.source = std::move(source);
   buffer.filename = std::move(syntheticName);
+  buffer.contentHash = hashBytes(buffer.source);
   buffer.isSynthetic = true;
   buffer.parentBuffer = parentBuffer;
+  buffer.buildLineOffsets();
 
+  sourceBytes_ += buffer.source.size();
   buffers_.push_back(std::move(buffer));
   return BufferID{static_cast<std::uint32_t>(buffers_.size())};
 }
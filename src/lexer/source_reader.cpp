@@ -9,6 +9,8 @@
 #include "czc/lexer/source_reader.hpp"
 #include "czc/lexer/utf8.hpp"
 
+#include <algorithm>
+
 namespace czc::lexer {
 
 SourceReader::SourceReader(SourceManager &sm, BufferID buffer)
@@ -71,6 +73,13 @@ void SourceReader::advance(std::size_t count) {
   }
 }
 
+void SourceReader::seek(std::size_t offset, std::uint32_t line,
+                        std::uint32_t column) noexcept {
+  position_ = std::min(offset, source_.size());
+  line_ = line;
+  column_ = column;
+}
+
 SourceLocation SourceReader::location() const noexcept {
   return SourceLocation{buffer_, line_, column_,
                         static_cast<std::uint32_t>(position_)};
@@ -84,6 +84,37 @@ std::optional<std::size_t> charCount(std::string_view str) noexcept {
   return count;
 }
 
+std::size_t utf16Length(std::string_view str) noexcept {
+  std::size_t units = 0;
+  for (char ch : str) {
+    auto byte = static_cast<unsigned char>(ch);
+    if (!isContinuationByte(byte)) {
+      units += byte >= 0xF0 ? 2 : 1;
+    }
+  }
+  return units;
+}
+
+std::size_t utf16ToByteOffset(std::string_view str,
+                              std::size_t units) noexcept {
+  std::size_t pos = 0;
+  while (pos < str.size()) {
+    auto byte = static_cast<unsigned char>(str[pos]);
+    std::size_t width = byte >= 0xF0 ? 2 : 1;
+    if (units < width) {
+      break;
+    }
+    units -= width;
+    // 跳过首字节及其后的续字节
+    ++pos;
+    while (pos < str.size() &&
+           isContinuationByte(static_cast<unsigned char>(str[pos]))) {
+      ++pos;
+    }
+  }
+  return pos;
+}
+
 bool readChar(std::string_view str, std::size_t &pos, std::string &dest) {
   if (pos >= str.size()) {
     return false;
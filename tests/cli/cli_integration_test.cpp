@@ -217,6 +217,27 @@ let x = 1;
   EXPECT_NE(result, 0);
 }
 
+TEST_F(CliIntegrationTest, DiagnosticsJsonCopy) {
+  auto inputPath = createTestFile("diag.zero", "let s = \"unterminated\n");
+  auto diagPath = testDir_ / "diag.json";
+
+  {
+    Cli cli;
+    makeArgs({"czc", "--async-diagnostics", "--diagnostics-json",
+              diagPath.string(), "lex", inputPath.string()});
+
+    int result = cli.run(getArgc(), getArgv());
+    EXPECT_NE(result, 0);
+  }
+
+  // Cli 析构后异步发射器已写出全部诊断
+  std::ifstream ifs(diagPath);
+  std::string content((std::istreambuf_iterator<char>(ifs)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_EQ(content.rfind(R"({"diagnostics":[)", 0), 0u);
+  EXPECT_NE(content.find(R"("level":"error")"), std::string::npos);
+}
+
 // ============================================================================
 // 输出文件测试
 // ============================================================================
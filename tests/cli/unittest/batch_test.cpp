@@ -0,0 +1,230 @@
+/**
+ * @file batch_test.cpp
+ * @brief 批量词法分析单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/batch/batch_lexer.hpp"
+#include "czc/cli/driver.hpp"
+#include "czc/common/json_reader.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace czc::cli {
+namespace {
+
+namespace fs = std::filesystem;
+
+class BatchLexerTest : public ::testing::Test {
+protected:
+  fs::path testDir_;
+
+  void SetUp() override {
+    testDir_ = fs::temp_directory_path() / "czc_batch_test";
+    fs::remove_all(testDir_);
+    fs::create_directories(testDir_);
+  }
+
+  void TearDown() override { fs::remove_all(testDir_); }
+
+  fs::path createFile(const fs::path &relative, std::string_view content) {
+    auto path = testDir_ / relative;
+    fs::create_directories(path.parent_path());
+    std::ofstream ofs(path);
+    ofs << content;
+    return path;
+  }
+
+  static std::string readFile(const fs::path &path) {
+    std::ifstream ifs(path);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+  }
+
+  /// 生成大小不一的输入，调度顺序因此与输入顺序不同
+  std::vector<std::string> createProject(std::size_t count) {
+    std::vector<std::string> args;
+    for (std::size_t i = 0; i < count; ++i) {
+      std::string source;
+      for (std::size_t line = 0; line < (i * 7) % 23 + 1; ++line) {
+        source += "let v" + std::to_string(line) + " = " +
+                  std::to_string(i) + ";\n";
+      }
+      args.push_back(
+          createFile("f" + std::to_string(i) + ".zero", source).string());
+    }
+    return args;
+  }
+};
+
+TEST_F(BatchLexerTest, ExpandsDirectoriesWithFilters) {
+  createFile("src/b.zero", "b");
+  createFile("src/a.zero", "a");
+  createFile("src/notes.txt", "x");
+  createFile("src/gen/c.zero", "c");
+  createFile("src/build/d.zero", "d");
+
+  BatchInputOptions options;
+  options.exclude = {"build"};
+  std::vector<std::string> args{(testDir_ / "src").string()};
+  auto inputs = collectBatchInputs(args, options);
+  ASSERT_TRUE(inputs.has_value()) << inputs.error().message;
+
+  ASSERT_EQ(inputs->size(), 3u);
+  EXPECT_EQ((*inputs)[0].path.filename(), "a.zero");
+  EXPECT_EQ((*inputs)[1].path.filename(), "b.zero");
+  EXPECT_EQ((*inputs)[2].outputName, fs::path("gen/c.zero"));
+  EXPECT_EQ((*inputs)[0].size, 1u);
+}
+
+TEST_F(BatchLexerTest, ReadsNestedResponseFiles) {
+  auto a = createFile("a.zero", "a");
+  auto b = createFile("b.zero", "b");
+  auto inner = createFile("inner.rsp", b.string() + "\n" + a.string() + "\n");
+  auto outer = createFile("outer.rsp", "# sources\n\n  " + a.string() +
+                                           "  \r\n@" + inner.string() + "\n");
+
+  std::vector<std::string> args{"@" + outer.string()};
+  auto inputs = collectBatchInputs(args);
+  ASSERT_TRUE(inputs.has_value()) << inputs.error().message;
+
+  // 重复的 a.zero 只保留第一次
+  ASSERT_EQ(inputs->size(), 2u);
+  EXPECT_EQ((*inputs)[0].path, a);
+  EXPECT_EQ((*inputs)[1].path, b);
+}
+
+TEST_F(BatchLexerTest, ReportsMissingInputs) {
+  std::vector<std::string> missing{(testDir_ / "none.zero").string()};
+  auto inputs = collectBatchInputs(missing);
+  ASSERT_FALSE(inputs.has_value());
+  EXPECT_EQ(inputs.error().code, "E001");
+
+  std::vector<std::string> response{"@" + (testDir_ / "none.rsp").string()};
+  inputs = collectBatchInputs(response);
+  ASSERT_FALSE(inputs.has_value());
+  EXPECT_EQ(inputs.error().code, "E003");
+
+  // 自引用的响应文件在嵌套上限处停止
+  auto self = testDir_ / "self.rsp";
+  createFile("self.rsp", "@" + self.string() + "\n");
+  std::vector<std::string> loop{"@" + self.string()};
+  inputs = collectBatchInputs(loop);
+  ASSERT_FALSE(inputs.has_value());
+  EXPECT_EQ(inputs.error().code, "E008");
+}
+
+TEST_F(BatchLexerTest, ParallelResultsMatchSequentialInInputOrder) {
+  auto args = createProject(40);
+  args.push_back(createFile("bad.zero", "let s = \"open").string());
+  auto inputs = collectBatchInputs(args);
+  ASSERT_TRUE(inputs.has_value());
+
+  CompilerContext ctx;
+  ctx.global().colorDiagnostics = false;
+  auto collect = [&](SchedulerOptions options, BatchSummary &summary) {
+    std::vector<std::string> records;
+    TaskScheduler scheduler(options);
+    BatchLexer batch(ctx, {});
+    summary = batch.run(*inputs, scheduler, [&](const BatchInput &input,
+                                                BatchFileResult &result) {
+      std::string record;
+      {
+        StringSink sink(record);
+        BatchLexer::writeRecord(sink, input, result);
+      }
+      records.push_back(record + result.diagnostics);
+    });
+    return records;
+  };
+
+  BatchSummary sequential;
+  BatchSummary parallel;
+  auto expected = collect({.deterministic = true}, sequential);
+  EXPECT_EQ(collect({.threads = 4}, parallel), expected);
+
+  EXPECT_EQ(parallel.files, 41u);
+  EXPECT_EQ(parallel.failed, 1u);
+  EXPECT_EQ(parallel.tokens, sequential.tokens);
+
+  auto record = parseJson(expected.front().substr(
+      0, expected.front().find('\n')));
+  ASSERT_TRUE(record.has_value());
+  EXPECT_EQ((*record)["exitCode"].asInt(), 0);
+  EXPECT_TRUE((*record)["result"]["success"].asBool());
+
+  // 失败文件没有结果，但带有诊断
+  const auto &bad = expected.back();
+  EXPECT_NE(bad.find(R"("exitCode":1)"), std::string::npos);
+  EXPECT_NE(bad.find(R"("result":null)"), std::string::npos);
+  EXPECT_NE(bad.find("error"), std::string::npos);
+}
+
+TEST_F(BatchLexerTest, WritesPerFileOutputs) {
+  createFile("proj/main.zero", "let x = 1;");
+  createFile("proj/lib/util.zero", "let y = 2;");
+  std::vector<std::string> args{(testDir_ / "proj").string()};
+  auto inputs = collectBatchInputs(args);
+  ASSERT_TRUE(inputs.has_value());
+  ASSERT_TRUE(BatchLexer::checkOutputNames(*inputs).has_value());
+
+  Driver driver;
+  driver.setQuiet(true);
+  driver.setOutputFormat(OutputFormat::Json);
+  std::ostringstream errors;
+  driver.setErrorStream(errors);
+  driver.context().lexer().jobs = 2;
+  auto outDir = testDir_ / "out";
+  EXPECT_EQ(driver.runLexerBatch(*inputs, {.outputDir = outDir}), 0);
+
+  auto util = parseJson(readFile(outDir / "lib" / "util.zero.json"));
+  ASSERT_TRUE(util.has_value());
+  EXPECT_TRUE((*util)["success"].asBool());
+  EXPECT_TRUE(fs::exists(outDir / "main.zero.json"));
+  EXPECT_TRUE(errors.str().empty());
+}
+
+TEST_F(BatchLexerTest, DetectsOutputCollisions) {
+  std::vector<BatchInput> inputs{
+      {"/a/x.zero", "x.zero", 1},
+      {"/b/x.zero", "x.zero", 1},
+  };
+  auto checked = BatchLexer::checkOutputNames(inputs);
+  ASSERT_FALSE(checked.has_value());
+  EXPECT_EQ(checked.error().code, "E008");
+}
+
+TEST_F(BatchLexerTest, DriverWritesNdjsonAndSummary) {
+  auto args = createProject(5);
+  auto inputs = collectBatchInputs(args);
+  ASSERT_TRUE(inputs.has_value());
+
+  Driver driver;
+  auto output = testDir_ / "tokens.ndjson";
+  driver.setOutputFile(output);
+  std::ostringstream errors;
+  driver.setErrorStream(errors);
+  driver.context().lexer().jobs = 0;
+  EXPECT_EQ(driver.runLexerBatch(*inputs, {}), 0);
+
+  std::istringstream lines(readFile(output));
+  std::string line;
+  std::size_t count = 0;
+  while (std::getline(lines, line)) {
+    auto record = parseJson(line);
+    ASSERT_TRUE(record.has_value()) << line;
+    EXPECT_EQ((*record)["file"].asString(), args[count]);
+    ++count;
+  }
+  EXPECT_EQ(count, 5u);
+  EXPECT_NE(errors.str().find("lexed 5 files"), std::string::npos);
+}
+
+} // namespace
+} // namespace czc::cli
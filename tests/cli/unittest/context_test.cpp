@@ -134,5 +134,30 @@ TEST_F(CompilerContextTest, ClearDiagnostics) {
   EXPECT_EQ(ctx_.diagContext().warningCount(), 1u);
 }
 
+// ============================================================================
+// 源码管理测试
+// ============================================================================
+
+TEST_F(CompilerContextTest, DiagContextUsesSharedLocator) {
+  EXPECT_EQ(ctx_.diagContext().locator(), &ctx_.sourceLocator());
+
+  auto id =
+      ctx_.sourceManager().addBuffer(std::string_view("a\nbc"), "f.zero");
+  auto lc = ctx_.sourceLocator().getLineColumn(id.value, 3);
+  EXPECT_EQ(lc.line, 2u);
+  EXPECT_EQ(lc.column, 2u);
+}
+
+TEST_F(CompilerContextTest, LocatorSurvivesMove) {
+  const auto *locator = &ctx_.sourceLocator();
+  auto id = ctx_.sourceManager().addBuffer(std::string_view("x"), "m.zero");
+
+  CompilerContext moved(std::move(ctx_));
+  EXPECT_EQ(&moved.sourceLocator(), locator);
+  EXPECT_EQ(moved.diagContext().locator(), locator);
+  auto span = diag::Span::create(id.value, 0, 1);
+  EXPECT_EQ(moved.sourceLocator().getFilename(span), "m.zero");
+}
+
 } // namespace
 } // namespace czc::cli
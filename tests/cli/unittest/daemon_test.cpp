@@ -0,0 +1,289 @@
+/**
+ * @file daemon_test.cpp
+ * @brief 常驻编译服务协议与服务端单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/daemon/daemon_client.hpp"
+#include "czc/cli/daemon/daemon_server.hpp"
+#include "czc/cli/daemon/protocol.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+
+#if !CZC_PLATFORM_WINDOWS
+#include <sys/socket.h>
+#endif
+
+namespace czc::cli {
+namespace {
+
+// ============================================================================
+// 编解码
+// ============================================================================
+
+TEST(DaemonProtocolTest, RequestRoundTrip) {
+  DaemonRequest request;
+  request.cwd = "/work";
+  request.path = "src/main.zero";
+  request.source = std::string("let x = 1;\0tail", 15);
+  request.name = "buffer.zero";
+  request.preserveTrivia = true;
+  request.colorDiagnostics = false;
+  request.format = OutputFormat::NdJson;
+  request.maxErrorsPerCode = 7;
+
+  auto decoded = decodeRequest(encodeRequest(request));
+  ASSERT_TRUE(decoded.has_value()) << decoded.error().message;
+  EXPECT_EQ(decoded->kind, DaemonRequestKind::Lex);
+  EXPECT_EQ(decoded->cwd, "/work");
+  EXPECT_EQ(decoded->path, "src/main.zero");
+  EXPECT_EQ(decoded->source, request.source);
+  EXPECT_EQ(decoded->name, "buffer.zero");
+  EXPECT_TRUE(decoded->preserveTrivia);
+  EXPECT_FALSE(decoded->dumpTokens);
+  EXPECT_FALSE(decoded->colorDiagnostics);
+  EXPECT_EQ(decoded->format, OutputFormat::NdJson);
+  EXPECT_EQ(decoded->maxErrorsPerCode, 7u);
+}
+
+TEST(DaemonProtocolTest, ResponseRoundTrip) {
+  DaemonResponse response{.exitCode = 1, .out = "tokens", .err = "error"};
+  auto decoded = decodeResponse(encodeResponse(response));
+  ASSERT_TRUE(decoded.has_value());
+  EXPECT_EQ(decoded->exitCode, 1);
+  EXPECT_EQ(decoded->out, "tokens");
+  EXPECT_EQ(decoded->err, "error");
+}
+
+TEST(DaemonProtocolTest, RejectsMalformedPayloads) {
+  auto payload = encodeRequest(DaemonRequest{});
+  EXPECT_FALSE(decodeRequest(payload.substr(0, payload.size() - 1)));
+  EXPECT_FALSE(decodeRequest(payload + "x"));
+  EXPECT_FALSE(decodeRequest(""));
+
+  payload[0] = static_cast<char>(kDaemonProtocolVersion + 1);
+  auto mismatched = decodeRequest(payload);
+  ASSERT_FALSE(mismatched.has_value());
+  EXPECT_EQ(mismatched.error().code, "E006");
+}
+
+// ============================================================================
+// 服务端
+// ============================================================================
+
+class DaemonServerTest : public ::testing::Test {
+protected:
+  std::filesystem::path testDir_;
+
+  void SetUp() override {
+    testDir_ = std::filesystem::temp_directory_path() / "czc_daemon_test";
+    std::filesystem::create_directories(testDir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(testDir_); }
+
+  std::filesystem::path writeFile(std::string_view name,
+                                  std::string_view content) {
+    auto path = testDir_ / name;
+    std::ofstream ofs(path);
+    ofs << content;
+    return path;
+  }
+
+  /// 等待服务开始监听后连接
+  static auto connectWhenReady(const std::filesystem::path &socket)
+      -> Result<DaemonClient> {
+    Result<DaemonClient> client = err<DaemonClient>("not connected");
+    for (int i = 0; i < 200 && !client.has_value(); ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      client = DaemonClient::connect(socket);
+    }
+    return client;
+  }
+
+  static auto lexRequest(std::string path) -> DaemonRequest {
+    DaemonRequest request;
+    request.path = std::move(path);
+    request.colorDiagnostics = false;
+    return request;
+  }
+};
+
+TEST_F(DaemonServerTest, LexesInMemorySource) {
+  DaemonServer server(testDir_ / "unused.sock");
+  auto request = lexRequest("");
+  request.source = "let x = 1;";
+  request.format = OutputFormat::Json;
+
+  auto response = server.handle(request);
+  EXPECT_EQ(response.exitCode, 0);
+  EXPECT_NE(response.out.find(R"("type":"KW_LET")"), std::string::npos);
+  EXPECT_TRUE(response.err.empty());
+}
+
+TEST_F(DaemonServerTest, ReportsDiagnosticsPerRequest) {
+  DaemonServer server(testDir_ / "unused.sock");
+  auto request = lexRequest("");
+  request.source = "let s = \"unterminated";
+
+  for (int i = 0; i < 2; ++i) {
+    auto response = server.handle(request);
+    EXPECT_EQ(response.exitCode, 1);
+    // 统计与去重按请求重置，第二次请求仍输出同一诊断
+    EXPECT_NE(response.err.find("L1012"), std::string::npos) << i;
+  }
+}
+
+TEST_F(DaemonServerTest, ReusesUnchangedFiles) {
+  DaemonServer server(testDir_ / "unused.sock");
+  writeFile("a.zero", "let a = 1;");
+  auto request = lexRequest("a.zero");
+  request.cwd = testDir_.string();
+
+  ASSERT_EQ(server.handle(request).exitCode, 0);
+  auto buffers = server.driver().context().sourceManager().bufferCount();
+  ASSERT_EQ(server.handle(request).exitCode, 0);
+  EXPECT_EQ(server.driver().context().sourceManager().bufferCount(), buffers);
+
+  // 内容与大小变化后重新加载
+  writeFile("a.zero", "let a = 12;");
+  auto response = server.handle(request);
+  EXPECT_EQ(response.exitCode, 0);
+  EXPECT_NE(response.out.find("12"), std::string::npos);
+  EXPECT_EQ(server.driver().context().sourceManager().bufferCount(),
+            buffers + 1);
+}
+
+TEST_F(DaemonServerTest, SkipsRelexWhenOnlyTimestampChanges) {
+  DaemonServer server(testDir_ / "unused.sock");
+  auto path = writeFile("b.zero", "let b = 1;");
+  auto request = lexRequest(path.string());
+
+  auto first = server.handle(request);
+  ASSERT_EQ(first.exitCode, 0);
+  auto executed = server.queries().stats().executed;
+
+  // 修改时间变化但内容相同：重新读取文件，但不重新分析
+  std::filesystem::last_write_time(
+      path, std::filesystem::last_write_time(path) + std::chrono::seconds(5));
+  auto second = server.handle(request);
+  EXPECT_EQ(second.exitCode, 0);
+  EXPECT_EQ(second.out, first.out);
+  EXPECT_EQ(server.queries().stats().executed, executed);
+}
+
+TEST_F(DaemonServerTest, MissingFileIsReported) {
+  DaemonServer server(testDir_ / "unused.sock");
+  auto response = server.handle(lexRequest((testDir_ / "nope.zero").string()));
+  EXPECT_EQ(response.exitCode, 1);
+  EXPECT_NE(response.err.find("File not found"), std::string::npos);
+}
+
+#if !CZC_PLATFORM_WINDOWS
+
+TEST_F(DaemonServerTest, ServesClientsOverSocket) {
+  auto socket = testDir_ / "d.sock";
+  DaemonServer server(socket);
+  VoidResult served;
+  std::thread thread([&] { served = server.run(); });
+
+  auto client = connectWhenReady(socket);
+  ASSERT_TRUE(client.has_value()) << client.error().message;
+
+  // 同一连接依次发送多个请求
+  auto request = lexRequest("");
+  request.source = "fn main() {}";
+  for (int i = 0; i < 3; ++i) {
+    auto response = client->send(request);
+    ASSERT_TRUE(response.has_value()) << response.error().message;
+    EXPECT_EQ(response->exitCode, 0);
+    EXPECT_FALSE(response->out.empty());
+  }
+
+  // 已有服务监听时拒绝重复启动
+  DaemonServer second(socket);
+  auto rejected = second.run();
+  ASSERT_FALSE(rejected.has_value());
+  EXPECT_EQ(rejected.error().code, "E005");
+
+  DaemonRequest shutdown;
+  shutdown.kind = DaemonRequestKind::Shutdown;
+  ASSERT_TRUE(client->send(shutdown).has_value());
+  thread.join();
+
+  EXPECT_TRUE(served.has_value());
+  EXPECT_FALSE(std::filesystem::exists(socket));
+  EXPECT_FALSE(DaemonClient::connect(socket).has_value());
+}
+
+TEST_F(DaemonServerTest, StalledClientDoesNotBlockOthers) {
+  auto socket = testDir_ / "s.sock";
+  DaemonServer server(socket);
+  VoidResult served;
+  std::thread thread([&] { served = server.run(); });
+
+  auto client = connectWhenReady(socket);
+  ASSERT_TRUE(client.has_value()) << client.error().message;
+
+  // 只发送半个帧头后停滞的连接
+  auto stalled = connectDaemonSocket(socket);
+  ASSERT_TRUE(stalled.has_value());
+  ASSERT_EQ(::send(stalled->get(), "\x10", 1, 0), 1);
+
+  auto request = lexRequest("");
+  request.source = "let x = 1;";
+  auto response = client->send(request);
+  ASSERT_TRUE(response.has_value()) << response.error().message;
+  EXPECT_EQ(response->exitCode, 0);
+
+  // 停止时不等待停滞的连接超时
+  auto started = std::chrono::steady_clock::now();
+  DaemonRequest shutdown;
+  shutdown.kind = DaemonRequestKind::Shutdown;
+  ASSERT_TRUE(client->send(shutdown).has_value());
+  thread.join();
+  EXPECT_TRUE(served.has_value());
+  EXPECT_LT(std::chrono::steady_clock::now() - started,
+            DaemonServer::kIdleTimeout / 2);
+}
+
+TEST_F(DaemonServerTest, ClosesIdleConnections) {
+  auto socket = testDir_ / "i.sock";
+  DaemonServer server(socket);
+  server.setIdleTimeout(std::chrono::milliseconds(50));
+  VoidResult served;
+  std::thread thread([&] { served = server.run(); });
+
+  auto client = connectWhenReady(socket);
+  ASSERT_TRUE(client.has_value()) << client.error().message;
+
+  auto idle = connectDaemonSocket(socket);
+  ASSERT_TRUE(idle.has_value());
+  ASSERT_TRUE(setSocketTimeout(idle->get(), std::chrono::seconds(5))
+                  .has_value());
+  // 服务端超时后关闭连接：读到连接结束而不是本端超时
+  std::string payload;
+  auto got = readFrame(idle->get(), payload);
+  ASSERT_TRUE(got.has_value()) << got.error().message;
+  EXPECT_FALSE(got.value());
+
+  // 空闲断开的客户端重新连接后仍可使用
+  client = DaemonClient::connect(socket);
+  ASSERT_TRUE(client.has_value());
+  DaemonRequest shutdown;
+  shutdown.kind = DaemonRequestKind::Shutdown;
+  ASSERT_TRUE(client->send(shutdown).has_value());
+  thread.join();
+  EXPECT_TRUE(served.has_value());
+}
+
+#endif
+
+} // namespace
+} // namespace czc::cli
@@ -10,10 +10,12 @@
 #include "czc/diag/diag_builder.hpp"
 #include "czc/diag/message.hpp"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
 #include <sstream>
+#include <thread>
 
 namespace czc::cli {
 namespace {
@@ -79,6 +81,17 @@ TEST_F(DriverTest, SetOutputFile) {
   EXPECT_EQ(driver_.context().output().file.value(), path);
 }
 
+TEST_F(DriverTest, SchedulerUsesAllCoresWithoutJobs) {
+  EXPECT_FALSE(driver_.context().lexer().jobs.has_value());
+  EXPECT_EQ(driver_.scheduler().concurrency(),
+            std::max(1u, std::thread::hardware_concurrency()));
+}
+
+TEST_F(DriverTest, SchedulerFollowsExplicitJobs) {
+  driver_.context().lexer().jobs = 1;
+  EXPECT_EQ(driver_.scheduler().concurrency(), 1u);
+}
+
 TEST_F(DriverTest, SetColorDiagnostics) {
   driver_.setColorDiagnostics(false);
   EXPECT_FALSE(driver_.context().global().colorDiagnostics);
@@ -137,6 +150,47 @@ TEST_F(DriverTest, RunLexerOutputToFile) {
   EXPECT_FALSE(content.empty());
 }
 
+TEST_F(DriverTest, RunLexerPipelinedMatchesSequential) {
+  auto inputPath = createTestFile("pipe.zero", "let x = 1;\nlet y = \"s\";");
+  auto sequentialPath = testDir_ / "sequential.ndjson";
+  auto pipelinedPath = testDir_ / "pipelined.ndjson";
+
+  driver_.setOutputFormat(OutputFormat::NdJson);
+  driver_.setOutputFile(sequentialPath);
+  EXPECT_EQ(driver_.runLexer(inputPath), 0);
+
+  driver_.context().lexer().pipelined = true;
+  driver_.setOutputFile(pipelinedPath);
+  EXPECT_EQ(driver_.runLexer(inputPath), 0);
+
+  auto read = [](const std::filesystem::path &path) {
+    std::ifstream ifs(path);
+    return std::string((std::istreambuf_iterator<char>(ifs)),
+                       std::istreambuf_iterator<char>());
+  };
+  EXPECT_FALSE(read(pipelinedPath).empty());
+  EXPECT_EQ(read(pipelinedPath), read(sequentialPath));
+}
+
+TEST_F(DriverTest, RunLexerPipelinedWithErrors) {
+  auto path = createTestFile("pipe_error.zero", "let s = \"unterminated\n");
+
+  driver_.context().lexer().pipelined = true;
+  driver_.setOutputFormat(OutputFormat::Json);
+  driver_.setOutputFile(testDir_ / "pipe_error.json");
+  int exitCode = driver_.runLexer(path);
+
+  EXPECT_NE(exitCode, 0);
+  EXPECT_TRUE(driver_.diagContext().hasErrors());
+
+  // 约定：错误前已扫描的 Token 仍写出，总数写在 Token 之后
+  std::ifstream ifs(testDir_ / "pipe_error.json");
+  std::string output((std::istreambuf_iterator<char>(ifs)),
+                     std::istreambuf_iterator<char>());
+  EXPECT_NE(output.find("KW_LET"), std::string::npos);
+  EXPECT_NE(output.find(R"(],"count":)"), std::string::npos);
+}
+
 // ============================================================================
 // 诊断测试
 // ============================================================================
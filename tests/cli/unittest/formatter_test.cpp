@@ -11,6 +11,7 @@
 #include "czc/cli/output/text_formatter.hpp"
 #include "czc/lexer/lexer.hpp"
 
+#include <algorithm>
 #include <gtest/gtest.h>
 
 namespace czc::cli {
@@ -74,6 +75,48 @@ TEST_F(FormatterTest, TextFormatterEscapesSpecialChars) {
   EXPECT_NE(output.find("LIT_STRING"), std::string::npos);
 }
 
+TEST_F(FormatterTest, TextFormatterExactOutput) {
+  auto tokens = createTestTokens("let s = \"a\tb\";");
+  TextFormatter formatter;
+
+  std::string output = formatter.formatTokens(tokens, sm_);
+
+  EXPECT_EQ(output, "Total tokens: 6\n\n"
+                    "[1:1] KW_LET \"let\"\n"
+                    "[1:5] IDENTIFIER \"s\"\n"
+                    "[1:7] OP_ASSIGN \"=\"\n"
+                    "[1:9] LIT_STRING \"\\\"a\\tb\\\"\"\n"
+                    "[1:14] DELIM_SEMICOLON \";\"\n"
+                    "[1:15] TOKEN_EOF\n");
+}
+
+TEST_F(FormatterTest, TextFormatterWritesToSink) {
+  auto tokens = createTestTokens("let x = 1; // comment");
+  TextFormatter formatter;
+
+  std::string streamed;
+  {
+    // 使用很小的缓冲区，强制多次排空
+    StringSink sink(streamed, 32);
+    formatter.writeTokens(tokens, sm_, sink);
+  }
+
+  EXPECT_EQ(streamed, formatter.formatTokens(tokens, sm_));
+}
+
+TEST_F(FormatterTest, TextFormatterErrorCodePadding) {
+  std::vector<lexer::LexerError> errors;
+  errors.push_back(lexer::LexerError::simple(
+      lexer::LexerErrorCode::InvalidCharacter,
+      lexer::SourceLocation{lexer::BufferID{1}, 1, 1, 0}, "invalid character"));
+
+  TextFormatter formatter;
+  std::string output = formatter.formatErrors(errors, sm_);
+
+  EXPECT_NE(output.find("error[" + errors[0].codeString() + "]"),
+            std::string::npos);
+}
+
 // ============================================================================
 // JsonFormatter 测试
 // ============================================================================
@@ -117,6 +160,55 @@ TEST_F(FormatterTest, JsonFormatterEmptyTokens) {
   EXPECT_NE(output.find("\"tokens\":[]"), std::string::npos);
 }
 
+TEST_F(FormatterTest, JsonFormatterExactCompactOutput) {
+  auto tokens = createTestTokens("let x");
+  JsonFormatter formatter;
+
+  std::string output = formatter.formatTokens(tokens, sm_);
+
+  EXPECT_EQ(output,
+            R"({"success":true,"count":3,"tokens":[)"
+            R"({"type":"KW_LET","value":"let","line":1,"column":1,"offset":0,"length":3},)"
+            R"({"type":"IDENTIFIER","value":"x","line":1,"column":5,"offset":4,"length":1},)"
+            R"({"type":"TOKEN_EOF","value":"","line":1,"column":6,"offset":5,"length":0}]})");
+}
+
+TEST_F(FormatterTest, JsonFormatterEscapesValues) {
+  auto tokens = createTestTokens("\"a\\tb\"");
+  JsonFormatter formatter;
+
+  std::string output = formatter.formatTokens(tokens, sm_);
+
+  // 引号与反斜杠均需转义
+  EXPECT_NE(output.find(R"("value":"\"a\\tb\"")"), std::string::npos);
+}
+
+TEST_F(FormatterTest, JsonFormatterNdJsonLayout) {
+  auto tokens = createTestTokens("let x");
+  JsonFormatter formatter(JsonLayout::Lines);
+
+  std::string output = formatter.formatTokens(tokens, sm_);
+
+  // 每个 Token 一行，无外层包装
+  EXPECT_EQ(std::count(output.begin(), output.end(), '\n'), 3);
+  EXPECT_EQ(output.find("\"tokens\""), std::string::npos);
+  EXPECT_EQ(output.rfind(R"({"type":"KW_LET")", 0), 0u);
+}
+
+TEST_F(FormatterTest, JsonFormatterWritesToSink) {
+  auto tokens = createTestTokens("let x = 1;");
+  JsonFormatter formatter;
+
+  std::string streamed;
+  {
+    // 使用很小的缓冲区，强制多次排空
+    StringSink sink(streamed, 32);
+    formatter.writeTokens(tokens, sm_, sink);
+  }
+
+  EXPECT_EQ(streamed, formatter.formatTokens(tokens, sm_));
+}
+
 // ============================================================================
 // createFormatter 工厂函数测试
 // ============================================================================
@@ -135,6 +227,14 @@ TEST_F(FormatterTest, CreateJsonFormatter) {
   EXPECT_NE(dynamic_cast<JsonFormatter *>(formatter.get()), nullptr);
 }
 
+TEST_F(FormatterTest, CreateNdJsonFormatter) {
+  auto formatter = createFormatter(OutputFormat::NdJson);
+
+  auto *json = dynamic_cast<JsonFormatter *>(formatter.get());
+  ASSERT_NE(json, nullptr);
+  EXPECT_EQ(json->layout(), JsonLayout::Lines);
+}
+
 // ============================================================================
 // 错误格式化测试
 // ============================================================================
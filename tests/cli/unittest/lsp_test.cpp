@@ -0,0 +1,387 @@
+/**
+ * @file lsp_test.cpp
+ * @brief 语言服务器文档与消息处理单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/lsp/document.hpp"
+#include "czc/cli/lsp/lsp_server.hpp"
+#include "czc/cli/lsp/transport.hpp"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace czc::cli {
+namespace {
+
+// ============================================================================
+// 文档
+// ============================================================================
+
+/// 比较两个文档的分析结果
+void expectSameAnalysis(const LspDocument &actual, const LspDocument &fresh) {
+  ASSERT_EQ(actual.tokens().size(), fresh.tokens().size());
+  for (std::size_t i = 0; i < fresh.tokens().size(); ++i) {
+    EXPECT_EQ(actual.tokens()[i].offset, fresh.tokens()[i].offset) << i;
+    EXPECT_EQ(actual.tokens()[i].length, fresh.tokens()[i].length) << i;
+    EXPECT_EQ(actual.tokens()[i].type, fresh.tokens()[i].type) << i;
+  }
+  ASSERT_EQ(actual.diagnostics().size(), fresh.diagnostics().size());
+  for (std::size_t i = 0; i < fresh.diagnostics().size(); ++i) {
+    EXPECT_EQ(actual.diagnostics()[i].offset, fresh.diagnostics()[i].offset);
+    EXPECT_EQ(actual.diagnostics()[i].code, fresh.diagnostics()[i].code);
+  }
+}
+
+/// 单项区间变更
+LspContentChange edit(LspPosition start, LspPosition end, std::string text) {
+  return LspContentChange{LspRange{start, end}, std::move(text)};
+}
+
+TEST(LspDocumentTest, EncodesSemanticTokensInUtf16) {
+  lexer::SourceManager sm;
+  // 😀 占 2 个 UTF-16 码元，其后的 Token 列号随之偏移
+  LspDocument doc(sm, "file:///a.zero", "let x = 1;\n\"😀\" + y", 1);
+
+  auto data = doc.encodeSemanticTokens();
+  std::vector<std::uint32_t> expected = {
+      0, 0, 3, 0, 0, // let
+      0, 4, 1, 1, 0, // x
+      0, 2, 1, 4, 0, // =
+      0, 2, 1, 2, 0, // 1
+      1, 0, 4, 3, 0, // "😀"
+      0, 5, 1, 4, 0, // +
+      0, 2, 1, 1, 0, // y
+  };
+  EXPECT_EQ(data, expected);
+}
+
+TEST(LspDocumentTest, SplitsMultilineTokensPerLine) {
+  lexer::SourceManager sm;
+  LspDocument doc(sm, "file:///a.zero", "x = r\"ab\ncd\";", 1);
+
+  auto data = doc.encodeSemanticTokens();
+  std::vector<std::uint32_t> expected = {
+      0, 0, 1, 1, 0, // x
+      0, 2, 1, 4, 0, // =
+      0, 2, 4, 3, 0, // r"ab
+      1, 0, 3, 3, 0, // cd"
+  };
+  EXPECT_EQ(data, expected);
+}
+
+TEST(LspDocumentTest, ConvertsPositions) {
+  lexer::SourceManager sm;
+  LspDocument doc(sm, "file:///a.zero", "ab\r\n名😀z\n", 1);
+
+  EXPECT_EQ(doc.positionAt(0), (LspPosition{0, 0}));
+  EXPECT_EQ(doc.positionAt(4), (LspPosition{1, 0}));
+  EXPECT_EQ(doc.positionAt(7), (LspPosition{1, 1}));
+  EXPECT_EQ(doc.positionAt(11), (LspPosition{1, 3}));
+
+  EXPECT_EQ(doc.offsetAt({1, 3}), 11u);
+  // 列号越界截到行尾（\r\n 之前），行号越界为文本末尾
+  EXPECT_EQ(doc.offsetAt({0, 99}), 2u);
+  EXPECT_EQ(doc.offsetAt({9, 0}), doc.text().size());
+}
+
+TEST(LspDocumentTest, RelexesOnlyAroundTheEdit) {
+  std::string text;
+  for (int i = 0; i < 2000; ++i) {
+    text += "let value" + std::to_string(i) + " = " + std::to_string(i) +
+            ";\n";
+  }
+  lexer::SourceManager sm;
+  LspDocument doc(sm, "file:///a.zero", text, 1);
+  auto total = doc.tokens().size();
+
+  // 在第 1000 行的标识符末尾追加字符
+  LspContentChange change = edit({1000, 13}, {1000, 13}, "x");
+  doc.applyChanges({&change, 1}, 2);
+
+  EXPECT_EQ(doc.version(), 2);
+  EXPECT_EQ(doc.tokens().size(), total);
+  EXPECT_LT(doc.lastRelex().lexedTokens, 10u);
+  EXPECT_GT(doc.lastRelex().reusedTokens, total / 3);
+
+  LspDocument fresh(sm, "file:///b.zero", std::string(doc.text()), 1);
+  expectSameAnalysis(doc, fresh);
+}
+
+TEST(LspDocumentTest, OpeningCommentRelexesToEnd) {
+  lexer::SourceManager sm;
+  LspDocument doc(sm, "file:///a.zero", "a b\nc d\ne f", 1);
+  ASSERT_EQ(doc.tokens().size(), 6u);
+
+  LspContentChange change = edit({1, 0}, {1, 0}, "/*");
+  doc.applyChanges({&change, 1}, 2);
+
+  EXPECT_EQ(doc.tokens().size(), 2u);
+  ASSERT_EQ(doc.diagnostics().size(), 1u);
+  EXPECT_EQ(doc.diagnostics()[0].code,
+            lexer::LexerErrorCode::UnterminatedBlockComment);
+
+  // 闭合后恢复
+  LspContentChange close = edit({1, 5}, {1, 5}, "*/");
+  doc.applyChanges({&close, 1}, 3);
+  EXPECT_EQ(doc.tokens().size(), 4u);
+  EXPECT_TRUE(doc.diagnostics().empty());
+}
+
+TEST(LspDocumentTest, AppliesSequentialChangesAndFullReplace) {
+  lexer::SourceManager sm;
+  LspDocument doc(sm, "file:///a.zero", "let a = 1;\nlet b = 2;\n", 1);
+
+  std::vector<LspContentChange> changes = {
+      edit({0, 4}, {0, 5}, "alpha"),
+      // 第二项基于第一项修改后的文本
+      edit({1, 8}, {1, 9}, "\"two\""),
+  };
+  doc.applyChanges(changes, 2);
+  EXPECT_EQ(doc.text(), "let alpha = 1;\nlet b = \"two\";\n");
+
+  LspContentChange full{std::nullopt, "let c = 3;"};
+  doc.applyChanges({&full, 1}, 3);
+  EXPECT_EQ(doc.text(), "let c = 3;");
+  LspDocument fresh(sm, "file:///b.zero", "let c = 3;", 1);
+  expectSameAnalysis(doc, fresh);
+}
+
+TEST(LspDocumentTest, RandomEditsMatchFullRelex) {
+  const std::vector<std::string> fragments = {
+      "let ", "x", "1", ".", "5", "\"", "s", "/*", "*/", "//", "\n",
+      " ",    "=", ">", "名", "0x", "e", "r\"", "\\", ";", "😀"};
+  std::mt19937 rng(12345);
+
+  lexer::SourceManager sm;
+  LspDocument doc(sm, "file:///a.zero",
+                  "fn main() {\n  let s = \"hi\";\n  /* c */ x = 0x1F;\n}\n",
+                  1);
+
+  for (int round = 0; round < 300; ++round) {
+    auto size = static_cast<std::uint32_t>(doc.text().size());
+    auto start = static_cast<std::uint32_t>(rng() % (size + 1));
+    auto end = std::min<std::uint32_t>(size, start + rng() % 4);
+    std::string text;
+    for (auto n = rng() % 3; n > 0; --n) {
+      text += fragments[rng() % fragments.size()];
+    }
+
+    LspContentChange change =
+        edit(doc.positionAt(start), doc.positionAt(end), text);
+    doc.applyChanges({&change, 1}, round + 2);
+
+    LspDocument fresh(sm, "file:///fresh.zero", std::string(doc.text()), 1);
+    expectSameAnalysis(doc, fresh);
+    if (::testing::Test::HasFailure()) {
+      FAIL() << "round " << round << " text:\n" << doc.text();
+    }
+  }
+}
+
+TEST(LspDocumentTest, RebindKeepsAnalysis) {
+  lexer::SourceManager first;
+  LspDocument doc(first, "file:///a.zero", "let a = \"x", 1);
+  auto tokens = doc.tokens().size();
+
+  lexer::SourceManager second;
+  doc.rebind(second);
+  EXPECT_EQ(doc.text(), "let a = \"x");
+  EXPECT_EQ(doc.tokens().size(), tokens);
+  EXPECT_EQ(doc.diagnostics().size(), 1u);
+}
+
+// ============================================================================
+// 服务端
+// ============================================================================
+
+/// 拆分输出中的全部消息
+std::vector<JsonValue> readMessages(const std::string &output) {
+  std::istringstream in(output);
+  std::vector<JsonValue> messages;
+  std::string body;
+  while (true) {
+    auto got = readLspMessage(in, body);
+    if (!got.has_value() || !got.value()) {
+      break;
+    }
+    auto parsed = parseJson(body);
+    EXPECT_TRUE(parsed.has_value()) << body;
+    if (parsed.has_value()) {
+      messages.push_back(std::move(parsed.value()));
+    }
+  }
+  return messages;
+}
+
+/// 为消息加上 Content-Length 头
+std::string frame(std::string_view body) {
+  return "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" +
+         std::string(body);
+}
+
+JsonValue parse(std::string_view text) {
+  auto parsed = parseJson(text);
+  EXPECT_TRUE(parsed.has_value()) << text;
+  return parsed.has_value() ? std::move(parsed.value()) : JsonValue();
+}
+
+TEST(LspServerTest, ServesSemanticTokensAndDeltas) {
+  std::istringstream in;
+  std::string output;
+  StringSink out(output);
+  LspServer server(in, out);
+
+  server.handle(parse(R"({"jsonrpc":"2.0","id":1,"method":"initialize",
+      "params":{}})"));
+  server.handle(parse(R"({"jsonrpc":"2.0","method":"textDocument/didOpen",
+      "params":{"textDocument":{"uri":"file:///a.zero","languageId":"zero",
+      "version":1,"text":"let a = 1;\nlet b = \"x;\n"}}})"));
+  server.handle(parse(R"({"jsonrpc":"2.0","id":2,
+      "method":"textDocument/semanticTokens/full",
+      "params":{"textDocument":{"uri":"file:///a.zero"}}})"));
+  server.handle(parse(R"({"jsonrpc":"2.0","method":"textDocument/didChange",
+      "params":{"textDocument":{"uri":"file:///a.zero","version":2},
+      "contentChanges":[{"range":{"start":{"line":1,"character":10},
+      "end":{"line":1,"character":10}},"text":"\" + c"}]}})"));
+  server.handle(parse(R"({"jsonrpc":"2.0","id":3,
+      "method":"textDocument/semanticTokens/full/delta",
+      "params":{"textDocument":{"uri":"file:///a.zero"},
+      "previousResultId":"1"}})"));
+  out.flush();
+
+  auto messages = readMessages(output);
+  ASSERT_EQ(messages.size(), 5u);
+
+  const auto &caps = messages[0]["result"]["capabilities"];
+  EXPECT_EQ(messages[0]["id"].asInt(), 1);
+  EXPECT_EQ(caps["textDocumentSync"]["change"].asInt(), 2);
+  EXPECT_TRUE(caps["semanticTokensProvider"]["full"]["delta"].asBool());
+  EXPECT_EQ(caps["semanticTokensProvider"]["legend"]["tokenTypes"]
+                .asArray()
+                .size(),
+            kSemanticTokenLegend.size());
+
+  // 打开时报告未闭合字符串
+  EXPECT_EQ(messages[1]["method"].asString(),
+            "textDocument/publishDiagnostics");
+  const auto &diagnostics = messages[1]["params"]["diagnostics"].asArray();
+  ASSERT_EQ(diagnostics.size(), 1u);
+  EXPECT_EQ(diagnostics[0]["code"].asString(), "L1012");
+  EXPECT_EQ(diagnostics[0]["range"]["start"]["line"].asInt(), 1);
+  EXPECT_EQ(diagnostics[0]["range"]["start"]["character"].asInt(), 8);
+
+  EXPECT_EQ(messages[2]["result"]["resultId"].asString(), "1");
+  EXPECT_EQ(messages[2]["result"]["data"].asArray().size(), 8u * 5u);
+
+  // 闭合字符串后诊断清空
+  EXPECT_EQ(messages[3]["params"]["version"].asInt(), 2);
+  EXPECT_TRUE(messages[3]["params"]["diagnostics"].asArray().empty());
+
+  // 字符串长度不变，增量结果只追加 + 与 c 两个 Token
+  const auto &delta = messages[4]["result"];
+  EXPECT_EQ(delta["resultId"].asString(), "2");
+  const auto &edits = delta["edits"].asArray();
+  ASSERT_EQ(edits.size(), 1u);
+  EXPECT_EQ(edits[0]["start"].asInt(), 8 * 5);
+  EXPECT_EQ(edits[0]["deleteCount"].asInt(), 0);
+  std::vector<std::int64_t> data;
+  for (const auto &value : edits[0]["data"].asArray()) {
+    data.push_back(value.asInt());
+  }
+  EXPECT_EQ(data, (std::vector<std::int64_t>{0, 4, 1, 4, 0, 0, 2, 1, 1, 0}));
+}
+
+TEST(LspServerTest, StaleDeltaFallsBackToFull) {
+  std::istringstream in;
+  std::string output;
+  StringSink out(output);
+  LspServer server(in, out);
+
+  server.handle(parse(R"({"jsonrpc":"2.0","method":"textDocument/didOpen",
+      "params":{"textDocument":{"uri":"u","version":1,"text":"a"}}})"));
+  server.handle(parse(R"({"jsonrpc":"2.0","id":"req",
+      "method":"textDocument/semanticTokens/full/delta",
+      "params":{"textDocument":{"uri":"u"},"previousResultId":"9"}})"));
+  out.flush();
+
+  auto messages = readMessages(output);
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[1]["id"].asString(), "req");
+  EXPECT_EQ(messages[1]["result"]["data"].asArray().size(), 5u);
+}
+
+TEST(LspServerTest, RetainedBytesStayBoundedUnderEdits) {
+  std::istringstream in;
+  std::string output;
+  StringSink out(output);
+  LspServer server(in, out);
+
+  // 约 1 MiB 的文档，每次编辑在开头插入一个字符
+  std::string text;
+  while (text.size() < (std::size_t{1} << 20)) {
+    text += "let value = 1; ";
+  }
+  server.handle(parse(R"({"jsonrpc":"2.0","method":"textDocument/didOpen",
+      "params":{"textDocument":{"uri":"big","version":1,"text":")" +
+                      text + R"("}}})"));
+
+  for (int version = 2; version < 20; ++version) {
+    server.handle(parse(
+        R"({"jsonrpc":"2.0","method":"textDocument/didChange",
+        "params":{"textDocument":{"uri":"big","version":)" +
+        std::to_string(version) +
+        R"(},"contentChanges":[{"range":{"start":{"line":0,"character":0},
+        "end":{"line":0,"character":0}},"text":"y"}]}})"));
+    const auto live = server.document("big")->text().size();
+    EXPECT_LE(server.retainedBytes(), live * LspServer::kRetainedFactor)
+        << version;
+  }
+  EXPECT_EQ(server.document("big")->text().size(), text.size() + 18);
+
+  // 关闭后不再保留文档内容
+  server.handle(parse(R"({"jsonrpc":"2.0","method":"textDocument/didClose",
+      "params":{"textDocument":{"uri":"big"}}})"));
+  EXPECT_LE(server.retainedBytes(), LspServer::kMinRetainedBytes);
+}
+
+TEST(LspServerTest, RunsUntilExit) {
+  std::string input =
+      frame(R"({"jsonrpc":"2.0","id":1,"method":"initialize","params":{}})") +
+      frame(R"({"jsonrpc":"2.0","id":2,"method":"unknown/method"})") +
+      frame("{not json") +
+      frame(R"({"jsonrpc":"2.0","id":3,"method":"shutdown"})") +
+      frame(R"({"jsonrpc":"2.0","method":"exit"})") +
+      frame(R"({"jsonrpc":"2.0","id":4,"method":"shutdown"})");
+  std::istringstream in(input);
+  std::string output;
+  StringSink out(output);
+  LspServer server(in, out);
+
+  EXPECT_EQ(server.run(), 0);
+  EXPECT_TRUE(server.exited());
+  out.flush();
+
+  auto messages = readMessages(output);
+  ASSERT_EQ(messages.size(), 4u);
+  EXPECT_EQ(messages[1]["error"]["code"].asInt(), -32601);
+  EXPECT_EQ(messages[2]["error"]["code"].asInt(), -32700);
+  EXPECT_TRUE(messages[2]["id"].isNull());
+  EXPECT_TRUE(messages[3]["result"].isNull());
+}
+
+TEST(LspServerTest, RejectsTruncatedFrames) {
+  std::istringstream in("Content-Length: 10\r\n\r\n{}");
+  std::string body;
+  auto got = readLspMessage(in, body);
+  ASSERT_FALSE(got.has_value());
+  EXPECT_EQ(got.error().code, "E006");
+}
+
+} // namespace
+} // namespace czc::cli
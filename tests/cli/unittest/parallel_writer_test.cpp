@@ -0,0 +1,101 @@
+/**
+ * @file parallel_writer_test.cpp
+ * @brief ParallelTokenWriter 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/output/json_formatter.hpp"
+#include "czc/cli/output/parallel_writer.hpp"
+#include "czc/cli/output/text_formatter.hpp"
+#include "czc/lexer/lexer.hpp"
+
+#include <gtest/gtest.h>
+
+namespace czc::cli {
+namespace {
+
+class ParallelWriterTest : public ::testing::Test {
+protected:
+  lexer::SourceManager sm_;
+  std::vector<lexer::Token> tokens_;
+
+  void SetUp() override {
+    std::string source;
+    for (int i = 0; i < 400; ++i) {
+      source += "fn f" + std::to_string(i) + "() { let s = \"a\\\"b\"; }\n";
+    }
+    auto id = sm_.addBuffer(source, "parallel.zero");
+    lexer::Lexer lex(sm_, id);
+    tokens_ = lex.tokenizeWithTrivia();
+  }
+
+  std::string renderParallel(const OutputFormatter &formatter,
+                             SchedulerOptions scheduling,
+                             ParallelWriteOptions options) {
+    std::string out;
+    {
+      TaskScheduler scheduler(scheduling);
+      StringSink sink(out, 64);
+      ParallelTokenWriter writer(scheduler, options);
+      writer.write(formatter, tokens_, sm_, sink);
+    }
+    return out;
+  }
+};
+
+TEST_F(ParallelWriterTest, JsonMatchesSequential) {
+  JsonFormatter formatter;
+
+  auto parallel = renderParallel(formatter, {.threads = 4},
+                                 {.chunkTokens = 37, .slotsPerJob = 1});
+
+  EXPECT_EQ(parallel, formatter.formatTokens(tokens_, sm_));
+}
+
+TEST_F(ParallelWriterTest, NdJsonMatchesSequential) {
+  JsonFormatter formatter(JsonLayout::Lines);
+
+  auto parallel =
+      renderParallel(formatter, {.threads = 3}, {.chunkTokens = 100});
+
+  EXPECT_EQ(parallel, formatter.formatTokens(tokens_, sm_));
+}
+
+TEST_F(ParallelWriterTest, TextMatchesSequential) {
+  TextFormatter formatter;
+
+  auto parallel =
+      renderParallel(formatter, {.threads = 8}, {.chunkTokens = 11});
+
+  EXPECT_EQ(parallel, formatter.formatTokens(tokens_, sm_));
+}
+
+TEST_F(ParallelWriterTest, SingleChunkFallsBackToSequential) {
+  JsonFormatter formatter;
+
+  auto parallel = renderParallel(formatter, {.threads = 4},
+                                 {.chunkTokens = tokens_.size() + 1});
+
+  EXPECT_EQ(parallel, formatter.formatTokens(tokens_, sm_));
+}
+
+TEST_F(ParallelWriterTest, DeterministicSchedulerFallsBackToSequential) {
+  JsonFormatter formatter;
+
+  auto parallel = renderParallel(formatter, {.deterministic = true},
+                                 {.chunkTokens = 37});
+
+  EXPECT_EQ(parallel, formatter.formatTokens(tokens_, sm_));
+}
+
+TEST_F(ParallelWriterTest, AutoJobsUsesSchedulerConcurrency) {
+  TaskScheduler scheduler;
+  ParallelTokenWriter writer(scheduler);
+  EXPECT_EQ(writer.effectiveJobs(), scheduler.concurrency());
+  EXPECT_GE(writer.effectiveJobs(), 1u);
+}
+
+} // namespace
+} // namespace czc::cli
@@ -0,0 +1,323 @@
+/**
+ * @file phase_pipeline_test.cpp
+ * @brief PhasePipeline 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/phases/lexer_phase.hpp"
+#include "czc/cli/phases/phase_pipeline.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace czc::cli {
+namespace {
+
+/// 记录拷贝次数的载荷，用于验证阶段之间只发生移动
+struct Payload {
+  static inline std::atomic<int> copies{0};
+
+  std::vector<int> values;
+
+  Payload() = default;
+  explicit Payload(std::vector<int> v) : values(std::move(v)) {}
+  Payload(const Payload &other) : values(other.values) { ++copies; }
+  Payload &operator=(const Payload &other) {
+    values = other.values;
+    ++copies;
+    return *this;
+  }
+  Payload(Payload &&) noexcept = default;
+  Payload &operator=(Payload &&) noexcept = default;
+};
+
+struct ExpandPhase {
+  using Input = int;
+  using Output = Payload;
+  Result<Payload> run(int n) {
+    if (n < 0) {
+      return err<Payload>("negative input", "E100");
+    }
+    return ok(Payload(std::vector<int>(static_cast<std::size_t>(n), n)));
+  }
+};
+
+struct SumPhase {
+  using Input = Payload;
+  using Output = long;
+  int calls{0};
+  Result<long> run(Payload payload) {
+    ++calls;
+    long sum = 0;
+    for (int v : payload.values) {
+      sum += v;
+    }
+    return ok(std::move(sum));
+  }
+};
+
+struct FormatPhase {
+  using Input = long;
+  using Output = std::string;
+  Result<std::string> run(long value) { return ok(std::to_string(value)); }
+};
+
+struct TokenCountPhase {
+  using Input = LexResult;
+  using Output = std::size_t;
+  Result<std::size_t> run(const LexResult &lexed) {
+    if (lexed.hasErrors) {
+      return err<std::size_t>("lexing failed", "E100");
+    }
+    return ok(lexed.tokens.size());
+  }
+};
+
+static_assert(CompilerPhase<ExpandPhase>);
+static_assert(CompilerPhase<PhasePipeline<ExpandPhase, SumPhase>>);
+static_assert(!PhasesChain<ExpandPhase, FormatPhase>::value);
+
+TEST(PhasePipelineTest, RunMovesResultsBetweenPhases) {
+  ExpandPhase expand;
+  SumPhase sum;
+  FormatPhase format;
+  PhasePipeline pipeline(expand, sum, format);
+  static_assert(std::is_same_v<decltype(pipeline)::Input, int>);
+  static_assert(std::is_same_v<decltype(pipeline)::Output, std::string>);
+
+  Payload::copies = 0;
+  auto result = pipeline.run(4);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(*result, "16");
+  EXPECT_EQ(Payload::copies.load(), 0);
+}
+
+TEST(PhasePipelineTest, FailureSkipsLaterPhases) {
+  ExpandPhase expand;
+  SumPhase sum;
+  PhasePipeline pipeline(expand, sum);
+
+  auto result = pipeline.run(-1);
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(result.error().code, "E100");
+  EXPECT_EQ(sum.calls, 0);
+}
+
+TEST(PhasePipelineTest, PipelinesCompose) {
+  ExpandPhase expand;
+  SumPhase sum;
+  FormatPhase format;
+  PhasePipeline inner(expand, sum);
+  PhasePipeline outer(inner, format);
+
+  auto result = outer.run(3);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(*result, "9");
+}
+
+TEST(PhasePipelineTest, RunEachDeliversInInputOrder) {
+  std::vector<int> inputs;
+  for (int i = -2; i < 60; ++i) {
+    inputs.push_back(i % 7 == 0 ? -i : i);
+  }
+
+  TaskScheduler scheduler({.threads = 4});
+  for (bool pipelined : {false, true}) {
+    ExpandPhase expand;
+    SumPhase sum;
+    FormatPhase format;
+    PhasePipeline pipeline(expand, sum, format);
+
+    auto copy = inputs;
+    std::vector<std::string> results;
+    Payload::copies = 0;
+    pipeline.runEach(
+        copy, scheduler,
+        [&](std::size_t index, Result<std::string> &&result) {
+          EXPECT_EQ(index, results.size());
+          results.push_back(result.has_value() ? *result
+                                               : result.error().code);
+        },
+        {.pipelined = pipelined, .queueDepth = 2});
+
+    ASSERT_EQ(results.size(), inputs.size());
+    int failures = 0;
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+      int n = inputs[i];
+      if (n < 0) {
+        ++failures;
+        EXPECT_EQ(results[i], "E100");
+      } else {
+        EXPECT_EQ(results[i], std::to_string(static_cast<long>(n) * n));
+      }
+    }
+    EXPECT_EQ(sum.calls, static_cast<int>(inputs.size()) - failures);
+    EXPECT_EQ(Payload::copies.load(), 0);
+  }
+}
+
+TEST(PhasePipelineTest, NextFileEntersFirstPhaseWhileFirstFileMovesOn) {
+  std::promise<void> secondStarted;
+  auto started = secondStarted.get_future();
+
+  struct MarkPhase {
+    using Input = int;
+    using Output = int;
+    std::promise<void> *mark;
+    Result<int> run(int n) {
+      if (n == 1) {
+        mark->set_value();
+      }
+      return ok(std::move(n));
+    }
+  };
+  struct AwaitPhase {
+    using Input = int;
+    using Output = bool;
+    std::future<void> *started;
+    Result<bool> run(int n) {
+      // 文件 0 停留在第二阶段，直到文件 1 进入第一阶段
+      if (n == 0) {
+        return ok(started->wait_for(std::chrono::seconds(10)) ==
+                  std::future_status::ready);
+      }
+      return ok(true);
+    }
+  };
+
+  MarkPhase mark{&secondStarted};
+  AwaitPhase await{&started};
+  PhasePipeline pipeline(mark, await);
+
+  TaskScheduler scheduler({.threads = 3});
+  std::vector<int> inputs{0, 1, 2};
+  std::vector<bool> overlapped;
+  pipeline.runEach(inputs, scheduler,
+                   [&](std::size_t, Result<bool> &&result) {
+                     overlapped.push_back(result.value_or(false));
+                   });
+  EXPECT_EQ(overlapped, (std::vector<bool>{true, true, true}));
+}
+
+TEST(PhasePipelineTest, ConsumerExceptionStopsStages) {
+  ExpandPhase expand;
+  SumPhase sum;
+  PhasePipeline pipeline(expand, sum);
+
+  TaskScheduler scheduler({.threads = 3});
+  std::vector<int> inputs(100, 3);
+  EXPECT_THROW(pipeline.runEach(
+                   inputs, scheduler,
+                   [](std::size_t index, Result<long> &&) {
+                     if (index == 1) {
+                       throw std::runtime_error("stop");
+                     }
+                   },
+                   {.pipelined = true, .queueDepth = 1}),
+               std::runtime_error);
+  EXPECT_LT(sum.calls, 100);
+}
+
+TEST(PhasePipelineTest, PhaseExceptionIsRethrownOnCaller) {
+  struct ThrowPhase {
+    using Input = Payload;
+    using Output = long;
+    Result<long> run(Payload payload) {
+      if (payload.values.size() == 5) {
+        throw std::runtime_error("phase failed");
+      }
+      return ok(static_cast<long>(payload.values.size()));
+    }
+  };
+
+  ExpandPhase expand;
+  ThrowPhase fail;
+  PhasePipeline pipeline(expand, fail);
+
+  TaskScheduler scheduler({.threads = 3});
+  std::vector<int> inputs(100, 1);
+  inputs[10] = 5;
+  std::size_t delivered = 0;
+  EXPECT_THROW(pipeline.runEach(
+                   inputs, scheduler,
+                   [&](std::size_t, Result<long> &&) { ++delivered; },
+                   {.pipelined = true, .queueDepth = 1}),
+               std::runtime_error);
+  EXPECT_LE(delivered, 10u);
+
+  // 调度器之后仍可使用
+  std::atomic<int> ran{0};
+  scheduler.parallelFor(0, 8, 1, [&](std::size_t lo, std::size_t hi) {
+    ran += static_cast<int>(hi - lo);
+  });
+  EXPECT_EQ(ran.load(), 8);
+}
+
+TEST(PhasePipelineTest, RunsSequentiallyWithoutEnoughWorkers) {
+  ExpandPhase expand;
+  SumPhase sum;
+  FormatPhase format;
+  PhasePipeline pipeline(expand, sum, format);
+
+  // 确定性调度器没有工作线程：按输入逐个执行，不会阻塞在阶段队列上
+  TaskScheduler scheduler({.deterministic = true});
+  std::vector<int> inputs{1, 2, 3};
+  std::vector<std::string> results;
+  pipeline.runEach(inputs, scheduler,
+                   [&](std::size_t, Result<std::string> &&result) {
+                     results.push_back(result.value_or("?"));
+                   });
+  EXPECT_EQ(results, (std::vector<std::string>{"1", "4", "9"}));
+}
+
+TEST(PhasePipelineTest, LexerPhaseFeedsDownstreamPhase) {
+  namespace fs = std::filesystem;
+  auto dir = fs::temp_directory_path() / "czc_phase_pipeline_test";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+
+  std::vector<fs::path> files;
+  for (int i = 0; i < 4; ++i) {
+    files.push_back(dir / ("f" + std::to_string(i) + ".zero"));
+    std::ofstream(files.back()) << std::string(static_cast<std::size_t>(i),
+                                               'x')
+                                << " y";
+  }
+  files.push_back(dir / "missing.zero");
+
+  CompilerContext ctx;
+  LexerPhase lex(ctx);
+  TokenCountPhase count;
+  PhasePipeline pipeline(lex, count);
+
+  TaskScheduler scheduler({.threads = 3});
+  std::vector<std::string> results;
+  pipeline.runEach(files, scheduler,
+                   [&](std::size_t, Result<std::size_t> &&result) {
+                     results.push_back(result.has_value()
+                                           ? std::to_string(*result)
+                                           : result.error().code);
+                   });
+  // 标识符数 + EOF；空前缀的文件只有一个标识符
+  EXPECT_EQ(results,
+            (std::vector<std::string>{"2", "3", "3", "3", "E001"}));
+
+  auto lexed = lex.run(files[1]);
+  ASSERT_TRUE(lexed.has_value());
+  EXPECT_EQ(ctx.sourceManager().getFilename(lexed->bufferId),
+            files[1].string());
+
+  fs::remove_all(dir);
+}
+
+} // namespace
+} // namespace czc::cli
@@ -0,0 +1,155 @@
+/**
+ * @file pipeline_test.cpp
+ * @brief TokenPipeline 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/output/json_formatter.hpp"
+#include "czc/cli/output/text_formatter.hpp"
+#include "czc/cli/pipeline/token_pipeline.hpp"
+#include "czc/lexer/lexer.hpp"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace czc::cli {
+namespace {
+
+class TokenPipelineTest : public ::testing::Test {
+protected:
+  lexer::SourceManager sm_;
+
+  /**
+   * @brief 生成包含大量 Token 的源码。
+   */
+  static std::string makeSource(int lines) {
+    std::string source;
+    for (int i = 0; i < lines; ++i) {
+      source += "let value_" + std::to_string(i) + " = \"s\\t" +
+                std::to_string(i) + "\"; // note\n";
+    }
+    return source;
+  }
+
+  /**
+   * @brief 以流水线方式运行并返回输出。
+   */
+  std::string runPipelined(std::string_view source,
+                           const OutputFormatter &formatter,
+                           PipelineOptions options = {},
+                           bool preserveTrivia = false,
+                           SchedulerOptions scheduling = {.threads = 3}) {
+    auto id = sm_.addBuffer(source, "pipeline.zero");
+    lexer::Lexer lex(sm_, id);
+    std::string out;
+    {
+      StringSink sink(out);
+      TaskScheduler scheduler(scheduling);
+      TokenPipeline pipeline(options);
+      auto stats =
+          pipeline.run(lex, preserveTrivia, formatter, sm_, sink, scheduler);
+      EXPECT_GT(stats.tokenCount, 0u);
+    }
+    return out;
+  }
+
+  /**
+   * @brief 以顺序方式扫描。
+   */
+  std::vector<lexer::Token> tokenize(std::string_view source,
+                                     bool preserveTrivia = false) {
+    auto id = sm_.addBuffer(source, "sequential.zero");
+    lexer::Lexer lex(sm_, id);
+    return preserveTrivia ? lex.tokenizeWithTrivia() : lex.tokenize();
+  }
+};
+
+TEST_F(TokenPipelineTest, NdJsonMatchesSequentialOutput) {
+  auto source = makeSource(500);
+  JsonFormatter formatter(JsonLayout::Lines);
+
+  // 小块、小队列，迫使各阶段频繁阻塞与复用
+  PipelineOptions options{.blockSize = 7, .queueDepth = 2, .chunkSize = 256};
+  auto pipelined = runPipelined(source, formatter, options);
+  auto tokens = tokenize(source);
+
+  EXPECT_EQ(pipelined, formatter.formatTokens(tokens, sm_));
+}
+
+TEST_F(TokenPipelineTest, JsonCountWrittenAsTrailer) {
+  JsonFormatter formatter;
+
+  auto output = runPipelined("let x", formatter);
+
+  EXPECT_EQ(output.rfind(R"({"success":true,"tokens":[)", 0), 0u);
+  EXPECT_NE(output.find(R"(],"count":3})"), std::string::npos);
+}
+
+TEST_F(TokenPipelineTest, TextBodyMatchesSequentialOutput) {
+  auto source = makeSource(300);
+  TextFormatter formatter;
+
+  PipelineOptions options{.blockSize = 13, .queueDepth = 2, .chunkSize = 128};
+  auto pipelined = runPipelined(source, formatter, options, true);
+  auto tokens = tokenize(source, true);
+
+  std::string body;
+  {
+    StringSink sink(body);
+    formatter.writeTokenRange(tokens, sm_, sink, 0);
+  }
+  EXPECT_EQ(pipelined,
+            body + "\nTotal tokens: " + std::to_string(tokens.size()) + "\n");
+}
+
+TEST_F(TokenPipelineTest, RunsSequentiallyWithoutEnoughWorkers) {
+  auto source = makeSource(200);
+  JsonFormatter formatter;
+
+  PipelineOptions options{.blockSize = 11, .queueDepth = 2, .chunkSize = 128};
+  auto staged = runPipelined(source, formatter, options);
+  auto sequential = runPipelined(source, formatter, options, false,
+                                 {.threads = 2});
+  auto deterministic = runPipelined(source, formatter, options, false,
+                                    {.deterministic = true});
+
+  EXPECT_EQ(sequential, staged);
+  EXPECT_EQ(deterministic, staged);
+}
+
+TEST_F(TokenPipelineTest, WriterExceptionIsRethrownOnCaller) {
+  /// 第一次写出即抛出的输出汇
+  class ThrowingSink final : public OutputSink {
+  public:
+    ThrowingSink() : OutputSink(64) {}
+
+  protected:
+    bool drain(std::string_view) override {
+      throw std::runtime_error("sink failed");
+    }
+  };
+
+  auto id = sm_.addBuffer(makeSource(500), "throwing.zero");
+  lexer::Lexer lex(sm_, id);
+  JsonFormatter formatter(JsonLayout::Lines);
+  TaskScheduler scheduler({.threads = 3});
+  ThrowingSink sink;
+  TokenPipeline pipeline({.blockSize = 5, .queueDepth = 2, .chunkSize = 64});
+
+  EXPECT_THROW(
+      (void)pipeline.run(lex, false, formatter, sm_, sink, scheduler),
+      std::runtime_error);
+}
+
+TEST_F(TokenPipelineTest, EmptySourceProducesEof) {
+  JsonFormatter formatter(JsonLayout::Lines);
+
+  auto output = runPipelined("", formatter);
+
+  EXPECT_NE(output.find("TOKEN_EOF"), std::string::npos);
+}
+
+} // namespace
+} // namespace czc::cli
@@ -0,0 +1,243 @@
+/**
+ * @file query_test.cpp
+ * @brief 查询数据库单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/query/query_database.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace czc::cli {
+namespace {
+
+namespace fs = std::filesystem;
+
+class QueryDatabaseTest : public ::testing::Test {
+protected:
+  fs::path testDir_;
+  lexer::SourceManager sm_;
+
+  void SetUp() override {
+    testDir_ = fs::temp_directory_path() / "czc_query_test";
+    fs::remove_all(testDir_);
+    fs::create_directories(testDir_);
+  }
+
+  void TearDown() override { fs::remove_all(testDir_); }
+
+  fs::path writeFile(std::string_view name, std::string_view content) {
+    auto path = testDir_ / name;
+    std::ofstream ofs(path);
+    ofs << content;
+    return path;
+  }
+
+  static std::vector<std::string> importsOf(QueryDatabase &db,
+                                            const fs::path &path) {
+    auto deps = db.deps(path);
+    EXPECT_TRUE(deps.has_value()) << deps.error().message;
+    return deps.has_value() ? deps.value()->imports
+                            : std::vector<std::string>{};
+  }
+};
+
+TEST_F(QueryDatabaseTest, MemoizesUntilInputChanges) {
+  QueryDatabase db(sm_);
+  db.setFileContents("a.zero", "let a = 1;");
+
+  auto first = db.tokens("a.zero");
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(db.stats().executed, 1u);
+
+  db.resetStats();
+  auto second = db.tokens("a.zero");
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(second.value(), first.value()); // 同一份结果
+  EXPECT_EQ(db.stats().executed, 0u);
+
+  // 设置相同内容不产生新修订
+  auto revision = db.revision();
+  EXPECT_FALSE(db.setFileContents("a.zero", "let a = 1;"));
+  EXPECT_EQ(db.revision(), revision);
+
+  EXPECT_TRUE(db.setFileContents("a.zero", "let a = 2;"));
+  auto third = db.tokens("a.zero");
+  ASSERT_TRUE(third.has_value());
+  EXPECT_NE(third.value(), first.value());
+  EXPECT_EQ(db.stats().executed, 1u);
+}
+
+TEST_F(QueryDatabaseTest, CollectsImports) {
+  QueryDatabase db(sm_);
+  db.setFileContents("m.zero", "import \"std/io\";\n"
+                               "import core.mem as mem;\n"
+                               "let x = 1;");
+  EXPECT_EQ(importsOf(db, "m.zero"),
+            (std::vector<std::string>{"std/io", "core.mem"}));
+}
+
+TEST_F(QueryDatabaseTest, UnchangedDepsCutOffEarly) {
+  QueryDatabase db(sm_);
+  db.setFileContents("m.zero", "import \"a\";\nlet x = 1;");
+  ASSERT_EQ(importsOf(db, "m.zero"), std::vector<std::string>{"a"});
+
+  // 只改空白：tokens 重新执行，deps 指纹不变
+  db.resetStats();
+  db.setFileContents("m.zero", "import \"a\";\n\n  let x = 1;");
+  ASSERT_EQ(importsOf(db, "m.zero"), std::vector<std::string>{"a"});
+  EXPECT_EQ(db.stats().executed, 2u);
+  EXPECT_EQ(db.stats().cutoff, 1u);
+
+  db.resetStats();
+  db.setFileContents("m.zero", "import \"b\";\nlet x = 1;");
+  EXPECT_EQ(importsOf(db, "m.zero"), std::vector<std::string>{"b"});
+  EXPECT_EQ(db.stats().cutoff, 0u);
+}
+
+TEST_F(QueryDatabaseTest, RestoredContentCutsOffTokens) {
+  QueryDatabase db(sm_);
+  db.setFileContents("a.zero", "let a = 1;");
+  ASSERT_TRUE(db.deps("a.zero").has_value());
+  db.setFileContents("a.zero", "let a = 2;");
+  ASSERT_TRUE(db.deps("a.zero").has_value());
+
+  // A -> B -> A：tokens 与 deps 都因指纹相同而截止
+  db.resetStats();
+  db.setFileContents("a.zero", "let a = 2;\n");
+  db.setFileContents("a.zero", "let a = 2;");
+  ASSERT_TRUE(db.deps("a.zero").has_value());
+  EXPECT_EQ(db.stats().executed, 1u);
+  EXPECT_EQ(db.stats().cutoff, 1u);
+}
+
+TEST_F(QueryDatabaseTest, RebindKeepsOnlyCurrentContents) {
+  QueryDatabase db(sm_);
+  db.setFileContents("a.zero", "import x; let a = 1;");
+  db.setFileContents("a.zero", "import y; let a = 2;");
+  ASSERT_TRUE(db.deps("a.zero").has_value());
+  ASSERT_EQ(sm_.bufferCount(), 2u);
+
+  lexer::SourceManager fresh;
+  db.rebind(fresh);
+  EXPECT_EQ(fresh.bufferCount(), 1u);
+
+  // 依赖结果沿用；Token 序列在新缓冲区上重新计算，但指纹不变
+  db.resetStats();
+  EXPECT_EQ(importsOf(db, "a.zero"), std::vector<std::string>{"y"});
+  EXPECT_EQ(db.stats().executed, 0u);
+  auto tokens = db.tokens("a.zero");
+  ASSERT_TRUE(tokens.has_value());
+  EXPECT_EQ(fresh.getSource(tokens.value()->buffer), "import y; let a = 2;");
+  EXPECT_EQ(db.stats().cutoff, 1u);
+
+  EXPECT_FALSE(db.setFileContents("a.zero", "import y; let a = 2;"));
+  EXPECT_TRUE(db.setFileContents("a.zero", "import z;"));
+  EXPECT_EQ(importsOf(db, "a.zero"), std::vector<std::string>{"z"});
+  EXPECT_EQ(sm_.bufferCount(), 2u);
+}
+
+TEST_F(QueryDatabaseTest, ReportsMissingInputs) {
+  QueryDatabase db(sm_);
+  auto missing = db.tokens("none.zero");
+  ASSERT_FALSE(missing.has_value());
+  EXPECT_EQ(missing.error().code, "E001");
+
+  auto unreadable = db.loadFile(testDir_ / "none.zero");
+  ASSERT_FALSE(unreadable.has_value());
+  EXPECT_EQ(unreadable.error().code, "E001");
+
+  db.setFileContents("a.zero", "let a = 1;");
+  ASSERT_TRUE(db.deps("a.zero").has_value());
+  db.removeFile("a.zero");
+  auto removed = db.deps("a.zero");
+  ASSERT_FALSE(removed.has_value());
+  EXPECT_EQ(removed.error().code, "E001");
+}
+
+TEST_F(QueryDatabaseTest, PrefetchMatchesSequential) {
+  std::vector<fs::path> files;
+  for (int i = 0; i < 24; ++i) {
+    files.push_back(writeFile("f" + std::to_string(i) + ".zero",
+                              "import \"m" + std::to_string(i % 5) +
+                                  "\";\nlet v = " + std::to_string(i) + ";"));
+  }
+
+  QueryDatabase parallel(sm_);
+  for (const auto &file : files) {
+    ASSERT_TRUE(parallel.loadFile(file).has_value());
+  }
+  TaskScheduler scheduler({.threads = 4});
+  parallel.prefetch(files, scheduler);
+  EXPECT_EQ(parallel.stats().executed, 2 * files.size());
+
+  lexer::SourceManager sm;
+  QueryDatabase sequential(sm);
+  for (const auto &file : files) {
+    ASSERT_TRUE(sequential.loadFile(file).has_value());
+  }
+
+  parallel.resetStats();
+  for (const auto &file : files) {
+    EXPECT_EQ(importsOf(parallel, file), importsOf(sequential, file));
+  }
+  EXPECT_EQ(parallel.stats().executed, 0u);
+}
+
+TEST_F(QueryDatabaseTest, PersistsAcrossRuns) {
+  auto a = writeFile("a.zero", "import \"b\";\nlet a = 1;");
+  auto b = writeFile("b.zero", "let b = 2;");
+  auto cache = testDir_ / "queries.json";
+  {
+    QueryDatabase db(sm_);
+    ASSERT_TRUE(db.loadFile(a).has_value());
+    ASSERT_TRUE(db.loadFile(b).has_value());
+    ASSERT_TRUE(db.deps(a).has_value());
+    ASSERT_TRUE(db.deps(b).has_value());
+    ASSERT_TRUE(db.save(cache).has_value());
+  }
+  EXPECT_FALSE(fs::exists(cache.string() + ".tmp"));
+
+  // 内容未变的文件直接复用缓存中的 deps，不重新词法分析
+  writeFile("b.zero", "let b = 3;");
+  lexer::SourceManager sm;
+  QueryDatabase db(sm);
+  ASSERT_TRUE(db.load(cache).has_value());
+  auto same = db.loadFile(a);
+  ASSERT_TRUE(same.has_value());
+  EXPECT_FALSE(same.value());
+  EXPECT_TRUE(db.loadFile(b).value());
+
+  EXPECT_EQ(importsOf(db, a), std::vector<std::string>{"b"});
+  EXPECT_EQ(db.stats().executed, 0u);
+  EXPECT_TRUE(importsOf(db, b).empty());
+  EXPECT_EQ(db.stats().executed, 2u);
+
+  // 只保存了指纹的 tokens 在需要时重新计算
+  auto tokens = db.tokens(a);
+  ASSERT_TRUE(tokens.has_value());
+  EXPECT_FALSE(tokens.value()->tokens.empty());
+}
+
+TEST_F(QueryDatabaseTest, RejectsInvalidCache) {
+  QueryDatabase db(sm_);
+  EXPECT_TRUE(db.load(testDir_ / "missing.json").has_value());
+
+  auto garbage = writeFile("garbage.json", "{not json");
+  auto loaded = db.load(garbage);
+  ASSERT_FALSE(loaded.has_value());
+  EXPECT_EQ(loaded.error().code, "E009");
+
+  auto future = writeFile("future.json",
+                          R"({"version":99,"revision":"1","queries":[]})");
+  loaded = db.load(future);
+  ASSERT_FALSE(loaded.has_value());
+  EXPECT_EQ(loaded.error().code, "E009");
+}
+
+} // namespace
+} // namespace czc::cli
@@ -0,0 +1,360 @@
+/**
+ * @file watch_test.cpp
+ * @brief 监视模式单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/cli/driver.hpp"
+#include "czc/cli/watch/file_watcher.hpp"
+#include "czc/cli/watch/watch_lexer.hpp"
+#include "czc/common/json_reader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+namespace czc::cli {
+namespace {
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+#if CZC_PLATFORM_LINUX
+
+class WatchTest : public ::testing::Test {
+protected:
+  fs::path testDir_;
+
+  void SetUp() override {
+    testDir_ = fs::temp_directory_path() / "czc_watch_test";
+    fs::remove_all(testDir_);
+    fs::create_directories(testDir_);
+  }
+
+  void TearDown() override { fs::remove_all(testDir_); }
+
+  fs::path writeFile(const fs::path &relative, std::string_view content) {
+    auto path = testDir_ / relative;
+    fs::create_directories(path.parent_path());
+    std::ofstream ofs(path);
+    ofs << content;
+    return path;
+  }
+
+  static std::unique_ptr<FileWatcher> makeWatcher() {
+    auto watcher = FileWatcher::create();
+    EXPECT_TRUE(watcher.has_value()) << watcher.error().message;
+    return watcher.has_value() ? std::move(watcher.value()) : nullptr;
+  }
+
+  /// 解析 NDJSON 输出
+  static std::vector<JsonValue> parseRecords(const std::string &ndjson) {
+    std::vector<JsonValue> records;
+    std::istringstream lines(ndjson);
+    std::string line;
+    while (std::getline(lines, line)) {
+      auto record = parseJson(line);
+      EXPECT_TRUE(record.has_value()) << line;
+      if (record.has_value()) {
+        records.push_back(std::move(record.value()));
+      }
+    }
+    return records;
+  }
+};
+
+TEST_F(WatchTest, WatcherReportsWritesAndRemovals) {
+  auto watcher = makeWatcher();
+  ASSERT_TRUE(watcher);
+  ASSERT_TRUE(watcher->addDirectory(testDir_).has_value());
+
+  // 同一文件的多次写入合并为一个事件
+  auto a = writeFile("a.zero", "let a = 1;");
+  writeFile("a.zero", "let a = 2;");
+  auto events = watcher->next(20ms);
+  ASSERT_TRUE(events.has_value()) << events.error().message;
+  ASSERT_EQ(events->size(), 1u);
+  EXPECT_EQ((*events)[0].path, a);
+  EXPECT_EQ((*events)[0].kind, FileEventKind::Changed);
+
+  fs::remove(a);
+  events = watcher->next(20ms);
+  ASSERT_TRUE(events.has_value());
+  ASSERT_EQ(events->size(), 1u);
+  EXPECT_EQ((*events)[0].kind, FileEventKind::Removed);
+}
+
+TEST_F(WatchTest, WatcherFollowsNewSubdirectories) {
+  auto watcher = makeWatcher();
+  ASSERT_TRUE(watcher);
+  ASSERT_TRUE(watcher
+                  ->addDirectory(testDir_, true,
+                                 [](const fs::path &dir) {
+                                   return dir.filename() != "build";
+                                 })
+                  .has_value());
+
+  // 监视建立之前已写入新目录的文件也要报告
+  auto nested = writeFile("src/lib/b.zero", "let b = 1;");
+  writeFile("build/out.zero", "x");
+  auto events = watcher->next(20ms);
+  ASSERT_TRUE(events.has_value());
+  EXPECT_TRUE(std::any_of(events->begin(), events->end(), [&](auto &event) {
+    return event.path == nested && event.kind == FileEventKind::Changed;
+  }));
+
+  // 被过滤的目录不监视
+  writeFile("build/out.zero", "y");
+  writeFile("src/lib/b.zero", "let b = 2;");
+  events = watcher->next(20ms);
+  ASSERT_TRUE(events.has_value());
+  ASSERT_EQ(events->size(), 1u);
+  EXPECT_EQ((*events)[0].path, nested);
+}
+
+TEST_F(WatchTest, InterruptWakesWatcher) {
+  auto watcher = makeWatcher();
+  ASSERT_TRUE(watcher);
+  ASSERT_TRUE(watcher->addDirectory(testDir_).has_value());
+
+  std::jthread waker([&] {
+    std::this_thread::sleep_for(20ms);
+    watcher->interrupt();
+  });
+  auto events = watcher->next(20ms);
+  ASSERT_TRUE(events.has_value());
+  EXPECT_TRUE(events->empty());
+  EXPECT_TRUE(watcher->interrupted());
+}
+
+TEST_F(WatchTest, RelexesOnlyChangedContent) {
+  auto a = writeFile("src/a.zero", "let a = 1;");
+  auto b = writeFile("src/b.zero", "let b = 1;");
+  writeFile("src/build/gen.zero", "let g = 1;");
+
+  CompilerContext ctx;
+  WatchOptions options;
+  options.inputs.exclude = {"build"};
+  WatchLexer watch(ctx, options);
+  auto watcher = makeWatcher();
+  ASSERT_TRUE(watcher);
+  TaskScheduler scheduler({.threads = 2});
+
+  std::string output;
+  {
+    StringSink sink(output);
+    std::vector<std::string> args{(testDir_ / "src").string()};
+    auto initial = watch.start(args, *watcher, scheduler, sink);
+    ASSERT_TRUE(initial.has_value()) << initial.error().message;
+    EXPECT_EQ(initial->lexed, 2u);
+  }
+  EXPECT_EQ(parseRecords(output).size(), 2u);
+  EXPECT_EQ(watch.fileCount(), 2u);
+
+  // 仅修改时间变化：不重新分析，也不输出
+  auto run = [&](std::vector<FileEvent> events) {
+    output.clear();
+    StringSink sink(output);
+    auto summary = watch.apply(events, sink);
+    sink.flush();
+    return summary;
+  };
+  auto executed = watch.queries().stats().executed;
+  auto summary = run({{a, FileEventKind::Changed}});
+  EXPECT_EQ(summary.unchanged, 1u);
+  EXPECT_EQ(summary.lexed, 0u);
+  EXPECT_TRUE(output.empty());
+  EXPECT_EQ(watch.queries().stats().executed, executed);
+
+  // 内容变化的文件重新分析；过滤掉的文件忽略；新文件加入
+  writeFile("src/b.zero", "let b = 12;");
+  auto c = writeFile("src/c.zero", "let c = 1;");
+  auto gen = writeFile("src/build/gen.zero", "let g = 2;");
+  auto notes = writeFile("src/notes.txt", "todo");
+  summary = run({{b, FileEventKind::Changed},
+                 {gen, FileEventKind::Changed},
+                 {notes, FileEventKind::Changed},
+                 {c, FileEventKind::Changed}});
+  EXPECT_EQ(summary.lexed, 2u);
+  auto records = parseRecords(output);
+  ASSERT_EQ(records.size(), 2u);
+  EXPECT_EQ(records[0]["file"].asString(), b.string());
+  EXPECT_EQ(records[0]["event"].asString(), "lexed");
+  EXPECT_TRUE(records[0]["result"]["success"].asBool());
+  EXPECT_EQ(records[1]["file"].asString(), c.string());
+  EXPECT_EQ(watch.fileCount(), 3u);
+
+  // 删除目录时移除其下全部文件
+  summary = run({{testDir_ / "src", FileEventKind::Removed}});
+  EXPECT_EQ(summary.removed, 3u);
+  records = parseRecords(output);
+  ASSERT_EQ(records.size(), 3u);
+  EXPECT_EQ(records[0]["event"].asString(), "removed");
+  EXPECT_EQ(watch.fileCount(), 0u);
+}
+
+TEST_F(WatchTest, CompactsSourcesInLongSessions) {
+  auto a = writeFile("src/a.zero", "let a = 0;");
+  auto b = writeFile("src/b.zero", "let b = 1;");
+  CompilerContext ctx;
+  WatchLexer watch(ctx, {});
+  auto watcher = makeWatcher();
+  ASSERT_TRUE(watcher);
+  TaskScheduler scheduler({.deterministic = true});
+
+  std::string output;
+  {
+    StringSink sink(output);
+    std::vector<std::string> args{(testDir_ / "src").string()};
+    ASSERT_TRUE(watch.start(args, *watcher, scheduler, sink).has_value());
+  }
+
+  // 每次保存新增一个缓冲区；超过上限后只保留各文件的当前内容
+  for (std::size_t i = 1; i <= WatchLexer::kMaxBuffers; ++i) {
+    writeFile("src/a.zero", "let a = " + std::to_string(i) + ";");
+    output.clear();
+    StringSink sink(output);
+    std::vector<FileEvent> events{{a, FileEventKind::Changed}};
+    auto summary = watch.apply(events, sink);
+    ASSERT_EQ(summary.lexed, 1u);
+  }
+  EXPECT_LT(watch.sources().bufferCount(), WatchLexer::kMaxBuffers);
+  auto records = parseRecords(output);
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_NE(output.find(std::format("\"{}\"", WatchLexer::kMaxBuffers)),
+            std::string::npos);
+
+  // 换用后未变化的文件仍按内容哈希跳过，变化时仍能正确分析
+  output.clear();
+  {
+    StringSink sink(output);
+    std::vector<FileEvent> events{{b, FileEventKind::Changed}};
+    EXPECT_EQ(watch.apply(events, sink).unchanged, 1u);
+  }
+  EXPECT_TRUE(output.empty());
+
+  writeFile("src/b.zero", "let b = 2 +;");
+  {
+    StringSink sink(output);
+    std::vector<FileEvent> events{{b, FileEventKind::Changed}};
+    EXPECT_EQ(watch.apply(events, sink).lexed, 1u);
+  }
+  records = parseRecords(output);
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_NE(output.find(R"("value":"+")"), std::string::npos);
+}
+
+TEST_F(WatchTest, RecordsCarryDiagnostics) {
+  auto bad = writeFile("bad.zero", "let s = \"open");
+  CompilerContext ctx;
+  WatchLexer watch(ctx, {});
+  auto watcher = makeWatcher();
+  ASSERT_TRUE(watcher);
+  TaskScheduler scheduler({.deterministic = true});
+
+  std::string output;
+  {
+    StringSink sink(output);
+    std::vector<std::string> args{bad.string()};
+    auto initial = watch.start(args, *watcher, scheduler, sink);
+    ASSERT_TRUE(initial.has_value());
+    EXPECT_EQ(initial->failed, 1u);
+  }
+  auto records = parseRecords(output);
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_EQ(records[0]["exitCode"].asInt(), 1);
+  EXPECT_TRUE(records[0]["result"].isNull());
+  const auto &diagnostics = records[0]["diagnostics"].asArray();
+  ASSERT_FALSE(diagnostics.empty());
+  EXPECT_EQ(diagnostics[0]["code"].asString(), "L1012");
+
+  // 修复后诊断清空；同一错误再次出现时仍会报告（去重按记录）
+  auto relex = [&](std::string_view content) {
+    writeFile("bad.zero", content);
+    output.clear();
+    {
+      StringSink sink(output);
+      std::vector<FileEvent> events{{bad, FileEventKind::Changed}};
+      (void)watch.apply(events, sink);
+    }
+    return parseRecords(output);
+  };
+  records = relex("let s = \"closed\";");
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_EQ(records[0]["exitCode"].asInt(), 0);
+  EXPECT_TRUE(records[0]["diagnostics"].asArray().empty());
+
+  records = relex("let s = \"open");
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_EQ(records[0]["diagnostics"].asArray().size(), 1u);
+}
+
+TEST_F(WatchTest, DriverStreamsRecordsUntilInterrupted) {
+  auto a = writeFile("src/a.zero", "let a = 1;");
+  auto output = testDir_ / "out.ndjson";
+
+  Driver driver;
+  driver.setQuiet(true);
+  driver.setOutputFile(output);
+  auto watcher = makeWatcher();
+  ASSERT_TRUE(watcher);
+
+  auto readOutput = [&] {
+    std::ifstream ifs(output);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+  };
+  auto waitForLines = [&](std::size_t count) {
+    for (int i = 0; i < 400; ++i) {
+      auto text = readOutput();
+      if (static_cast<std::size_t>(std::count(text.begin(), text.end(),
+                                              '\n')) >= count) {
+        return true;
+      }
+      std::this_thread::sleep_for(5ms);
+    }
+    return false;
+  };
+
+  int exitCode = -1;
+  std::vector<std::string> args{(testDir_ / "src").string()};
+  WatchOptions options;
+  options.debounce = 10ms;
+  std::jthread runner([&] {
+    exitCode = driver.runLexerWatch(args, *watcher, options);
+  });
+
+  ASSERT_TRUE(waitForLines(1));
+  writeFile("src/a.zero", "let a = 12;");
+  bool relexed = waitForLines(2);
+  watcher->interrupt();
+  runner.join();
+
+  ASSERT_TRUE(relexed);
+  EXPECT_EQ(exitCode, 0);
+  auto records = parseRecords(readOutput());
+  ASSERT_EQ(records.size(), 2u);
+  EXPECT_EQ(records[1]["file"].asString(), a.string());
+  EXPECT_NE(readOutput().find("\"12\""), std::string::npos);
+}
+
+#else
+
+TEST(WatchTest, RequiresInotify) {
+  auto watcher = FileWatcher::create();
+  ASSERT_FALSE(watcher.has_value());
+  EXPECT_EQ(watcher.error().code, "E010");
+}
+
+#endif
+
+} // namespace
+} // namespace czc::cli
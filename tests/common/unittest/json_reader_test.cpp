@@ -0,0 +1,79 @@
+/**
+ * @file json_reader_test.cpp
+ * @brief 轻量 JSON 解析单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/json_reader.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace czc {
+namespace {
+
+TEST(JsonReaderTest, ParsesNestedMessage) {
+  auto parsed = parseJson(R"( {"jsonrpc":"2.0","id":7,"method":"m",
+      "params":{"list":[1,-2.5,true,null],"flag":false}} )");
+  ASSERT_TRUE(parsed.has_value()) << parsed.error().message;
+
+  const auto &value = parsed.value();
+  EXPECT_EQ(value["jsonrpc"].asString(), "2.0");
+  EXPECT_EQ(value["id"].asInt(), 7);
+  const auto &list = value["params"]["list"].asArray();
+  ASSERT_EQ(list.size(), 4u);
+  EXPECT_DOUBLE_EQ(list[1].asNumber(), -2.5);
+  EXPECT_TRUE(list[2].asBool());
+  EXPECT_TRUE(list[3].isNull());
+  EXPECT_FALSE(value["params"]["flag"].asBool(true));
+}
+
+TEST(JsonReaderTest, MissingMembersYieldDefaults) {
+  auto parsed = parseJson(R"({"a":1})");
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_EQ(parsed->find("b"), nullptr);
+  EXPECT_TRUE((*parsed)["b"]["c"].isNull());
+  EXPECT_EQ((*parsed)["b"].asInt(42), 42);
+  EXPECT_TRUE((*parsed)["a"].asString().empty());
+}
+
+TEST(JsonReaderTest, DecodesEscapes) {
+  auto parsed = parseJson(R"("a\"\\\/\n\té名😀\udc00")");
+  ASSERT_TRUE(parsed.has_value()) << parsed.error().message;
+  EXPECT_EQ(parsed->asString(),
+            "a\"\\/\n\t\xC3\xA9\xE5\x90\x8D\xF0\x9F\x98\x80\xEF\xBF\xBD");
+}
+
+TEST(JsonReaderTest, RejectsMalformedInput) {
+  for (const char *text :
+       {"", "{", "[1,]", R"({"a" 1})", "01x", "+1", "tru", R"("abc)",
+        "\"a\x01\"", R"("\x")", "[1] 2"}) {
+    auto parsed = parseJson(text);
+    ASSERT_FALSE(parsed.has_value()) << text;
+    EXPECT_EQ(parsed.error().code, "E007");
+  }
+}
+
+TEST(JsonReaderTest, RejectsExcessiveNesting) {
+  std::string deep(1000, '[');
+  deep.append(1000, ']');
+  EXPECT_FALSE(parseJson(deep).has_value());
+}
+
+TEST(JsonReaderTest, WritesCompactJson) {
+  auto parsed =
+      parseJson(R"({ "id" : 12, "s" : "x\ny", "a" : [ 1.5 , null ] })");
+  ASSERT_TRUE(parsed.has_value());
+
+  std::string out;
+  {
+    StringSink sink(out);
+    writeJson(sink, parsed.value());
+  }
+  EXPECT_EQ(out, R"({"id":12,"s":"x\ny","a":[1.5,null]})");
+}
+
+} // namespace
+} // namespace czc
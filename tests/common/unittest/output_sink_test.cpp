@@ -0,0 +1,187 @@
+/**
+ * @file output_sink_test.cpp
+ * @brief OutputSink 与 JSON 转义写入单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/json_writer.hpp"
+#include "czc/common/output_sink.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace czc {
+namespace {
+
+// ============================================================================
+// StringSink 测试
+// ============================================================================
+
+TEST(OutputSinkTest, StringSinkCollectsWrites) {
+  std::string out;
+  {
+    StringSink sink(out);
+    sink.write("hello");
+    sink.put(' ');
+    sink.writeInt(42);
+  }
+  EXPECT_EQ(out, "hello 42");
+}
+
+TEST(OutputSinkTest, SmallBufferDrainsInOrder) {
+  std::string out;
+  StringSink sink(out, 32);
+
+  std::string expected;
+  for (int i = 0; i < 100; ++i) {
+    sink.writeInt(i);
+    sink.put(',');
+    expected += std::to_string(i) + ",";
+  }
+  sink.flush();
+
+  EXPECT_EQ(out, expected);
+  EXPECT_EQ(sink.bytesDrained(), expected.size());
+}
+
+TEST(OutputSinkTest, LargeWriteBypassesBuffer) {
+  std::string out;
+  StringSink sink(out, 32);
+  std::string large(1000, 'x');
+
+  sink.write("ab");
+  sink.write(large);
+  sink.flush();
+
+  EXPECT_EQ(out, "ab" + large);
+}
+
+TEST(OutputSinkTest, WriteIntExtremes) {
+  std::string out;
+  {
+    StringSink sink(out);
+    sink.writeInt(std::numeric_limits<std::int64_t>::min());
+    sink.put(' ');
+    sink.writeInt(std::numeric_limits<std::uint64_t>::max());
+  }
+  EXPECT_EQ(out, "-9223372036854775808 18446744073709551615");
+}
+
+// ============================================================================
+// FdSink 测试
+// ============================================================================
+
+TEST(OutputSinkTest, FdSinkWritesFile) {
+  auto path = std::filesystem::temp_directory_path() / "czc_output_sink.txt";
+  {
+    auto sink = FdSink::open(path);
+    ASSERT_TRUE(sink.has_value());
+    (*sink)->write("line 1\n");
+    (*sink)->writeInt(2);
+    (*sink)->flush();
+    EXPECT_TRUE((*sink)->ok());
+  }
+
+  std::ifstream ifs(path);
+  std::string content((std::istreambuf_iterator<char>(ifs)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_EQ(content, "line 1\n2");
+  std::filesystem::remove(path);
+}
+
+TEST(OutputSinkTest, FdSinkWritesVectored) {
+  auto path = std::filesystem::temp_directory_path() / "czc_output_writev.txt";
+  std::vector<std::string> parts;
+  std::vector<std::string_view> views;
+  std::string expected = "head:";
+  for (int i = 0; i < 200; ++i) {
+    parts.push_back(std::to_string(i) + ";");
+  }
+  for (const auto &part : parts) {
+    views.push_back(part);
+    expected += part;
+  }
+  {
+    auto sink = FdSink::open(path);
+    ASSERT_TRUE(sink.has_value());
+    (*sink)->write("head:");
+    (*sink)->writeVectored(views);
+    (*sink)->flush();
+    EXPECT_TRUE((*sink)->ok());
+  }
+
+  std::ifstream ifs(path);
+  std::string content((std::istreambuf_iterator<char>(ifs)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_EQ(content, expected);
+  std::filesystem::remove(path);
+}
+
+TEST(OutputSinkTest, FdSinkOpenFailure) {
+  auto sink = FdSink::open("/nonexistent_dir_czc/out.txt");
+  EXPECT_FALSE(sink.has_value());
+}
+
+TEST(OutputSinkTest, OstreamSinkBuffersUntilFlush) {
+  std::ostringstream out;
+  OstreamSink sink(out, 16);
+
+  sink.write("abc");
+  EXPECT_TRUE(out.str().empty());
+
+  sink.write("0123456789abcdef"); // 超出容量，先排空已缓冲内容
+  sink.flush();
+  EXPECT_EQ(out.str(), "abc0123456789abcdef");
+  EXPECT_TRUE(sink.ok());
+}
+
+// ============================================================================
+// JSON 转义测试
+// ============================================================================
+
+TEST(JsonWriterTest, PlainStringUnchanged) {
+  std::string out;
+  {
+    StringSink sink(out);
+    writeJsonString(sink, "hello world");
+  }
+  EXPECT_EQ(out, R"("hello world")");
+}
+
+TEST(JsonWriterTest, EscapesSpecialCharacters) {
+  std::string out;
+  {
+    StringSink sink(out);
+    writeJsonEscaped(sink, "a\"b\\c\nd\te\r\b\f");
+  }
+  EXPECT_EQ(out, R"(a\"b\\c\nd\te\r\b\f)");
+}
+
+TEST(JsonWriterTest, EscapesControlCharactersAsUnicode) {
+  std::string out;
+  {
+    StringSink sink(out);
+    writeJsonEscaped(sink, std::string_view("\x01\x1f", 2));
+  }
+  EXPECT_EQ(out, R"(\u0001\u001f)");
+}
+
+TEST(JsonWriterTest, PassesThroughUtf8) {
+  std::string out;
+  {
+    StringSink sink(out);
+    writeJsonEscaped(sink, "变量");
+  }
+  EXPECT_EQ(out, "变量");
+}
+
+} // namespace
+} // namespace czc
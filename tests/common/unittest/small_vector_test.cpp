@@ -0,0 +1,115 @@
+/**
+ * @file small_vector_test.cpp
+ * @brief SmallVector 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/small_vector.hpp"
+
+#include <gtest/gtest.h>
+#include <span>
+#include <string>
+
+namespace czc {
+namespace {
+
+/// 统计存活实例数，检查构造与析构配对
+struct Tracked {
+  static inline int alive = 0;
+  std::string value;
+
+  explicit Tracked(std::string v) : value(std::move(v)) { ++alive; }
+  Tracked(const Tracked &other) : value(other.value) { ++alive; }
+  Tracked(Tracked &&other) noexcept : value(std::move(other.value)) {
+    ++alive;
+  }
+  auto operator=(const Tracked &) -> Tracked & = default;
+  auto operator=(Tracked &&) noexcept -> Tracked & = default;
+  ~Tracked() { --alive; }
+};
+
+TEST(SmallVectorTest, StaysInlineUpToCapacity) {
+  SmallVector<int, 2> vec;
+  EXPECT_TRUE(vec.empty());
+  vec.push_back(1);
+  vec.push_back(2);
+
+  EXPECT_TRUE(vec.isInline());
+  EXPECT_EQ(vec.size(), 2u);
+  EXPECT_EQ(vec.front(), 1);
+  EXPECT_EQ(vec.back(), 2);
+}
+
+TEST(SmallVectorTest, SpillsToHeapPreservingOrder) {
+  SmallVector<int, 2> vec;
+  for (int i = 0; i < 10; ++i) {
+    vec.push_back(i);
+  }
+
+  EXPECT_FALSE(vec.isInline());
+  ASSERT_EQ(vec.size(), 10u);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(vec[static_cast<size_t>(i)], i);
+  }
+}
+
+TEST(SmallVectorTest, EmplaceBackMayReferenceOwnElement) {
+  SmallVector<std::string, 1> vec;
+  vec.emplace_back("first element long enough to avoid SSO");
+  vec.push_back(vec[0]);
+
+  ASSERT_EQ(vec.size(), 2u);
+  EXPECT_EQ(vec[1], vec[0]);
+}
+
+TEST(SmallVectorTest, CopyAndMoveInlineAndHeap) {
+  for (size_t count : {1u, 5u}) {
+    SmallVector<std::string, 2> source;
+    for (size_t i = 0; i < count; ++i) {
+      source.emplace_back(std::to_string(i));
+    }
+
+    SmallVector<std::string, 2> copy(source);
+    EXPECT_EQ(copy.size(), count);
+
+    SmallVector<std::string, 2> moved(std::move(source));
+    EXPECT_EQ(moved.size(), count);
+    EXPECT_TRUE(source.empty());
+    EXPECT_TRUE(source.isInline());
+
+    SmallVector<std::string, 2> assigned;
+    assigned.emplace_back("old");
+    assigned = std::move(moved);
+    ASSERT_EQ(assigned.size(), count);
+    EXPECT_EQ(assigned.back(), std::to_string(count - 1));
+
+    assigned = copy;
+    EXPECT_EQ(assigned.size(), count);
+  }
+}
+
+TEST(SmallVectorTest, DestroysEveryElement) {
+  {
+    SmallVector<Tracked, 2> vec;
+    for (int i = 0; i < 7; ++i) {
+      vec.emplace_back(std::to_string(i));
+    }
+    SmallVector<Tracked, 2> copy = vec;
+    SmallVector<Tracked, 2> moved = std::move(copy);
+    vec.pop_back();
+    EXPECT_EQ(Tracked::alive, 13);
+  }
+  EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST(SmallVectorTest, ConvertsToSpan) {
+  SmallVector<int, 4> vec{1, 2, 3};
+  std::span<const int> view = vec;
+  ASSERT_EQ(view.size(), 3u);
+  EXPECT_EQ(view[2], 3);
+}
+
+} // namespace
+} // namespace czc
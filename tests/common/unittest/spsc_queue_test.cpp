@@ -0,0 +1,101 @@
+/**
+ * @file spsc_queue_test.cpp
+ * @brief SpscQueue 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/spsc_queue.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace czc {
+namespace {
+
+TEST(SpscQueueTest, CapacityRoundsUpToPowerOfTwo) {
+  SpscQueue<int> queue(5);
+  EXPECT_EQ(queue.capacity(), 8u);
+}
+
+TEST(SpscQueueTest, FifoOrder) {
+  SpscQueue<int> queue(4);
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_TRUE(queue.push(2));
+  EXPECT_TRUE(queue.push(3));
+
+  EXPECT_EQ(queue.pop(), 1);
+  EXPECT_EQ(queue.pop(), 2);
+  EXPECT_EQ(queue.pop(), 3);
+}
+
+TEST(SpscQueueTest, TryPushFailsWhenFull) {
+  SpscQueue<int> queue(2);
+  int value = 1;
+  EXPECT_TRUE(queue.tryPush(value));
+  EXPECT_TRUE(queue.tryPush(value));
+  EXPECT_FALSE(queue.tryPush(value));
+  EXPECT_EQ(queue.tryPop(), 1);
+  EXPECT_TRUE(queue.tryPush(value));
+}
+
+TEST(SpscQueueTest, TryPopOnEmpty) {
+  SpscQueue<int> queue(2);
+  EXPECT_FALSE(queue.tryPop().has_value());
+}
+
+TEST(SpscQueueTest, CloseDrainsRemainingItems) {
+  SpscQueue<std::string> queue(4);
+  queue.push("a");
+  queue.push("b");
+  queue.close();
+
+  EXPECT_TRUE(queue.isClosed());
+  EXPECT_FALSE(queue.push("c"));
+  EXPECT_EQ(queue.pop(), "a");
+  EXPECT_EQ(queue.pop(), "b");
+  EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(SpscQueueTest, CloseWakesBlockedConsumer) {
+  SpscQueue<int> queue(2);
+  std::jthread consumer([&] { EXPECT_FALSE(queue.pop().has_value()); });
+  queue.close();
+}
+
+TEST(SpscQueueTest, CloseWakesBlockedProducer) {
+  SpscQueue<int> queue(1);
+  queue.push(1);
+  std::jthread producer([&] { EXPECT_FALSE(queue.push(2)); });
+  queue.close();
+}
+
+TEST(SpscQueueTest, ProducerConsumerTransfersAllItemsInOrder) {
+  constexpr int kCount = 100000;
+  SpscQueue<int> queue(16);
+  std::vector<int> received;
+  received.reserve(kCount);
+
+  {
+    std::jthread consumer([&] {
+      while (auto value = queue.pop()) {
+        received.push_back(*value);
+      }
+    });
+    for (int i = 0; i < kCount; ++i) {
+      ASSERT_TRUE(queue.push(i));
+    }
+    queue.close();
+  }
+
+  ASSERT_EQ(received.size(), static_cast<std::size_t>(kCount));
+  for (int i = 0; i < kCount; ++i) {
+    ASSERT_EQ(received[static_cast<std::size_t>(i)], i);
+  }
+}
+
+} // namespace
+} // namespace czc
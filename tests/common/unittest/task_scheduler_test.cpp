@@ -0,0 +1,142 @@
+/**
+ * @file task_scheduler_test.cpp
+ * @brief TaskScheduler 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/task_scheduler.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace czc {
+namespace {
+
+long fib(TaskScheduler &scheduler, int n) {
+  if (n < 12) {
+    return n < 2 ? n : fib(scheduler, n - 1) + fib(scheduler, n - 2);
+  }
+  long left = 0;
+  TaskGroup group(scheduler);
+  group.spawn([&] { left = fib(scheduler, n - 1); });
+  long right = fib(scheduler, n - 2);
+  group.wait();
+  return left + right;
+}
+
+TEST(TaskSchedulerTest, RunsEverySpawnedTask) {
+  TaskScheduler scheduler({.threads = 4});
+  EXPECT_EQ(scheduler.concurrency(), 4u);
+  EXPECT_FALSE(scheduler.deterministic());
+
+  std::atomic<int> count{0};
+  TaskGroup group(scheduler);
+  for (int i = 0; i < 1000; ++i) {
+    group.spawn([&] { count.fetch_add(1, std::memory_order_relaxed); });
+  }
+  group.wait();
+  EXPECT_EQ(count.load(), 1000);
+}
+
+TEST(TaskSchedulerTest, NestedForkJoinDoesNotDeadlock) {
+  TaskScheduler scheduler({.threads = 3});
+  EXPECT_EQ(fib(scheduler, 25), 75025);
+
+  TaskScheduler single({.deterministic = true});
+  EXPECT_EQ(fib(single, 20), 6765);
+}
+
+TEST(TaskSchedulerTest, WaitRethrowsFirstError) {
+  TaskScheduler scheduler({.threads = 2});
+  std::atomic<int> count{0};
+  TaskGroup group(scheduler);
+  group.spawn([] { throw std::runtime_error("boom"); });
+  for (int i = 0; i < 10; ++i) {
+    group.spawn([&] { count.fetch_add(1); });
+  }
+  EXPECT_THROW(group.wait(), std::runtime_error);
+  EXPECT_EQ(count.load(), 10);
+
+  // 异常已交付，组可以继续使用
+  group.spawn([&] { count.fetch_add(1); });
+  EXPECT_NO_THROW(group.wait());
+  EXPECT_EQ(count.load(), 11);
+}
+
+TEST(TaskSchedulerTest, ParallelForCoversRangeOnce) {
+  TaskScheduler scheduler({.threads = 4});
+  std::vector<std::atomic<int>> hits(10007);
+  scheduler.parallelFor(3, hits.size(), 64,
+                        [&](std::size_t lo, std::size_t hi) {
+                          EXPECT_LE(hi - lo, 64u);
+                          for (auto i = lo; i < hi; ++i) {
+                            hits[i].fetch_add(1, std::memory_order_relaxed);
+                          }
+                        });
+  for (std::size_t i = 0; i < hits.size(); ++i) {
+    EXPECT_EQ(hits[i].load(), i < 3 ? 0 : 1) << i;
+  }
+
+  EXPECT_THROW(scheduler.parallelFor(0, 1000, 1,
+                                     [](std::size_t lo, std::size_t) {
+                                       if (lo == 500) {
+                                         throw std::runtime_error("stop");
+                                       }
+                                     }),
+               std::runtime_error);
+}
+
+TEST(TaskSchedulerTest, DeterministicModeRunsInOrderOnCaller) {
+  TaskScheduler scheduler({.threads = 8, .deterministic = true});
+  EXPECT_TRUE(scheduler.deterministic());
+  EXPECT_EQ(scheduler.concurrency(), 1u);
+
+  const auto caller = std::this_thread::get_id();
+  std::vector<int> order;
+  TaskGroup group(scheduler);
+  for (int i = 0; i < 5; ++i) {
+    group.spawn([&, i] {
+      EXPECT_EQ(std::this_thread::get_id(), caller);
+      order.push_back(i);
+    });
+  }
+  EXPECT_TRUE(order.empty());
+  group.wait();
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4}));
+
+  std::vector<std::size_t> chunks;
+  scheduler.parallelFor(0, 10, 3, [&](std::size_t lo, std::size_t) {
+    chunks.push_back(lo);
+  });
+  EXPECT_EQ(chunks, (std::vector<std::size_t>{0, 3, 6, 9}));
+}
+
+TEST(TaskSchedulerTest, RunPendingExecutesQueuedTask) {
+  TaskScheduler scheduler({.deterministic = true});
+  EXPECT_FALSE(scheduler.runPending());
+
+  bool ran = false;
+  TaskGroup group(scheduler);
+  group.spawn([&] { ran = true; });
+  EXPECT_TRUE(scheduler.runPending());
+  EXPECT_TRUE(ran);
+  EXPECT_FALSE(scheduler.runPending());
+  group.wait();
+}
+
+TEST(TaskSchedulerTest, PinnedWorkersStillRunTasks) {
+  TaskScheduler scheduler({.threads = 2, .pinWorkers = true});
+  std::atomic<int> count{0};
+  scheduler.parallelFor(0, 256, 1, [&](std::size_t, std::size_t) {
+    count.fetch_add(1);
+  });
+  EXPECT_EQ(count.load(), 256);
+}
+
+} // namespace
+} // namespace czc
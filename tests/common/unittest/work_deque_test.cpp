@@ -0,0 +1,94 @@
+/**
+ * @file work_deque_test.cpp
+ * @brief WorkStealingDeque 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/common/work_deque.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace czc {
+namespace {
+
+TEST(WorkDequeTest, OwnerPopsLifoThievesStealFifo) {
+  WorkStealingDeque<int> deque(4);
+  int items[3] = {1, 2, 3};
+  for (int &item : items) {
+    deque.push(&item);
+  }
+  EXPECT_EQ(deque.sizeApprox(), 3u);
+
+  EXPECT_EQ(deque.steal(), &items[0]);
+  EXPECT_EQ(deque.pop(), &items[2]);
+  EXPECT_EQ(deque.pop(), &items[1]);
+  EXPECT_EQ(deque.pop(), nullptr);
+  EXPECT_EQ(deque.steal(), nullptr);
+}
+
+TEST(WorkDequeTest, GrowsWhenFull) {
+  WorkStealingDeque<int> deque(2);
+  std::vector<int> items(100);
+  for (int &item : items) {
+    deque.push(&item);
+  }
+  EXPECT_GE(deque.capacity(), 100u);
+
+  for (std::size_t i = items.size(); i-- > 0;) {
+    EXPECT_EQ(deque.pop(), &items[i]);
+  }
+}
+
+TEST(WorkDequeTest, ConcurrentStealsTakeEachItemOnce) {
+  constexpr int kItems = 20000;
+  constexpr int kThieves = 3;
+  WorkStealingDeque<int> deque(16);
+  std::vector<int> items(kItems);
+  std::vector<std::atomic<int>> taken(kItems);
+  std::atomic<bool> done{false};
+
+  auto record = [&](int *item) {
+    taken[static_cast<std::size_t>(item - items.data())].fetch_add(1);
+  };
+
+  std::vector<std::jthread> thieves;
+  for (int t = 0; t < kThieves; ++t) {
+    thieves.emplace_back([&] {
+      while (!done.load(std::memory_order_acquire)) {
+        if (int *item = deque.steal()) {
+          record(item);
+        }
+      }
+      while (int *item = deque.steal()) {
+        record(item);
+      }
+    });
+  }
+
+  // 所有者交替压入与弹出，与窃取者竞争最后一个元素
+  for (int i = 0; i < kItems; ++i) {
+    deque.push(&items[static_cast<std::size_t>(i)]);
+    if (i % 3 == 0) {
+      if (int *item = deque.pop()) {
+        record(item);
+      }
+    }
+  }
+  while (int *item = deque.pop()) {
+    record(item);
+  }
+  done.store(true, std::memory_order_release);
+  thieves.clear();
+
+  for (const auto &count : taken) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+} // namespace
+} // namespace czc
@@ -0,0 +1,249 @@
+/**
+ * @file ansi_renderer_test.cpp
+ * @brief AnsiRenderer 批量渲染单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/emitters/ansi_renderer.hpp"
+#include "czc/diag/emitters/text_emitter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <format>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace czc::diag {
+namespace {
+
+/// 基于内存文本的定位器，统计各接口的调用次数
+class CountingLocator : public SourceLocator {
+public:
+  explicit CountingLocator(std::string text) : text_(std::move(text)) {
+    starts_.push_back(0);
+    for (uint32_t i = 0; i < text_.size(); ++i) {
+      if (text_[i] == '\n') {
+        starts_.push_back(i + 1);
+      }
+    }
+  }
+
+  auto getFilename(Span) const -> std::string_view override {
+    return "a.zero";
+  }
+
+  auto getLineColumn(uint32_t, uint32_t offset) const -> LineColumn override {
+    ++lineColumnCalls;
+    uint32_t line = 0;
+    while (line + 1 < starts_.size() && starts_[line + 1] <= offset) {
+      ++line;
+    }
+    return {line + 1, offset - starts_[line] + 1};
+  }
+
+  auto getLineContent(uint32_t, uint32_t line) const
+      -> std::string_view override {
+    ++lineContentCalls;
+    if (line == 0 || line > starts_.size()) {
+      return {};
+    }
+    auto begin = starts_[line - 1];
+    auto end = line < starts_.size() ? starts_[line] - 1 : text_.size();
+    return std::string_view(text_).substr(begin, end - begin);
+  }
+
+  auto getSourceSlice(Span) const -> std::string_view override { return ""; }
+
+  void resolveSorted(uint32_t fileId, std::span<const uint32_t> offsets,
+                     std::span<LineColumn> out) const override {
+    ++sweeps;
+    SourceLocator::resolveSorted(fileId, offsets, out);
+  }
+
+  mutable int lineColumnCalls{0};
+  mutable int lineContentCalls{0};
+  mutable int sweeps{0};
+
+private:
+  std::string text_;
+  std::vector<uint32_t> starts_;
+};
+
+auto makeError(uint32_t start, uint32_t end, std::string label)
+    -> Diagnostic {
+  Diagnostic diag(Level::Error, Message("bad token"),
+                  ErrorCode(ErrorCategory::Lexer, 1021));
+  diag.spans.addPrimary(Span::create(1, start, end), std::move(label));
+  return diag;
+}
+
+// ============================================================================
+// 批量渲染
+// ============================================================================
+
+TEST(AnsiRendererTest, BatchMatchesIndividualRendering) {
+  CountingLocator locator("let a = $;\nlet b = @ # ;\n");
+  std::vector<Diagnostic> diags;
+  diags.push_back(makeError(19, 20, "second line"));
+  diags.push_back(makeError(8, 9, "first"));
+  diags.push_back(makeError(21, 22, ""));
+  diags.push_back(Diagnostic(Level::Warning, Message("no location")));
+
+  AnsiRenderer renderer(AnsiStyle::noColor());
+  std::string expected;
+  for (const auto &diag : diags) {
+    expected += renderer.renderDiagnostic(diag, &locator);
+  }
+
+  EXPECT_EQ(renderer.renderBatch(diags, &locator), expected);
+}
+
+TEST(AnsiRendererTest, BatchResolvesOncePerFileAndLine) {
+  CountingLocator locator("aaaa\nbbbb\ncccc\n");
+  std::vector<Diagnostic> diags;
+  for (uint32_t offset : {10u, 0u, 11u, 1u, 12u, 5u}) {
+    diags.push_back(makeError(offset, offset + 1, ""));
+  }
+
+  AnsiRenderer renderer(AnsiStyle::noColor());
+  auto text = renderer.renderBatch(diags, &locator);
+
+  EXPECT_EQ(locator.sweeps, 1);
+  EXPECT_EQ(locator.lineContentCalls, 3);
+  // 输出保持输入顺序
+  EXPECT_LT(text.find("a.zero:3:1"), text.find("a.zero:1:1"));
+}
+
+TEST(AnsiRendererTest, BatchWithoutLocatorSkipsSnippets) {
+  std::vector<Diagnostic> diags;
+  diags.push_back(makeError(0, 1, "x"));
+
+  AnsiRenderer renderer(AnsiStyle::noColor());
+  EXPECT_EQ(renderer.renderBatch(diags, nullptr), "error[L1021]: bad token\n");
+}
+
+// ============================================================================
+// 超长行窗口化
+// ============================================================================
+
+/// 检查文本是否为完整的 UTF-8 序列（不含被截断的字符）
+auto isWellFormedUtf8(std::string_view text) -> bool {
+  for (size_t i = 0; i < text.size();) {
+    auto lead = static_cast<unsigned char>(text[i]);
+    size_t length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+    if ((lead & 0xC0) == 0x80 || i + length > text.size()) {
+      return false;
+    }
+    for (size_t k = 1; k < length; ++k) {
+      if ((static_cast<unsigned char>(text[i + k]) & 0xC0) != 0x80) {
+        return false;
+      }
+    }
+    i += length;
+  }
+  return true;
+}
+
+TEST(AnsiRendererTest, LongLineRendersBoundedWindow) {
+  constexpr uint32_t kLineLength = 5 * 1024 * 1024;
+  std::string source(kLineLength, 'x');
+  uint32_t start = kLineLength / 2;
+  source.replace(start, 3, "BAD");
+  CountingLocator locator(source);
+
+  AnsiRenderer renderer(AnsiStyle::noColor());
+  auto text = renderer.renderDiagnostic(makeError(start, start + 3, "here"),
+                                        &locator);
+
+  EXPECT_LT(text.size(), 1024u);
+  EXPECT_NE(text.find(std::format("a.zero:1:{}", start + 1)),
+            std::string::npos);
+
+  // 源码行两端省略，标注对齐到窗口中的 BAD
+  auto lineBegin = text.find(" 1 | ");
+  ASSERT_NE(lineBegin, std::string::npos);
+  auto content = text.substr(lineBegin + 5, text.find('\n', lineBegin) -
+                                                lineBegin - 5);
+  ASSERT_TRUE(content.starts_with("..."));
+  ASSERT_TRUE(content.ends_with("..."));
+  auto bad = content.find("BAD");
+  ASSERT_NE(bad, std::string::npos);
+
+  auto caretLine = text.substr(text.find('\n', lineBegin) + 1);
+  EXPECT_EQ(caretLine.find('^'), bad + 5);
+  EXPECT_NE(caretLine.find("^^^ here"), std::string::npos);
+}
+
+TEST(AnsiRendererTest, LongLineWindowCutsOnCharacterBoundaries) {
+  // 三字节字符组成的超长行，窗口边界不得截断字符
+  std::string source;
+  for (int i = 0; i < 4000; ++i) {
+    source += "\xE5\xAD\x97";
+  }
+  for (uint32_t start : {3u * 2000, 3u * 2000 + 1, 3u * 1999 + 2}) {
+    CountingLocator locator(source);
+    AnsiRenderer renderer(AnsiStyle::noColor());
+    auto text =
+        renderer.renderDiagnostic(makeError(start, start + 3, ""), &locator);
+    EXPECT_TRUE(isWellFormedUtf8(text)) << start;
+    EXPECT_LT(text.size(), 2048u);
+
+    // 标注按码点对齐：窗口前缀 "..." 后每个字符占一列
+    auto caretLine = text.substr(text.rfind(" | ") + 3);
+    EXPECT_EQ(caretLine.find('^'),
+              3 + AnsiRenderer::kSnippetContext / 3) << start;
+  }
+}
+
+TEST(AnsiRendererTest, ShortLinesAreNotWindowed) {
+  std::string source(AnsiRenderer::kMaxSnippetLine, 'y');
+  CountingLocator locator(source);
+
+  AnsiRenderer renderer(AnsiStyle::noColor());
+  auto text = renderer.renderDiagnostic(makeError(10, 11, ""), &locator);
+
+  EXPECT_NE(text.find(source), std::string::npos);
+  EXPECT_EQ(text.find("..."), std::string::npos);
+}
+
+TEST(AnsiRendererTest, BatchWindowsLongLinesPerDiagnostic) {
+  std::string source(64 * 1024, 'z');
+  CountingLocator locator(source);
+  std::vector<Diagnostic> diags;
+  diags.push_back(makeError(50000, 50001, "late"));
+  diags.push_back(makeError(100, 101, "early"));
+
+  AnsiRenderer renderer(AnsiStyle::noColor());
+  std::string expected;
+  for (const auto &diag : diags) {
+    expected += renderer.renderDiagnostic(diag, &locator);
+  }
+
+  auto text = renderer.renderBatch(diags, &locator);
+  EXPECT_EQ(text, expected);
+  EXPECT_LT(text.size(), 2048u);
+}
+
+// ============================================================================
+// 汇总
+// ============================================================================
+
+TEST(TextEmitterTest, SummaryReportsSuppressedCodes) {
+  std::ostringstream out;
+  TextEmitter emitter(out, AnsiStyle::noColor());
+  DiagnosticStats stats;
+  stats.errorCount = 5;
+  stats.suppressedByCode.emplace(ErrorCode(ErrorCategory::Lexer, 1021), 3);
+  emitter.emitSummary(stats);
+
+  auto text = out.str();
+  auto note = text.find("note: 3 more L1021 diagnostics suppressed\n");
+  ASSERT_NE(note, std::string::npos);
+  EXPECT_LT(note, text.find("error: aborting due to 5 previous errors"));
+}
+
+} // namespace
+} // namespace czc::diag
@@ -0,0 +1,156 @@
+/**
+ * @file async_emitter_test.cpp
+ * @brief AsyncEmitter 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/emitters/async_emitter.hpp"
+#include "czc/diag/emitters/json_emitter.hpp"
+#include "czc/diag/emitters/text_emitter.hpp"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+namespace czc::diag {
+namespace {
+
+/// 统计位置查询次数的定位器
+class CountingLocator : public SourceLocator {
+public:
+  auto getFilename(Span) const -> std::string_view override { return "t.zero"; }
+  auto getLineColumn(uint32_t, uint32_t offset) const -> LineColumn override {
+    ++lineColumnCalls;
+    return {1, offset + 1};
+  }
+  auto getLineContent(uint32_t, uint32_t) const -> std::string_view override {
+    return "let x = 1;";
+  }
+  auto getSourceSlice(Span) const -> std::string_view override { return "x"; }
+
+  mutable size_t lineColumnCalls{0};
+};
+
+auto makeTextSink(std::string &target) -> AsyncSink {
+  return {[](std::ostream &out) -> std::unique_ptr<Emitter> {
+            return std::make_unique<TextEmitter>(out, AnsiStyle());
+          },
+          std::make_unique<StringSink>(target)};
+}
+
+auto makeJsonSink(std::string &target) -> AsyncSink {
+  return {[](std::ostream &out) -> std::unique_ptr<Emitter> {
+            return std::make_unique<JsonEmitter>(out);
+          },
+          std::make_unique<StringSink>(target)};
+}
+
+auto makeError(std::string text, uint32_t offset) -> Diagnostic {
+  Diagnostic diag(Level::Error, Message(std::move(text)));
+  diag.spans.addPrimary(Span::create(1, offset, offset + 1), "");
+  return diag;
+}
+
+auto sinks(AsyncSink a) -> std::vector<AsyncSink> {
+  std::vector<AsyncSink> result;
+  result.push_back(std::move(a));
+  return result;
+}
+
+// ============================================================================
+// 输出一致性
+// ============================================================================
+
+TEST(AsyncEmitterTest, MatchesSynchronousTextEmitter) {
+  CountingLocator locator;
+  std::ostringstream expected;
+  TextEmitter sync(expected, AnsiStyle());
+
+  std::string actual;
+  {
+    AsyncEmitter async(sinks(makeTextSink(actual)), 4);
+    for (uint32_t i = 0; i < 50; ++i) {
+      auto diag = makeError("error " + std::to_string(i), i);
+      sync.emit(diag, &locator);
+      async.emit(diag, &locator);
+    }
+    DiagnosticStats stats;
+    stats.errorCount = 50;
+    sync.emitSummary(stats);
+    async.emitSummary(stats);
+    async.flush();
+    EXPECT_EQ(actual, expected.str());
+  }
+  EXPECT_EQ(actual, expected.str());
+}
+
+TEST(AsyncEmitterTest, DestructorWritesPendingOutput) {
+  std::string actual;
+  {
+    AsyncEmitter async(sinks(makeTextSink(actual)));
+    async.emit(Diagnostic(Level::Warning, Message("pending")), nullptr);
+  }
+  EXPECT_NE(actual.find("pending"), std::string::npos);
+}
+
+TEST(AsyncEmitterTest, FatalIsWrittenBeforeEmitReturns) {
+  std::string actual;
+  AsyncEmitter async(sinks(makeTextSink(actual)));
+
+  async.emit(Diagnostic(Level::Fatal, Message("boom")), nullptr);
+
+  // 未显式 flush，Fatal 应已同步写出
+  EXPECT_NE(actual.find("boom"), std::string::npos);
+}
+
+// ============================================================================
+// 扇出
+// ============================================================================
+
+TEST(AsyncEmitterTest, FansOutToAllSinks) {
+  CountingLocator locator;
+  std::string text;
+  std::string json;
+
+  std::vector<AsyncSink> list;
+  list.push_back(makeTextSink(text));
+  list.push_back(makeJsonSink(json));
+  AsyncEmitter async(std::move(list));
+  EXPECT_EQ(async.sinkCount(), 2u);
+
+  async.emit(makeError("shared", 4), &locator);
+  async.flush();
+
+  EXPECT_NE(text.find("shared"), std::string::npos);
+  EXPECT_NE(json.find(R"("message":"shared")"), std::string::npos);
+  EXPECT_NE(json.find(R"("column":5)"), std::string::npos);
+}
+
+TEST(AsyncEmitterTest, SinksShareLocationLookups) {
+  CountingLocator single;
+  {
+    std::string text;
+    AsyncEmitter async(sinks(makeTextSink(text)));
+    async.emit(makeError("x", 3), &single);
+  }
+
+  CountingLocator shared;
+  {
+    std::string text;
+    std::string json;
+    std::vector<AsyncSink> list;
+    list.push_back(makeTextSink(text));
+    list.push_back(makeJsonSink(json));
+    AsyncEmitter async(std::move(list));
+    async.emit(makeError("x", 3), &shared);
+  }
+
+  // 第二个格式复用第一个格式的行列查询结果
+  EXPECT_GT(single.lineColumnCalls, 0u);
+  EXPECT_EQ(shared.lineColumnCalls, single.lineColumnCalls);
+}
+
+} // namespace
+} // namespace czc::diag
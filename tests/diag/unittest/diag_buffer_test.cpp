@@ -0,0 +1,198 @@
+/**
+ * @file diag_buffer_test.cpp
+ * @brief DiagBuffer 与 DiagContext::merge 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/diag_buffer.hpp"
+#include "czc/diag/diag_context.hpp"
+#include "czc/diag/emitter.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace czc::diag {
+namespace {
+
+/// 记录诊断及其定位器的 Emitter
+class RecordingEmitter : public Emitter {
+public:
+  struct Record {
+    std::string message;
+    const SourceLocator *locator;
+  };
+
+  void emit(const Diagnostic &diag, const SourceLocator *locator) override {
+    records.push_back({std::string(diag.message.markdown()), locator});
+  }
+
+  void emitSummary(const DiagnosticStats &) override {}
+
+  void flush() override {}
+
+  std::vector<Record> records;
+};
+
+/// 空实现的定位器，仅用于比较指针
+class DummyLocator : public SourceLocator {
+public:
+  auto getFilename(Span) const -> std::string_view override { return ""; }
+  auto getLineColumn(uint32_t, uint32_t) const -> LineColumn override {
+    return {};
+  }
+  auto getLineContent(uint32_t, uint32_t) const -> std::string_view override {
+    return "";
+  }
+  auto getSourceSlice(Span) const -> std::string_view override { return ""; }
+};
+
+auto makeError(std::string text, uint32_t file, uint32_t offset)
+    -> Diagnostic {
+  Diagnostic diag(Level::Error, Message(std::move(text)));
+  diag.spans.addPrimary(Span::create(file, offset, offset + 1), "");
+  return diag;
+}
+
+class DiagBufferTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    emitter_ = new RecordingEmitter();
+    ctx_ = std::make_unique<DiagContext>(std::unique_ptr<Emitter>(emitter_));
+  }
+
+  RecordingEmitter *emitter_;
+  std::unique_ptr<DiagContext> ctx_;
+};
+
+// ============================================================================
+// DiagBuffer 基本行为
+// ============================================================================
+
+TEST_F(DiagBufferTest, BufferDoesNotEmitUntilMerged) {
+  DiagBuffer buffer;
+  buffer.emit(makeError("a", 1, 0));
+  buffer.emit(Diagnostic(Level::Warning, Message("w")));
+
+  EXPECT_EQ(buffer.size(), 2u);
+  EXPECT_EQ(buffer.errorCount(), 1u);
+  EXPECT_TRUE(emitter_->records.empty());
+  EXPECT_EQ(ctx_->errorCount(), 0u);
+
+  ctx_->merge(buffer);
+
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_EQ(buffer.errorCount(), 0u);
+  EXPECT_EQ(emitter_->records.size(), 2u);
+  EXPECT_EQ(ctx_->errorCount(), 1u);
+  EXPECT_EQ(ctx_->warningCount(), 1u);
+}
+
+// ============================================================================
+// 合并顺序
+// ============================================================================
+
+TEST_F(DiagBufferTest, MergeSortsByFileAndOffset) {
+  std::vector<DiagBuffer> buffers(2);
+  buffers[0].emit(makeError("f2@5", 2, 5));
+  buffers[0].emit(makeError("f1@9", 1, 9));
+  buffers[1].emit(makeError("f1@3", 1, 3));
+  buffers[1].emit(Diagnostic(Level::Error, Message("nospan")));
+
+  ctx_->merge(buffers);
+
+  ASSERT_EQ(emitter_->records.size(), 4u);
+  EXPECT_EQ(emitter_->records[0].message, "nospan");
+  EXPECT_EQ(emitter_->records[1].message, "f1@3");
+  EXPECT_EQ(emitter_->records[2].message, "f1@9");
+  EXPECT_EQ(emitter_->records[3].message, "f2@5");
+}
+
+TEST_F(DiagBufferTest, MergeTiesBrokenByBufferThenSequence) {
+  // 同一位置的同类诊断会被去重，这里只验证排序
+  ctx_->config().deduplicate = false;
+  std::vector<DiagBuffer> buffers(2);
+  buffers[1].emit(makeError("b1-first", 1, 0));
+  buffers[0].emit(makeError("b0-first", 1, 0));
+  buffers[0].emit(makeError("b0-second", 1, 0));
+
+  ctx_->merge(buffers);
+
+  ASSERT_EQ(emitter_->records.size(), 3u);
+  EXPECT_EQ(emitter_->records[0].message, "b0-first");
+  EXPECT_EQ(emitter_->records[1].message, "b0-second");
+  EXPECT_EQ(emitter_->records[2].message, "b1-first");
+}
+
+// ============================================================================
+// 去重与定位器
+// ============================================================================
+
+TEST_F(DiagBufferTest, MergeDeduplicatesAcrossBuffers) {
+  std::vector<DiagBuffer> buffers(3);
+  for (auto &buffer : buffers) {
+    buffer.emit(makeError("same", 1, 4));
+  }
+
+  ctx_->merge(buffers);
+
+  EXPECT_EQ(emitter_->records.size(), 1u);
+  EXPECT_EQ(ctx_->errorCount(), 1u);
+}
+
+TEST_F(DiagBufferTest, MergeUsesPerBufferLocator) {
+  DummyLocator contextLocator;
+  DummyLocator bufferLocator;
+  ctx_->setLocator(&contextLocator);
+
+  std::vector<DiagBuffer> buffers;
+  buffers.emplace_back(&bufferLocator);
+  buffers.emplace_back();
+  buffers[0].emit(makeError("own", 1, 0));
+  buffers[1].emit(makeError("fallback", 2, 0));
+
+  ctx_->merge(buffers);
+
+  ASSERT_EQ(emitter_->records.size(), 2u);
+  EXPECT_EQ(emitter_->records[0].locator, &bufferLocator);
+  EXPECT_EQ(emitter_->records[1].locator, &contextLocator);
+  // 合并不修改上下文的定位器
+  EXPECT_EQ(ctx_->locator(), &contextLocator);
+}
+
+// ============================================================================
+// 并发填充
+// ============================================================================
+
+TEST_F(DiagBufferTest, ConcurrentFillMergesDeterministically) {
+  constexpr uint32_t kThreads = 4;
+  constexpr uint32_t kPerThread = 100;
+
+  std::vector<DiagBuffer> buffers(kThreads);
+  {
+    std::vector<std::jthread> workers;
+    for (uint32_t t = 0; t < kThreads; ++t) {
+      workers.emplace_back([&buffers, t] {
+        for (uint32_t i = 0; i < kPerThread; ++i) {
+          buffers[t].emit(
+              makeError("e" + std::to_string(t) + "." + std::to_string(i),
+                        t + 1, kPerThread - i));
+        }
+      });
+    }
+  }
+
+  ctx_->merge(buffers);
+
+  ASSERT_EQ(emitter_->records.size(), kThreads * kPerThread);
+  EXPECT_EQ(ctx_->errorCount(), kThreads * kPerThread);
+  // 第一个文件的最小偏移来自该线程最后一次追加
+  EXPECT_EQ(emitter_->records.front().message, "e0.99");
+  EXPECT_EQ(emitter_->records.back().message, "e3.0");
+}
+
+} // namespace
+} // namespace czc::diag
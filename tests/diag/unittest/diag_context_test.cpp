@@ -7,6 +7,7 @@
  */
 
 #include "czc/diag/diag_context.hpp"
+#include "czc/diag/diag_dedup.hpp"
 #include "czc/diag/emitter.hpp"
 #include "czc/diag/i18n.hpp"
 #include "czc/diag/message.hpp"
@@ -148,7 +149,7 @@ TEST_F(DiagContextTest, DeduplicateSameDiagnostics) {
   EXPECT_EQ(ctx_->errorCount(), 1);
 }
 
-TEST_F(DiagContextTest, DifferentMessagesNotDeduplicated) {
+TEST_F(DiagContextTest, SameLocationDifferentMessagesDeduplicated) {
   Diagnostic diag1(Level::Error, Message("error 1"),
                    ErrorCode(ErrorCategory::Lexer, 100));
   diag1.spans.addPrimary(Span::create(1, 0, 10));
@@ -160,9 +161,9 @@ TEST_F(DiagContextTest, DifferentMessagesNotDeduplicated) {
   ctx_->emit(diag1);
   ctx_->emit(diag2);
 
-  // 不同消息应该都发射
-  EXPECT_EQ(mockEmitter_->emittedCount(), 2);
-  EXPECT_EQ(ctx_->errorCount(), 2);
+  // 去重键不含消息文本：同一位置的同一错误码只发射一次
+  EXPECT_EQ(mockEmitter_->emittedCount(), 1);
+  EXPECT_EQ(ctx_->errorCount(), 1);
 }
 
 TEST_F(DiagContextTest, DifferentCodesNotDeduplicated) {
@@ -216,6 +217,92 @@ TEST_F(DiagContextTest, DeduplicationDisabled) {
   EXPECT_EQ(emitter->emittedCount(), 2);
 }
 
+TEST_F(DiagContextTest, UnlocatedDiagnosticsNotDeduplicated) {
+  Diagnostic diag(Level::Error, Message("no location"),
+                  ErrorCode(ErrorCategory::Lexer, 100));
+
+  ctx_->emit(diag);
+  ctx_->emit(diag);
+
+  EXPECT_EQ(mockEmitter_->emittedCount(), 2);
+}
+
+TEST_F(DiagContextTest, DeduplicationWindowEvictsOldestKeys) {
+  constexpr uint32_t kCount = DiagDeduplicator::kRecentCapacity * 4;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    Diagnostic diag(Level::Error, Message("error"),
+                    ErrorCode(ErrorCategory::Lexer, 100));
+    diag.spans.addPrimary(Span::create(1, i, i + 1));
+    ctx_->emit(std::move(diag));
+  }
+  ASSERT_EQ(mockEmitter_->emittedCount(), kCount);
+
+  // 最近的键仍在窗口内，被去重
+  Diagnostic recent(Level::Error, Message("error"),
+                    ErrorCode(ErrorCategory::Lexer, 100));
+  recent.spans.addPrimary(Span::create(1, kCount - 1, kCount));
+  ctx_->emit(recent);
+  EXPECT_EQ(mockEmitter_->emittedCount(), kCount);
+
+  // 最早的键已被淘汰，再次出现时放行
+  Diagnostic oldest(Level::Error, Message("error"),
+                    ErrorCode(ErrorCategory::Lexer, 100));
+  oldest.spans.addPrimary(Span::create(1, 0, 1));
+  ctx_->emit(oldest);
+  EXPECT_EQ(mockEmitter_->emittedCount(), kCount + 1);
+}
+
+TEST(DiagDeduplicatorTest, DistinctKeysAreNeverDropped) {
+  // 布隆过滤器多次重建后，未出现过的键仍全部放行
+  DiagDeduplicator dedup;
+  constexpr uint32_t kCount = DiagDeduplicator::kBloomBudget * 3;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    ASSERT_TRUE(dedup.insert(DedupKey{i % 7, i, 42})) << i;
+  }
+  EXPECT_FALSE(dedup.insert(DedupKey{(kCount - 1) % 7, kCount - 1, 42}));
+
+  dedup.clear();
+  EXPECT_TRUE(dedup.insert(DedupKey{(kCount - 1) % 7, kCount - 1, 42}));
+}
+
+// ============================================================================
+// 按错误码限流测试
+// ============================================================================
+
+TEST_F(DiagContextTest, MaxPerCodeSuppressesExcess) {
+  ctx_->config().maxPerCode = 2;
+  for (uint32_t i = 0; i < 5; ++i) {
+    Diagnostic diag(Level::Error, Message("noisy"),
+                    ErrorCode(ErrorCategory::Lexer, 1021));
+    diag.spans.addPrimary(Span::create(1, i, i + 1));
+    ctx_->emit(std::move(diag));
+  }
+  Diagnostic other(Level::Error, Message("other"),
+                   ErrorCode(ErrorCategory::Lexer, 1001));
+  other.spans.addPrimary(Span::create(1, 0, 1));
+  ctx_->emit(std::move(other));
+
+  EXPECT_EQ(mockEmitter_->emittedCount(), 3);
+  // 被限流的诊断仍计入错误数
+  EXPECT_EQ(ctx_->errorCount(), 6);
+
+  auto stats = ctx_->stats();
+  ASSERT_EQ(stats.suppressedByCode.size(), 1u);
+  EXPECT_EQ(stats.suppressedByCode.at(ErrorCode(ErrorCategory::Lexer, 1021)),
+            3u);
+}
+
+TEST_F(DiagContextTest, MaxPerCodeZeroIsUnlimited) {
+  for (uint32_t i = 0; i < 5; ++i) {
+    Diagnostic diag(Level::Error, Message("noisy"),
+                    ErrorCode(ErrorCategory::Lexer, 1021));
+    diag.spans.addPrimary(Span::create(1, i, i + 1));
+    ctx_->emit(std::move(diag));
+  }
+  EXPECT_EQ(mockEmitter_->emittedCount(), 5);
+  EXPECT_TRUE(ctx_->stats().suppressedByCode.empty());
+}
+
 // ============================================================================
 // 配置测试
 // ============================================================================
@@ -256,6 +343,24 @@ TEST_F(DiagContextTest, Stats) {
   EXPECT_EQ(stats.warningCount, 1);
 }
 
+TEST_F(DiagContextTest, ResetClearsStatsAndDedup) {
+  ctx_->config().maxPerCode = 1;
+  Diagnostic diag(Level::Error, Message("error"),
+                  ErrorCode(ErrorCategory::Lexer, 100));
+  diag.spans.addPrimary(Span::create(1, 0, 1));
+  ctx_->emit(diag);
+  ASSERT_EQ(ctx_->errorCount(), 1);
+
+  ctx_->reset();
+  EXPECT_EQ(ctx_->errorCount(), 0);
+  EXPECT_FALSE(ctx_->shouldAbort());
+
+  // 重置后同一诊断不再被去重或限流
+  ctx_->emit(diag);
+  EXPECT_EQ(mockEmitter_->emittedCount(), 2);
+  EXPECT_EQ(ctx_->stats().uniqueErrorCodes.size(), 1u);
+}
+
 // ============================================================================
 // Flush 和 Summary 测试
 // ============================================================================
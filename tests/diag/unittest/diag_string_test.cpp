@@ -0,0 +1,144 @@
+/**
+ * @file diag_string_test.cpp
+ * @brief DiagString、字符串驻留与内联诊断存储单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/diag_builder.hpp"
+#include "czc/diag/diag_string.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace czc::diag {
+namespace {
+
+// ============================================================================
+// DiagString
+// ============================================================================
+
+TEST(DiagStringTest, BorrowedTextIsNotCopied) {
+  static constexpr std::string_view kText = "static label, longer than SSO";
+  auto text = DiagString::borrowed(kText);
+
+  EXPECT_TRUE(text.isBorrowed());
+  EXPECT_EQ(text.data(), kText.data());
+  EXPECT_EQ(text, kText);
+
+  DiagString copy = text;
+  EXPECT_EQ(copy.data(), kText.data());
+}
+
+TEST(DiagStringTest, OwnedTextSurvivesCopyAndMove) {
+  std::string source = "dynamic text, longer than the SSO buffer";
+  DiagString text(source);
+  EXPECT_FALSE(text.isBorrowed());
+  EXPECT_NE(text.data(), source.data());
+
+  DiagString copy = text;
+  DiagString moved = std::move(text);
+  EXPECT_EQ(copy, source);
+  EXPECT_EQ(moved, source);
+}
+
+TEST(DiagStringTest, EmptyBorrowedViewIsValid) {
+  auto text = DiagString::borrowed(std::string_view{});
+  EXPECT_TRUE(text.empty());
+  EXPECT_NE(text.data(), nullptr);
+  EXPECT_TRUE(DiagString().empty());
+}
+
+// ============================================================================
+// StringInterner
+// ============================================================================
+
+TEST(StringInternerTest, SameContentSharesStorage) {
+  std::string first = "interned help: add a closing quote";
+  std::string second = first;
+
+  auto a = DiagString::interned(first);
+  auto b = DiagString::interned(second);
+
+  EXPECT_TRUE(a.isBorrowed());
+  EXPECT_EQ(a.data(), b.data());
+  EXPECT_NE(a.data(), first.data());
+}
+
+TEST(StringInternerTest, ViewsOutliveSource) {
+  std::string_view view;
+  {
+    std::string temporary(StringInterner::kBlockSize, 'q');
+    view = StringInterner::instance().intern(temporary);
+  }
+  EXPECT_EQ(view, std::string(StringInterner::kBlockSize, 'q'));
+}
+
+TEST(StringInternerTest, ConcurrentInterningReturnsOneView) {
+  constexpr int kThreads = 4;
+  std::vector<std::string_view> results(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 200; ++i) {
+        (void)StringInterner::instance().intern("noise " + std::to_string(i));
+      }
+      results[static_cast<size_t>(t)] =
+          StringInterner::instance().intern(std::string("shared key"));
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (auto view : results) {
+    EXPECT_EQ(view.data(), results[0].data());
+  }
+}
+
+// ============================================================================
+// 内联存储
+// ============================================================================
+
+TEST(DiagnosticStorageTest, CommonShapeStaysInline) {
+  auto builder = error(Message::fromStatic("unexpected token"));
+  builder
+      .spanLabel(Span::create(1, 0, 1), DiagString::borrowed("expected here"))
+      .secondarySpan(Span::create(1, 4, 5))
+      .note(DiagString::borrowed("note text"))
+      .help(DiagString::interned("help text"));
+  auto diag = std::move(builder).build();
+
+  EXPECT_EQ(diag.spans.size(), 2u);
+  EXPECT_EQ(diag.children.size(), 2u);
+  EXPECT_TRUE(diag.children.isInline());
+  EXPECT_TRUE(diag.message.markdown() == "unexpected token");
+  ASSERT_NE(diag.spans.primary(), nullptr);
+  EXPECT_TRUE(diag.spans.primary()->label.isBorrowed());
+  for (const auto &child : diag.children) {
+    EXPECT_TRUE(child.message.isBorrowed());
+  }
+
+  // 移动后内联元素随之迁移
+  Diagnostic moved = std::move(diag);
+  EXPECT_EQ(moved.children[1].message, "help text");
+  EXPECT_EQ(moved.spans.primary()->label, "expected here");
+}
+
+TEST(DiagnosticStorageTest, ManyChildrenSpillToHeap) {
+  DiagBuilder builder(Level::Error, Message("many notes"));
+  for (int i = 0; i < 8; ++i) {
+    builder.note("note " + std::to_string(i));
+  }
+  auto diag = std::move(builder).build();
+
+  ASSERT_EQ(diag.children.size(), 8u);
+  EXPECT_FALSE(diag.children.isInline());
+  EXPECT_EQ(diag.children[7].message, "note 7");
+}
+
+} // namespace
+} // namespace czc::diag
@@ -0,0 +1,79 @@
+/**
+ * @file error_registry_test.cpp
+ * @brief ErrorRegistry 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/error_code.hpp"
+#include "czc/lexer/lexer_error_codes.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace czc::diag {
+namespace {
+
+// ============================================================================
+// 内置错误表
+// ============================================================================
+
+TEST(ErrorRegistryTest, BuiltinTableIsSortedAndComplete) {
+  auto entries = ErrorRegistry::builtinEntries();
+  EXPECT_EQ(entries.size(), 15u);
+  EXPECT_TRUE(std::ranges::is_sorted(entries, {}, &ErrorEntry::code));
+}
+
+TEST(ErrorRegistryTest, BuiltinLookupByCode) {
+  const auto *entry = ErrorRegistry::builtin(lexer::errors::kTokenTooLong);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->brief, "token length exceeds limit");
+  EXPECT_EQ(entry->explanationKey, "lexer.token_too_long");
+
+  // 区间内的空位、区间外的编号与未使用的分类
+  EXPECT_EQ(ErrorRegistry::builtin(ErrorCode(ErrorCategory::Lexer, 1007)),
+            nullptr);
+  EXPECT_EQ(ErrorRegistry::builtin(ErrorCode(ErrorCategory::Lexer, 1)),
+            nullptr);
+  EXPECT_EQ(ErrorRegistry::builtin(ErrorCode(ErrorCategory::Lexer, 9999)),
+            nullptr);
+  EXPECT_EQ(ErrorRegistry::builtin(ErrorCode(ErrorCategory::Sema, 1001)),
+            nullptr);
+}
+
+TEST(ErrorRegistryTest, EveryDeclaredCodeResolves) {
+  for (const auto &entry : ErrorRegistry::builtinEntries()) {
+    EXPECT_EQ(ErrorRegistry::builtin(entry.code), &entry);
+    EXPECT_TRUE(ErrorRegistry::instance().isRegistered(entry.code));
+  }
+}
+
+// ============================================================================
+// 运行时注册（插件）
+// ============================================================================
+
+TEST(ErrorRegistryTest, PluginRegistrationExtendsTable) {
+  auto &registry = ErrorRegistry::instance();
+  ErrorCode pluginCode(ErrorCategory::Codegen, 4999);
+  registry.registerError(pluginCode, "plugin error", "plugin.key");
+
+  auto entry = registry.lookup(pluginCode);
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry->brief, "plugin error");
+
+  auto codes = registry.allCodes();
+  EXPECT_TRUE(std::ranges::is_sorted(codes));
+  EXPECT_NE(std::ranges::find(codes, pluginCode), codes.end());
+}
+
+TEST(ErrorRegistryTest, BuiltinEntriesTakePrecedence) {
+  auto &registry = ErrorRegistry::instance();
+  registry.registerError(lexer::errors::kInvalidCharacter, "other", "k");
+  EXPECT_EQ(registry.lookup(lexer::errors::kInvalidCharacter)->brief,
+            "invalid character");
+}
+
+} // namespace
+} // namespace czc::diag
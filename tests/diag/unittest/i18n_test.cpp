@@ -7,9 +7,14 @@
  */
 
 #include "czc/diag/i18n.hpp"
+#include "czc/diag/i18n_catalog.hpp"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 namespace czc::diag::i18n {
 namespace {
 
@@ -101,6 +106,102 @@ TEST_F(TranslatorTest, TranslateWithFallback) {
   EXPECT_EQ(result, "fallback message");
 }
 
+// ============================================================================
+// 内置目录测试
+// ============================================================================
+
+TEST_F(TranslatorTest, BuiltinCatalogsAreSorted) {
+  for (auto locale : {Locale::En, Locale::ZhCN}) {
+    const auto *catalog = builtinCatalog(locale);
+    ASSERT_NE(catalog, nullptr);
+    EXPECT_GT(catalog->size(), 0u);
+    EXPECT_TRUE(std::is_sorted(
+        catalog->entries().begin(), catalog->entries().end(),
+        [](const auto &a, const auto &b) { return a.key < b.key; }));
+  }
+  EXPECT_EQ(builtinCatalog(Locale::Ja), nullptr);
+}
+
+TEST_F(TranslatorTest, BuiltinTranslationsWithoutLoading) {
+  EXPECT_EQ(translator_.get("E0001.message"), "missing hex digits after `0x`");
+  EXPECT_EQ(translator_.get("meta.locale"), "en");
+  // 多行字符串与转义按 TOML 规则解码
+  EXPECT_TRUE(translator_.get("E0001.explanation").starts_with("A hex"));
+}
+
+TEST_F(TranslatorTest, LocaleSelectsCatalogAndFallsBackToEnglish) {
+  translator_.setLocale(Locale::ZhCN);
+  EXPECT_EQ(translator_.get("meta.locale"), "zh-CN");
+
+  // 未内置的语言回退到英文
+  translator_.setLocale(Locale::Ja);
+  EXPECT_EQ(translator_.get("meta.locale"), "en");
+}
+
+// ============================================================================
+// 运行时覆盖层测试
+// ============================================================================
+
+TEST_F(TranslatorTest, OverrideTakesPrecedence) {
+  translator_.loadFromMemory(R"(
+[E0001]
+message = "custom"
+[custom]
+key = "value"
+)");
+  EXPECT_EQ(translator_.get("E0001.message"), "custom");
+  EXPECT_EQ(translator_.get("custom.key"), "value");
+  // 未覆盖的键仍来自内置目录
+  EXPECT_FALSE(translator_.get("E0002.message").empty());
+}
+
+TEST_F(TranslatorTest, LaterOverridesMergeAndKeepViewsValid) {
+  translator_.loadFromMemory("[a]\nx = \"1\"\ny = \"2\"\n");
+  auto first = translator_.get("a.x");
+
+  translator_.loadFromMemory("[a]\nx = \"3\"\n");
+  EXPECT_EQ(translator_.get("a.x"), "3");
+  EXPECT_EQ(translator_.get("a.y"), "2");
+  // 之前返回的视图仍指向有效内存
+  EXPECT_EQ(first, "1");
+}
+
+TEST_F(TranslatorTest, RepeatedReloadsReleaseOldTables) {
+  for (int i = 0; i < 50; ++i) {
+    translator_.loadFromMemory("[a]\nx = \"" + std::to_string(i) + "\"\n");
+  }
+  EXPECT_LE(translator_.retainedTables(), 2u);
+  EXPECT_EQ(translator_.get("a.x"), "49");
+
+  // 上一张表仍保留：加载前取得的视图在一次加载之后仍然有效
+  auto previous = translator_.get("a.x");
+  translator_.loadFromMemory("[a]\ny = \"1\"\n");
+  EXPECT_EQ(previous, "49");
+}
+
+TEST_F(TranslatorTest, CopySharesOverrides) {
+  translator_.loadFromMemory("[a]\nx = \"1\"\n");
+  Translator copy(translator_);
+  EXPECT_EQ(copy.get("a.x"), "1");
+}
+
+TEST_F(TranslatorTest, ConcurrentLookupsDuringOverrideLoad) {
+  std::vector<std::jthread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([this] {
+      for (int i = 0; i < 2000; ++i) {
+        auto value = translator_.get("E0001.message");
+        ASSERT_FALSE(value.empty());
+      }
+    });
+  }
+  for (int i = 0; i < 20; ++i) {
+    translator_.loadFromMemory("[E0001]\nmessage = \"override\"\n");
+  }
+  readers.clear();
+  EXPECT_EQ(translator_.get("E0001.message"), "override");
+}
+
 // ============================================================================
 // TranslationScope 测试
 // ============================================================================
@@ -0,0 +1,251 @@
+/**
+ * @file json_emitter_test.cpp
+ * @brief JsonEmitter 单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/emitters/json_emitter.hpp"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+namespace czc::diag {
+namespace {
+
+/// 固定返回值的定位器
+class FixedLocator : public SourceLocator {
+public:
+  auto getFilename(Span) const -> std::string_view override {
+    return R"(dir\"q".zero)";
+  }
+  auto getLineColumn(uint32_t, uint32_t offset) const -> LineColumn override {
+    return {2, offset + 1};
+  }
+  auto getLineContent(uint32_t, uint32_t) const -> std::string_view override {
+    return "";
+  }
+  auto getSourceSlice(Span) const -> std::string_view override { return ""; }
+};
+
+/// 以指定文件名与 UTF-8 行内容定位的定位器（单行，列号按字节）
+class LineLocator : public SourceLocator {
+public:
+  LineLocator(std::string_view filename, std::string_view line)
+      : filename_(filename), line_(line) {}
+
+  auto getFilename(Span) const -> std::string_view override {
+    return filename_;
+  }
+  auto getLineColumn(uint32_t, uint32_t offset) const -> LineColumn override {
+    return {1, offset + 1};
+  }
+  auto getLineContent(uint32_t, uint32_t) const -> std::string_view override {
+    return line_;
+  }
+  auto getSourceSlice(Span) const -> std::string_view override { return ""; }
+
+private:
+  std::string_view filename_;
+  std::string_view line_;
+};
+
+auto makeError() -> Diagnostic {
+  Diagnostic diag(Level::Error, Message("bad"),
+                  ErrorCode(ErrorCategory::Lexer, 1));
+  diag.spans.addPrimary(Span::create(1, 3, 5), "here");
+  return diag;
+}
+
+// ============================================================================
+// Document 格式
+// ============================================================================
+
+TEST(JsonEmitterTest, DocumentExactOutput) {
+  std::ostringstream out;
+  {
+    JsonEmitter emitter(out);
+    emitter.emit(makeError(), nullptr);
+    DiagnosticStats stats;
+    stats.errorCount = 1;
+    stats.uniqueErrorCodes.insert(ErrorCode(ErrorCategory::Lexer, 1));
+    emitter.emitSummary(stats);
+  }
+
+  EXPECT_EQ(out.str(),
+            R"({"diagnostics":[{"level":"error","code":"L0001","message":"bad",)"
+            R"("spans":[{"file_id":1,"start":3,"end":5,"primary":true,)"
+            R"("label":"here"}],"children":[],"suggestions":[]}],)"
+            R"("stats":{"error_count":1,"warning_count":0,"note_count":0,)"
+            R"("unique_error_codes":["L0001"]}})"
+            "\n");
+}
+
+TEST(JsonEmitterTest, DocumentClosedByDestructorWithoutSummary) {
+  std::ostringstream out;
+  {
+    JsonEmitter emitter(out);
+    emitter.emit(Diagnostic(Level::Warning, Message("w")), nullptr);
+  }
+  auto text = out.str();
+  EXPECT_EQ(text.substr(text.size() - 3), "]}\n");
+}
+
+TEST(JsonEmitterTest, EmptyDocumentStillValid) {
+  std::ostringstream out;
+  {
+    JsonEmitter emitter(out);
+    emitter.emitSummary(DiagnosticStats{});
+  }
+  EXPECT_EQ(out.str().rfind(R"({"diagnostics":[],"stats":)", 0), 0u);
+}
+
+TEST(JsonEmitterTest, StatsReportSuppressedCodes) {
+  std::ostringstream out;
+  {
+    JsonEmitter emitter(out, JsonDiagFormat::Lines);
+    DiagnosticStats stats;
+    stats.errorCount = 5;
+    stats.suppressedByCode.emplace(ErrorCode(ErrorCategory::Lexer, 1021), 3);
+    emitter.emitSummary(stats);
+  }
+  EXPECT_NE(
+      out.str().find(R"("unique_error_codes":[],"suppressed":{"L1021":3}})"),
+      std::string::npos);
+}
+
+// ============================================================================
+// 转义
+// ============================================================================
+
+TEST(JsonEmitterTest, EscapesEveryStringField) {
+  FixedLocator locator;
+  Diagnostic diag(Level::Error, Message("m"));
+  diag.spans.addPrimary(Span::create(1, 0, 1), "lab\"el");
+  diag.children.emplace_back(Level::Help, "use \"x\"\n");
+  diag.suggestions.emplace_back(Span::create(1, 0, 1), "a\\b", "tab\there");
+
+  std::ostringstream out;
+  {
+    JsonEmitter emitter(out, JsonDiagFormat::Lines);
+    emitter.emit(diag, &locator);
+  }
+  auto text = out.str();
+
+  EXPECT_NE(text.find(R"("file":"dir\\\"q\".zero")"), std::string::npos);
+  EXPECT_NE(text.find(R"("label":"lab\"el")"), std::string::npos);
+  EXPECT_NE(text.find(R"("message":"use \"x\"\n")"), std::string::npos);
+  EXPECT_NE(text.find(R"("replacement":"a\\b")"), std::string::npos);
+  EXPECT_NE(text.find(R"("message":"tab\there")"), std::string::npos);
+}
+
+// ============================================================================
+// JSON Lines
+// ============================================================================
+
+TEST(JsonEmitterTest, LinesOneObjectPerLine) {
+  std::ostringstream out;
+  {
+    JsonEmitter emitter(out, JsonDiagFormat::Lines);
+    for (int i = 0; i < 3; ++i) {
+      emitter.emit(makeError(), nullptr);
+    }
+    emitter.emitSummary(DiagnosticStats{});
+  }
+
+  std::istringstream in(out.str());
+  std::string line;
+  int count = 0;
+  while (std::getline(in, line)) {
+    EXPECT_EQ(line.front(), '{');
+    EXPECT_EQ(line.back(), '}');
+    ++count;
+  }
+  EXPECT_EQ(count, 4);
+  EXPECT_NE(out.str().find(R"({"stats":{)"), std::string::npos);
+}
+
+// ============================================================================
+// SARIF
+// ============================================================================
+
+TEST(JsonEmitterTest, SarifStructure) {
+  FixedLocator locator;
+  auto diag = makeError();
+  diag.spans.addSecondary(Span::create(1, 8, 9), "other");
+  diag.children.emplace_back(Level::Note, "note text");
+
+  std::ostringstream out;
+  {
+    JsonEmitter emitter(out, JsonDiagFormat::Sarif);
+    emitter.emit(diag, &locator);
+    DiagnosticStats stats;
+    stats.errorCount = 1;
+    emitter.emitSummary(stats);
+  }
+  auto text = out.str();
+
+  EXPECT_EQ(text.rfind(R"({"version":"2.1.0",)", 0), 0u);
+  EXPECT_NE(text.find(R"("tool":{"driver":{"name":"czc")"), std::string::npos);
+  EXPECT_NE(text.find(R"("ruleId":"L0001","level":"error",)"
+                      R"("message":{"text":"bad"})"),
+            std::string::npos);
+  EXPECT_NE(text.find(R"("region":{"startLine":2,"startColumn":4,)"
+                      R"("endLine":2,"endColumn":6,"byteOffset":3,)"
+                      R"("byteLength":2})"),
+            std::string::npos);
+  EXPECT_NE(text.find(R"("artifactLocation":{"uri":"dir%5C%22q%22.zero",)"
+                      R"("uriBaseId":"%SRCROOT%"})"),
+            std::string::npos);
+  EXPECT_NE(text.find(R"("columnKind":"unicodeCodePoints","results":[)"),
+            std::string::npos);
+  EXPECT_NE(text.find(R"("relatedLocations":[)"), std::string::npos);
+  EXPECT_NE(text.find(R"("properties":{"notes":["note text"]})"),
+            std::string::npos);
+  EXPECT_NE(text.find(R"("invocations":[{"executionSuccessful":false}])"),
+            std::string::npos);
+  EXPECT_EQ(text.substr(text.size() - 4), "}]}\n");
+}
+
+TEST(JsonEmitterTest, SarifFileUriAndCodePointColumns) {
+  // "é" 与 "中" 分别占 2 与 3 字节；span 覆盖 "中x"（字节 4..8）
+  LineLocator locator("/tmp/my dir/ä.zero", "a\u00e9 \u4e2dx;");
+  Diagnostic diag(Level::Error, Message("bad"),
+                  ErrorCode(ErrorCategory::Lexer, 1));
+  diag.spans.addPrimary(Span::create(1, 4, 8), "here");
+
+  std::ostringstream out;
+  {
+    JsonEmitter emitter(out, JsonDiagFormat::Sarif);
+    emitter.emit(diag, &locator);
+  }
+  auto text = out.str();
+
+  EXPECT_NE(text.find(R"("artifactLocation":{)"
+                      R"("uri":"file:///tmp/my%20dir/%C3%A4.zero"})"),
+            std::string::npos);
+  EXPECT_NE(text.find(R"("region":{"startLine":1,"startColumn":4,)"
+                      R"("endLine":1,"endColumn":6,"byteOffset":4,)"
+                      R"("byteLength":4})"),
+            std::string::npos);
+}
+
+TEST(JsonEmitterTest, SarifWindowsDrivePathUri) {
+  LineLocator locator(R"(C:\src\a b.zero)", "x");
+  Diagnostic diag(Level::Error, Message("bad"),
+                  ErrorCode(ErrorCategory::Lexer, 1));
+  diag.spans.addPrimary(Span::create(1, 0, 1), "here");
+
+  std::ostringstream out;
+  {
+    JsonEmitter emitter(out, JsonDiagFormat::Sarif);
+    emitter.emit(diag, &locator);
+  }
+  EXPECT_NE(out.str().find(R"("uri":"file:///C:/src/a%20b.zero"})"),
+            std::string::npos);
+}
+
+} // namespace
+} // namespace czc::diag
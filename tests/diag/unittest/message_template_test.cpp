@@ -0,0 +1,107 @@
+/**
+ * @file message_template_test.cpp
+ * @brief MessageTemplate 与 Translator 格式化单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/i18n.hpp"
+#include "czc/diag/message_template.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <string>
+
+namespace czc::diag::i18n {
+namespace {
+
+auto render(std::string_view text, std::span<const std::string_view> args)
+    -> std::string {
+  auto segments = compileTemplate(text);
+  std::string out;
+  MessageTemplate(text, segments).formatTo(out, args);
+  return out;
+}
+
+// ============================================================================
+// 模板编译
+// ============================================================================
+
+TEST(MessageTemplateTest, PlainTextHasNoSegments) {
+  EXPECT_TRUE(compileTemplate("no placeholders here").empty());
+  EXPECT_TRUE(compileTemplate("{} {x} {01} {").empty());
+}
+
+TEST(MessageTemplateTest, SegmentsCoverLiteralsAndSlots) {
+  auto segments = compileTemplate("a{0}bc{12}d");
+  ASSERT_EQ(segments.size(), 3u);
+  EXPECT_EQ(segments[0].length, 1u);
+  EXPECT_EQ(segments[0].arg, 0);
+  EXPECT_EQ(segments[1].offset, 4u);
+  EXPECT_EQ(segments[1].arg, 12);
+  EXPECT_EQ(segments[2].offset, 10u);
+  EXPECT_EQ(segments[2].arg, kNoArg);
+}
+
+// ============================================================================
+// 格式化
+// ============================================================================
+
+TEST(MessageTemplateTest, FormatsRepeatedAndReorderedSlots) {
+  std::array<std::string_view, 2> args{"x", "y"};
+  EXPECT_EQ(render("{1}-{0}-{1}", args), "y-x-y");
+}
+
+TEST(MessageTemplateTest, ArgumentsAreNotRescanned) {
+  std::array<std::string_view, 2> args{"{1}", "z"};
+  EXPECT_EQ(render("{0}{1}", args), "{1}z");
+}
+
+TEST(MessageTemplateTest, MissingArgumentKeepsPlaceholder) {
+  std::array<std::string_view, 1> args{"x"};
+  EXPECT_EQ(render("{0} {3}", args), "x {3}");
+}
+
+TEST(MessageTemplateTest, AppendsToExistingBuffer) {
+  auto segments = compileTemplate("<{0}>");
+  std::string out = "prefix ";
+  std::array<std::string_view, 1> args{"v"};
+  MessageTemplate("<{0}>", segments).formatTo(out, args);
+  EXPECT_EQ(out, "prefix <v>");
+}
+
+// ============================================================================
+// Translator 格式化
+// ============================================================================
+
+TEST(MessageTemplateTest, TranslatorFormatsMixedArguments) {
+  Translator translator;
+  translator.loadFromMemory("[t]\nmsg = \"{0} has {1} items ({2}, {3})\"\n");
+  std::string name = "list";
+  EXPECT_EQ(translator.get("t.msg", name, 3, 1.5, true),
+            "list has 3 items (1.5, 1)");
+  EXPECT_EQ(translator.get("t.msg", "c-string", 'A'),
+            "c-string has 65 items ({2}, {3})");
+}
+
+TEST(MessageTemplateTest, TranslatorFormatToAppendsOrUsesKey) {
+  Translator translator;
+  translator.loadFromMemory("[t]\nmsg = \"n={0}\"\n");
+
+  std::string out;
+  translator.formatTo(out, "t.msg", 42);
+  out.push_back(';');
+  translator.formatTo(out, "missing.key", 1);
+  EXPECT_EQ(out, "n=42;missing.key");
+}
+
+TEST(MessageTemplateTest, BuiltinEntriesFormatAsPlainText) {
+  Translator translator;
+  EXPECT_EQ(translator.get("E0001.message", 1),
+            std::string(translator.get("E0001.message")));
+}
+
+} // namespace
+} // namespace czc::diag::i18n
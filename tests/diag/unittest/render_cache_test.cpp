@@ -0,0 +1,107 @@
+/**
+ * @file render_cache_test.cpp
+ * @brief 消息渲染快速路径与渲染缓存单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/diag/emitters/ansi_renderer.hpp"
+#include "czc/diag/message.hpp"
+#include "czc/diag/render_cache.hpp"
+
+#include <gtest/gtest.h>
+
+namespace czc::diag {
+namespace {
+
+class RenderCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override { RenderCache::instance().clear(); }
+  void TearDown() override { RenderCache::instance().clear(); }
+};
+
+// ============================================================================
+// Markdown 扫描
+// ============================================================================
+
+TEST_F(RenderCacheTest, PlainTextNeedsNoMarkdown) {
+  EXPECT_FALSE(needsMarkdown(""));
+  EXPECT_FALSE(needsMarkdown("unterminated string literal"));
+  EXPECT_FALSE(needsMarkdown("expected ';' after \"let\" (found ')')"));
+  EXPECT_FALSE(needsMarkdown("1 error: x > y"));
+}
+
+TEST_F(RenderCacheTest, InlineSyntaxNeedsMarkdown) {
+  EXPECT_TRUE(needsMarkdown("use `let`"));
+  EXPECT_TRUE(needsMarkdown("**bold**"));
+  EXPECT_TRUE(needsMarkdown("snake_case"));
+  EXPECT_TRUE(needsMarkdown("see [docs](url)"));
+  EXPECT_TRUE(needsMarkdown("a \\* b"));
+  EXPECT_TRUE(needsMarkdown("<tag>"));
+  EXPECT_TRUE(needsMarkdown("&amp;"));
+}
+
+TEST_F(RenderCacheTest, BlockSyntaxNeedsMarkdown) {
+  EXPECT_TRUE(needsMarkdown("- item"));
+  EXPECT_TRUE(needsMarkdown("# title"));
+  EXPECT_TRUE(needsMarkdown("> quote"));
+  EXPECT_TRUE(needsMarkdown("1. first"));
+  EXPECT_TRUE(needsMarkdown("line\nbreak"));
+  EXPECT_TRUE(needsMarkdown(" leading space"));
+  EXPECT_TRUE(needsMarkdown("trailing space "));
+  EXPECT_TRUE(needsMarkdown("中文"));
+}
+
+// ============================================================================
+// 快速路径
+// ============================================================================
+
+TEST_F(RenderCacheTest, FastPathBypassesCache) {
+  Message msg("unterminated string literal");
+  EXPECT_EQ(msg.renderPlainText(), "unterminated string literal");
+  EXPECT_EQ(msg.renderAnsi(AnsiStyle::defaultStyle()),
+            "unterminated string literal");
+  EXPECT_EQ(RenderCache::instance().misses(), 0u);
+  EXPECT_EQ(RenderCache::instance().size(), 0u);
+}
+
+TEST_F(RenderCacheTest, FastPathHtmlMatchesCmarkEscaping) {
+  Message msg("a \"b\" > c");
+  EXPECT_EQ(msg.renderHtml(), "<p>a &quot;b&quot; &gt; c</p>\n");
+  EXPECT_EQ(Message("").renderHtml(), "");
+}
+
+// ============================================================================
+// 进程级缓存
+// ============================================================================
+
+TEST_F(RenderCacheTest, IdenticalTemplatesRenderedOnce) {
+  auto &cache = RenderCache::instance();
+
+  EXPECT_EQ(Message("use `let`").renderPlainText(), "use let");
+  EXPECT_EQ(Message("use `let`").renderPlainText(), "use let");
+
+  EXPECT_EQ(cache.misses(), 1u);
+  EXPECT_EQ(cache.hits(), 1u);
+  EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST_F(RenderCacheTest, KeyedByTargetAndStyle) {
+  auto &cache = RenderCache::instance();
+  AnsiRenderer colored(AnsiStyle::defaultStyle());
+  AnsiRenderer plain(AnsiStyle::noColor());
+
+  auto a = colored.renderMessage("use `let`");
+  auto b = plain.renderMessage("use `let`");
+  (void)Message("use `let`").renderPlainText();
+
+  EXPECT_NE(a, b);
+  EXPECT_EQ(b, "use `let`");
+  EXPECT_EQ(cache.size(), 3u);
+  EXPECT_EQ(colored.renderMessage("use `let`"), a);
+  EXPECT_EQ(cache.hits(), 1u);
+}
+
+} // namespace
+} // namespace czc::diag
@@ -0,0 +1,131 @@
+/**
+ * @file lexer_source_locator_test.cpp
+ * @brief LexerError 到诊断转换的单元测试。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ */
+
+#include "czc/lexer/lexer_source_locator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace czc::lexer {
+namespace {
+
+auto makeLexerError(LexerErrorCode code, uint32_t offset) -> LexerError {
+  SourceLocation loc(BufferID{1}, 1, offset + 1, offset);
+  return LexerError::make(code, loc, 2, "message {}", offset);
+}
+
+// ============================================================================
+// 单条转换
+// ============================================================================
+
+TEST(LexerDiagnosticTest, UsesLabelAndHelpFromCatalog) {
+  SourceManager sm;
+  diag::i18n::Translator translator;
+
+  auto diag = toDiagnostic(
+      makeLexerError(LexerErrorCode::UnterminatedString, 4), sm, translator);
+
+  ASSERT_TRUE(diag.code.has_value());
+  EXPECT_EQ(diag.code->toString(), "L1012");
+  ASSERT_NE(diag.spans.primary(), nullptr);
+  EXPECT_EQ(diag.spans.primary()->label,
+            translator.get("lexer.unterminated_string.label"));
+  EXPECT_EQ(diag.spans.primary()->span.startOffset, 4u);
+  EXPECT_EQ(diag.spans.primary()->span.endOffset, 6u);
+  ASSERT_EQ(diag.children.size(), 1u);
+  EXPECT_EQ(diag.children[0].level, diag::Level::Help);
+  EXPECT_EQ(diag.children[0].message,
+            translator.get("lexer.unterminated_string.help"));
+}
+
+TEST(LexerDiagnosticTest, MissingHelpAddsNoChild) {
+  SourceManager sm;
+  diag::i18n::Translator translator;
+  ASSERT_TRUE(translator.get("lexer.invalid_character.help").empty());
+
+  auto diag = toDiagnostic(
+      makeLexerError(LexerErrorCode::InvalidCharacter, 0), sm, translator);
+
+  EXPECT_TRUE(diag.children.empty());
+  EXPECT_FALSE(diag.spans.primary()->label.empty());
+}
+
+TEST(LexerDiagnosticTest, PreparedTemplatesFollowTranslatorChanges) {
+  SourceManager sm;
+  diag::i18n::Translator translator;
+  auto error = makeLexerError(LexerErrorCode::InvalidCharacter, 0);
+
+  auto before = translator.generation();
+  (void)toDiagnostic(error, sm, translator);
+
+  translator.loadFromMemory(R"(
+[lexer.invalid_character]
+label = "overridden label"
+help = "overridden help"
+)");
+  EXPECT_NE(translator.generation(), before);
+
+  auto diag = toDiagnostic(error, sm, translator);
+  EXPECT_EQ(diag.spans.primary()->label, "overridden label");
+  ASSERT_EQ(diag.children.size(), 1u);
+  EXPECT_EQ(diag.children[0].message, "overridden help");
+
+  // 另一个 Translator 的状态代号不同，不会命中前者的模板
+  diag::i18n::Translator other;
+  auto plain = toDiagnostic(error, sm, other);
+  EXPECT_EQ(plain.spans.primary()->label,
+            other.get("lexer.invalid_character.label"));
+  EXPECT_TRUE(plain.children.empty());
+}
+
+TEST(LexerDiagnosticTest, SetLocaleInvalidatesPreparedTemplates) {
+  diag::i18n::Translator translator;
+  auto before = translator.generation();
+  translator.setLocale(diag::i18n::Locale::ZhCN);
+  EXPECT_NE(translator.generation(), before);
+
+  SourceManager sm;
+  auto diag = toDiagnostic(
+      makeLexerError(LexerErrorCode::UnterminatedString, 0), sm, translator);
+  EXPECT_EQ(diag.spans.primary()->label,
+            translator.get("lexer.unterminated_string.label"));
+}
+
+// ============================================================================
+// 批量转换
+// ============================================================================
+
+TEST(LexerDiagnosticTest, AppendDiagnosticsMatchesSingleConversion) {
+  SourceManager sm;
+  diag::i18n::Translator translator;
+  std::vector<LexerError> errors;
+  for (uint32_t i = 0; i < 64; ++i) {
+    auto code = i % 2 == 0 ? LexerErrorCode::InvalidCharacter
+                           : LexerErrorCode::UnterminatedBlockComment;
+    errors.push_back(makeLexerError(code, i * 3));
+  }
+
+  diag::DiagBuffer buffer;
+  appendDiagnostics(buffer, errors, translator);
+
+  ASSERT_EQ(buffer.size(), errors.size());
+  for (size_t i = 0; i < errors.size(); ++i) {
+    auto expected = toDiagnostic(errors[i], sm, translator);
+    const auto &actual = buffer.diagnostics()[i];
+    EXPECT_EQ(actual.message.renderPlainText(),
+              expected.message.renderPlainText());
+    EXPECT_EQ(actual.code, expected.code);
+    EXPECT_EQ(actual.spans.primary()->label,
+              expected.spans.primary()->label);
+    EXPECT_EQ(actual.children.size(), expected.children.size());
+  }
+}
+
+} // namespace
+} // namespace czc::lexer
@@ -463,5 +463,25 @@ TEST_F(LexerTest, RangeInclusiveOperator) {
   EXPECT_EQ(tokens[2].type(), TokenType::LIT_INT);
 }
 
+TEST_F(LexerTest, ResumeAtMatchesFullTokenize) {
+  auto id = addSource("let a = 1;\nlet 名字 = \"s\";", "test.zero");
+  Lexer full(sm_, id);
+  auto expected = full.tokenize();
+
+  // 从第二行的 let 处继续，结果与整体分析的后半部分一致
+  Lexer resumed(sm_, id);
+  resumed.resumeAt(11);
+  auto tokens = resumed.tokenize();
+
+  ASSERT_EQ(tokens.size(), 6u);
+  for (std::size_t i = 0; i < tokens.size(); ++i) {
+    const auto &want = expected[expected.size() - tokens.size() + i];
+    EXPECT_EQ(tokens[i].type(), want.type()) << i;
+    EXPECT_EQ(tokens[i].offset(), want.offset()) << i;
+    EXPECT_EQ(tokens[i].location().line, want.location().line) << i;
+    EXPECT_EQ(tokens[i].location().column, want.location().column) << i;
+  }
+}
+
 } // namespace
 } // namespace czc::lexer
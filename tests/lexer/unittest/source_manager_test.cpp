@@ -6,10 +6,17 @@
  * @date 2025-11-30
  */
 
+#include "czc/common/hash.hpp"
+#include "czc/lexer/lexer_source_locator.hpp"
 #include "czc/lexer/source_manager.hpp"
 
 #include <gtest/gtest.h>
 
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace czc::lexer {
 namespace {
 
@@ -376,5 +383,193 @@ TEST_F(SourceManagerTest, GetExpansionInfoOversizedID) {
   EXPECT_FALSE(result.has_value());
 }
 
+// ============================================================================
+// 行号索引测试
+// ============================================================================
+
+TEST_F(SourceManagerTest, GetLineNumberUsesLineIndex) {
+  auto id = addSource("ab\ncd\n\nef", "lines.zero");
+
+  EXPECT_EQ(sm_.getLineNumber(id, 0), 1u);
+  EXPECT_EQ(sm_.getLineNumber(id, 2), 1u); // 换行符属于所在行
+  EXPECT_EQ(sm_.getLineNumber(id, 3), 2u);
+  EXPECT_EQ(sm_.getLineNumber(id, 6), 3u);
+  EXPECT_EQ(sm_.getLineNumber(id, 9), 4u); // 源码末尾
+  EXPECT_EQ(sm_.getLineNumber(id, 10), 0u);
+  EXPECT_EQ(sm_.getLineNumber(BufferID::invalid(), 0), 0u);
+}
+
+TEST_F(SourceManagerTest, GetLineStartReturnsLineOffsets) {
+  auto id = addSource("ab\ncd\n\nef", "lines.zero");
+
+  EXPECT_EQ(sm_.getLineStart(id, 1), 0u);
+  EXPECT_EQ(sm_.getLineStart(id, 2), 3u);
+  EXPECT_EQ(sm_.getLineStart(id, 4), 7u);
+  EXPECT_FALSE(sm_.getLineStart(id, 5).has_value());
+  EXPECT_FALSE(sm_.getLineStart(id, 0).has_value());
+}
+
+TEST_F(SourceManagerTest, GetLineStartsReturnsWholeIndex) {
+  auto id = addSource("ab\ncd\n\nef", "lines.zero");
+
+  auto starts = sm_.getLineStarts(id);
+  ASSERT_EQ(starts.size(), 4u);
+  EXPECT_EQ(starts[1], 3u);
+  EXPECT_EQ(starts[3], 7u);
+  EXPECT_TRUE(sm_.getLineStarts(BufferID::invalid()).empty());
+}
+
+TEST_F(SourceManagerTest, LocatorSortedSweepMatchesPointLookups) {
+  auto id = addSource("ab\ncd\n\nef", "lines.zero");
+  LexerSourceLocator locator(sm_);
+
+  std::vector<uint32_t> offsets{0, 2, 3, 3, 6, 7, 9, 10};
+  std::vector<diag::LineColumn> out(offsets.size());
+  locator.resolveSorted(id.value, offsets, out);
+
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    auto expected = locator.getLineColumn(id.value, offsets[i]);
+    EXPECT_EQ(out[i].line, expected.line) << "offset " << offsets[i];
+    EXPECT_EQ(out[i].column, expected.column) << "offset " << offsets[i];
+  }
+}
+
+TEST_F(SourceManagerTest, LocatorSliceIsNotTruncated) {
+  std::string source(70000, 'x');
+  auto id = addSource(source, "long.zero");
+  LexerSourceLocator locator(sm_);
+
+  auto slice = locator.getSourceSlice(diag::Span::create(id.value, 1, 69001));
+  EXPECT_EQ(slice.size(), 69000u);
+  EXPECT_EQ(slice.data(), sm_.getSource(id).data() + 1);
+}
+
+TEST_F(SourceManagerTest, LocatorSharedAcrossThreads) {
+  std::string source;
+  for (int i = 0; i < 1000; ++i) {
+    source += "line " + std::to_string(i) + "\n";
+  }
+  auto id = addSource(source, "shared.zero");
+  LexerSourceLocator locator(sm_);
+
+  // 行偏移表在加入时已构建，并发只读查询无需同步
+  std::vector<std::thread> threads;
+  std::vector<uint32_t> lines(4);
+  for (size_t t = 0; t < lines.size(); ++t) {
+    threads.emplace_back([&, t] {
+      auto offset = static_cast<uint32_t>(source.size() / 2 + t);
+      lines[t] = locator.getLineColumn(id.value, offset).line;
+      (void)locator.getLineContent(id.value, lines[t]);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < lines.size(); ++t) {
+    auto offset = static_cast<uint32_t>(source.size() / 2 + t);
+    EXPECT_EQ(lines[t], sm_.getLineNumber(id, offset));
+  }
+}
+
+// ============================================================================
+// 列号换算索引测试
+// ============================================================================
+
+TEST_F(SourceManagerTest, AsciiLinesConvertDirectly) {
+  auto id = addSource("let x = 1;\nname\n", "ascii.zero");
+  EXPECT_TRUE(sm_.isAsciiLine(id, 1));
+  EXPECT_TRUE(sm_.isAsciiLine(id, 3));
+  EXPECT_FALSE(sm_.isAsciiLine(id, 4));
+  EXPECT_EQ(sm_.getColumn(id, 15, ColumnUnit::Utf16), 4u);
+  EXPECT_EQ(sm_.getColumn(id, 15, ColumnUnit::CodePoint), 4u);
+  EXPECT_EQ(sm_.getOffset(id, 2, 2, ColumnUnit::Utf16), 13u);
+  EXPECT_EQ(sm_.getOffset(id, 2, 99, ColumnUnit::CodePoint), 15u);
+  EXPECT_EQ(sm_.getOffset(id, 5, 0, ColumnUnit::Byte), std::nullopt);
+}
+
+TEST_F(SourceManagerTest, ConvertsMixedWidthColumns) {
+  // "aé名😀b"：字节 0,1,3,6,10；UTF-16 0,1,2,3,5；码点 0,1,2,3,4
+  auto id = addSource("x\na\xC3\xA9\xE5\x90\x8D\xF0\x9F\x98\x80"
+                      "b\r\n",
+                      "mixed.zero");
+  EXPECT_TRUE(sm_.isAsciiLine(id, 1));
+  EXPECT_FALSE(sm_.isAsciiLine(id, 2));
+
+  const std::uint32_t base = 2;
+  EXPECT_EQ(sm_.getColumn(id, base + 10, ColumnUnit::Byte), 10u);
+  EXPECT_EQ(sm_.getColumn(id, base + 10, ColumnUnit::Utf16), 5u);
+  EXPECT_EQ(sm_.getColumn(id, base + 10, ColumnUnit::CodePoint), 4u);
+  // 偏移落在多字节字符中间时，已越过首字节的字符计入
+  EXPECT_EQ(sm_.getColumn(id, base + 8, ColumnUnit::Utf16), 5u);
+
+  EXPECT_EQ(sm_.getOffset(id, 2, 3, ColumnUnit::Utf16), base + 6);
+  EXPECT_EQ(sm_.getOffset(id, 2, 4, ColumnUnit::Utf16), base + 6);
+  EXPECT_EQ(sm_.getOffset(id, 2, 5, ColumnUnit::Utf16), base + 10);
+  EXPECT_EQ(sm_.getOffset(id, 2, 4, ColumnUnit::CodePoint), base + 10);
+  // 超过行长截到行尾，不含 \r\n
+  EXPECT_EQ(sm_.getOffset(id, 2, 99, ColumnUnit::Utf16), base + 11);
+}
+
+TEST_F(SourceManagerTest, ColumnIndexMatchesLinearScan) {
+  // 长的非 ASCII 行跨越多个检查点
+  std::mt19937 rng(7);
+  const char *pieces[] = {"a", " ", "\xC3\xA9", "\xE5\x90\x8D",
+                          "\xF0\x9F\x98\x80", "\n"};
+  std::string source;
+  for (int i = 0; i < 4000; ++i) {
+    source += pieces[rng() % (i % 500 < 400 ? 5 : 6)];
+  }
+  auto id = addSource(source, "long.zero");
+
+  std::uint32_t line = 1;
+  std::uint32_t utf16 = 0;
+  std::uint32_t codePoint = 0;
+  for (std::uint32_t offset = 0; offset <= source.size(); ++offset) {
+    if (offset > 0 && source[offset - 1] == '\n') {
+      ++line;
+      utf16 = codePoint = 0;
+    }
+    auto byte = offset < source.size()
+                    ? static_cast<unsigned char>(source[offset])
+                    : 0;
+    bool boundary = (byte & 0xC0) != 0x80;
+    if (boundary) {
+      ASSERT_EQ(sm_.getColumn(id, offset, ColumnUnit::Utf16), utf16);
+      ASSERT_EQ(sm_.getColumn(id, offset, ColumnUnit::CodePoint), codePoint);
+      if (byte != '\n') {
+        ASSERT_EQ(sm_.getOffset(id, line, utf16, ColumnUnit::Utf16), offset);
+        ASSERT_EQ(sm_.getOffset(id, line, codePoint, ColumnUnit::CodePoint),
+                  offset);
+      }
+    }
+    if (boundary && offset < source.size() && byte != '\n') {
+      utf16 += byte >= 0xF0 ? 2 : 1;
+      ++codePoint;
+    }
+  }
+}
+
+TEST_F(SourceManagerTest, ContentHashDependsOnlyOnContent) {
+  auto a = addSource("let x = 1;", "a.zero");
+  auto b = addSource("let x = 1;", "b.zero");
+  auto c = addSource("let x = 2;", "a.zero");
+  auto empty = addSource("", "e.zero");
+
+  EXPECT_EQ(sm_.contentHash(a), sm_.contentHash(b));
+  EXPECT_NE(sm_.contentHash(a), sm_.contentHash(c));
+  EXPECT_NE(sm_.contentHash(a), sm_.contentHash(empty));
+  EXPECT_EQ(sm_.contentHash(BufferID::invalid()), 0u);
+}
+
+TEST_F(SourceManagerTest, PrecomputedContentHashIsKept) {
+  std::string source = "let y = 2;\nlet z = 3;";
+  const auto hash = czc::hashBytes(source);
+  auto id = sm_.addBuffer(source, "p.zero", hash);
+
+  EXPECT_EQ(sm_.contentHash(id), hash);
+  EXPECT_EQ(sm_.contentHash(id), sm_.contentHash(addSource(source, "q.zero")));
+  EXPECT_EQ(sm_.getLineContent(id, 2), "let z = 3;");
+}
+
 } // namespace
 } // namespace czc::lexer
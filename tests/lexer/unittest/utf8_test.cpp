@@ -487,5 +487,28 @@ TEST_F(AsciiIdentTest, LettersAreAsciiIdentContinue) {
   }
 }
 
+// ============================================================================
+// utf16Length / utf16ToByteOffset 测试
+// ============================================================================
+
+TEST(Utf16Test, LengthCountsSurrogatePairs) {
+  EXPECT_EQ(utf16Length(""), 0u);
+  EXPECT_EQ(utf16Length("abc"), 3u);
+  EXPECT_EQ(utf16Length("名字"), 2u);     // 各 3 字节、1 个码元
+  EXPECT_EQ(utf16Length("a\U0001F600"), 3u); // emoji 为代理对
+}
+
+TEST(Utf16Test, ByteOffsetFromUnits) {
+  std::string_view text = "a名\U0001F600b";
+  EXPECT_EQ(utf16ToByteOffset(text, 0), 0u);
+  EXPECT_EQ(utf16ToByteOffset(text, 1), 1u);
+  EXPECT_EQ(utf16ToByteOffset(text, 2), 4u);
+  // 落在代理对中间时取字符起点
+  EXPECT_EQ(utf16ToByteOffset(text, 3), 4u);
+  EXPECT_EQ(utf16ToByteOffset(text, 4), 8u);
+  EXPECT_EQ(utf16ToByteOffset(text, 5), 9u);
+  EXPECT_EQ(utf16ToByteOffset(text, 100), text.size());
+}
+
 } // namespace
 } // namespace czc::lexer::utf8
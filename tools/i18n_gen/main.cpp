@@ -0,0 +1,253 @@
+/**
+ * @file main.cpp
+ * @brief i18n 目录生成器：将 TOML 翻译文件编译为 C++ 常量表。
+ * @author BegoniaHe
+ * @version 0.0.1
+ * @date 2025-12-04
+ *
+ * @details
+ *   用法: czc_i18n_gen <output.cpp> <locale.toml>...
+ *
+ *   语言由文件名推断（如 en.toml -> Locale::En）。
+ *   每个文件的字符串值按点分路径扁平化、按键排序后输出为
+ *   constexpr CatalogEntry 数组，并生成 builtinCatalog() 的定义。
+ *   含 `{N}` 占位符的值同时输出预编译的模板片段。
+ */
+
+#include "czc/diag/message_template.hpp"
+
+#include <toml++/toml.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// 单段字符串字面量的最大字节数（MSVC 限制单段 16 KiB）
+constexpr size_t kMaxLiteralChunk = 2048;
+
+/// 语言标签与 Locale 枚举名的对应关系
+constexpr std::array<std::pair<std::string_view, std::string_view>, 4>
+    kLocales = {{
+        {"en", "En"},
+        {"zh-CN", "ZhCN"},
+        {"zh-TW", "ZhTW"},
+        {"ja", "Ja"},
+    }};
+
+using Entries = std::vector<std::pair<std::string, std::string>>;
+
+/// 生成的单个语言目录
+struct LocaleCatalog {
+  std::string_view enumerator;
+  Entries entries;
+};
+
+/// 递归扁平化 TOML 表（与 Translator::loadFromMemory 的键规则一致）
+void flatten(const toml::table &table, const std::string &prefix,
+             Entries &out) {
+  for (const auto &[key, value] : table) {
+    std::string fullKey = prefix.empty()
+                              ? std::string(key.str())
+                              : prefix + "." + std::string(key.str());
+    if (value.is_string()) {
+      out.emplace_back(fullKey, std::string(value.as_string()->get()));
+    } else if (value.is_table()) {
+      flatten(*value.as_table(), fullKey, out);
+    }
+  }
+}
+
+/// 以 C++ 字符串字面量形式写出字节串（非 ASCII 使用八进制转义）
+void writeLiteral(std::ostream &out, std::string_view text) {
+  if (text.empty()) {
+    out << "\"\"";
+    return;
+  }
+  for (size_t pos = 0; pos < text.size(); pos += kMaxLiteralChunk) {
+    if (pos != 0) {
+      out << "\n    ";
+    }
+    out << '"';
+    for (char c : text.substr(pos, kMaxLiteralChunk)) {
+      auto byte = static_cast<unsigned char>(c);
+      switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (byte < 0x20 || byte >= 0x7F) {
+          // 八进制转义至多 3 位，不会吞并后续字符
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\%03o", byte);
+          out << buf;
+        } else {
+          out << c;
+        }
+      }
+    }
+    out << '"';
+  }
+}
+
+/// 读取并扁平化一个翻译文件
+auto loadCatalog(const std::filesystem::path &path, LocaleCatalog &catalog)
+    -> bool {
+  auto tag = path.stem().string();
+  auto it = std::find_if(kLocales.begin(), kLocales.end(),
+                         [&](const auto &entry) { return entry.first == tag; });
+  if (it == kLocales.end()) {
+    std::cerr << "czc_i18n_gen: unknown locale '" << tag << "' (" << path
+              << ")\n";
+    return false;
+  }
+  catalog.enumerator = it->second;
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::cerr << "czc_i18n_gen: cannot open " << path << "\n";
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+
+  try {
+    auto table = toml::parse(buffer.str());
+    flatten(table, "", catalog.entries);
+  } catch (const toml::parse_error &e) {
+    std::cerr << "czc_i18n_gen: " << path << ": " << e.what() << "\n";
+    return false;
+  }
+
+  std::sort(catalog.entries.begin(), catalog.entries.end());
+  return true;
+}
+
+/// 写出生成的源文件
+void writeSource(std::ostream &out,
+                 const std::vector<LocaleCatalog> &catalogs) {
+  out << "// 由 czc_i18n_gen 生成，请勿手动修改。\n"
+         "\n"
+         "#include \"czc/diag/i18n_catalog.hpp\"\n"
+         "\n"
+         "namespace czc::diag::i18n {\n"
+         "\n"
+         "namespace {\n";
+
+  using czc::diag::i18n::TemplateSegment;
+
+  for (const auto &catalog : catalogs) {
+    // 所有条目的模板片段集中在一个数组中，条目以子区间引用
+    std::vector<TemplateSegment> segments;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (const auto &entry : catalog.entries) {
+      size_t begin = segments.size();
+      czc::diag::i18n::forEachSegment(
+          entry.second, [&](TemplateSegment s) { segments.push_back(s); });
+      ranges.emplace_back(begin, segments.size() - begin);
+    }
+
+    if (!segments.empty()) {
+      out << "\nconstexpr TemplateSegment k" << catalog.enumerator
+          << "Segments[] = {\n";
+      for (const auto &s : segments) {
+        out << "    {" << s.offset << ", " << s.length << ", " << s.arg
+            << "},\n";
+      }
+      out << "};\n";
+    }
+
+    out << "\nconstexpr CatalogEntry k" << catalog.enumerator
+        << "Entries[] = {\n";
+    for (size_t i = 0; i < catalog.entries.size(); ++i) {
+      const auto &[key, value] = catalog.entries[i];
+      out << "    {";
+      writeLiteral(out, key);
+      out << ",\n     ";
+      writeLiteral(out, value);
+      if (ranges[i].second != 0) {
+        out << ",\n     std::span<const TemplateSegment>(k"
+            << catalog.enumerator << "Segments + " << ranges[i].first << ", "
+            << ranges[i].second << ")";
+      }
+      out << "},\n";
+    }
+    out << "};\n"
+        << "\nconstexpr Catalog k" << catalog.enumerator << "Catalog{k"
+        << catalog.enumerator << "Entries};\n";
+  }
+
+  out << "\n} // namespace\n"
+         "\n"
+         "auto builtinCatalog(Locale locale) noexcept -> const Catalog * {\n"
+         "  switch (locale) {\n";
+  for (const auto &catalog : catalogs) {
+    out << "  case Locale::" << catalog.enumerator << ":\n"
+        << "    return &k" << catalog.enumerator << "Catalog;\n";
+  }
+  out << "  default:\n"
+         "    return nullptr;\n"
+         "  }\n"
+         "}\n"
+         "\n"
+         "} // namespace czc::diag::i18n\n";
+}
+
+} // namespace
+
+/**
+ * @brief 生成器入口点。
+ *
+ * @param argc 命令行参数个数
+ * @param argv 命令行参数数组
+ * @return 成功返回 0
+ */
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "usage: czc_i18n_gen <output.cpp> <locale.toml>...\n";
+    return 2;
+  }
+
+  std::vector<LocaleCatalog> catalogs(static_cast<size_t>(argc - 2));
+  for (int i = 2; i < argc; ++i) {
+    if (!loadCatalog(argv[i], catalogs[static_cast<size_t>(i - 2)])) {
+      return 1;
+    }
+  }
+
+  // 先写入临时文件再替换，避免中断后留下半个源文件
+  std::filesystem::path output(argv[1]);
+  if (output.has_parent_path()) {
+    std::filesystem::create_directories(output.parent_path());
+  }
+  auto temp = output;
+  temp += ".tmp";
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      std::cerr << "czc_i18n_gen: cannot write " << temp << "\n";
+      return 1;
+    }
+    writeSource(out, catalogs);
+  }
+  std::filesystem::rename(temp, output);
+  return 0;
+}